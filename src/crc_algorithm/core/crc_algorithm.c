@@ -1,5 +1,16 @@
 #include "crc_algorithm.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define CRC_HAVE_HARDWARE_CRC32C 1
+#endif
+
+#define CRC32C_POLYNOMIAL 0x1EDC6F41
+
 /* CRC标准预设配置 */
 const crc_config_t CRC_PRESETS[] = {
     // CRC-8: 多项式 x^8 + x^2 + x^1 + 1 = 0x07
@@ -12,12 +23,15 @@ const crc_config_t CRC_PRESETS[] = {
     {CRC_16_CCITT, 0x1021, 16, 0xFFFF, 0x0000, false, false, "CRC-16-CCITT"},
     
     // CRC-32: 多项式 x^32 + x^26 + x^23 + ... + 1 = 0x04C11DB7
-    {CRC_32, 0x04C11DB7, 32, 0xFFFFFFFF, 0xFFFFFFFF, true, true, "CRC-32"}
+    {CRC_32, 0x04C11DB7, 32, 0xFFFFFFFF, 0xFFFFFFFF, true, true, "CRC-32"},
+    
+    // CRC-32C: Castagnoli多项式 0x1EDC6F41，iSCSI/ext4等使用，x86有硬件指令
+    {CRC_32C, CRC32C_POLYNOMIAL, 32, 0xFFFFFFFF, 0xFFFFFFFF, true, true, "CRC-32C"}
 };
 
 /* 初始化CRC配置 */
 void init_crc_config(crc_config_t* config, crc_type_t type) {
-    if (config == NULL || type > CRC_32) return;
+    if (config == NULL || type >= CRC_TYPE_COUNT) return;
     *config = CRC_PRESETS[type];
 }
 
@@ -45,12 +59,33 @@ uint32_t reflect_bits(uint32_t data, int width) {
     uint32_t reflection = 0;
     for (int i = 0; i < width; i++) {
         if ((data >> i) & 1) {
-            reflection |= (1 << (width - 1 - i));
+            reflection |= (1u << (width - 1 - i));
         }
     }
     return reflection;
 }
 
+/* 计算位宽掩码 */
+static uint32_t crc_width_mask(int width) {
+    return width >= 32 ? 0xFFFFFFFFu : ((1u << width) - 1);
+}
+
+/* GF(2)多项式乘法取模：返回 a*b mod P（非反射表示，结果位宽为config->width） */
+static uint32_t crc_multiply_mod(uint32_t a, uint32_t b, const crc_config_t* config) {
+    uint32_t top_bit = 1u << (config->width - 1);
+    uint32_t mask = crc_width_mask(config->width);
+    uint32_t product = 0;
+    
+    for (int i = config->width - 1; i >= 0; i--) {
+        bool carry = (product & top_bit) != 0;
+        product = (product << 1) & mask;
+        if (carry) product ^= config->polynomial;
+        if ((b >> i) & 1) product ^= a;
+    }
+    
+    return product;
+}
+
 /* 生成CRC查找表 */
 void generate_crc_table(crc_table_t* table, const crc_config_t* config) {
     if (table == NULL || config == NULL) return;
@@ -101,8 +136,38 @@ void generate_crc_table(crc_table_t* table, const crc_config_t* config) {
         table->table[i] = crc & ((1ULL << config->width) - 1);
     }
     
+    // 零字节跳跃幂表：zero_powers[k] = x^(8*2^k) mod P（非反射表示）
+    uint32_t power = 1;
+    for (int bit = 0; bit < 8; bit++) {
+        power = crc_multiply_mod(power, 2, config);
+    }
+    for (int k = 0; k < CRC_ZERO_POWERS; k++) {
+        table->zero_powers[k] = power;
+        power = crc_multiply_mod(power, power, config);
+    }
+    
+    // 反射32位CRC额外生成切片表，每次处理8字节；CRC-32C在支持时直接使用硬件指令
+    table->engine = CRC_ENGINE_TABLE;
+    if (config->reflect_in && config->width == 32) {
+        for (int i = 0; i < CRC_TABLE_SIZE; i++) {
+            table->slice_table[0][i] = table->table[i];
+        }
+        for (int k = 1; k < CRC_SLICE_COUNT; k++) {
+            for (int i = 0; i < CRC_TABLE_SIZE; i++) {
+                uint32_t prev = table->slice_table[k - 1][i];
+                table->slice_table[k][i] = (prev >> 8) ^ table->table[prev & 0xFF];
+            }
+        }
+        table->engine = CRC_ENGINE_SLICE8;
+#ifdef CRC_HAVE_HARDWARE_CRC32C
+        if (config->polynomial == CRC32C_POLYNOMIAL && __builtin_cpu_supports("sse4.2")) {
+            table->engine = CRC_ENGINE_HARDWARE;
+        }
+#endif
+    }
+    
     table->is_generated = true;
-    printf("CRC查找表生成完成！\n");
+    printf("CRC查找表生成完成！(计算引擎: %s)\n", crc_engine_name(table->engine));
 }
 
 /* 打印CRC查找表（用于教学演示） */
@@ -146,6 +211,9 @@ uint32_t calculate_crc_bitwise(const uint8_t* data, size_t length,
     printf("\n生成多项式: 0x%0*X\n", (config->width + 3) / 4, polynomial);
     printf("\n");
     
+    uint32_t top_bit = 1u << (config->width - 1);
+    uint32_t mask = crc_width_mask(config->width);
+    
     for (size_t i = 0; i < length; i++) {
         uint8_t byte = data[i];
         if (config->reflect_in) {
@@ -154,29 +222,19 @@ uint32_t calculate_crc_bitwise(const uint8_t* data, size_t length,
         
         printf("处理字节 %zu: 0x%02X\n", i, data[i]);
         
+        // 数据字节异或进寄存器高8位，再逐位做模2除法
+        crc ^= (uint32_t)byte << (config->width - 8);
+        
         for (int bit = 7; bit >= 0; bit--) {
-            bool data_bit = (byte >> bit) & 1;
-            bool msb = 0;
-            
-            if (config->width == 8) {
-                msb = (crc >> 7) & 1;
-                crc = (crc << 1) & 0xFF;
-            } else if (config->width == 16) {
-                msb = (crc >> 15) & 1;
-                crc = (crc << 1) & 0xFFFF;
-            } else if (config->width == 32) {
-                msb = (crc >> 31) & 1;
-                crc = crc << 1;
-            }
-            
-            if (data_bit) crc |= 1;
+            bool msb = (crc & top_bit) != 0;
+            crc = (crc << 1) & mask;
             
             if (msb) {
                 crc ^= polynomial;
             }
             
             if (i < 2) { // 只显示前两个字节的详细过程
-                printf("  位 %d: 数据位=%d, MSB=%d, CRC=0x", 7-bit, data_bit, msb);
+                printf("  位 %d: MSB=%d, CRC=0x", 7-bit, msb);
                 print_binary(crc, config->width);
                 printf("\n");
             }
@@ -194,52 +252,210 @@ uint32_t calculate_crc_bitwise(const uint8_t* data, size_t length,
     return crc;
 }
 
+#ifdef CRC_HAVE_HARDWARE_CRC32C
+/* SSE4.2 crc32指令推进CRC-32C寄存器 */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hardware_update(uint32_t crc, const uint8_t* data, size_t length) {
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (length > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+        length--;
+    }
+    return crc;
+}
+#endif
+
+/* 切片查表法推进反射32位CRC寄存器，每次处理8字节 */
+static uint32_t crc_slice8_update(uint32_t crc, const uint8_t* data, size_t length,
+                                  const crc_table_t* table) {
+    const uint32_t (*s)[CRC_TABLE_SIZE] = table->slice_table;
+    
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (length >= 8) {
+        uint32_t one;
+        uint32_t two;
+        memcpy(&one, data, sizeof(one));
+        memcpy(&two, data + 4, sizeof(two));
+        one ^= crc;
+        crc = s[7][one & 0xFF] ^ s[6][(one >> 8) & 0xFF] ^
+              s[5][(one >> 16) & 0xFF] ^ s[4][one >> 24] ^
+              s[3][two & 0xFF] ^ s[2][(two >> 8) & 0xFF] ^
+              s[1][(two >> 16) & 0xFF] ^ s[0][two >> 24];
+        data += 8;
+        length -= 8;
+    }
+#endif
+    while (length > 0) {
+        crc = (crc >> 8) ^ s[0][(crc ^ *data++) & 0xFF];
+        length--;
+    }
+    return crc;
+}
+
+/* 按字节推进CRC寄存器（不含初始值和最终异或处理） */
+static uint32_t crc_register_update(uint32_t crc, const uint8_t* data, size_t length,
+                                    const crc_config_t* config, const crc_table_t* table) {
+    const uint32_t* t = table->table;
+    
+#ifdef CRC_HAVE_HARDWARE_CRC32C
+    if (table->engine == CRC_ENGINE_HARDWARE) {
+        return crc32c_hardware_update(crc, data, length);
+    }
+#endif
+    if (table->engine == CRC_ENGINE_SLICE8) {
+        return crc_slice8_update(crc, data, length, table);
+    }
+    
+    if (config->reflect_in) {
+        // 反射查找表已经按反射顺序生成，输入字节无需再反转
+        for (size_t i = 0; i < length; i++) {
+            crc = (crc >> 8) ^ t[(crc ^ data[i]) & 0xFF];
+        }
+    } else {
+        int shift = config->width - 8;
+        uint32_t mask = crc_width_mask(config->width);
+        for (size_t i = 0; i < length; i++) {
+            crc = ((crc << 8) ^ t[((crc >> shift) ^ data[i]) & 0xFF]) & mask;
+        }
+    }
+    
+    return crc;
+}
+
+/* 由寄存器值得到最终CRC（输出反射和最终异或） */
+static uint32_t crc_register_finalize(uint32_t crc, const crc_config_t* config) {
+    if (config->reflect_out && !config->reflect_in) {
+        crc = reflect_bits(crc, config->width);
+    }
+    return crc ^ config->final_xor_value;
+}
+
 /* 使用查找表快速计算CRC */
 uint32_t calculate_crc_table(const uint8_t* data, size_t length, 
                              const crc_config_t* config, const crc_table_t* table) {
     if (data == NULL || config == NULL || table == NULL || 
         !table->is_generated || length == 0) return 0;
     
-    uint32_t crc = config->initial_value;
-    
-    for (size_t i = 0; i < length; i++) {
-        uint8_t byte = data[i];
-        
-        if (config->reflect_in) {
-            byte = reflect_bits(byte, 8);
+    uint32_t crc = crc_register_update(config->initial_value, data, length, config, table);
+    return crc_register_finalize(crc, config);
+}
+
+/* 以当前寄存器为起点推进count个零字节：寄存器乘以 x^(8*count) mod P，O(log count) */
+static uint32_t crc_register_zeros(uint32_t crc, uint64_t count,
+                                   const crc_config_t* config, const crc_table_t* table) {
+    // 反射寄存器的位序与多项式表示相反，先转回非反射表示再相乘
+    if (config->reflect_in) crc = reflect_bits(crc, config->width);
+    
+    for (int k = 0; count > 0 && k < CRC_ZERO_POWERS; k++, count >>= 1) {
+        if (count & 1) {
+            crc = crc_multiply_mod(crc, table->zero_powers[k], config);
         }
-        
-        if (config->width == 8) {
-            crc = table->table[crc ^ byte];
-        } else if (config->width == 16) {
-            if (config->reflect_in) {
-                crc = (crc >> 8) ^ table->table[(crc ^ byte) & 0xFF];
-            } else {
-                crc = (crc << 8) ^ table->table[((crc >> 8) ^ byte) & 0xFF];
-            }
-        } else if (config->width == 32) {
-            if (config->reflect_in) {
-                crc = (crc >> 8) ^ table->table[(crc ^ byte) & 0xFF];
-            } else {
-                crc = (crc << 8) ^ table->table[((crc >> 24) ^ byte) & 0xFF];
+    }
+    
+    if (config->reflect_in) crc = reflect_bits(crc, config->width);
+    return crc;
+}
+
+/* 检查一个零块检测单元是否全为零 */
+static bool crc_block_is_zero(const uint8_t* block) {
+#if defined(__SSE2__)
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(const void*)block);
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(const void*)(block + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i*)(const void*)(block + 32));
+    __m128i v3 = _mm_loadu_si128((const __m128i*)(const void*)(block + 48));
+    __m128i any = _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xFFFF;
+#else
+    uint64_t any = 0;
+    for (size_t i = 0; i < CRC_SPARSE_BLOCK; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, block + i, sizeof(word));
+        any |= word;
+    }
+    return any == 0;
+#endif
+}
+
+/* 稀疏数据CRC计算 */
+uint32_t calculate_crc_sparse(const uint8_t* data, size_t length,
+                              const crc_config_t* config, const crc_table_t* table) {
+    if (data == NULL || config == NULL || table == NULL || 
+        !table->is_generated || length == 0) return 0;
+    
+    uint32_t crc = config->initial_value;
+    size_t literal_start = 0;   // 尚未计算的非零数据起点
+    size_t i = 0;
+    
+    while (i + CRC_SPARSE_BLOCK <= length) {
+        if (!crc_block_is_zero(data + i)) {
+            i += CRC_SPARSE_BLOCK;
+            // 稠密数据趁刚检测过还在L1缓存中时分段计算，避免二次读取带来的减速
+            if (i - literal_start >= CRC_SPARSE_FLUSH) {
+                crc = crc_register_update(crc, data + literal_start, i - literal_start,
+                                          config, table);
+                literal_start = i;
             }
+            continue;
         }
         
-        // 确保CRC值在正确的位宽范围内
-        if (config->width < 32) {
-            crc &= (1ULL << config->width) - 1;
+        // 找到整块零数据：向后延伸零串，再把零串之前的普通数据一次性查表计算
+        size_t run_start = i;
+        i += CRC_SPARSE_BLOCK;
+        while (i + CRC_SPARSE_BLOCK <= length && crc_block_is_zero(data + i)) {
+            i += CRC_SPARSE_BLOCK;
         }
+        
+        size_t run_length = i - run_start;
+        if (run_length < CRC_ZERO_RUN_MIN) continue;  // 短零串按普通数据处理更快
+        
+        crc = crc_register_update(crc, data + literal_start, run_start - literal_start,
+                                  config, table);
+        crc = crc_register_zeros(crc, run_length, config, table);
+        literal_start = i;
     }
     
+    crc = crc_register_update(crc, data + literal_start, length - literal_start, config, table);
+    return crc_register_finalize(crc, config);
+}
+
+/* 由最终CRC值还原寄存器值（crc_register_finalize的逆运算） */
+static uint32_t crc_register_unfinalize(uint32_t crc, const crc_config_t* config) {
+    crc ^= config->final_xor_value;
     if (config->reflect_out && !config->reflect_in) {
         crc = reflect_bits(crc, config->width);
     }
-    
-    crc ^= config->final_xor_value;
-    
     return crc;
 }
 
+/* CRC合并：reg(AB) = reg(A)*x^(8|B|) ^ reg(B) ^ init*x^(8|B|) */
+uint32_t combine_crc(uint32_t crc_a, uint32_t crc_b, uint64_t length_b,
+                     const crc_config_t* config, const crc_table_t* table) {
+    if (config == NULL || table == NULL || !table->is_generated) return 0;
+    if (length_b == 0) return crc_a;
+    
+    uint32_t reg_a = crc_register_unfinalize(crc_a, config);
+    uint32_t reg_b = crc_register_unfinalize(crc_b, config);
+    uint32_t shifted = crc_register_zeros(reg_a ^ config->initial_value, length_b, config, table);
+    return crc_register_finalize(shifted ^ reg_b, config);
+}
+
+/* 获取计算引擎名称 */
+const char* crc_engine_name(crc_engine_t engine) {
+    switch (engine) {
+        case CRC_ENGINE_SLICE8:   return "切片查表(slicing-by-8)";
+        case CRC_ENGINE_HARDWARE: return "SSE4.2硬件指令";
+        default:                  return "逐字节查表";
+    }
+}
+
 /* 完整CRC计算（包含时间统计） */
 crc_result_t compute_crc_complete(const uint8_t* data, size_t length,
                                   const crc_config_t* config, 
@@ -567,4 +783,279 @@ void bytes_to_hex_string(const uint8_t* bytes, size_t length, char* hex_str) {
         sprintf(hex_str + i * 2, "%02X", bytes[i]);
     }
     hex_str[length * 2] = '\0';
-}
\ No newline at end of file
+}
+
+/* ========== 流式CRC计算 ========== */
+
+/* 初始化流式CRC上下文 */
+bool init_crc_context(crc_context_t* context, const crc_config_t* config,
+                      const crc_table_t* table) {
+    if (context == NULL || config == NULL || table == NULL || !table->is_generated) return false;
+    
+    context->config = *config;
+    context->table = table;
+    context->crc = config->initial_value;
+    context->length = 0;
+    return true;
+}
+
+/* 追加一段数据，结果与对整体数据一次性计算相同 */
+void update_crc_context(crc_context_t* context, const uint8_t* data, size_t length) {
+    if (context == NULL || data == NULL || length == 0) return;
+    
+    context->crc = crc_register_update(context->crc, data, length, &context->config, context->table);
+    context->length += length;
+}
+
+/* 取出当前CRC值（不改变上下文，可继续追加数据） */
+uint32_t finalize_crc_context(const crc_context_t* context) {
+    if (context == NULL) return 0;
+    if (context->length == 0) return 0;   // 与 calculate_crc_table 对空数据的约定一致
+    return crc_register_finalize(context->crc, &context->config);
+}
+
+/* ========== 滚动CRC与内容定义分块 ========== */
+
+/* 初始化滚动CRC */
+bool init_rolling_crc(rolling_crc_t* rolling, const crc_config_t* config,
+                      const crc_table_t* table, size_t window_size) {
+    if (rolling == NULL || config == NULL || table == NULL ||
+        !table->is_generated || window_size == 0) return false;
+    
+    memset(rolling, 0, sizeof(*rolling));
+    rolling->window = calloc(window_size, 1);
+    if (rolling->window == NULL) return false;
+    
+    rolling->config = *config;
+    rolling->table = table;
+    rolling->window_size = window_size;
+    
+    // 零初值寄存器关于输入是线性的：移出字节b的贡献 = b 后接 window_size 个零字节。
+    // 先求8个单比特基向量，再按位异或组合出整张移出表。
+    uint32_t basis[8];
+    for (int bit = 0; bit < 8; bit++) {
+        uint8_t byte = (uint8_t)(1u << bit);
+        uint32_t crc = crc_register_update(0, &byte, 1, config, table);
+        basis[bit] = crc_register_zeros(crc, window_size, config, table);
+    }
+    for (int i = 0; i < CRC_TABLE_SIZE; i++) {
+        uint32_t value = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (i & (1 << bit)) value ^= basis[bit];
+        }
+        rolling->out_table[i] = value;
+    }
+    
+    // 初始值对整窗CRC的贡献是常量，计算结果时再异或进去
+    rolling->init_term = crc_register_zeros(config->initial_value, window_size, config, table);
+    
+    return true;
+}
+
+/* 滚动CRC移入一个字节（同时移出窗口中最旧的字节） */
+uint32_t update_rolling_crc(rolling_crc_t* rolling, uint8_t byte) {
+    if (rolling == NULL || rolling->window == NULL) return 0;
+    
+    uint8_t out = rolling->window[rolling->position];
+    rolling->window[rolling->position] = byte;
+    if (++rolling->position == rolling->window_size) rolling->position = 0;
+    if (rolling->filled < rolling->window_size) rolling->filled++;
+    
+    rolling->crc = crc_register_update(rolling->crc, &byte, 1, &rolling->config, rolling->table)
+                   ^ rolling->out_table[out];
+    
+    return rolling_crc_value(rolling);
+}
+
+/* 获取当前窗口的CRC值（窗口填满后等于最近window_size字节的标准CRC） */
+uint32_t rolling_crc_value(const rolling_crc_t* rolling) {
+    if (rolling == NULL) return 0;
+    return crc_register_finalize(rolling->crc ^ rolling->init_term, &rolling->config);
+}
+
+/* 释放滚动CRC资源 */
+void free_rolling_crc(rolling_crc_t* rolling) {
+    if (rolling == NULL) return;
+    free(rolling->window);
+    rolling->window = NULL;
+}
+
+/* 初始化内容定义分块器 */
+bool init_crc_chunker(crc_chunker_t* chunker, const crc_config_t* config,
+                      const crc_table_t* table, size_t window_size,
+                      uint32_t boundary_mask, size_t min_chunk_size,
+                      size_t max_chunk_size) {
+    if (chunker == NULL) return false;
+    // 最小分块不短于窗口，保证判断边界时窗口总是满的
+    if (min_chunk_size < window_size || max_chunk_size < min_chunk_size) return false;
+    
+    memset(chunker, 0, sizeof(*chunker));
+    if (!init_rolling_crc(&chunker->rolling, config, table, window_size)) return false;
+    
+    chunker->boundary_mask = boundary_mask;
+    chunker->min_chunk_size = min_chunk_size;
+    chunker->max_chunk_size = max_chunk_size;
+    return true;
+}
+
+/* 分块器滚动阶段的寄存器更新与边界判断（按配置展开成不同的循环，逐字节不再判断配置） */
+#define CHUNKER_UPDATE_REFLECTED(crc, in) (((crc) >> 8) ^ t[((crc) ^ (in)) & 0xFF])
+#define CHUNKER_UPDATE_NORMAL(crc, in) ((((crc) << 8) ^ t[(((crc) >> shift) ^ (in)) & 0xFF]) & mask)
+// (crc ^ xor_term) & boundary_mask == boundary_mask 等价于 crc & boundary_mask == boundary_target
+#define CHUNKER_BOUNDARY_PLAIN(crc) (((crc) & boundary_mask) == boundary_target)
+#define CHUNKER_BOUNDARY_REFLECT(crc) \
+    (((reflect_bits((crc) ^ init_term, width) ^ final_xor) & boundary_mask) == boundary_mask)
+
+/* 从 data[i] 滚动到 end 或找到边界为止：移出的字节先取自上次调用留下的环形缓冲区，再直接回看输入 */
+#define CHUNKER_ROLL(UPDATE, BOUNDARY) do { \
+        size_t ring_end = CRC_MIN(end, window_size); \
+        for (; i < ring_end && !found; i++) { \
+            crc = UPDATE(crc, data[i]) ^ out_table[window[(position + i) % window_size]]; \
+            found = BOUNDARY(crc); \
+        } \
+        for (; i < end && !found; i++) { \
+            crc = UPDATE(crc, data[i]) ^ out_table[data[i - window_size]]; \
+            found = BOUNDARY(crc); \
+        } \
+    } while (0)
+
+#ifdef CRC_HAVE_HARDWARE_CRC32C
+#define CHUNKER_UPDATE_HARDWARE(crc, in) _mm_crc32_u8((crc), (in))
+
+/* CRC-32C硬件指令的滚动循环（寄存器形式与反射查找表相同，单条指令的延迟低于一次查表），返回停止位置 */
+__attribute__((target("sse4.2")))
+static size_t crc32c_hardware_roll(const uint8_t* data, size_t i, size_t end, const rolling_crc_t* rolling,
+                                   size_t position, uint32_t boundary_mask, uint32_t boundary_target,
+                                   uint32_t* crc_io, bool* found_out) {
+    const uint8_t* window = rolling->window;
+    const uint32_t* out_table = rolling->out_table;
+    size_t window_size = rolling->window_size;
+    uint32_t crc = *crc_io;
+    bool found = false;
+    CHUNKER_ROLL(CHUNKER_UPDATE_HARDWARE, CHUNKER_BOUNDARY_PLAIN);
+    *crc_io = crc;
+    *found_out = found;
+    return i;
+}
+#endif
+
+/* 处理一段数据流，每找到一个分块边界调用一次回调，返回本次输出的分块数
+ * 分块内第 min_chunk_size 个字节之前不判断边界，而第一次判断时的窗口只覆盖分块内
+ * [min_chunk_size - window_size, min_chunk_size) 的字节：之前的字节直接跳过，
+ * 这一段从零寄存器重新计算窗口CRC，之后才逐字节滚动 */
+size_t process_crc_chunker(crc_chunker_t* chunker, const uint8_t* data, size_t length,
+                           crc_chunk_callback_t callback, void* user_data) {
+    if (chunker == NULL || data == NULL || chunker->rolling.window == NULL) return 0;
+    
+    rolling_crc_t* rolling = &chunker->rolling;
+    const crc_config_t* config = &rolling->config;
+    const uint32_t* t = rolling->table->table;
+    const uint32_t* out_table = rolling->out_table;
+    uint8_t* window = rolling->window;
+    size_t window_size = rolling->window_size;
+    size_t position = rolling->position;
+    
+    bool reflected = config->reflect_in;
+    bool hardware = rolling->table->engine == CRC_ENGINE_HARDWARE;
+    int width = config->width;
+    int shift = width - 8;
+    uint32_t mask = crc_width_mask(width);
+    // 结果需要再反射时才逐字节反射，否则初值贡献与最终异或合成一个常量
+    bool reflect_value = config->reflect_out && !config->reflect_in;
+    uint32_t init_term = rolling->init_term;
+    uint32_t final_xor = config->final_xor_value;
+    uint32_t boundary_mask = chunker->boundary_mask;
+    uint32_t boundary_target = ~(init_term ^ final_xor) & boundary_mask;
+    
+    uint32_t crc = rolling->crc;
+    size_t min_chunk_size = chunker->min_chunk_size;
+    size_t max_chunk_size = chunker->max_chunk_size;
+    size_t skip_end = min_chunk_size - window_size;
+    size_t chunk_length = (size_t)(chunker->offset - chunker->chunk_start);
+    size_t emitted = 0;
+    size_t i = 0;
+    
+    while (i < length) {
+        bool found = false;
+        if (chunk_length < skip_end) {
+            // 不影响任何边界判断的字节
+            size_t n = CRC_MIN(skip_end - chunk_length, length - i);
+            i += n;
+            chunk_length += n;
+            continue;
+        } else if (chunk_length < min_chunk_size) {
+            // 第一次判断边界时的窗口：从零寄存器计算（可能跨越多次调用）
+            if (chunk_length == skip_end) crc = 0;
+            size_t n = CRC_MIN(min_chunk_size - chunk_length, length - i);
+            crc = crc_register_update(crc, data + i, n, config, rolling->table);
+            i += n;
+            chunk_length += n;
+            if (chunk_length < min_chunk_size) continue;
+            found = reflect_value ? CHUNKER_BOUNDARY_REFLECT(crc) : CHUNKER_BOUNDARY_PLAIN(crc);
+        } else {
+            size_t start = i;
+            size_t end = i + CRC_MIN(max_chunk_size - chunk_length, length - i);
+            if (hardware) {
+#ifdef CRC_HAVE_HARDWARE_CRC32C
+                i = crc32c_hardware_roll(data, i, end, rolling, position, boundary_mask, boundary_target,
+                                         &crc, &found);
+#endif
+            } else if (reflect_value) {
+                CHUNKER_ROLL(CHUNKER_UPDATE_NORMAL, CHUNKER_BOUNDARY_REFLECT);
+            } else if (reflected) {
+                CHUNKER_ROLL(CHUNKER_UPDATE_REFLECTED, CHUNKER_BOUNDARY_PLAIN);
+            } else {
+                CHUNKER_ROLL(CHUNKER_UPDATE_NORMAL, CHUNKER_BOUNDARY_PLAIN);
+            }
+            chunk_length += i - start;
+        }
+        
+        if (found || chunk_length >= max_chunk_size) {
+            if (callback != NULL) {
+                callback(chunker->chunk_start, chunk_length, user_data);
+            }
+            chunker->chunk_start += chunk_length;
+            chunker->chunk_count++;
+            chunk_length = 0;
+            emitted++;
+        }
+    }
+    
+    // 环形缓冲区保留数据流最后window_size个字节，供下一次调用取移出值
+    if (length >= window_size) {
+        memcpy(window, data + length - window_size, window_size);
+        position = 0;
+    } else {
+        for (i = 0; i < length; i++) {
+            window[position] = data[i];
+            if (++position == window_size) position = 0;
+        }
+    }
+    
+    rolling->crc = crc;
+    rolling->position = position;
+    rolling->filled = CRC_MIN(window_size, rolling->filled + length);
+    chunker->offset += length;
+    
+    return emitted;
+}
+
+/* 结束数据流，输出最后一个不完整的分块 */
+size_t finish_crc_chunker(crc_chunker_t* chunker, crc_chunk_callback_t callback,
+                          void* user_data) {
+    if (chunker == NULL || chunker->offset == chunker->chunk_start) return 0;
+    
+    size_t chunk_length = (size_t)(chunker->offset - chunker->chunk_start);
+    if (callback != NULL) {
+        callback(chunker->chunk_start, chunk_length, user_data);
+    }
+    chunker->chunk_start = chunker->offset;
+    chunker->chunk_count++;
+    return 1;
+}
+
+/* 释放分块器资源 */
+void free_crc_chunker(crc_chunker_t* chunker) {
+    if (chunker == NULL) return;
+    free_rolling_crc(&chunker->rolling);
+}
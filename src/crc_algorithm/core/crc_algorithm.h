@@ -12,15 +12,29 @@
 #define MAX_DATA_SIZE 4096          // 最大数据大小
 #define CRC_TABLE_SIZE 256          // CRC查找表大小
 #define MAX_MESSAGE_LEN 1024        // 最大消息长度
+#define CRC_ZERO_POWERS 64          // 零字节跳跃幂表项数 x^(8*2^k) mod P
+#define CRC_SPARSE_BLOCK 64         // 稀疏计算的零块检测粒度（字节）
+#define CRC_ZERO_RUN_MIN 256        // 按多项式幂跳过的最短零串（字节）
+#define CRC_SPARSE_FLUSH 4096       // 稠密数据分段查表计算的长度（字节）
+#define CRC_SLICE_COUNT 8           // 切片查表法（slicing-by-8）的表数
 
 /* CRC标准类型枚举 */
 typedef enum {
     CRC_8,          // CRC-8, 多项式: 0x07
     CRC_16,         // CRC-16, 多项式: 0x8005 
     CRC_16_CCITT,   // CRC-16-CCITT, 多项式: 0x1021
-    CRC_32          // CRC-32, 多项式: 0x04C11DB7
+    CRC_32,         // CRC-32, 多项式: 0x04C11DB7
+    CRC_32C,        // CRC-32C (Castagnoli), 多项式: 0x1EDC6F41
+    CRC_TYPE_COUNT  // CRC标准数量
 } crc_type_t;
 
+/* CRC计算引擎（由generate_crc_table根据配置和CPU能力选择） */
+typedef enum {
+    CRC_ENGINE_TABLE,       // 逐字节查表
+    CRC_ENGINE_SLICE8,      // 切片查表，每次处理8字节（反射32位CRC）
+    CRC_ENGINE_HARDWARE     // SSE4.2 crc32指令（仅CRC-32C）
+} crc_engine_t;
+
 /* CRC算法配置结构体 */
 typedef struct {
     crc_type_t type;            // CRC类型
@@ -61,9 +75,47 @@ typedef struct {
 /* CRC查找表 */
 typedef struct {
     uint32_t table[CRC_TABLE_SIZE];  // 查找表
+    uint32_t zero_powers[CRC_ZERO_POWERS]; // x^(8*2^k) mod P，用于O(log n)跳过零字节
+    uint32_t slice_table[CRC_SLICE_COUNT][CRC_TABLE_SIZE]; // 切片查表法使用的扩展表
+    crc_engine_t engine;             // 查表计算使用的引擎
     bool is_generated;               // 表是否已生成
 } crc_table_t;
 
+/* 流式CRC上下文：数据分多次到达时逐段累积 */
+typedef struct {
+    crc_config_t config;        // CRC配置
+    const crc_table_t* table;   // 查找表
+    uint32_t crc;               // 当前寄存器值（未做最终异或）
+    uint64_t length;            // 已处理字节数
+} crc_context_t;
+
+/* 滚动CRC：固定长度窗口上O(1)增量更新 */
+typedef struct {
+    crc_config_t config;                  // CRC配置
+    const crc_table_t* table;             // 移入字节使用的查找表
+    uint32_t out_table[CRC_TABLE_SIZE];   // 移出表：字节后接窗口长度个零字节的寄存器贡献
+    uint32_t init_term;                   // 初始值对整窗CRC的贡献
+    uint8_t* window;                      // 窗口环形缓冲区
+    size_t window_size;                   // 窗口长度
+    size_t position;                      // 最旧字节在环形缓冲区中的位置
+    size_t filled;                        // 已填充字节数
+    uint32_t crc;                         // 零初值寄存器
+} rolling_crc_t;
+
+/* 分块回调：offset为分块在数据流中的起始偏移 */
+typedef void (*crc_chunk_callback_t)(uint64_t offset, size_t length, void* user_data);
+
+/* 基于滚动CRC的内容定义分块器 */
+typedef struct {
+    rolling_crc_t rolling;      // 滚动CRC状态
+    uint32_t boundary_mask;     // 滚动值与掩码按位与后等于掩码时切分
+    size_t min_chunk_size;      // 最小分块长度（不小于窗口长度）
+    size_t max_chunk_size;      // 最大分块长度（达到即强制切分）
+    uint64_t chunk_start;       // 当前分块起始偏移
+    uint64_t offset;            // 已处理的总字节数
+    size_t chunk_count;         // 已输出的分块数
+} crc_chunker_t;
+
 /* 全局CRC配置预设 */
 extern const crc_config_t CRC_PRESETS[];
 
@@ -84,6 +136,15 @@ uint32_t calculate_crc_bitwise(const uint8_t* data, size_t length,
 uint32_t calculate_crc_table(const uint8_t* data, size_t length, 
                              const crc_config_t* config, const crc_table_t* table);
 
+/* 稀疏数据CRC计算：检测长零串并按多项式幂直接跳过，结果与查表法一致 */
+uint32_t calculate_crc_sparse(const uint8_t* data, size_t length,
+                              const crc_config_t* config, const crc_table_t* table);
+
+/* CRC合并：由CRC(A)、CRC(B)和B的长度得到CRC(AB)，用于分块并行计算 */
+uint32_t combine_crc(uint32_t crc_a, uint32_t crc_b, uint64_t length_b,
+                     const crc_config_t* config, const crc_table_t* table);
+const char* crc_engine_name(crc_engine_t engine);
+
 /* 完整CRC计算（包含统计） */
 crc_result_t compute_crc_complete(const uint8_t* data, size_t length,
                                   const crc_config_t* config, 
@@ -119,6 +180,29 @@ void performance_comparison(const uint8_t* data, size_t length,
                            const crc_config_t* config, 
                            const crc_table_t* table);
 
+/* 流式CRC计算 */
+bool init_crc_context(crc_context_t* context, const crc_config_t* config,
+                      const crc_table_t* table);
+void update_crc_context(crc_context_t* context, const uint8_t* data, size_t length);
+uint32_t finalize_crc_context(const crc_context_t* context);
+
+/* 滚动CRC与内容定义分块 */
+bool init_rolling_crc(rolling_crc_t* rolling, const crc_config_t* config,
+                      const crc_table_t* table, size_t window_size);
+uint32_t update_rolling_crc(rolling_crc_t* rolling, uint8_t byte);
+uint32_t rolling_crc_value(const rolling_crc_t* rolling);
+void free_rolling_crc(rolling_crc_t* rolling);
+
+bool init_crc_chunker(crc_chunker_t* chunker, const crc_config_t* config,
+                      const crc_table_t* table, size_t window_size,
+                      uint32_t boundary_mask, size_t min_chunk_size,
+                      size_t max_chunk_size);
+size_t process_crc_chunker(crc_chunker_t* chunker, const uint8_t* data, size_t length,
+                           crc_chunk_callback_t callback, void* user_data);
+size_t finish_crc_chunker(crc_chunker_t* chunker, crc_chunk_callback_t callback,
+                          void* user_data);
+void free_crc_chunker(crc_chunker_t* chunker);
+
 /* 信息打印函数 */
 void print_crc_config(const crc_config_t* config);
 void print_crc_result(const crc_result_t* result, const crc_config_t* config);
@@ -0,0 +1,159 @@
+#define _GNU_SOURCE
+#include "crc_filter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* 获取单调时钟毫秒数 */
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* 判断文件描述符是否为管道 */
+static bool is_pipe_fd(int fd) {
+    struct stat st;
+    return fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+/* 完整读取length字节（管道读可能返回部分数据） */
+static bool read_fully(int fd, uint8_t* buffer, size_t length) {
+    while (length > 0) {
+        ssize_t n = read(fd, buffer, length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/* 完整写出length字节 */
+static bool write_fully(int fd, const uint8_t* buffer, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, buffer, length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/* 缓冲回退路径：大块读入、计算CRC、写出 */
+static bool filter_buffered(int in_fd, int out_fd, crc_context_t* context,
+                            crc_filter_report_t* report, uint8_t* buffer) {
+    while (true) {
+        ssize_t n = read(in_fd, buffer, FILTER_CHUNK_SIZE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            printf("错误: 读取输入失败 (%s)\n", strerror(errno));
+            return false;
+        }
+        if (n == 0) return true;
+
+        update_crc_context(context, buffer, (size_t)n);
+        if (!write_fully(out_fd, buffer, (size_t)n)) {
+            printf("错误: 写出数据失败 (%s)\n", strerror(errno));
+            return false;
+        }
+        report->bytes += (size_t)n;
+    }
+}
+
+/*
+ * 零拷贝路径：tee 把输入管道中的数据复制到内部旁路管道（不消费），
+ * 再用 splice 把同样的字节从输入管道直接移到输出，数据本身不经过用户态；
+ * 只有旁路管道里的副本被读出来计算CRC。
+ * 返回值: 1 完成, 0 出错, -1 输出端不支持splice（调用方改走缓冲路径）
+ */
+static int filter_zero_copy(int in_fd, int out_fd, crc_context_t* context,
+                            crc_filter_report_t* report, uint8_t* buffer) {
+    int side[2];
+    if (pipe(side) != 0) return -1;
+
+    // 尽量扩大旁路管道，使每次tee能搬运更多数据
+    long capacity = fcntl(side[1], F_SETPIPE_SZ, FILTER_PIPE_SIZE);
+    if (capacity <= 0) capacity = fcntl(side[1], F_GETPIPE_SZ);
+    size_t chunk = capacity > 0 ? (size_t)capacity : 65536;
+    if (chunk > FILTER_CHUNK_SIZE) chunk = FILTER_CHUNK_SIZE;
+
+    int status = 1;
+    while (true) {
+        ssize_t teed = tee(in_fd, side[1], chunk, 0);
+        if (teed < 0 && errno == EINTR) continue;
+        if (teed < 0) {
+            status = (errno == EINVAL) ? -1 : 0;
+            break;
+        }
+        if (teed == 0) break;   // 写端已关闭且管道为空
+
+        size_t remaining = (size_t)teed;
+        int error = 0;
+        while (remaining > 0) {
+            ssize_t moved = splice(in_fd, NULL, out_fd, NULL, remaining, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (moved < 0 && errno == EINTR) continue;
+            if (moved <= 0) {
+                error = moved < 0 ? errno : EIO;
+                break;
+            }
+            remaining -= (size_t)moved;
+        }
+
+        if (remaining == (size_t)teed && error == EINVAL) {
+            // 输出端不支持splice（如以O_APPEND打开的文件）：丢弃旁路副本，
+            // 输入管道中的这部分数据尚未被消费，交给缓冲路径继续处理
+            status = read_fully(side[0], buffer, (size_t)teed) ? -1 : 0;
+            break;
+        }
+        if (remaining > 0) {
+            printf("错误: 转发数据失败 (%s)\n", strerror(error));
+            status = 0;
+            break;
+        }
+
+        if (!read_fully(side[0], buffer, (size_t)teed)) {
+            printf("错误: 读取旁路管道失败\n");
+            status = 0;
+            break;
+        }
+        update_crc_context(context, buffer, (size_t)teed);
+        report->bytes += (size_t)teed;
+    }
+
+    close(side[0]);
+    close(side[1]);
+    return status;
+}
+
+/* 把in_fd的数据原样转发到out_fd，同时把数据流入context计算CRC */
+bool run_crc_filter(int in_fd, int out_fd, crc_context_t* context,
+                    crc_filter_report_t* report) {
+    if (context == NULL || report == NULL) return false;
+
+    memset(report, 0, sizeof(crc_filter_report_t));
+    uint8_t* buffer = malloc(FILTER_CHUNK_SIZE);
+    if (buffer == NULL) return false;
+
+    double start = monotonic_ms();
+    bool ok;
+
+    // tee要求输入是管道；splice只要求两端之一是管道
+    int status = -1;
+    if (is_pipe_fd(in_fd)) {
+        status = filter_zero_copy(in_fd, out_fd, context, report, buffer);
+        report->zero_copy = (status == 1);
+    }
+    if (status == -1) {
+        ok = filter_buffered(in_fd, out_fd, context, report, buffer);
+    } else {
+        ok = (status == 1);
+    }
+
+    report->elapsed_ms = monotonic_ms() - start;
+    free(buffer);
+    return ok;
+}
@@ -0,0 +1,23 @@
+#ifndef CRC_FILTER_H
+#define CRC_FILTER_H
+
+#include "crc_algorithm.h"
+
+/* 常量定义 */
+#define FILTER_CHUNK_SIZE (1024 * 1024)     // 单次tee/splice或缓冲读写的最大字节数
+#define FILTER_PIPE_SIZE (1024 * 1024)      // 内部旁路管道的期望容量
+
+/* 透传过滤器运行报告 */
+typedef struct {
+    uint64_t bytes;             // 透传的字节数
+    bool zero_copy;             // 是否使用了 tee/splice 零拷贝路径
+    double elapsed_ms;          // 耗时（毫秒）
+} crc_filter_report_t;
+
+/* 把in_fd的数据原样转发到out_fd，同时把数据流入context计算CRC。
+ * 输入是管道时走 tee/splice 零拷贝路径，否则（或输出端不支持splice时）回退为大块缓冲读写。
+ * 诊断信息经printf输出，调用方需保证out_fd不是当前的标准输出流。 */
+bool run_crc_filter(int in_fd, int out_fd, crc_context_t* context,
+                    crc_filter_report_t* report);
+
+#endif // CRC_FILTER_H
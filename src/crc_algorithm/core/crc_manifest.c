@@ -0,0 +1,916 @@
+#define _DEFAULT_SOURCE
+#include "crc_manifest.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ========== 工作窃取线程池 ========== */
+
+/* 任务类型：文件任务负责打开文件并拆分出块任务，块任务负责读取并计算一个分块 */
+typedef enum {
+    TASK_FILE,
+    TASK_BLOCK
+} manifest_task_kind_t;
+
+typedef struct {
+    manifest_task_kind_t kind;
+    size_t job;                 // 对应的文件作业下标
+    uint32_t block;             // 块下标（仅块任务）
+} manifest_task_t;
+
+/* 每个工作线程一个双端队列：自己从尾部取，其他线程从头部窃取 */
+typedef struct {
+    manifest_task_t* tasks;
+    size_t head;
+    size_t tail;
+    size_t capacity;
+    pthread_mutex_t lock;
+} task_deque_t;
+
+/* 一个待计算文件的作业状态 */
+typedef struct {
+    manifest_entry_t* entry;    // 计算结果写入的条目
+    int fd;                     // 打开的文件描述符
+    uint32_t blocks_left;       // 尚未完成的块数，归零时关闭文件
+    bool failed;                // 读取是否失败
+} hash_job_t;
+
+typedef struct {
+    const char* root;
+    crc_config_t config;
+    crc_table_t table;
+    uint32_t block_size;
+    hash_job_t* jobs;
+    size_t job_count;
+
+    task_deque_t deques[MANIFEST_MAX_THREADS];
+    int worker_count;
+
+    pthread_mutex_t state_lock;
+    pthread_cond_t state_cond;
+    size_t queued;              // 队列中等待执行的任务数
+    size_t pending;             // 已入队但尚未完成的任务数（含正在执行的）
+    uint64_t bytes_hashed;
+    size_t blocks_hashed;
+} work_pool_t;
+
+typedef struct {
+    work_pool_t* pool;
+    int id;
+    uint8_t* buffer;
+} worker_context_t;
+
+/* 获取单调时钟（毫秒） */
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* 任务入队（压入指定工作线程的队尾） */
+static bool pool_push(work_pool_t* pool, int worker, manifest_task_t task) {
+    task_deque_t* deque = &pool->deques[worker];
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail == deque->capacity) {
+        // 先把已被窃取的头部空间挪回来，仍不够再扩容
+        if (deque->head > 0) {
+            memmove(deque->tasks, deque->tasks + deque->head,
+                    (deque->tail - deque->head) * sizeof(manifest_task_t));
+            deque->tail -= deque->head;
+            deque->head = 0;
+        } else {
+            size_t capacity = deque->capacity ? deque->capacity * 2 : 64;
+            manifest_task_t* tasks = realloc(deque->tasks, capacity * sizeof(manifest_task_t));
+            if (tasks == NULL) {
+                pthread_mutex_unlock(&deque->lock);
+                return false;
+            }
+            deque->tasks = tasks;
+            deque->capacity = capacity;
+        }
+    }
+    deque->tasks[deque->tail++] = task;
+    pthread_mutex_unlock(&deque->lock);
+
+    pthread_mutex_lock(&pool->state_lock);
+    pool->queued++;
+    pool->pending++;
+    pthread_cond_signal(&pool->state_cond);
+    pthread_mutex_unlock(&pool->state_lock);
+    return true;
+}
+
+/* 从自己的队尾取任务（后进先出，缓存局部性好） */
+static bool pool_pop(work_pool_t* pool, int worker, manifest_task_t* task) {
+    task_deque_t* deque = &pool->deques[worker];
+    bool found = false;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail > deque->head) {
+        *task = deque->tasks[--deque->tail];
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/* 从其他线程的队头窃取任务（先进先出，拿走最早拆分出的块） */
+static bool pool_steal(work_pool_t* pool, int thief, manifest_task_t* task) {
+    for (int i = 1; i < pool->worker_count; i++) {
+        task_deque_t* deque = &pool->deques[(thief + i) % pool->worker_count];
+        bool found = false;
+
+        pthread_mutex_lock(&deque->lock);
+        if (deque->tail > deque->head) {
+            *task = deque->tasks[deque->head++];
+            found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+        if (found) return true;
+    }
+    return false;
+}
+
+/* 执行文件任务：打开文件，按当前大小拆分块任务 */
+static void run_file_task(work_pool_t* pool, int worker, hash_job_t* job, size_t job_index) {
+    manifest_entry_t* entry = job->entry;
+    char path[MANIFEST_MAX_PATH];
+    snprintf(path, sizeof(path), "%s/%s", pool->root, entry->path);
+
+    job->fd = open(path, O_RDONLY);
+    struct stat st;
+    if (job->fd < 0 || fstat(job->fd, &st) != 0) {
+        job->failed = true;
+        if (job->fd >= 0) close(job->fd);
+        job->fd = -1;
+        return;
+    }
+
+    entry->size = (uint64_t)st.st_size;
+    entry->mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    entry->mtime_nsec = (uint32_t)st.st_mtim.tv_nsec;
+    entry->block_count = (uint32_t)((entry->size + pool->block_size - 1) / pool->block_size);
+    entry->file_crc = 0;
+    free(entry->block_crcs);
+    entry->block_crcs = NULL;
+
+    if (entry->block_count == 0) {
+        close(job->fd);
+        job->fd = -1;
+        return;
+    }
+
+    entry->block_crcs = calloc(entry->block_count, sizeof(uint32_t));
+    if (entry->block_crcs == NULL) {
+        job->failed = true;
+        close(job->fd);
+        job->fd = -1;
+        return;
+    }
+
+    job->blocks_left = entry->block_count;
+    for (uint32_t b = 0; b < entry->block_count; b++) {
+        manifest_task_t task = {TASK_BLOCK, job_index, b};
+        if (!pool_push(pool, worker, task)) {
+            job->failed = true;
+            // 未入队的块不会再执行，直接计入完成
+            if (__sync_sub_and_fetch(&job->blocks_left, entry->block_count - b) == 0) {
+                close(job->fd);
+                job->fd = -1;
+            }
+            return;
+        }
+    }
+}
+
+/* 执行块任务：读取一个分块并计算CRC */
+static void run_block_task(work_pool_t* pool, hash_job_t* job, uint32_t block, uint8_t* buffer) {
+    manifest_entry_t* entry = job->entry;
+    uint64_t offset = (uint64_t)block * pool->block_size;
+    size_t length = (size_t)CRC_MIN((uint64_t)pool->block_size, entry->size - offset);
+    size_t done = 0;
+
+    while (done < length) {
+        ssize_t n = pread(job->fd, buffer + done, length - done, (off_t)(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+
+    if (done == length) {
+        entry->block_crcs[block] = calculate_crc_table(buffer, length, &pool->config, &pool->table);
+    } else {
+        job->failed = true;
+    }
+
+    pthread_mutex_lock(&pool->state_lock);
+    pool->bytes_hashed += done;
+    pool->blocks_hashed++;
+    pthread_mutex_unlock(&pool->state_lock);
+
+    if (__sync_sub_and_fetch(&job->blocks_left, 1) == 0) {
+        close(job->fd);
+        job->fd = -1;
+    }
+}
+
+/* 工作线程主循环 */
+static void* manifest_worker(void* arg) {
+    worker_context_t* context = (worker_context_t*)arg;
+    work_pool_t* pool = context->pool;
+
+    while (1) {
+        manifest_task_t task;
+        if (pool_pop(pool, context->id, &task) || pool_steal(pool, context->id, &task)) {
+            pthread_mutex_lock(&pool->state_lock);
+            pool->queued--;
+            pthread_mutex_unlock(&pool->state_lock);
+
+            hash_job_t* job = &pool->jobs[task.job];
+            if (task.kind == TASK_FILE) {
+                run_file_task(pool, context->id, job, task.job);
+            } else {
+                run_block_task(pool, job, task.block, context->buffer);
+            }
+
+            pthread_mutex_lock(&pool->state_lock);
+            if (--pool->pending == 0) pthread_cond_broadcast(&pool->state_cond);
+            pthread_mutex_unlock(&pool->state_lock);
+            continue;
+        }
+
+        // 所有队列都空：等待新任务或全部完成
+        pthread_mutex_lock(&pool->state_lock);
+        while (pool->queued == 0 && pool->pending > 0) {
+            pthread_cond_wait(&pool->state_cond, &pool->state_lock);
+        }
+        bool finished = pool->pending == 0;
+        pthread_mutex_unlock(&pool->state_lock);
+        if (finished) break;
+    }
+
+    return NULL;
+}
+
+/* 并行计算一组条目的分块CRC和文件CRC，返回失败的条目数 */
+static size_t hash_entries(const char* root, manifest_entry_t** entries, size_t count,
+                           crc_type_t crc_type, uint32_t block_size, int threads,
+                           bool* failed, manifest_report_t* report) {
+    if (count == 0) return 0;
+
+    work_pool_t* pool = calloc(1, sizeof(work_pool_t));
+    hash_job_t* jobs = calloc(count, sizeof(hash_job_t));
+    if (pool == NULL || jobs == NULL) {
+        free(pool);
+        free(jobs);
+        for (size_t i = 0; i < count; i++) failed[i] = true;
+        return count;
+    }
+
+    pool->root = root;
+    init_crc_config(&pool->config, crc_type);
+    generate_crc_table(&pool->table, &pool->config);
+    pool->block_size = block_size;
+    pool->jobs = jobs;
+    pool->job_count = count;
+    pool->worker_count = CRC_MAX(1, CRC_MIN(threads, MANIFEST_MAX_THREADS));
+    pthread_mutex_init(&pool->state_lock, NULL);
+    pthread_cond_init(&pool->state_cond, NULL);
+    for (int w = 0; w < pool->worker_count; w++) {
+        pthread_mutex_init(&pool->deques[w].lock, NULL);
+    }
+
+    // 文件任务轮流分给各线程，大文件拆出的块任务由空闲线程窃取
+    for (size_t i = 0; i < count; i++) {
+        jobs[i].entry = entries[i];
+        jobs[i].fd = -1;
+        manifest_task_t task = {TASK_FILE, i, 0};
+        if (!pool_push(pool, (int)(i % pool->worker_count), task)) jobs[i].failed = true;
+    }
+
+    pthread_t threads_id[MANIFEST_MAX_THREADS];
+    worker_context_t contexts[MANIFEST_MAX_THREADS];
+    int started = 0;
+    for (int w = 0; w < pool->worker_count; w++) {
+        contexts[w].pool = pool;
+        contexts[w].id = w;
+        contexts[w].buffer = malloc(block_size);
+        if (contexts[w].buffer == NULL) break;
+        if (pthread_create(&threads_id[w], NULL, manifest_worker, &contexts[w]) != 0) {
+            free(contexts[w].buffer);
+            break;
+        }
+        started++;
+    }
+    bool ran = started > 0;
+    if (!ran) {
+        // 无法创建线程时退化为当前线程执行
+        contexts[0].pool = pool;
+        contexts[0].id = 0;
+        contexts[0].buffer = malloc(block_size);
+        if (contexts[0].buffer != NULL) {
+            manifest_worker(&contexts[0]);
+            free(contexts[0].buffer);
+            ran = true;
+        }
+    }
+    for (int w = 0; w < started; w++) {
+        pthread_join(threads_id[w], NULL);
+        free(contexts[w].buffer);
+    }
+
+    // 块CRC按顺序合并成整个文件的CRC
+    size_t failures = 0;
+    for (size_t i = 0; i < count; i++) {
+        manifest_entry_t* entry = entries[i];
+        failed[i] = jobs[i].failed || !ran;
+        if (failed[i]) {
+            failures++;
+            continue;
+        }
+        uint32_t file_crc = 0;
+        for (uint32_t b = 0; b < entry->block_count; b++) {
+            uint64_t length = CRC_MIN((uint64_t)block_size, entry->size - (uint64_t)b * block_size);
+            file_crc = (b == 0) ? entry->block_crcs[0]
+                                : combine_crc(file_crc, entry->block_crcs[b], length,
+                                              &pool->config, &pool->table);
+        }
+        entry->file_crc = file_crc;
+    }
+
+    if (report != NULL) {
+        report->files_hashed += count - failures;
+        report->files_failed += failures;
+        report->blocks_hashed += pool->blocks_hashed;
+        report->bytes_hashed += pool->bytes_hashed;
+    }
+
+    for (int w = 0; w < pool->worker_count; w++) {
+        free(pool->deques[w].tasks);
+        pthread_mutex_destroy(&pool->deques[w].lock);
+    }
+    pthread_mutex_destroy(&pool->state_lock);
+    pthread_cond_destroy(&pool->state_cond);
+    free(pool);
+    free(jobs);
+    return failures;
+}
+
+/* ========== 目录遍历 ========== */
+
+/* 追加一个条目 */
+static manifest_entry_t* manifest_append(manifest_t* manifest, const char* path) {
+    if (manifest->entry_count == manifest->entry_capacity) {
+        size_t capacity = manifest->entry_capacity ? manifest->entry_capacity * 2 : 64;
+        manifest_entry_t* entries = realloc(manifest->entries, capacity * sizeof(manifest_entry_t));
+        if (entries == NULL) return NULL;
+        manifest->entries = entries;
+        manifest->entry_capacity = capacity;
+    }
+
+    manifest_entry_t* entry = &manifest->entries[manifest->entry_count];
+    memset(entry, 0, sizeof(*entry));
+    entry->path = strdup(path);
+    if (entry->path == NULL) return NULL;
+    manifest->entry_count++;
+    return entry;
+}
+
+/* 递归收集普通文件（不跟随符号链接） */
+static bool collect_files(const char* root, const char* relative, manifest_t* list) {
+    char dir_path[MANIFEST_MAX_PATH];
+    snprintf(dir_path, sizeof(dir_path), "%s%s%s", root, relative[0] ? "/" : "", relative);
+
+    DIR* dir = opendir(dir_path);
+    if (dir == NULL) return false;
+
+    bool ok = true;
+    struct dirent* item;
+    while (ok && (item = readdir(dir)) != NULL) {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) continue;
+
+        char child[MANIFEST_MAX_PATH];
+        int written = snprintf(child, sizeof(child), "%s%s%s", relative,
+                               relative[0] ? "/" : "", item->d_name);
+        if (written < 0 || (size_t)written >= sizeof(child)) continue;
+
+        char full[MANIFEST_MAX_PATH];
+        written = snprintf(full, sizeof(full), "%s/%s", root, child);
+        if (written < 0 || (size_t)written >= sizeof(full)) continue;
+        struct stat st;
+        if (lstat(full, &st) != 0) continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            ok = collect_files(root, child, list);
+        } else if (S_ISREG(st.st_mode)) {
+            manifest_entry_t* entry = manifest_append(list, child);
+            if (entry == NULL) {
+                ok = false;
+                break;
+            }
+            entry->size = (uint64_t)st.st_size;
+            entry->mtime_sec = (int64_t)st.st_mtim.tv_sec;
+            entry->mtime_nsec = (uint32_t)st.st_mtim.tv_nsec;
+        }
+    }
+
+    closedir(dir);
+    return ok;
+}
+
+static int compare_entries(const void* a, const void* b) {
+    return strcmp(((const manifest_entry_t*)a)->path, ((const manifest_entry_t*)b)->path);
+}
+
+/* ========== 初始化与释放 ========== */
+
+void init_manifest(manifest_t* manifest, crc_type_t crc_type, uint32_t block_size) {
+    if (manifest == NULL) return;
+    memset(manifest, 0, sizeof(*manifest));
+    manifest->crc_type = crc_type;
+    manifest->block_size = block_size;
+}
+
+void init_manifest_options(manifest_options_t* options) {
+    if (options == NULL) return;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    options->threads = (int)CRC_MAX(1, CRC_MIN(cpus, MANIFEST_MAX_THREADS));
+    options->block_size = MANIFEST_DEFAULT_BLOCK_SIZE;
+    options->crc_type = CRC_32C;
+    options->full_verify = false;
+    options->update = false;
+    options->verbose = true;
+}
+
+void init_manifest_report(manifest_report_t* report) {
+    if (report == NULL) return;
+    memset(report, 0, sizeof(*report));
+}
+
+static void free_entry(manifest_entry_t* entry) {
+    free(entry->path);
+    free(entry->block_crcs);
+    entry->path = NULL;
+    entry->block_crcs = NULL;
+}
+
+void free_manifest(manifest_t* manifest) {
+    if (manifest == NULL) return;
+    for (size_t i = 0; i < manifest->entry_count; i++) {
+        free_entry(&manifest->entries[i]);
+    }
+    free(manifest->entries);
+    manifest->entries = NULL;
+    manifest->entry_count = 0;
+    manifest->entry_capacity = 0;
+}
+
+/* ========== 构建与校验 ========== */
+
+/* 构建完整性清单：遍历目录并行计算所有文件 */
+bool build_manifest(const char* root, const manifest_options_t* options,
+                    manifest_t* manifest, manifest_report_t* report) {
+    if (root == NULL || options == NULL || manifest == NULL || options->block_size == 0) {
+        return false;
+    }
+
+    double start = monotonic_ms();
+    init_manifest(manifest, options->crc_type, options->block_size);
+    if (report != NULL) init_manifest_report(report);
+
+    if (!collect_files(root, "", manifest)) {
+        printf("[清单] 无法遍历目录: %s\n", root);
+        free_manifest(manifest);
+        return false;
+    }
+    qsort(manifest->entries, manifest->entry_count, sizeof(manifest_entry_t), compare_entries);
+
+    manifest_entry_t** targets = malloc((manifest->entry_count + 1) * sizeof(manifest_entry_t*));
+    bool* failed = calloc(manifest->entry_count + 1, sizeof(bool));
+    if (targets == NULL || failed == NULL) {
+        free(targets);
+        free(failed);
+        free_manifest(manifest);
+        return false;
+    }
+    for (size_t i = 0; i < manifest->entry_count; i++) targets[i] = &manifest->entries[i];
+
+    size_t failures = hash_entries(root, targets, manifest->entry_count, manifest->crc_type,
+                                   manifest->block_size, options->threads, failed, report);
+    for (size_t i = 0; i < manifest->entry_count && options->verbose; i++) {
+        if (failed[i]) printf("[清单] 读取失败: %s\n", manifest->entries[i].path);
+    }
+
+    if (report != NULL) {
+        report->files_total = manifest->entry_count;
+        report->elapsed_ms = monotonic_ms() - start;
+    }
+    free(targets);
+    free(failed);
+    return failures == 0;
+}
+
+/* 校验项：磁盘文件与清单条目的对应关系 */
+typedef enum {
+    ITEM_UNCHANGED,     // 元数据未变
+    ITEM_MODIFIED,      // 大小或修改时间变化
+    ITEM_ADDED,         // 新增文件
+    ITEM_MISSING        // 文件已删除
+} verify_item_kind_t;
+
+typedef struct {
+    verify_item_kind_t kind;
+    manifest_entry_t* stored;   // 清单中的条目（新增文件为NULL）
+    manifest_entry_t current;   // 磁盘上的当前状态和重新计算的CRC
+    bool hashed;                // 是否需要重新计算
+    bool failed;                // 计算是否失败
+} verify_item_t;
+
+/* 校验完整性清单：增量跳过大小/修改时间未变的文件，报告具体损坏的块 */
+bool verify_manifest(const char* root, manifest_t* manifest,
+                     const manifest_options_t* options, manifest_report_t* report) {
+    if (root == NULL || manifest == NULL || options == NULL) return false;
+
+    double start = monotonic_ms();
+    manifest_report_t local_report;
+    if (report == NULL) report = &local_report;
+    init_manifest_report(report);
+
+    manifest_t disk;
+    init_manifest(&disk, manifest->crc_type, manifest->block_size);
+    if (!collect_files(root, "", &disk)) {
+        printf("[清单] 无法遍历目录: %s\n", root);
+        free_manifest(&disk);
+        return false;
+    }
+    qsort(disk.entries, disk.entry_count, sizeof(manifest_entry_t), compare_entries);
+
+    // 两个列表都按路径排序，一次归并得到每个文件的状态
+    size_t capacity = disk.entry_count + manifest->entry_count + 1;
+    verify_item_t* items = calloc(capacity, sizeof(verify_item_t));
+    manifest_entry_t** targets = calloc(capacity, sizeof(manifest_entry_t*));
+    bool* failed = calloc(capacity, sizeof(bool));
+    if (items == NULL || targets == NULL || failed == NULL) {
+        free(items);
+        free(targets);
+        free(failed);
+        free_manifest(&disk);
+        return false;
+    }
+
+    size_t item_count = 0;
+    size_t d = 0;
+    size_t m = 0;
+    while (d < disk.entry_count || m < manifest->entry_count) {
+        int order;
+        if (d == disk.entry_count) order = 1;
+        else if (m == manifest->entry_count) order = -1;
+        else order = strcmp(disk.entries[d].path, manifest->entries[m].path);
+
+        verify_item_t* item = &items[item_count++];
+        if (order < 0) {
+            item->kind = ITEM_ADDED;
+            item->current = disk.entries[d++];
+            item->hashed = true;
+        } else if (order > 0) {
+            item->kind = ITEM_MISSING;
+            item->stored = &manifest->entries[m++];
+        } else {
+            manifest_entry_t* stored = &manifest->entries[m++];
+            item->stored = stored;
+            item->current = disk.entries[d++];
+            bool same = stored->size == item->current.size &&
+                        stored->mtime_sec == item->current.mtime_sec &&
+                        stored->mtime_nsec == item->current.mtime_nsec;
+            item->kind = same ? ITEM_UNCHANGED : ITEM_MODIFIED;
+            item->hashed = !same || options->full_verify;
+        }
+    }
+    // 路径字符串已转移到校验项中，只释放数组
+    free(disk.entries);
+
+    size_t target_count = 0;
+    for (size_t i = 0; i < item_count; i++) {
+        if (items[i].hashed) targets[target_count++] = &items[i].current;
+    }
+    hash_entries(root, targets, target_count, manifest->crc_type, manifest->block_size,
+                 options->threads, failed, report);
+
+    // 按路径顺序汇总结果
+    size_t t = 0;
+    for (size_t i = 0; i < item_count; i++) {
+        verify_item_t* item = &items[i];
+        if (item->hashed) item->failed = failed[t++];
+
+        switch (item->kind) {
+            case ITEM_MISSING:
+                report->files_missing++;
+                if (options->verbose) printf("[校验] 文件已删除: %s\n", item->stored->path);
+                break;
+            case ITEM_ADDED:
+                report->files_added++;
+                if (options->verbose) printf("[校验] 新增文件: %s\n", item->current.path);
+                break;
+            case ITEM_MODIFIED:
+                report->files_modified++;
+                if (options->verbose) {
+                    printf("[校验] 文件已修改 (大小/修改时间变化): %s\n", item->current.path);
+                }
+                break;
+            case ITEM_UNCHANGED: {
+                if (!item->hashed) {
+                    report->files_skipped++;
+                    break;
+                }
+                if (item->failed) break;
+
+                // 扫描元数据之后、读取内容之前文件被截断或追加：按已修改处理（更新时采用新结果）
+                if (item->current.size != item->stored->size ||
+                    item->current.block_count != item->stored->block_count) {
+                    item->kind = ITEM_MODIFIED;
+                    report->files_modified++;
+                    if (options->verbose) {
+                        printf("[校验] 文件在校验过程中被修改: %s\n", item->current.path);
+                    }
+                    break;
+                }
+
+                // 元数据未变但内容不同：逐块比较定位损坏位置
+                bool corrupted = false;
+                for (uint32_t b = 0; b < item->current.block_count; b++) {
+                    if (item->current.block_crcs[b] == item->stored->block_crcs[b]) continue;
+                    corrupted = true;
+                    report->blocks_corrupted++;
+                    if (options->verbose) {
+                        uint64_t offset = (uint64_t)b * manifest->block_size;
+                        printf("[校验] 数据损坏: %s 第 %u 块 (偏移 %llu), "
+                               "期望 0x%08X, 实际 0x%08X\n",
+                               item->current.path, b, (unsigned long long)offset,
+                               item->stored->block_crcs[b], item->current.block_crcs[b]);
+                    }
+                }
+                if (corrupted) report->files_corrupted++;
+                break;
+            }
+        }
+        if (item->failed && options->verbose) {
+            printf("[校验] 读取失败: %s\n", item->current.path);
+        }
+    }
+    report->files_total = item_count;
+
+    // 增量更新：用重新计算的结果替换已修改/新增的条目，删除已不存在的条目
+    if (options->update) {
+        manifest_entry_t* entries = calloc(item_count + 1, sizeof(manifest_entry_t));
+        if (entries != NULL) {
+            size_t count = 0;
+            for (size_t i = 0; i < item_count; i++) {
+                verify_item_t* item = &items[i];
+                bool take_current = (item->kind == ITEM_ADDED || item->kind == ITEM_MODIFIED) &&
+                                    !item->failed;
+                if (item->kind == ITEM_MISSING) {
+                    free_entry(item->stored);
+                } else if (take_current) {
+                    if (item->stored != NULL) free_entry(item->stored);
+                    entries[count++] = item->current;
+                    item->current.path = NULL;
+                    item->current.block_crcs = NULL;
+                } else if (item->stored != NULL) {
+                    entries[count++] = *item->stored;
+                }
+            }
+            free(manifest->entries);
+            manifest->entries = entries;
+            manifest->entry_count = count;
+            manifest->entry_capacity = item_count + 1;
+        }
+    }
+
+    for (size_t i = 0; i < item_count; i++) free_entry(&items[i].current);
+    free(items);
+    free(targets);
+    free(failed);
+
+    report->elapsed_ms = monotonic_ms() - start;
+    return report->files_corrupted == 0 && report->files_failed == 0;
+}
+
+/* ========== 二进制清单读写 ========== */
+
+/* 所有整数按小端序写入，文件末尾附加整个内容的CRC-32C */
+static void put_bytes(uint8_t** cursor, const void* data, size_t length) {
+    memcpy(*cursor, data, length);
+    *cursor += length;
+}
+
+static void put_u16(uint8_t** cursor, uint16_t value) {
+    uint8_t bytes[2] = {(uint8_t)value, (uint8_t)(value >> 8)};
+    put_bytes(cursor, bytes, 2);
+}
+
+static void put_u32(uint8_t** cursor, uint32_t value) {
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                        (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    put_bytes(cursor, bytes, 4);
+}
+
+static void put_u64(uint8_t** cursor, uint64_t value) {
+    put_u32(cursor, (uint32_t)value);
+    put_u32(cursor, (uint32_t)(value >> 32));
+}
+
+static bool get_bytes(const uint8_t** cursor, const uint8_t* end, void* data, size_t length) {
+    if ((size_t)(end - *cursor) < length) return false;
+    memcpy(data, *cursor, length);
+    *cursor += length;
+    return true;
+}
+
+static bool get_u16(const uint8_t** cursor, const uint8_t* end, uint16_t* value) {
+    uint8_t bytes[2];
+    if (!get_bytes(cursor, end, bytes, 2)) return false;
+    *value = (uint16_t)(bytes[0] | (bytes[1] << 8));
+    return true;
+}
+
+static bool get_u32(const uint8_t** cursor, const uint8_t* end, uint32_t* value) {
+    uint8_t bytes[4];
+    if (!get_bytes(cursor, end, bytes, 4)) return false;
+    *value = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+             ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    return true;
+}
+
+static bool get_u64(const uint8_t** cursor, const uint8_t* end, uint64_t* value) {
+    uint32_t low;
+    uint32_t high;
+    if (!get_u32(cursor, end, &low) || !get_u32(cursor, end, &high)) return false;
+    *value = ((uint64_t)high << 32) | low;
+    return true;
+}
+
+/* 清单自身校验使用的CRC-32C查找表（读写清单可能并发调用，由 pthread_once 保证只生成一次） */
+static crc_config_t manifest_crc_config;
+static crc_table_t manifest_crc_table;
+static pthread_once_t manifest_crc_once = PTHREAD_ONCE_INIT;
+
+static void init_manifest_crc_table(void) {
+    init_crc_config(&manifest_crc_config, CRC_32C);
+    generate_crc_table(&manifest_crc_table, &manifest_crc_config);
+}
+
+/* 计算清单自身校验使用的CRC-32C */
+static uint32_t manifest_checksum(const uint8_t* data, size_t length) {
+    pthread_once(&manifest_crc_once, init_manifest_crc_table);
+    return calculate_crc_table(data, length, &manifest_crc_config, &manifest_crc_table);
+}
+
+/* 写入二进制清单文件 */
+bool write_manifest(const manifest_t* manifest, const char* path) {
+    if (manifest == NULL || path == NULL) return false;
+
+    size_t size = 8 + 4 + 4 + 4 + 8 + 4;
+    for (size_t i = 0; i < manifest->entry_count; i++) {
+        const manifest_entry_t* entry = &manifest->entries[i];
+        size += 2 + strlen(entry->path) + 8 + 8 + 4 + 4 + 4 + 4 * (size_t)entry->block_count;
+    }
+
+    uint8_t* buffer = malloc(size);
+    if (buffer == NULL) return false;
+
+    uint8_t* cursor = buffer;
+    put_bytes(&cursor, MANIFEST_MAGIC, 8);
+    put_u32(&cursor, MANIFEST_VERSION);
+    put_u32(&cursor, (uint32_t)manifest->crc_type);
+    put_u32(&cursor, manifest->block_size);
+    put_u64(&cursor, manifest->entry_count);
+    for (size_t i = 0; i < manifest->entry_count; i++) {
+        const manifest_entry_t* entry = &manifest->entries[i];
+        size_t path_length = strlen(entry->path);
+        put_u16(&cursor, (uint16_t)path_length);
+        put_bytes(&cursor, entry->path, path_length);
+        put_u64(&cursor, entry->size);
+        put_u64(&cursor, (uint64_t)entry->mtime_sec);
+        put_u32(&cursor, entry->mtime_nsec);
+        put_u32(&cursor, entry->file_crc);
+        put_u32(&cursor, entry->block_count);
+        for (uint32_t b = 0; b < entry->block_count; b++) {
+            put_u32(&cursor, entry->block_crcs[b]);
+        }
+    }
+    put_u32(&cursor, manifest_checksum(buffer, (size_t)(cursor - buffer)));
+
+    FILE* file = fopen(path, "wb");
+    bool ok = file != NULL && fwrite(buffer, 1, size, file) == size;
+    if (file != NULL && fclose(file) != 0) ok = false;
+    free(buffer);
+    return ok;
+}
+
+/* 读取二进制清单文件 */
+bool read_manifest(manifest_t* manifest, const char* path) {
+    if (manifest == NULL || path == NULL) return false;
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (file_size < 32) {
+        fclose(file);
+        return false;
+    }
+
+    uint8_t* buffer = malloc((size_t)file_size);
+    if (buffer == NULL) {
+        fclose(file);
+        return false;
+    }
+    bool ok = fread(buffer, 1, (size_t)file_size, file) == (size_t)file_size;
+    fclose(file);
+
+    // 先校验末尾的CRC-32C，再解析内容
+    const uint8_t* end = buffer + file_size - 4;
+    uint32_t stored_checksum = 0;
+    const uint8_t* trailer = end;
+    ok = ok && get_u32(&trailer, buffer + file_size, &stored_checksum) &&
+         stored_checksum == manifest_checksum(buffer, (size_t)(file_size - 4));
+
+    const uint8_t* cursor = buffer;
+    char magic[8];
+    uint32_t version = 0;
+    uint32_t crc_type = 0;
+    uint32_t block_size = 0;
+    uint64_t entry_count = 0;
+    ok = ok && get_bytes(&cursor, end, magic, 8) && memcmp(magic, MANIFEST_MAGIC, 8) == 0 &&
+         get_u32(&cursor, end, &version) && version == MANIFEST_VERSION &&
+         get_u32(&cursor, end, &crc_type) && crc_type < CRC_TYPE_COUNT &&
+         get_u32(&cursor, end, &block_size) && block_size > 0 &&
+         get_u64(&cursor, end, &entry_count);
+
+    if (!ok) {
+        free(buffer);
+        return false;
+    }
+
+    init_manifest(manifest, (crc_type_t)crc_type, block_size);
+    for (uint64_t i = 0; ok && i < entry_count; i++) {
+        uint16_t path_length = 0;
+        char entry_path[MANIFEST_MAX_PATH];
+        ok = get_u16(&cursor, end, &path_length) && path_length < sizeof(entry_path) &&
+             get_bytes(&cursor, end, entry_path, path_length);
+        if (!ok) break;
+        entry_path[path_length] = '\0';
+
+        manifest_entry_t* entry = manifest_append(manifest, entry_path);
+        uint64_t mtime_sec = 0;
+        ok = entry != NULL &&
+             get_u64(&cursor, end, &entry->size) &&
+             get_u64(&cursor, end, &mtime_sec) &&
+             get_u32(&cursor, end, &entry->mtime_nsec) &&
+             get_u32(&cursor, end, &entry->file_crc) &&
+             get_u32(&cursor, end, &entry->block_count) &&
+             (size_t)(end - cursor) >= 4 * (size_t)entry->block_count;
+        if (!ok) break;
+        entry->mtime_sec = (int64_t)mtime_sec;
+
+        if (entry->block_count > 0) {
+            entry->block_crcs = malloc(entry->block_count * sizeof(uint32_t));
+            ok = entry->block_crcs != NULL;
+            for (uint32_t b = 0; ok && b < entry->block_count; b++) {
+                ok = get_u32(&cursor, end, &entry->block_crcs[b]);
+            }
+        }
+    }
+
+    free(buffer);
+    if (!ok) free_manifest(manifest);
+    return ok;
+}
+
+/* ========== 信息打印函数 ========== */
+
+void print_manifest_report(const manifest_report_t* report) {
+    if (report == NULL) return;
+
+    printf("=== 完整性清单报告 ===\n");
+    printf("文件总数: %zu\n", report->files_total);
+    printf("重新计算: %zu 个文件, %zu 个块, %.2f MB\n", report->files_hashed,
+           report->blocks_hashed, report->bytes_hashed / (1024.0 * 1024.0));
+    printf("增量跳过: %zu 个文件\n", report->files_skipped);
+    printf("已修改:   %zu\n", report->files_modified);
+    printf("新增:     %zu\n", report->files_added);
+    printf("已删除:   %zu\n", report->files_missing);
+    printf("损坏:     %zu 个文件, %zu 个块\n", report->files_corrupted, report->blocks_corrupted);
+    printf("读取失败: %zu\n", report->files_failed);
+    printf("耗时:     %.2f 毫秒", report->elapsed_ms);
+    if (report->elapsed_ms > 0 && report->bytes_hashed > 0) {
+        printf(" (%.1f MB/s)", report->bytes_hashed / (1024.0 * 1024.0) / (report->elapsed_ms / 1000.0));
+    }
+    printf("\n\n");
+}
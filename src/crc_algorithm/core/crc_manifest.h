@@ -0,0 +1,78 @@
+#ifndef CRC_MANIFEST_H
+#define CRC_MANIFEST_H
+
+#include "crc_algorithm.h"
+
+/* 常量定义 */
+#define MANIFEST_MAGIC "CRCMANI1"                // 清单文件魔数（8字节）
+#define MANIFEST_VERSION 1                       // 清单格式版本
+#define MANIFEST_DEFAULT_BLOCK_SIZE (1024 * 1024) // 默认分块大小 1MB
+#define MANIFEST_MAX_THREADS 64                  // 最大工作线程数
+#define MANIFEST_MAX_PATH 4096                   // 最大路径长度
+
+/* 清单中的单个文件条目 */
+typedef struct {
+    char* path;                 // 相对根目录的路径
+    uint64_t size;              // 文件大小
+    int64_t mtime_sec;          // 修改时间（秒）
+    uint32_t mtime_nsec;        // 修改时间（纳秒）
+    uint32_t file_crc;          // 整个文件的CRC（由块CRC合并得到）
+    uint32_t block_count;       // 分块数
+    uint32_t* block_crcs;       // 每个分块的CRC
+} manifest_entry_t;
+
+/* 完整性清单 */
+typedef struct {
+    crc_type_t crc_type;        // 使用的CRC标准
+    uint32_t block_size;        // 分块大小
+    size_t entry_count;         // 文件条目数
+    size_t entry_capacity;      // 条目数组容量
+    manifest_entry_t* entries;  // 文件条目（按路径排序）
+} manifest_t;
+
+/* 构建/校验选项 */
+typedef struct {
+    int threads;                // 工作线程数
+    uint32_t block_size;        // 分块大小（仅构建时使用）
+    crc_type_t crc_type;        // CRC标准（仅构建时使用）
+    bool full_verify;           // 是否重新读取大小/修改时间未变的文件
+    bool update;                // 校验时是否把已修改/新增/删除的文件写回清单
+    bool verbose;               // 是否打印每个问题文件
+} manifest_options_t;
+
+/* 构建/校验报告 */
+typedef struct {
+    size_t files_total;         // 涉及的文件总数
+    size_t files_hashed;        // 实际读取并计算的文件数
+    size_t files_skipped;       // 因大小/修改时间未变而跳过的文件数
+    size_t files_modified;      // 大小或修改时间变化的文件数
+    size_t files_corrupted;     // 元数据未变但内容损坏的文件数
+    size_t files_missing;       // 清单中存在但磁盘上已删除的文件数
+    size_t files_added;         // 磁盘上新增的文件数
+    size_t files_failed;        // 读取失败的文件数
+    size_t blocks_hashed;       // 计算的分块数
+    size_t blocks_corrupted;    // 损坏的分块数
+    uint64_t bytes_hashed;      // 读取的字节数
+    double elapsed_ms;          // 耗时（毫秒）
+} manifest_report_t;
+
+/* 初始化函数 */
+void init_manifest(manifest_t* manifest, crc_type_t crc_type, uint32_t block_size);
+void init_manifest_options(manifest_options_t* options);
+void init_manifest_report(manifest_report_t* report);
+void free_manifest(manifest_t* manifest);
+
+/* 构建与校验 */
+bool build_manifest(const char* root, const manifest_options_t* options,
+                    manifest_t* manifest, manifest_report_t* report);
+bool verify_manifest(const char* root, manifest_t* manifest,
+                     const manifest_options_t* options, manifest_report_t* report);
+
+/* 二进制清单文件读写 */
+bool write_manifest(const manifest_t* manifest, const char* path);
+bool read_manifest(manifest_t* manifest, const char* path);
+
+/* 信息打印函数 */
+void print_manifest_report(const manifest_report_t* report);
+
+#endif // CRC_MANIFEST_H
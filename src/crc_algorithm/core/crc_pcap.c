@@ -0,0 +1,390 @@
+#define _DEFAULT_SOURCE
+#include "crc_pcap.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* pcap 魔数（按文件字节序读取后的值） */
+#define PCAP_MAGIC_USEC 0xA1B2C3D4
+#define PCAP_MAGIC_NSEC 0xA1B23C4D
+#define PCAP_HEADER_SIZE 24
+#define PCAP_RECORD_SIZE 16
+#define PCAP_LINKTYPE_FCS_VALID 0x04000000  // LinkType字段中的F位：FCS长度有效
+#define PCAP_LINKTYPE_MASK 0x0000FFFF       // LinkType字段中的链路类型
+
+/* pcapng 块类型 */
+#define PCAPNG_SHB 0x0A0D0D0A
+#define PCAPNG_IDB 0x00000001
+#define PCAPNG_SPB 0x00000003
+#define PCAPNG_EPB 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_OPT_END 0
+#define PCAPNG_OPT_FCSLEN 13
+
+/* 待校验的一帧 */
+typedef struct {
+    const uint8_t* data;
+    uint32_t length;            // 含FCS的捕获长度
+    uint64_t index;             // 帧号（从1开始）
+} fcs_frame_t;
+
+/* 批量校验上下文：解析阶段只收集帧描述，攒满一批后集中计算CRC */
+typedef struct {
+    crc_config_t config;
+    crc_table_t table;
+    fcs_frame_t frames[FCS_BATCH_SIZE];
+    size_t count;
+    bool assume_fcs;            // 未声明FCS长度的以太网接口是否按带FCS校验
+    fcs_report_t* report;
+} fcs_batch_t;
+
+/* 获取单调时钟毫秒数 */
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* 按指定字节序读取整数 */
+static uint16_t read_u16(const uint8_t* p, bool swapped) {
+    return swapped ? (uint16_t)((p[0] << 8) | p[1]) : (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t* p, bool swapped) {
+    if (swapped) {
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* 初始化FCS校验报告 */
+void init_fcs_report(fcs_report_t* report) {
+    if (report == NULL) return;
+    memset(report, 0, sizeof(fcs_report_t));
+}
+
+/* 释放FCS校验报告 */
+void free_fcs_report(fcs_report_t* report) {
+    if (report == NULL) return;
+    free(report->corrupted_frames);
+    report->corrupted_frames = NULL;
+    report->corrupted_capacity = 0;
+}
+
+/* 记录一个损坏帧的帧号 */
+static void record_corrupted_frame(fcs_report_t* report, uint64_t index) {
+    if (report->frames_corrupted >= report->corrupted_capacity) {
+        size_t capacity = report->corrupted_capacity ? report->corrupted_capacity * 2 : 64;
+        uint64_t* frames = realloc(report->corrupted_frames, capacity * sizeof(uint64_t));
+        if (frames == NULL) {
+            report->frames_corrupted++;     // 内存不足时只计数，不保留帧号
+            return;
+        }
+        report->corrupted_frames = frames;
+        report->corrupted_capacity = capacity;
+    }
+    report->corrupted_frames[report->frames_corrupted++] = index;
+}
+
+/* 集中校验一批帧：FCS以小端序附在帧尾，等于除FCS外全部字节的CRC-32 */
+static void flush_fcs_batch(fcs_batch_t* batch) {
+    fcs_report_t* report = batch->report;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        const fcs_frame_t* frame = &batch->frames[i];
+        if (i + 1 < batch->count) {
+            __builtin_prefetch(batch->frames[i + 1].data);
+        }
+
+        uint32_t payload = frame->length - FCS_LENGTH;
+        uint32_t crc = calculate_crc_table(frame->data, payload, &batch->config, &batch->table);
+        uint32_t fcs = read_u32(frame->data + payload, false);
+
+        if (crc != fcs) {
+            record_corrupted_frame(report, frame->index);
+        }
+        report->bytes_checked += frame->length;
+    }
+
+    report->frames_checked += batch->count;
+    batch->count = 0;
+}
+
+/* 把一帧加入当前批次；截断或不含4字节FCS的帧无法校验，直接跳过 */
+static void queue_fcs_frame(fcs_batch_t* batch, const uint8_t* data, uint32_t captured,
+                            uint32_t original, uint32_t fcs_length) {
+    fcs_report_t* report = batch->report;
+    report->frames_total++;
+
+    if (fcs_length != FCS_LENGTH || captured < original || captured <= FCS_LENGTH) {
+        report->frames_skipped++;
+        return;
+    }
+
+    fcs_frame_t* frame = &batch->frames[batch->count++];
+    frame->data = data;
+    frame->length = captured;
+    frame->index = report->frames_total;
+
+    if (batch->count == FCS_BATCH_SIZE) {
+        flush_fcs_batch(batch);
+    }
+}
+
+/* 解析经典pcap格式 */
+static bool parse_pcap(const uint8_t* data, size_t length, fcs_batch_t* batch) {
+    if (length < PCAP_HEADER_SIZE) {
+        printf("错误: pcap文件头不完整\n");
+        return false;
+    }
+
+    uint32_t magic = read_u32(data, false);
+    bool swapped = (magic != PCAP_MAGIC_USEC && magic != PCAP_MAGIC_NSEC);
+    uint32_t linktype = read_u32(data + 20, swapped);
+
+    // 只校验以太网；LinkType的F位置位时高4位给出FCS长度（以16位为单位），否则视为不带FCS
+    uint32_t fcs_length = 0;
+    if ((linktype & PCAP_LINKTYPE_MASK) == FCS_LINKTYPE_ETHERNET) {
+        if (linktype & PCAP_LINKTYPE_FCS_VALID) {
+            fcs_length = (linktype >> 28) * 2;
+        } else if (batch->assume_fcs) {
+            fcs_length = FCS_LENGTH;
+        }
+    }
+
+    size_t offset = PCAP_HEADER_SIZE;
+    while (offset + PCAP_RECORD_SIZE <= length) {
+        uint32_t captured = read_u32(data + offset + 8, swapped);
+        uint32_t original = read_u32(data + offset + 12, swapped);
+        offset += PCAP_RECORD_SIZE;
+
+        if (captured > length - offset) {
+            printf("错误: 第 %llu 帧超出文件末尾\n",
+                   (unsigned long long)(batch->report->frames_total + 1));
+            return false;
+        }
+
+        queue_fcs_frame(batch, data + offset, captured, original, fcs_length);
+        offset += captured;
+    }
+
+    if (offset != length) {
+        printf("错误: 文件末尾存在不完整的记录头\n");
+        return false;
+    }
+    return true;
+}
+
+/* 从IDB选项中读取if_fcslen，未给出时返回 default_length */
+static uint32_t parse_idb_fcs_length(const uint8_t* options, size_t length, bool swapped,
+                                     uint32_t default_length) {
+    size_t offset = 0;
+    while (offset + 4 <= length) {
+        uint16_t code = read_u16(options + offset, swapped);
+        uint16_t size = read_u16(options + offset + 2, swapped);
+        offset += 4;
+        if (code == PCAPNG_OPT_END || size > length - offset) break;
+        if (code == PCAPNG_OPT_FCSLEN && size >= 1) {
+            return options[offset];
+        }
+        offset += (size + 3u) & ~3u;
+    }
+    return default_length;
+}
+
+/* 解析pcapng格式（支持多个节、多接口以及EPB/SPB两种包块） */
+static bool parse_pcapng(const uint8_t* data, size_t length, fcs_batch_t* batch) {
+    uint32_t fcs_lengths[FCS_MAX_INTERFACES];
+    uint32_t interface_count = 0;
+    bool swapped = false;
+    size_t offset = 0;
+
+    while (offset + 12 <= length) {
+        const uint8_t* block = data + offset;
+        uint32_t type = read_u32(block, false);
+
+        if (type == PCAPNG_SHB) {
+            // 新的节：重新确定字节序，接口编号从零开始
+            uint32_t order = read_u32(block + 8, false);
+            if (order == PCAPNG_BYTE_ORDER_MAGIC) {
+                swapped = false;
+            } else if (read_u32(block + 8, true) == PCAPNG_BYTE_ORDER_MAGIC) {
+                swapped = true;
+            } else {
+                printf("错误: 偏移 %zu 处的节头块字节序标记无效\n", offset);
+                return false;
+            }
+            interface_count = 0;
+        } else {
+            type = read_u32(block, swapped);
+        }
+
+        uint32_t total = read_u32(block + 4, swapped);
+        if (total < 12 || (total & 3) != 0 || total > length - offset) {
+            printf("错误: 偏移 %zu 处的块长度无效 (%u)\n", offset, total);
+            return false;
+        }
+
+        const uint8_t* body = block + 8;
+        size_t body_length = total - 12;
+
+        if (type == PCAPNG_IDB && body_length >= 8) {
+            // 非以太网接口的帧不校验；未声明if_fcslen的以太网接口视为不带FCS
+            if (interface_count < FCS_MAX_INTERFACES) {
+                uint32_t default_length = batch->assume_fcs ? FCS_LENGTH : 0;
+                fcs_lengths[interface_count] = (read_u16(body, swapped) == FCS_LINKTYPE_ETHERNET)
+                    ? parse_idb_fcs_length(body + 8, body_length - 8, swapped, default_length) : 0;
+            }
+            interface_count++;
+        } else if (type == PCAPNG_EPB && body_length >= 20) {
+            uint32_t interface = read_u32(body, swapped);
+            uint32_t captured = read_u32(body + 12, swapped);
+            uint32_t original = read_u32(body + 16, swapped);
+            if (captured > body_length - 20) {
+                printf("错误: 偏移 %zu 处的增强包块数据超出块长度\n", offset);
+                return false;
+            }
+            uint32_t fcs_length = (interface < interface_count && interface < FCS_MAX_INTERFACES)
+                                  ? fcs_lengths[interface] : 0;
+            queue_fcs_frame(batch, body + 20, captured, original, fcs_length);
+        } else if (type == PCAPNG_SPB && body_length >= 4) {
+            // 简单包块不记录捕获长度，由原始长度和块长度推出；隐含使用接口0
+            uint32_t original = read_u32(body, swapped);
+            uint32_t captured = original < body_length - 4 ? original : (uint32_t)(body_length - 4);
+            uint32_t fcs_length = interface_count > 0 ? fcs_lengths[0] : 0;
+            queue_fcs_frame(batch, body + 4, captured, original, fcs_length);
+        }
+
+        offset += total;
+    }
+
+    if (offset != length) {
+        printf("错误: 文件末尾存在不完整的块\n");
+        return false;
+    }
+    return true;
+}
+
+/* 校验内存中一个完整抓包文件的所有帧FCS */
+bool verify_capture_fcs_buffer(const uint8_t* data, size_t length, bool assume_fcs, fcs_report_t* report) {
+    if (data == NULL || report == NULL) return false;
+
+    free_fcs_report(report);
+    init_fcs_report(report);
+
+    if (length < 4) {
+        printf("错误: 文件太短，无法识别格式\n");
+        return false;
+    }
+
+    uint32_t magic = read_u32(data, false);
+    if (magic == PCAPNG_SHB) {
+        report->format = CAPTURE_FORMAT_PCAPNG;
+    } else if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC ||
+               read_u32(data, true) == PCAP_MAGIC_USEC || read_u32(data, true) == PCAP_MAGIC_NSEC) {
+        report->format = CAPTURE_FORMAT_PCAP;
+    } else {
+        printf("错误: 无法识别的抓包文件格式 (魔数 0x%08X)\n", magic);
+        return false;
+    }
+
+    // CRC表较大，放在堆上；以太网FCS即标准CRC-32，使用切片查表引擎
+    fcs_batch_t* batch = malloc(sizeof(fcs_batch_t));
+    if (batch == NULL) return false;
+    batch->count = 0;
+    batch->assume_fcs = assume_fcs;
+    batch->report = report;
+    memset(&batch->table, 0, sizeof(crc_table_t));
+    init_crc_config(&batch->config, CRC_32);
+    generate_crc_table(&batch->table, &batch->config);
+
+    double start = monotonic_ms();
+    bool ok = (report->format == CAPTURE_FORMAT_PCAP)
+              ? parse_pcap(data, length, batch)
+              : parse_pcapng(data, length, batch);
+    flush_fcs_batch(batch);
+    report->elapsed_ms = monotonic_ms() - start;
+
+    free(batch);
+    return ok;
+}
+
+/* 通过mmap映射抓包文件并校验所有帧的FCS */
+bool verify_capture_fcs(const char* path, bool assume_fcs, fcs_report_t* report) {
+    if (path == NULL || report == NULL) return false;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("错误: 无法打开抓包文件 %s\n", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        printf("错误: 无法读取抓包文件 %s\n", path);
+        close(fd);
+        return false;
+    }
+
+    size_t length = (size_t)st.st_size;
+    void* mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        printf("错误: 无法映射抓包文件 %s\n", path);
+        return false;
+    }
+    // 访问建议是互斥的枚举值而非位标志，需分别设置；失败只影响预读效果，不影响校验
+    if (madvise(mapped, length, MADV_SEQUENTIAL) != 0 || madvise(mapped, length, MADV_WILLNEED) != 0) {
+        printf("警告: 无法设置抓包文件的预读建议，继续校验\n");
+    }
+
+    bool ok = verify_capture_fcs_buffer(mapped, length, assume_fcs, report);
+    munmap(mapped, length);
+    return ok;
+}
+
+/* 获取抓包格式名称 */
+const char* capture_format_name(capture_format_t format) {
+    switch (format) {
+        case CAPTURE_FORMAT_PCAP:
+            return "pcap";
+        case CAPTURE_FORMAT_PCAPNG:
+            return "pcapng";
+        default:
+            return "未知";
+    }
+}
+
+/* 打印FCS校验报告，最多列出max_listed个损坏帧号 */
+void print_fcs_report(const fcs_report_t* report, size_t max_listed) {
+    if (report == NULL) return;
+
+    printf("=== 以太网FCS校验报告 ===\n");
+    printf("文件格式: %s\n", capture_format_name(report->format));
+    printf("帧总数:   %llu\n", (unsigned long long)report->frames_total);
+    printf("已校验:   %llu\n", (unsigned long long)report->frames_checked);
+    printf("已跳过:   %llu (截断、未声明FCS或非以太网)\n", (unsigned long long)report->frames_skipped);
+    printf("FCS错误:  %llu\n", (unsigned long long)report->frames_corrupted);
+
+    size_t listed = report->frames_corrupted < report->corrupted_capacity
+                    ? (size_t)report->frames_corrupted : report->corrupted_capacity;
+    if (listed > max_listed) listed = max_listed;
+    if (listed > 0) {
+        printf("损坏帧号:");
+        for (size_t i = 0; i < listed; i++) {
+            printf(" %llu", (unsigned long long)report->corrupted_frames[i]);
+        }
+        if (listed < report->frames_corrupted) printf(" ...");
+        printf("\n");
+    }
+
+    printf("耗时:     %.2f 毫秒", report->elapsed_ms);
+    if (report->elapsed_ms > 0 && report->bytes_checked > 0) {
+        double seconds = report->elapsed_ms / 1000.0;
+        printf(" (%.1f MB/s, %.0f 帧/秒)", report->bytes_checked / (1024.0 * 1024.0) / seconds,
+               report->frames_checked / seconds);
+    }
+    printf("\n\n");
+}
@@ -0,0 +1,45 @@
+#ifndef CRC_PCAP_H
+#define CRC_PCAP_H
+
+#include "crc_algorithm.h"
+
+/* 常量定义 */
+#define FCS_LENGTH 4                    // 以太网FCS长度（CRC-32）
+#define FCS_BATCH_SIZE 64               // 每批校验的帧数
+#define FCS_MAX_INTERFACES 256          // pcapng中最多跟踪的接口数
+#define FCS_LINKTYPE_ETHERNET 1         // 唯一校验FCS的链路类型
+
+/* 抓包文件格式 */
+typedef enum {
+    CAPTURE_FORMAT_UNKNOWN,
+    CAPTURE_FORMAT_PCAP,
+    CAPTURE_FORMAT_PCAPNG
+} capture_format_t;
+
+/* FCS校验报告 */
+typedef struct {
+    capture_format_t format;        // 识别出的文件格式
+    uint64_t frames_total;          // 文件中的帧总数
+    uint64_t frames_checked;        // 实际校验FCS的帧数
+    uint64_t frames_corrupted;      // FCS不匹配的帧数
+    uint64_t frames_skipped;        // 被截断、未声明FCS或非以太网而跳过的帧数
+    uint64_t bytes_checked;         // 参与校验的字节数
+    double elapsed_ms;              // 耗时（毫秒）
+    uint64_t* corrupted_frames;     // 损坏帧的帧号（从1开始，与Wireshark一致）
+    size_t corrupted_capacity;      // 帧号数组容量
+} fcs_report_t;
+
+/* 初始化函数 */
+void init_fcs_report(fcs_report_t* report);
+void free_fcs_report(fcs_report_t* report);
+
+/* 校验函数 */
+/* assume_fcs 为 true 时，未声明FCS长度的以太网接口按带4字节FCS校验；否则这些帧视为不含FCS而跳过 */
+bool verify_capture_fcs(const char* path, bool assume_fcs, fcs_report_t* report);
+bool verify_capture_fcs_buffer(const uint8_t* data, size_t length, bool assume_fcs, fcs_report_t* report);
+
+/* 信息打印函数 */
+const char* capture_format_name(capture_format_t format);
+void print_fcs_report(const fcs_report_t* report, size_t max_listed);
+
+#endif // CRC_PCAP_H
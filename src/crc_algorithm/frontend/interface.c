@@ -1,8 +1,12 @@
 #include "../core/crc_algorithm.h"
+#include "../core/crc_manifest.h"
+#include "../core/crc_pcap.h"
+#include "../core/crc_filter.h"
+#include <unistd.h>
 
 /* 全局变量 */
 static crc_statistics_t g_stats;
-static crc_table_t g_tables[4]; // 为四种CRC标准分别准备表
+static crc_table_t g_tables[CRC_TYPE_COUNT]; // 为每种CRC标准分别准备表
 
 /* 函数声明 */
 void show_welcome_message(void);
@@ -16,15 +20,25 @@ void show_statistics_report(void);
 int get_user_choice(int min, int max);
 void clear_input_buffer(void);
 void press_enter_to_continue(void);
+int run_command_line(int argc, char* argv[]);
+void show_command_usage(const char* program);
+int handle_manifest_command(int argc, char* argv[]);
+int handle_pcap_command(int argc, char* argv[]);
+int handle_filter_command(int argc, char* argv[]);
 
 /* 主函数 */
-int main(void) {
+int main(int argc, char* argv[]) {
+    // 带参数时作为命令行工具运行
+    if (argc > 1) {
+        return run_command_line(argc, argv);
+    }
+    
     // 初始化统计信息
     init_crc_statistics(&g_stats);
     
     // 预生成所有CRC表
     printf("正在初始化CRC算法演示系统...\n");
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < CRC_TYPE_COUNT; i++) {
         crc_config_t config;
         init_crc_config(&config, (crc_type_t)i);
         generate_crc_table(&g_tables[i], &config);
@@ -69,6 +83,8 @@ int main(void) {
                 printf("• CRC-16: 16位CRC，广泛应用于工业控制\n");
                 printf("• CRC-16-CCITT: CCITT标准，用于电信\n");
                 printf("• CRC-32: 32位CRC，用于以太网、ZIP等\n");
+                printf("• CRC-32C: Castagnoli多项式，用于iSCSI、ext4等 (支持SSE4.2硬件加速)\n\n");
+                printf("命令行工具: 带参数运行本程序 (如 demo manifest build <目录> <清单>)\n");
                 press_enter_to_continue();
                 break;
             case 0:
@@ -304,6 +320,33 @@ void handle_algorithm_comparison(void) {
     }
     
     printf("\n结论: 查表算法在处理大数据时具有明显的性能优势！\n");
+    
+    // 内容定义分块吞吐量：窗口48字节、掩码0x1FFF、分块 2KB-64KB
+    size_t chunk_data_size = 16 * 1024 * 1024;
+    uint8_t* chunk_data = malloc(chunk_data_size);
+    if (chunk_data != NULL) {
+        for (size_t j = 0; j < chunk_data_size; j++) {
+            chunk_data[j] = rand() % 256;
+        }
+        crc_type_t chunk_types[2] = {(crc_type_t)crc_choice, CRC_32C};
+        printf("\n=== 内容定义分块吞吐量 (16 MB 随机数据) ===\n");
+        for (int k = 0; k < 2; k++) {
+            crc_config_t chunk_config;
+            init_crc_config(&chunk_config, chunk_types[k]);
+            crc_chunker_t chunker;
+            if (!init_crc_chunker(&chunker, &chunk_config, &g_tables[chunk_types[k]], 48, 0x1FFF, 2048, 65536)) {
+                continue;
+            }
+            clock_t start = clock();
+            process_crc_chunker(&chunker, chunk_data, chunk_data_size, NULL, NULL);
+            finish_crc_chunker(&chunker, NULL, NULL);
+            double seconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+            printf("%-14s %zu 个分块, %.1f MB/s\n", chunk_config.name, chunker.chunk_count,
+                   seconds > 0 ? chunk_data_size / (1024.0 * 1024.0) / seconds : 0.0);
+            free_crc_chunker(&chunker);
+        }
+        free(chunk_data);
+    }
     press_enter_to_continue();
 }
 
@@ -476,4 +519,218 @@ void press_enter_to_continue(void) {
     printf("\n按回车键继续...");
     clear_input_buffer();
     getchar();
-}
\ No newline at end of file
+}
+
+/* 命令行工具入口 */
+int run_command_line(int argc, char* argv[]) {
+    if (strcmp(argv[1], "manifest") == 0) {
+        return handle_manifest_command(argc, argv);
+    }
+    if (strcmp(argv[1], "pcap") == 0) {
+        return handle_pcap_command(argc, argv);
+    }
+    if (strcmp(argv[1], "filter") == 0) {
+        return handle_filter_command(argc, argv);
+    }
+    
+    show_command_usage(argv[0]);
+    return (strcmp(argv[1], "help") == 0 || strcmp(argv[1], "--help") == 0) ? 0 : 1;
+}
+
+/* 显示命令行用法 */
+void show_command_usage(const char* program) {
+    printf("用法:\n");
+    printf("  %s                                   进入交互式演示\n", program);
+    printf("  %s manifest build <目录> <清单文件> [-j 线程数] [-b 块大小KB] [-t crc32|crc32c]\n", program);
+    printf("  %s manifest verify <目录> <清单文件> [-j 线程数] [--full] [--update]\n", program);
+    printf("  %s pcap <抓包文件> [--list 数量] [--assume-fcs]  校验pcap/pcapng中每帧的以太网FCS\n", program);
+    printf("  %s filter [-t crc32|crc32c] [-o 结果文件]         透传标准输入到标准输出并计算CRC\n", program);
+    printf("\n");
+    printf("verify 默认跳过大小和修改时间未变的文件；--full 重新读取所有文件以发现静默损坏，\n");
+    printf("--update 把新增/修改/删除的文件写回清单。\n");
+    printf("pcap 只校验以太网链路上声明了FCS的帧；--assume-fcs 把未声明FCS的以太网帧按带4字节FCS校验。\n");
+}
+
+/* 完整性清单子命令 */
+int handle_manifest_command(int argc, char* argv[]) {
+    if (argc < 5) {
+        show_command_usage(argv[0]);
+        return 1;
+    }
+    
+    const char* action = argv[2];
+    const char* root = argv[3];
+    const char* manifest_path = argv[4];
+    
+    manifest_options_t options;
+    init_manifest_options(&options);
+    
+    for (int i = 5; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            options.block_size = (uint32_t)atoi(argv[++i]) * 1024;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "crc32") == 0) {
+                options.crc_type = CRC_32;
+            } else if (strcmp(argv[i], "crc32c") == 0) {
+                options.crc_type = CRC_32C;
+            } else {
+                printf("错误: 不支持的CRC标准 %s (可选 crc32, crc32c)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--full") == 0) {
+            options.full_verify = true;
+        } else if (strcmp(argv[i], "--update") == 0) {
+            options.update = true;
+        } else {
+            printf("错误: 未知参数 %s\n", argv[i]);
+            show_command_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (options.threads < 1 || options.block_size == 0) {
+        printf("错误: 线程数和块大小必须为正数\n");
+        return 1;
+    }
+    
+    manifest_t manifest;
+    manifest_report_t report;
+    
+    if (strcmp(action, "build") == 0) {
+        if (!build_manifest(root, &options, &manifest, &report)) {
+            print_manifest_report(&report);
+            free_manifest(&manifest);
+            return 1;
+        }
+        bool written = write_manifest(&manifest, manifest_path);
+        print_manifest_report(&report);
+        free_manifest(&manifest);
+        if (!written) {
+            printf("错误: 无法写入清单文件 %s\n", manifest_path);
+            return 1;
+        }
+        printf("清单已写入: %s\n", manifest_path);
+        return 0;
+    }
+    
+    if (strcmp(action, "verify") == 0) {
+        if (!read_manifest(&manifest, manifest_path)) {
+            printf("错误: 无法读取清单文件 %s\n", manifest_path);
+            return 1;
+        }
+        bool intact = verify_manifest(root, &manifest, &options, &report);
+        print_manifest_report(&report);
+        if (options.update && !write_manifest(&manifest, manifest_path)) {
+            printf("错误: 无法更新清单文件 %s\n", manifest_path);
+            intact = false;
+        }
+        free_manifest(&manifest);
+        printf("%s\n", intact ? "校验通过" : "校验失败: 发现损坏或读取错误");
+        return intact ? 0 : 2;
+    }
+    
+    show_command_usage(argv[0]);
+    return 1;
+}
+
+/* 抓包文件FCS校验子命令 */
+int handle_pcap_command(int argc, char* argv[]) {
+    if (argc < 3) {
+        show_command_usage(argv[0]);
+        return 1;
+    }
+    
+    size_t max_listed = 20;
+    bool assume_fcs = false;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            max_listed = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "--assume-fcs") == 0) {
+            assume_fcs = true;
+        } else {
+            printf("错误: 未知参数 %s\n", argv[i]);
+            show_command_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    fcs_report_t report;
+    init_fcs_report(&report);
+    bool parsed = verify_capture_fcs(argv[2], assume_fcs, &report);
+    print_fcs_report(&report, max_listed);
+    
+    int status = !parsed ? 1 : (report.frames_corrupted > 0 ? 2 : 0);
+    free_fcs_report(&report);
+    return status;
+}
+
+/* 管道透传CRC过滤子命令：数据从标准输入原样流向标准输出，CRC输出到标准错误或结果文件 */
+int handle_filter_command(int argc, char* argv[]) {
+    crc_type_t type = CRC_32C;
+    const char* side_file = NULL;
+    
+    // 标准输出专用于数据：保留原始描述符用于转发，其余打印一律改到标准错误
+    fflush(stdout);
+    int out_fd = dup(STDOUT_FILENO);
+    if (out_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        fprintf(stderr, "错误: 无法重定向标准输出\n");
+        if (out_fd >= 0) close(out_fd);
+        return 1;
+    }
+    
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "crc32") == 0) {
+                type = CRC_32;
+            } else if (strcmp(argv[i], "crc32c") == 0) {
+                type = CRC_32C;
+            } else {
+                printf("错误: 不支持的CRC标准 %s (可选 crc32, crc32c)\n", argv[i]);
+                close(out_fd);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            side_file = argv[++i];
+        } else {
+            printf("错误: 未知参数 %s\n", argv[i]);
+            show_command_usage(argv[0]);
+            close(out_fd);
+            return 1;
+        }
+    }
+    
+    crc_config_t config;
+    init_crc_config(&config, type);
+    generate_crc_table(&g_tables[type], &config);
+    
+    crc_context_t context;
+    crc_filter_report_t report;
+    init_crc_context(&context, &config, &g_tables[type]);
+    bool ok = run_crc_filter(STDIN_FILENO, out_fd, &context, &report);
+    close(out_fd);
+    
+    uint32_t crc = finalize_crc_context(&context);
+    printf("%s: 0x%08X  字节数: %llu  模式: %s  耗时: %.2f 毫秒", config.name, crc,
+           (unsigned long long)report.bytes, report.zero_copy ? "零拷贝(tee/splice)" : "缓冲读写",
+           report.elapsed_ms);
+    if (report.elapsed_ms > 0 && report.bytes > 0) {
+        printf(" (%.1f MB/s)", report.bytes / (1024.0 * 1024.0) / (report.elapsed_ms / 1000.0));
+    }
+    printf("\n");
+    
+    if (side_file != NULL) {
+        FILE* file = fopen(side_file, "w");
+        if (file == NULL) {
+            printf("错误: 无法写入结果文件 %s\n", side_file);
+            return 1;
+        }
+        fprintf(file, "%08x  %llu\n", crc, (unsigned long long)report.bytes);
+        fclose(file);
+    }
+    
+    return ok ? 0 : 1;
+}
@@ -1,5 +1,12 @@
+#define _DEFAULT_SOURCE
 #include "../core/crc_algorithm.h"
+#include "../core/crc_manifest.h"
+#include "../core/crc_pcap.h"
+#include "../core/crc_filter.h"
 #include <assert.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* 测试统计 */
 typedef struct {
@@ -34,6 +41,13 @@ bool test_empty_data_handling(void);
 bool test_large_data_processing(void);
 bool test_string_conversion_functions(void);
 bool test_performance_measurements(void);
+bool test_rolling_crc_window(void);
+bool test_crc_chunker_boundaries(void);
+bool test_sparse_crc_zero_runs(void);
+bool test_crc32c_engines_and_combine(void);
+bool test_integrity_manifest(void);
+bool test_capture_fcs_validation(void);
+bool test_streaming_crc_filter(void);
 
 /* 已知的测试向量 (标准CRC值) */
 typedef struct {
@@ -76,6 +90,13 @@ int main(void) {
     run_test("大数据处理测试", test_large_data_processing);
     run_test("字符串转换函数测试", test_string_conversion_functions);
     run_test("性能测量功能测试", test_performance_measurements);
+    run_test("滚动CRC窗口一致性测试", test_rolling_crc_window);
+    run_test("内容定义分块边界测试", test_crc_chunker_boundaries);
+    run_test("稀疏数据零串跳跃CRC测试", test_sparse_crc_zero_runs);
+    run_test("CRC-32C计算引擎与CRC合并测试", test_crc32c_engines_and_combine);
+    run_test("并行分块完整性清单测试", test_integrity_manifest);
+    run_test("抓包文件FCS校验测试", test_capture_fcs_validation);
+    run_test("流式CRC与管道透传过滤测试", test_streaming_crc_filter);
     
     print_final_summary();
     
@@ -565,4 +586,710 @@ bool test_performance_measurements(void) {
            stats.total_time_ms, stats.avg_time_ms);
     
     return all_passed;
-}
\ No newline at end of file
+}
+
+/* 测试15: 滚动CRC与整窗CRC一致 */
+bool test_rolling_crc_window(void) {
+    bool all_passed = true;
+    const size_t window_size = 48;
+    const size_t data_size = 2048;
+    
+    printf("  滚动CRC窗口一致性测试:\n");
+    
+    uint8_t* data = malloc(data_size);
+    if (data == NULL) return false;
+    srand(12345);
+    for (size_t i = 0; i < data_size; i++) {
+        data[i] = (uint8_t)(rand() & 0xFF);
+    }
+    
+    crc_type_t types[] = {CRC_16_CCITT, CRC_32};
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        crc_config_t config;
+        crc_table_t table = {0};
+        rolling_crc_t rolling;
+        
+        init_crc_config(&config, types[t]);
+        generate_crc_table(&table, &config);
+        all_passed &= assert_true(init_rolling_crc(&rolling, &config, &table, window_size),
+                                  "滚动CRC初始化成功");
+        
+        size_t mismatches = 0;
+        for (size_t i = 0; i < data_size; i++) {
+            uint32_t value = update_rolling_crc(&rolling, data[i]);
+            if (i + 1 >= window_size) {
+                uint32_t expected = calculate_crc_table(data + i + 1 - window_size,
+                                                        window_size, &config, &table);
+                if (value != expected) mismatches++;
+            }
+        }
+        
+        printf("    %s: 窗口=%zu, 不一致位置数=%zu\n", config.name, window_size, mismatches);
+        all_passed &= assert_true(mismatches == 0, "每个位置的滚动值等于窗口内字节的CRC");
+        free_rolling_crc(&rolling);
+    }
+    
+    free(data);
+    return all_passed;
+}
+
+/* 分块测试回调：记录分块边界 */
+typedef struct {
+    uint64_t offsets[4096];
+    size_t lengths[4096];
+    size_t count;
+} chunk_record_t;
+
+static void record_chunk(uint64_t offset, size_t length, void* user_data) {
+    chunk_record_t* record = (chunk_record_t*)user_data;
+    if (record->count < 4096) {
+        record->offsets[record->count] = offset;
+        record->lengths[record->count] = length;
+        record->count++;
+    }
+}
+
+/* 测试16: 内容定义分块边界 */
+bool test_crc_chunker_boundaries(void) {
+    bool all_passed = true;
+    const size_t data_size = 1 << 20;
+    
+    printf("  内容定义分块边界测试:\n");
+    
+    uint8_t* data = malloc(data_size + 100);
+    chunk_record_t* whole = calloc(1, sizeof(chunk_record_t));
+    chunk_record_t* pieces = calloc(1, sizeof(chunk_record_t));
+    chunk_record_t* shifted = calloc(1, sizeof(chunk_record_t));
+    if (data == NULL || whole == NULL || pieces == NULL || shifted == NULL) {
+        free(data); free(whole); free(pieces); free(shifted);
+        return false;
+    }
+    srand(54321);
+    for (size_t i = 0; i < data_size + 100; i++) {
+        data[i] = (uint8_t)(rand() & 0xFF);
+    }
+    
+    crc_config_t config;
+    crc_table_t table = {0};
+    init_crc_config(&config, CRC_32);
+    generate_crc_table(&table, &config);
+    
+    // 一次性处理整个数据流，平均分块约4KB
+    crc_chunker_t chunker;
+    all_passed &= assert_true(init_crc_chunker(&chunker, &config, &table, 48, 0x0FFF, 512, 16384),
+                              "分块器初始化成功");
+    clock_t start = clock();
+    process_crc_chunker(&chunker, data + 100, data_size, record_chunk, whole);
+    clock_t end = clock();
+    finish_crc_chunker(&chunker, record_chunk, whole);
+    free_crc_chunker(&chunker);
+    
+    double seconds = ((double)(end - start)) / CLOCKS_PER_SEC;
+    if (seconds > 0) {
+        printf("    分块吞吐量: %.1f MB/s\n", data_size / seconds / (1024.0 * 1024.0));
+    }
+    
+    uint64_t total = 0;
+    bool sizes_valid = true;
+    for (size_t i = 0; i < whole->count; i++) {
+        if (whole->offsets[i] != total) sizes_valid = false;
+        if (whole->lengths[i] > 16384) sizes_valid = false;
+        if (i + 1 < whole->count && whole->lengths[i] < 512) sizes_valid = false;
+        total += whole->lengths[i];
+    }
+    printf("    分块数: %zu, 平均分块: %.0f 字节\n", whole->count,
+           whole->count > 0 ? (double)total / whole->count : 0.0);
+    all_passed &= assert_true(total == data_size, "分块覆盖整个数据流");
+    all_passed &= assert_true(sizes_valid, "分块长度满足最小/最大限制且首尾相接");
+    all_passed &= assert_true(whole->count > 1, "找到内容定义的分块边界");
+    
+    // 分段喂入的结果应与一次性处理完全相同
+    init_crc_chunker(&chunker, &config, &table, 48, 0x0FFF, 512, 16384);
+    size_t fed = 0;
+    size_t piece = 1;
+    while (fed < data_size) {
+        size_t step = CRC_MIN(piece, data_size - fed);
+        process_crc_chunker(&chunker, data + 100 + fed, step, record_chunk, pieces);
+        fed += step;
+        piece = piece * 3 + 7;
+    }
+    finish_crc_chunker(&chunker, record_chunk, pieces);
+    free_crc_chunker(&chunker);
+    
+    bool same = pieces->count == whole->count;
+    for (size_t i = 0; same && i < whole->count; i++) {
+        same = pieces->offsets[i] == whole->offsets[i] && pieces->lengths[i] == whole->lengths[i];
+    }
+    all_passed &= assert_true(same, "分段处理与一次性处理得到相同边界");
+    
+    // 在数据前插入字节后，后续边界应随内容一起平移
+    init_crc_chunker(&chunker, &config, &table, 48, 0x0FFF, 512, 16384);
+    process_crc_chunker(&chunker, data, data_size + 100, record_chunk, shifted);
+    finish_crc_chunker(&chunker, record_chunk, shifted);
+    free_crc_chunker(&chunker);
+    
+    size_t matched = 0;
+    for (size_t i = 0; i < shifted->count; i++) {
+        uint64_t end_offset = shifted->offsets[i] + shifted->lengths[i];
+        for (size_t j = 0; j < whole->count; j++) {
+            if (whole->offsets[j] + whole->lengths[j] + 100 == end_offset) {
+                matched++;
+                break;
+            }
+        }
+    }
+    printf("    插入100字节后仍对齐的边界: %zu/%zu\n", matched, whole->count);
+    all_passed &= assert_true(matched + 2 >= whole->count, "插入数据后边界重新同步");
+    
+    free(data);
+    free(whole);
+    free(pieces);
+    free(shifted);
+    return all_passed;
+}
+
+/* 测试17: 稀疏数据零串跳跃CRC */
+bool test_sparse_crc_zero_runs(void) {
+    bool all_passed = true;
+    const size_t data_size = 1 << 20;
+    
+    printf("  稀疏数据零串跳跃CRC测试:\n");
+    
+    uint8_t* sparse = calloc(data_size, 1);
+    uint8_t* dense = malloc(data_size);
+    if (sparse == NULL || dense == NULL) {
+        free(sparse);
+        free(dense);
+        return false;
+    }
+    
+    // 模拟定长帧：每1024字节只有开头几个有效字节，其余为零填充
+    srand(2024);
+    for (size_t i = 0; i < data_size; i += 1024) {
+        for (size_t j = 0; j < 5; j++) {
+            sparse[i + j] = (uint8_t)(1 + rand() % 255);
+        }
+    }
+    for (size_t i = 0; i < data_size; i++) {
+        dense[i] = (uint8_t)(rand() & 0xFF);
+    }
+    
+    // 各种长度和对齐下与查表法逐一比较
+    size_t lengths[] = {1, 63, 64, 65, 300, 1024, 4097, 70000, data_size};
+    for (int type = 0; type < 4; type++) {
+        crc_config_t config;
+        crc_table_t table = {0};
+        init_crc_config(&config, (crc_type_t)type);
+        generate_crc_table(&table, &config);
+        
+        bool consistent = true;
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            size_t offset = (i * 7) % 13;
+            size_t length = CRC_MIN(lengths[i], data_size - offset);
+            consistent &= calculate_crc_sparse(sparse + offset, length, &config, &table) ==
+                          calculate_crc_table(sparse + offset, length, &config, &table);
+            consistent &= calculate_crc_sparse(dense + offset, length, &config, &table) ==
+                          calculate_crc_table(dense + offset, length, &config, &table);
+        }
+        
+        printf("    %s: 稀疏/稠密数据结果与查表法%s\n", config.name, consistent ? "一致" : "不一致");
+        all_passed &= assert_true(consistent, "稀疏计算结果与查表法一致");
+    }
+    
+    // 性能对比（仅打印）
+    crc_config_t config;
+    crc_table_t table = {0};
+    init_crc_config(&config, CRC_32);
+    generate_crc_table(&table, &config);
+    
+    memset(sparse, 0, data_size);
+    for (size_t i = 0; i < data_size; i += 4096) sparse[i] = 0x5A;
+    
+    clock_t start = clock();
+    uint32_t crc_table = calculate_crc_table(sparse, data_size, &config, &table);
+    double table_time = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000.0;
+    start = clock();
+    uint32_t crc_sparse = calculate_crc_sparse(sparse, data_size, &config, &table);
+    double sparse_time = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000.0;
+    printf("    稀疏1MB: 查表法 %.3f ms, 零串跳跃 %.3f ms\n", table_time, sparse_time);
+    all_passed &= assert_equal_uint32(crc_table, crc_sparse, "稀疏1MB数据CRC一致");
+    
+    start = clock();
+    calculate_crc_table(dense, data_size, &config, &table);
+    table_time = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000.0;
+    start = clock();
+    calculate_crc_sparse(dense, data_size, &config, &table);
+    sparse_time = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000.0;
+    printf("    随机1MB: 查表法 %.3f ms, 零串跳跃 %.3f ms\n", table_time, sparse_time);
+    
+    free(sparse);
+    free(dense);
+    return all_passed;
+}
+
+/* 测试18: CRC-32C计算引擎与CRC合并 */
+bool test_crc32c_engines_and_combine(void) {
+    bool all_passed = true;
+    
+    printf("  CRC-32C计算引擎与CRC合并测试:\n");
+    
+    crc_config_t config;
+    crc_table_t table = {0};
+    init_crc_config(&config, CRC_32C);
+    generate_crc_table(&table, &config);
+    
+    uint8_t check[] = "123456789";
+    all_passed &= assert_equal_uint32(0xE3069283, calculate_crc_table(check, 9, &config, &table),
+                                      "CRC-32C标准测试向量");
+    printf("    CRC-32C计算引擎: %s\n", crc_engine_name(table.engine));
+    
+    size_t data_size = 100000;
+    uint8_t* data = malloc(data_size);
+    if (data == NULL) return false;
+    srand(777);
+    for (size_t i = 0; i < data_size; i++) {
+        data[i] = (uint8_t)(rand() & 0xFF);
+    }
+    
+    // 快速引擎与逐字节查表结果一致（覆盖未对齐的起点和长度）
+    for (int type = CRC_32; type <= CRC_32C; type++) {
+        crc_config_t fast_config;
+        crc_table_t fast_table = {0};
+        init_crc_config(&fast_config, (crc_type_t)type);
+        generate_crc_table(&fast_table, &fast_config);
+        crc_table_t byte_table = fast_table;
+        byte_table.engine = CRC_ENGINE_TABLE;
+        
+        bool consistent = true;
+        for (size_t length = 1; length < 200; length += 13) {
+            for (size_t offset = 0; offset < 8; offset++) {
+                consistent &= calculate_crc_table(data + offset, length, &fast_config, &fast_table) ==
+                              calculate_crc_table(data + offset, length, &fast_config, &byte_table);
+            }
+        }
+        consistent &= calculate_crc_table(data, data_size, &fast_config, &fast_table) ==
+                      calculate_crc_table(data, data_size, &fast_config, &byte_table);
+        printf("    %s: %s 与逐字节查表%s\n", fast_config.name,
+               crc_engine_name(fast_table.engine), consistent ? "一致" : "不一致");
+        all_passed &= assert_true(consistent, "快速计算引擎结果正确");
+    }
+    
+    // CRC(AB) 可由 CRC(A)、CRC(B) 和 |B| 合并得到
+    for (int type = 0; type < CRC_TYPE_COUNT; type++) {
+        crc_config_t combine_config;
+        crc_table_t combine_table = {0};
+        init_crc_config(&combine_config, (crc_type_t)type);
+        generate_crc_table(&combine_table, &combine_config);
+        
+        size_t split = 12345;
+        uint32_t crc_a = calculate_crc_table(data, split, &combine_config, &combine_table);
+        uint32_t crc_b = calculate_crc_table(data + split, data_size - split,
+                                             &combine_config, &combine_table);
+        uint32_t combined = combine_crc(crc_a, crc_b, data_size - split,
+                                        &combine_config, &combine_table);
+        uint32_t whole = calculate_crc_table(data, data_size, &combine_config, &combine_table);
+        all_passed &= assert_equal_uint32(whole, combined, combine_config.name);
+    }
+    
+    free(data);
+    return all_passed;
+}
+
+/* 写入测试文件 */
+static bool write_test_file(const char* path, const uint8_t* data, size_t length) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+    bool ok = fwrite(data, 1, length, file) == length;
+    fclose(file);
+    return ok;
+}
+
+/* 测试19: 并行分块完整性清单 */
+bool test_integrity_manifest(void) {
+    bool all_passed = true;
+    
+    printf("  并行分块完整性清单测试:\n");
+    
+    char root[] = "/tmp/crc_manifest_test_XXXXXX";
+    if (mkdtemp(root) == NULL) {
+        printf("    无法创建临时目录\n");
+        return false;
+    }
+    
+    char path_a[256], path_b[256], path_empty[256], path_sub[256], manifest_path[256];
+    snprintf(path_a, sizeof(path_a), "%s/a.bin", root);
+    snprintf(path_sub, sizeof(path_sub), "%s/sub", root);
+    snprintf(path_b, sizeof(path_b), "%s/sub/b.bin", root);
+    snprintf(path_empty, sizeof(path_empty), "%s/empty", root);
+    snprintf(manifest_path, sizeof(manifest_path), "%s.manifest", root);
+    mkdir(path_sub, 0755);
+    
+    size_t size_a = 3 * 4096 + 7;
+    uint8_t data_a[3 * 4096 + 7];
+    uint8_t data_b[10000];
+    srand(4242);
+    for (size_t i = 0; i < sizeof(data_a); i++) data_a[i] = (uint8_t)(rand() & 0xFF);
+    for (size_t i = 0; i < sizeof(data_b); i++) data_b[i] = (uint8_t)(rand() & 0xFF);
+    write_test_file(path_a, data_a, size_a);
+    write_test_file(path_b, data_b, sizeof(data_b));
+    write_test_file(path_empty, data_a, 0);
+    
+    manifest_options_t options;
+    init_manifest_options(&options);
+    options.threads = 4;
+    options.block_size = 4096;
+    options.crc_type = CRC_32C;
+    
+    // 构建并写入清单，再读回比较
+    manifest_t manifest;
+    manifest_report_t report;
+    all_passed &= assert_true(build_manifest(root, &options, &manifest, &report), "构建清单成功");
+    all_passed &= assert_equal_uint32(3, (uint32_t)manifest.entry_count, "清单包含3个文件");
+    all_passed &= assert_equal_uint32(7, (uint32_t)report.blocks_hashed, "共计算7个分块");
+    
+    crc_config_t config;
+    crc_table_t table = {0};
+    init_crc_config(&config, CRC_32C);
+    generate_crc_table(&table, &config);
+    all_passed &= assert_true(strcmp(manifest.entries[0].path, "a.bin") == 0, "条目按路径排序");
+    all_passed &= assert_equal_uint32(calculate_crc_table(data_a, size_a, &config, &table),
+                                      manifest.entries[0].file_crc, "块CRC合并得到整个文件的CRC");
+    
+    all_passed &= assert_true(write_manifest(&manifest, manifest_path), "写入二进制清单");
+    manifest_t loaded;
+    all_passed &= assert_true(read_manifest(&loaded, manifest_path), "读取二进制清单");
+    bool same = loaded.entry_count == manifest.entry_count;
+    for (size_t i = 0; same && i < loaded.entry_count; i++) {
+        same = strcmp(loaded.entries[i].path, manifest.entries[i].path) == 0 &&
+               loaded.entries[i].file_crc == manifest.entries[i].file_crc &&
+               loaded.entries[i].block_count == manifest.entries[i].block_count &&
+               loaded.entries[i].mtime_nsec == manifest.entries[i].mtime_nsec;
+    }
+    all_passed &= assert_true(same, "读回的清单与原清单一致");
+    free_manifest(&manifest);
+    
+    // 未改动时增量校验全部跳过
+    all_passed &= assert_true(verify_manifest(root, &loaded, &options, &report), "未改动时校验通过");
+    all_passed &= assert_equal_uint32(3, (uint32_t)report.files_skipped, "大小/修改时间未变的文件全部跳过");
+    all_passed &= assert_equal_uint32(0, (uint32_t)report.bytes_hashed, "增量校验没有读取文件内容");
+    
+    // 静默损坏：修改一个字节并恢复修改时间
+    struct stat st;
+    stat(path_a, &st);
+    data_a[2 * 4096 + 5] ^= 0x10;
+    write_test_file(path_a, data_a, size_a);
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+    utimensat(AT_FDCWD, path_a, times, 0);
+    
+    options.full_verify = true;
+    all_passed &= assert_false(verify_manifest(root, &loaded, &options, &report), "完整校验发现损坏");
+    all_passed &= assert_equal_uint32(1, (uint32_t)report.files_corrupted, "定位到1个损坏文件");
+    all_passed &= assert_equal_uint32(1, (uint32_t)report.blocks_corrupted, "定位到1个损坏块");
+    
+    // 正常修改：文件变长，增量校验识别为已修改并更新清单
+    uint8_t extra[10010];
+    memcpy(extra, data_b, sizeof(data_b));
+    memset(extra + sizeof(data_b), 0x33, 10);
+    write_test_file(path_b, extra, sizeof(extra));
+    options.full_verify = false;
+    options.update = true;
+    verify_manifest(root, &loaded, &options, &report);
+    all_passed &= assert_equal_uint32(1, (uint32_t)report.files_modified, "识别出1个已修改文件");
+    all_passed &= assert_equal_uint32(1, (uint32_t)report.files_hashed, "只重新计算已修改的文件");
+    all_passed &= assert_true(loaded.entries[2].size == sizeof(extra), "清单条目已更新");
+    
+    options.update = false;
+    all_passed &= assert_true(verify_manifest(root, &loaded, &options, &report), "更新后增量校验通过");
+    all_passed &= assert_equal_uint32(3, (uint32_t)report.files_skipped, "更新后全部跳过");
+    print_manifest_report(&report);
+    
+    // 读取内容前文件被截断：清单条目的元数据与截断后的文件一致（模拟扫描与读取之间的竞争），
+    // 块数变少或为0时按已修改处理，不越界比较块CRC
+    size_t lengths[2] = {4096, 0};
+    for (int i = 0; i < 2; i++) {
+        write_test_file(path_a, data_a, lengths[i]);
+        stat(path_a, &st);
+        loaded.entries[0].size = (uint64_t)st.st_size;
+        loaded.entries[0].mtime_sec = (int64_t)st.st_mtim.tv_sec;
+        loaded.entries[0].mtime_nsec = (uint32_t)st.st_mtim.tv_nsec;
+        options.full_verify = true;
+        verify_manifest(root, &loaded, &options, &report);
+        all_passed &= assert_equal_uint32(1, (uint32_t)report.files_modified, "截断的文件识别为已修改");
+        all_passed &= assert_equal_uint32(0, (uint32_t)report.blocks_corrupted, "截断的文件不逐块比较");
+    }
+    
+    free_manifest(&loaded);
+    remove(path_a);
+    remove(path_b);
+    remove(path_empty);
+    remove(path_sub);
+    remove(root);
+    remove(manifest_path);
+    return all_passed;
+}
+
+/* 按小端序向缓冲区追加整数 */
+static size_t put_le16(uint8_t* buffer, size_t offset, uint16_t value) {
+    buffer[offset] = value & 0xFF;
+    buffer[offset + 1] = value >> 8;
+    return offset + 2;
+}
+
+static size_t put_le32(uint8_t* buffer, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) buffer[offset + i] = (value >> (8 * i)) & 0xFF;
+    return offset + 4;
+}
+
+/* 生成一个带FCS的以太网帧，返回含FCS的长度 */
+static uint32_t make_ethernet_frame(uint8_t* frame, uint32_t payload, const crc_config_t* config,
+                                    const crc_table_t* table) {
+    for (uint32_t i = 0; i < payload; i++) frame[i] = (uint8_t)(rand() & 0xFF);
+    put_le32(frame, payload, calculate_crc_table(frame, payload, config, table));
+    return payload + 4;
+}
+
+/* 追加pcapng增强包块 */
+static size_t put_epb(uint8_t* buffer, size_t offset, uint32_t interface,
+                      const uint8_t* frame, uint32_t length) {
+    uint32_t padded = (length + 3) & ~3u;
+    uint32_t total = 32 + padded;
+    offset = put_le32(buffer, offset, 6);
+    offset = put_le32(buffer, offset, total);
+    offset = put_le32(buffer, offset, interface);
+    offset = put_le32(buffer, offset, 0);
+    offset = put_le32(buffer, offset, 0);
+    offset = put_le32(buffer, offset, length);
+    offset = put_le32(buffer, offset, length);
+    memset(buffer + offset, 0, padded);
+    memcpy(buffer + offset, frame, length);
+    offset += padded;
+    return put_le32(buffer, offset, total);
+}
+
+/* 测试20: 抓包文件FCS校验 */
+bool test_capture_fcs_validation(void) {
+    bool all_passed = true;
+    
+    printf("  抓包文件FCS校验测试:\n");
+    
+    crc_config_t config;
+    crc_table_t table = {0};
+    init_crc_config(&config, CRC_32);
+    generate_crc_table(&table, &config);
+    srand(2024);
+    
+    // pcap: 以太网链路，F位声明4字节FCS；130帧（跨越多个批次），第2帧和第100帧损坏，第7帧被截断
+    size_t capacity = 130 * (16 + 1600) + 24;
+    uint8_t* capture = malloc(capacity);
+    if (capture == NULL) return false;
+    
+    size_t offset = 0;
+    offset = put_le32(capture, offset, 0xA1B2C3D4);
+    offset = put_le16(capture, offset, 2);
+    offset = put_le16(capture, offset, 4);
+    offset = put_le32(capture, offset, 0);
+    offset = put_le32(capture, offset, 0);
+    offset = put_le32(capture, offset, 65535);
+    offset = put_le32(capture, offset, 0x24000001);
+    for (int i = 1; i <= 130; i++) {
+        uint8_t frame[1600];
+        uint32_t length = make_ethernet_frame(frame, 60 + (uint32_t)(rand() % 1454), &config, &table);
+        if (i == 2 || i == 100) frame[length / 2] ^= 0x04;
+        uint32_t captured = (i == 7) ? length - 10 : length;
+        offset = put_le32(capture, offset, (uint32_t)i);
+        offset = put_le32(capture, offset, 0);
+        offset = put_le32(capture, offset, captured);
+        offset = put_le32(capture, offset, length);
+        memcpy(capture + offset, frame, captured);
+        offset += captured;
+    }
+    
+    fcs_report_t report;
+    init_fcs_report(&report);
+    all_passed &= assert_true(verify_capture_fcs_buffer(capture, offset, false, &report), "pcap解析成功");
+    all_passed &= assert_true(report.format == CAPTURE_FORMAT_PCAP, "识别为pcap格式");
+    all_passed &= assert_equal_uint32(130, (uint32_t)report.frames_total, "pcap帧总数");
+    all_passed &= assert_equal_uint32(1, (uint32_t)report.frames_skipped, "截断帧被跳过");
+    all_passed &= assert_equal_uint32(2, (uint32_t)report.frames_corrupted, "发现2个FCS错误");
+    all_passed &= assert_true(report.corrupted_frames[0] == 2 && report.corrupted_frames[1] == 100,
+                              "损坏帧号为2和100");
+    
+    // 通过mmap读取同一文件
+    char path[] = "/tmp/crc_fcs_test_XXXXXX";
+    int fd = mkstemp(path);
+    bool written = fd >= 0 && write(fd, capture, offset) == (ssize_t)offset;
+    if (fd >= 0) close(fd);
+    all_passed &= assert_true(written && verify_capture_fcs(path, false, &report), "mmap读取抓包文件");
+    all_passed &= assert_equal_uint32(2, (uint32_t)report.frames_corrupted, "mmap方式结果一致");
+    remove(path);
+    
+    // 未声明FCS的以太网抓包按不带FCS处理，不应报告错误；显式假定带FCS时照常校验
+    put_le32(capture, 20, 1);
+    all_passed &= assert_true(verify_capture_fcs_buffer(capture, offset, false, &report), "未声明FCS的pcap解析成功");
+    all_passed &= assert_equal_uint32(0, (uint32_t)report.frames_checked, "未声明FCS时不校验");
+    all_passed &= assert_equal_uint32(0, (uint32_t)report.frames_corrupted, "未声明FCS时无错误");
+    all_passed &= assert_equal_uint32(130, (uint32_t)report.frames_skipped, "未声明FCS的帧全部跳过");
+    verify_capture_fcs_buffer(capture, offset, true, &report);
+    all_passed &= assert_equal_uint32(2, (uint32_t)report.frames_corrupted, "假定带FCS时照常校验");
+    
+    // 非以太网链路（裸IP）即使声明了FCS也不校验
+    put_le32(capture, 20, 0x24000065);
+    verify_capture_fcs_buffer(capture, offset, true, &report);
+    all_passed &= assert_equal_uint32(0, (uint32_t)report.frames_checked, "非以太网链路不校验");
+    
+    // pcapng: 接口0声明 if_fcslen=4，接口1声明 if_fcslen=0
+    offset = 0;
+    offset = put_le32(capture, offset, 0x0A0D0D0A);
+    offset = put_le32(capture, offset, 28);
+    offset = put_le32(capture, offset, 0x1A2B3C4D);
+    offset = put_le16(capture, offset, 1);
+    offset = put_le16(capture, offset, 0);
+    offset = put_le32(capture, offset, 0xFFFFFFFF);
+    offset = put_le32(capture, offset, 0xFFFFFFFF);
+    offset = put_le32(capture, offset, 28);
+    
+    offset = put_le32(capture, offset, 1);
+    offset = put_le32(capture, offset, 32);
+    offset = put_le16(capture, offset, 1);
+    offset = put_le16(capture, offset, 0);
+    offset = put_le32(capture, offset, 65535);
+    offset = put_le16(capture, offset, 13);
+    offset = put_le16(capture, offset, 1);
+    offset = put_le32(capture, offset, 4);
+    offset = put_le32(capture, offset, 0);
+    offset = put_le32(capture, offset, 32);
+    
+    offset = put_le32(capture, offset, 1);
+    offset = put_le32(capture, offset, 32);
+    offset = put_le16(capture, offset, 1);
+    offset = put_le16(capture, offset, 0);
+    offset = put_le32(capture, offset, 65535);
+    offset = put_le16(capture, offset, 13);
+    offset = put_le16(capture, offset, 1);
+    offset = put_le32(capture, offset, 0);
+    offset = put_le32(capture, offset, 0);
+    offset = put_le32(capture, offset, 32);
+    
+    uint8_t frame[1600];
+    uint32_t length = make_ethernet_frame(frame, 61, &config, &table);
+    offset = put_epb(capture, offset, 0, frame, length);
+    length = make_ethernet_frame(frame, 200, &config, &table);
+    frame[3] ^= 0x80;
+    offset = put_epb(capture, offset, 0, frame, length);
+    length = make_ethernet_frame(frame, 100, &config, &table);
+    offset = put_epb(capture, offset, 1, frame, length);
+    
+    // 简单包块（隐含接口0）
+    length = make_ethernet_frame(frame, 75, &config, &table);
+    uint32_t total = 16 + ((length + 3) & ~3u);
+    offset = put_le32(capture, offset, 3);
+    offset = put_le32(capture, offset, total);
+    offset = put_le32(capture, offset, length);
+    memset(capture + offset, 0, (length + 3) & ~3u);
+    memcpy(capture + offset, frame, length);
+    offset += (length + 3) & ~3u;
+    offset = put_le32(capture, offset, total);
+    
+    all_passed &= assert_true(verify_capture_fcs_buffer(capture, offset, false, &report), "pcapng解析成功");
+    all_passed &= assert_true(report.format == CAPTURE_FORMAT_PCAPNG, "识别为pcapng格式");
+    all_passed &= assert_equal_uint32(4, (uint32_t)report.frames_total, "pcapng帧总数");
+    all_passed &= assert_equal_uint32(3, (uint32_t)report.frames_checked, "pcapng校验帧数");
+    all_passed &= assert_equal_uint32(1, (uint32_t)report.frames_skipped, "if_fcslen=0的接口被跳过");
+    all_passed &= assert_true(report.frames_corrupted == 1 && report.corrupted_frames[0] == 2,
+                              "pcapng损坏帧号为2");
+    print_fcs_report(&report, 10);
+    
+    // 截断的文件应报告错误
+    all_passed &= assert_false(verify_capture_fcs_buffer(capture, offset - 6, false, &report), "截断文件报告错误");
+    
+    free_fcs_report(&report);
+    free(capture);
+    return all_passed;
+}
+
+/* 读回文件全部内容并与期望数据比较 */
+static bool file_matches(const char* path, const uint8_t* expected, size_t length) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+    uint8_t* actual = malloc(length + 1);
+    size_t read_length = actual ? fread(actual, 1, length + 1, file) : 0;
+    fclose(file);
+    bool same = actual != NULL && read_length == length && memcmp(actual, expected, length) == 0;
+    free(actual);
+    return same;
+}
+
+/* 测试21: 流式CRC与管道透传过滤 */
+bool test_streaming_crc_filter(void) {
+    bool all_passed = true;
+    
+    printf("  流式CRC与管道透传过滤测试:\n");
+    
+    crc_config_t config;
+    crc_table_t table = {0};
+    init_crc_config(&config, CRC_32C);
+    generate_crc_table(&table, &config);
+    
+    // 管道默认容量64KB，测试数据小于该值，写端无需并发
+    size_t data_size = 60000;
+    uint8_t* data = malloc(data_size);
+    if (data == NULL) return false;
+    srand(99);
+    for (size_t i = 0; i < data_size; i++) data[i] = (uint8_t)(rand() & 0xFF);
+    uint32_t expected = calculate_crc_table(data, data_size, &config, &table);
+    
+    // 任意切分的流式计算与一次性计算一致
+    crc_context_t context;
+    all_passed &= assert_true(init_crc_context(&context, &config, &table), "初始化流式上下文");
+    for (size_t offset = 0; offset < data_size; ) {
+        size_t piece = (size_t)(rand() % 5000);
+        piece = CRC_MIN(piece, data_size - offset);
+        update_crc_context(&context, data + offset, piece);
+        offset += piece;
+    }
+    all_passed &= assert_equal_uint32(expected, finalize_crc_context(&context), "分段流式CRC");
+    
+    // 输入为管道：tee/splice 零拷贝路径
+    char out_path[] = "/tmp/crc_filter_out_XXXXXX";
+    int out_fd = mkstemp(out_path);
+    int input[2];
+    if (out_fd < 0 || pipe(input) != 0) {
+        free(data);
+        return false;
+    }
+    bool written = write(input[1], data, data_size) == (ssize_t)data_size;
+    close(input[1]);
+    
+    crc_filter_report_t report;
+    init_crc_context(&context, &config, &table);
+    all_passed &= assert_true(written && run_crc_filter(input[0], out_fd, &context, &report),
+                              "管道输入透传成功");
+    close(input[0]);
+    close(out_fd);
+    printf("    管道输入: %llu 字节, %s\n", (unsigned long long)report.bytes,
+           report.zero_copy ? "零拷贝(tee/splice)" : "缓冲读写");
+    all_passed &= assert_true(report.zero_copy, "管道输入使用零拷贝路径");
+    all_passed &= assert_equal_uint32(expected, finalize_crc_context(&context), "零拷贝路径CRC正确");
+    all_passed &= assert_true(file_matches(out_path, data, data_size), "输出数据与输入完全一致");
+    
+    // 输入为普通文件：回退到缓冲读写
+    char in_path[] = "/tmp/crc_filter_in_XXXXXX";
+    int in_fd = mkstemp(in_path);
+    out_fd = open(out_path, O_WRONLY | O_TRUNC);
+    written = in_fd >= 0 && write(in_fd, data, data_size) == (ssize_t)data_size;
+    if (in_fd >= 0) lseek(in_fd, 0, SEEK_SET);
+    
+    init_crc_context(&context, &config, &table);
+    all_passed &= assert_true(written && out_fd >= 0 && run_crc_filter(in_fd, out_fd, &context, &report),
+                              "文件输入透传成功");
+    if (in_fd >= 0) close(in_fd);
+    if (out_fd >= 0) close(out_fd);
+    all_passed &= assert_false(report.zero_copy, "文件输入回退到缓冲读写");
+    all_passed &= assert_equal_uint32(expected, finalize_crc_context(&context), "缓冲路径CRC正确");
+    all_passed &= assert_true(file_matches(out_path, data, data_size), "缓冲路径输出一致");
+    
+    remove(in_path);
+    remove(out_path);
+    free(data);
+    return all_passed;
+}
@@ -0,0 +1,161 @@
+#define _DEFAULT_SOURCE
+#include "crc32c.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define CRC32C_HAVE_SSE42 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define CRC32C_HAVE_ARMV8 1
+#endif
+
+#define CRC32C_POLY 0x82F63B78u     // 反射多项式
+
+/* ========== 查表法 ========== */
+
+static uint32_t crc32c_table[8][256];
+
+/**
+ * 生成 slicing-by-8 查表：table[k][b] 为字节 b 后面再跟 k 个零字节时的余数
+ */
+static void build_crc32c_table(void) {
+    for (int b = 0; b < 256; b++) {
+        uint32_t crc = (uint32_t)b;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        crc32c_table[0][b] = crc;
+    }
+    for (int b = 0; b < 256; b++) {
+        uint32_t crc = crc32c_table[0][b];
+        for (int k = 1; k < 8; k++) {
+            crc = (crc >> 8) ^ crc32c_table[0][crc & 0xff];
+            crc32c_table[k][b] = crc;
+        }
+    }
+}
+
+/**
+ * 查表法：按8字节一组处理，剩余字节逐个处理
+ */
+static uint32_t crc32c_software(uint32_t crc, const uint8_t* bytes, size_t length) {
+    while (length >= 8) {
+        uint32_t low = crc ^ ((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+                              ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+        crc = crc32c_table[7][low & 0xff] ^ crc32c_table[6][(low >> 8) & 0xff] ^
+              crc32c_table[5][(low >> 16) & 0xff] ^ crc32c_table[4][low >> 24] ^
+              crc32c_table[3][bytes[4]] ^ crc32c_table[2][bytes[5]] ^
+              crc32c_table[1][bytes[6]] ^ crc32c_table[0][bytes[7]];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *bytes++) & 0xff];
+    }
+    return crc;
+}
+
+/* ========== 硬件指令 ========== */
+
+#ifdef CRC32C_HAVE_SSE42
+/**
+ * SSE4.2 crc32 指令：每条指令处理8字节（只对本函数启用 SSE4.2，运行时检测后才会调用）
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* bytes, size_t length) {
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        bytes += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (length-- > 0) {
+        crc = _mm_crc32_u8(crc, *bytes++);
+    }
+    return crc;
+}
+#endif
+
+#ifdef CRC32C_HAVE_ARMV8
+/**
+ * ARMv8 crc32c 指令
+ */
+static uint32_t crc32c_armv8(uint32_t crc, const uint8_t* bytes, size_t length) {
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        crc = __crc32cd(crc, word);
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32cb(crc, *bytes++);
+    }
+    return crc;
+}
+#endif
+
+/* ========== 实现选择 ========== */
+
+typedef uint32_t (*crc32c_fn)(uint32_t crc, const uint8_t* bytes, size_t length);
+
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+static crc32c_fn crc32c_update = crc32c_software;
+static const char* crc32c_name = "slicing-by-8";
+
+/**
+ * 首次使用时生成查表并检测硬件支持（发送与接收线程可能同时调用，由 pthread_once 保证只执行一次）
+ */
+static void select_crc32c_implementation(void) {
+    build_crc32c_table();
+#ifdef CRC32C_HAVE_SSE42
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32c_update = crc32c_sse42;
+        crc32c_name = "SSE4.2";
+    }
+#endif
+#ifdef CRC32C_HAVE_ARMV8
+    crc32c_update = crc32c_armv8;
+    crc32c_name = "ARMv8";
+#endif
+}
+
+/**
+ * 增量计算 CRC-32C
+ * @param crc 之前的中间值（首次为 CRC32C_INIT）
+ * @param data 数据
+ * @param length 数据长度
+ * @return 新的中间值
+ */
+uint32_t update_crc32c(uint32_t crc, const void* data, size_t length) {
+    pthread_once(&crc32c_once, select_crc32c_implementation);
+    return crc32c_update(crc, (const uint8_t*)data, length);
+}
+
+/**
+ * 计算 CRC-32C
+ * @param data 数据
+ * @param length 数据长度
+ * @return 校验值
+ */
+uint32_t calculate_crc32c(const void* data, size_t length) {
+    return update_crc32c(CRC32C_INIT, data, length) ^ CRC32C_INIT;
+}
+
+/**
+ * 查询当前使用的实现
+ * @return 实现名称
+ */
+const char* crc32c_implementation(void) {
+    pthread_once(&crc32c_once, select_crc32c_implementation);
+    return crc32c_name;
+}
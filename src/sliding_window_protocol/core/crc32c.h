@@ -0,0 +1,23 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* CRC-32C（Castagnoli，反射多项式 0x82F63B78）
+ * 能发现所有奇数个比特错误、所有双比特错误以及长度不超过32的突发错误，
+ * 字节交换这类加法和发现不了的错误也能发现。
+ * x86-64 上支持 SSE4.2 时使用 crc32 指令，ARMv8 编译时启用 CRC 扩展则使用 crc32c 指令，
+ * 其余情况使用 slicing-by-8 查表法（每次处理8字节）。 */
+#define CRC32C_INIT 0xFFFFFFFFu     // 初始值（也是最终异或值）
+
+/* 计算一段数据的 CRC-32C */
+uint32_t calculate_crc32c(const void* data, size_t length);
+
+/* 增量计算：crc 从 CRC32C_INIT 开始，分段调用后与 CRC32C_INIT 异或得到结果 */
+uint32_t update_crc32c(uint32_t crc, const void* data, size_t length);
+
+/* 当前使用的实现（"SSE4.2"、"ARMv8" 或 "slicing-by-8"） */
+const char* crc32c_implementation(void);
+
+#endif // CRC32C_H
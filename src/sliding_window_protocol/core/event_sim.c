@@ -0,0 +1,139 @@
+#include "event_sim.h"
+
+#include <stdlib.h>
+
+/* ========== 堆操作 ========== */
+
+/**
+ * 比较两个事件的先后
+ * @return a 是否应先于 b 执行
+ */
+static bool event_before(const sim_event_t* a, const sim_event_t* b) {
+    if (a->time != b->time) return a->time < b->time;
+    return a->order < b->order;
+}
+
+/**
+ * 上浮：新事件插入堆尾后恢复堆序
+ */
+static void sift_up(sim_event_t* heap, size_t index) {
+    sim_event_t event = heap[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!event_before(&event, &heap[parent])) break;
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    heap[index] = event;
+}
+
+/**
+ * 下沉：堆顶被替换后恢复堆序
+ */
+static void sift_down(sim_event_t* heap, size_t count, size_t index) {
+    sim_event_t event = heap[index];
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= count) break;
+        if (child + 1 < count && event_before(&heap[child + 1], &heap[child])) child++;
+        if (!event_before(&heap[child], &event)) break;
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = event;
+}
+
+/* ========== 事件队列 ========== */
+
+/**
+ * 初始化事件队列
+ * @param queue 事件队列
+ * @param initial_capacity 初始容量（0 表示使用默认值）
+ * @return 是否成功
+ */
+bool init_event_queue(event_queue_t* queue, size_t initial_capacity) {
+    if (!queue) return false;
+
+    if (initial_capacity == 0) initial_capacity = EVENT_QUEUE_INITIAL_CAPACITY;
+    queue->heap = malloc(initial_capacity * sizeof(sim_event_t));
+    if (!queue->heap) return false;
+
+    queue->count = 0;
+    queue->capacity = initial_capacity;
+    queue->now = 0;
+    queue->next_order = 0;
+    queue->processed = 0;
+    return true;
+}
+
+/**
+ * 释放事件队列
+ * @param queue 事件队列
+ */
+void free_event_queue(event_queue_t* queue) {
+    if (!queue) return;
+
+    free(queue->heap);
+    queue->heap = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+}
+
+/**
+ * 调度一个事件
+ * @param queue 事件队列
+ * @param time 事件时刻（早于当前时刻时按当前时刻处理）
+ * @param type 事件类型
+ * @param arg 事件参数
+ * @return 是否成功
+ */
+bool schedule_event(event_queue_t* queue, double time, sim_event_type_t type, int arg) {
+    if (!queue) return false;
+
+    if (queue->count == queue->capacity) {
+        size_t capacity = queue->capacity * 2;
+        sim_event_t* heap = realloc(queue->heap, capacity * sizeof(sim_event_t));
+        if (!heap) return false;
+        queue->heap = heap;
+        queue->capacity = capacity;
+    }
+
+    sim_event_t* event = &queue->heap[queue->count];
+    event->time = time < queue->now ? queue->now : time;
+    event->order = queue->next_order++;
+    event->type = type;
+    event->arg = arg;
+    sift_up(queue->heap, queue->count++);
+    return true;
+}
+
+/**
+ * 取出最早的事件并推进虚拟时钟
+ * @param queue 事件队列
+ * @param event 输出的事件
+ * @return 队列是否非空
+ */
+bool pop_event(event_queue_t* queue, sim_event_t* event) {
+    if (!queue || !event || queue->count == 0) return false;
+
+    *event = queue->heap[0];
+    queue->heap[0] = queue->heap[--queue->count];
+    if (queue->count > 0) sift_down(queue->heap, queue->count, 0);
+
+    queue->now = event->time;
+    queue->processed++;
+    return true;
+}
+
+/**
+ * 查看最早事件的时刻
+ * @param queue 事件队列
+ * @param time 输出的时刻
+ * @return 队列是否非空
+ */
+bool peek_event_time(const event_queue_t* queue, double* time) {
+    if (!queue || !time || queue->count == 0) return false;
+
+    *time = queue->heap[0].time;
+    return true;
+}
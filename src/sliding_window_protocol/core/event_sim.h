@@ -0,0 +1,48 @@
+#ifndef EVENT_SIM_H
+#define EVENT_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 常量定义 */
+#define EVENT_QUEUE_INITIAL_CAPACITY 256   // 事件堆的初始容量
+
+/* 仿真事件类型（重传计时器由 timing_wheel 管理，不进入事件堆） */
+typedef enum {
+    EVENT_DATA_ARRIVAL,     // 数据帧到达接收方
+    EVENT_ACK_ARRIVAL       // 确认帧到达发送方
+} sim_event_type_t;
+
+/* 仿真事件 */
+typedef struct {
+    double time;            // 事件发生的虚拟时刻（毫秒）
+    uint64_t order;         // 调度序号：同一时刻的事件按调度先后执行
+    sim_event_type_t type;  // 事件类型
+    int arg;                // 事件参数（如帧号）
+} sim_event_t;
+
+/* 事件队列：按 (time, order) 排序的二叉最小堆，附带虚拟时钟 */
+typedef struct {
+    sim_event_t* heap;      // 堆数组
+    size_t count;           // 待处理事件数
+    size_t capacity;        // 堆容量
+    double now;             // 当前虚拟时刻（毫秒）
+    uint64_t next_order;    // 下一个调度序号
+    uint64_t processed;     // 已处理的事件数
+} event_queue_t;
+
+/* 初始化与释放 */
+bool init_event_queue(event_queue_t* queue, size_t initial_capacity);
+void free_event_queue(event_queue_t* queue);
+
+/* 事件调度：time 不得早于当前虚拟时刻 */
+bool schedule_event(event_queue_t* queue, double time, sim_event_type_t type, int arg);
+
+/* 取出最早的事件并把虚拟时钟推进到该事件的时刻 */
+bool pop_event(event_queue_t* queue, sim_event_t* event);
+
+/* 查看最早事件的时刻（不取出） */
+bool peek_event_time(const event_queue_t* queue, double* time);
+
+#endif // EVENT_SIM_H
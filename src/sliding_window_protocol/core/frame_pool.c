@@ -0,0 +1,101 @@
+#include "frame_pool.h"
+
+/**
+ * 初始化帧池
+ * @param pool 帧池
+ * @param capacity 帧数
+ * @return 是否成功
+ */
+bool init_frame_pool(frame_pool_t* pool, int capacity) {
+    if (!pool || capacity < 1) return false;
+
+    pool->frames = malloc(sizeof(data_frame_t) * (size_t)capacity);
+    pool->refcounts = calloc((size_t)capacity, sizeof(int));
+    pool->free_frames = malloc(sizeof(int) * (size_t)capacity);
+    if (!pool->frames || !pool->refcounts || !pool->free_frames) {
+        free_frame_pool(pool);
+        return false;
+    }
+
+    // 栈顶为0号帧：先用低地址的帧
+    for (int i = 0; i < capacity; i++) {
+        pool->free_frames[i] = capacity - 1 - i;
+    }
+    pool->free_count = capacity;
+    pool->capacity = capacity;
+    pool->peak_in_use = 0;
+    return true;
+}
+
+/**
+ * 释放帧池（所有句柄随之失效）
+ * @param pool 帧池
+ */
+void free_frame_pool(frame_pool_t* pool) {
+    if (!pool) return;
+
+    free(pool->frames);
+    free(pool->refcounts);
+    free(pool->free_frames);
+    pool->frames = NULL;
+    pool->refcounts = NULL;
+    pool->free_frames = NULL;
+    pool->free_count = 0;
+    pool->capacity = 0;
+}
+
+/**
+ * 取一个空闲帧
+ * @param pool 帧池
+ * @return 句柄（引用计数为1），帧池耗尽时返回 FRAME_NONE
+ */
+int acquire_frame(frame_pool_t* pool) {
+    if (pool->free_count == 0) return FRAME_NONE;
+
+    int handle = pool->free_frames[--pool->free_count];
+    pool->refcounts[handle] = 1;
+    int in_use = pool->capacity - pool->free_count;
+    if (in_use > pool->peak_in_use) pool->peak_in_use = in_use;
+    return handle;
+}
+
+/**
+ * 增加一个引用
+ * @param pool 帧池
+ * @param handle 句柄
+ */
+void retain_frame(frame_pool_t* pool, int handle) {
+    if (handle == FRAME_NONE) return;
+    pool->refcounts[handle]++;
+}
+
+/**
+ * 减少一个引用，最后一个引用释放时帧回到空闲栈
+ * @param pool 帧池
+ * @param handle 句柄
+ */
+void release_frame(frame_pool_t* pool, int handle) {
+    if (handle == FRAME_NONE) return;
+    if (--pool->refcounts[handle] == 0) {
+        pool->free_frames[pool->free_count++] = handle;
+    }
+}
+
+/**
+ * 句柄对应的帧
+ * @param pool 帧池
+ * @param handle 句柄（不得为 FRAME_NONE）
+ * @return 帧
+ */
+data_frame_t* frame_at(const frame_pool_t* pool, int handle) {
+    return &pool->frames[handle];
+}
+
+/**
+ * 在用帧数
+ * @param pool 帧池
+ * @return 引用计数不为0的帧数
+ */
+int frames_in_use(const frame_pool_t* pool) {
+    return pool->capacity - pool->free_count;
+}
@@ -0,0 +1,36 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include "sliding_window.h"
+
+/* 常量定义 */
+#define FRAME_NONE -1           // 空句柄
+
+/* 预分配的数据帧池：帧以句柄（数组下标）在发送窗口、信道与接收缓冲区之间传递，
+ * 各处持有引用而不复制帧；引用计数归零时帧回到空闲栈。
+ * 载荷只在进入帧池时写入一次，之后只读（线路损坏等需要修改时先复制出私有副本） */
+typedef struct {
+    data_frame_t* frames;       // 帧数组
+    int* refcounts;             // 各帧的引用计数（0 表示空闲）
+    int* free_frames;           // 空闲帧栈
+    int free_count;
+    int capacity;
+    int peak_in_use;            // 同时在用帧数的峰值
+} frame_pool_t;
+
+/* 初始化与释放（一次分配全部帧，之后不再分配内存） */
+bool init_frame_pool(frame_pool_t* pool, int capacity);
+void free_frame_pool(frame_pool_t* pool);
+
+/* 取一个空闲帧（引用计数为1），帧池耗尽时返回 FRAME_NONE */
+int acquire_frame(frame_pool_t* pool);
+
+/* 增加 / 减少一个引用（FRAME_NONE 时无操作），减到0时帧回到空闲栈 */
+void retain_frame(frame_pool_t* pool, int handle);
+void release_frame(frame_pool_t* pool, int handle);
+
+/* 句柄对应的帧与在用帧数 */
+data_frame_t* frame_at(const frame_pool_t* pool, int handle);
+int frames_in_use(const frame_pool_t* pool);
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,354 @@
+#define _DEFAULT_SOURCE
+#include "parameter_sweep.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* 一次重复的结果 */
+typedef struct {
+    bool success;
+    double goodput_bps;
+    double efficiency;
+    int retransmissions;
+    int acks;
+    double acks_per_frame;
+} sweep_sample_t;
+
+/* 工作线程共享的任务表：任务号 = 格号 × 重复次数 + 重复序号 */
+typedef struct {
+    const sweep_config_t* sweep;
+    const sweep_cell_t* cells;
+    sweep_sample_t* samples;
+    int total;
+    int next;                   // 下一个未领取的任务
+    pthread_mutex_t lock;
+} sweep_work_t;
+
+/**
+ * 初始化参数网格（默认配置）
+ * @param sweep 参数网格
+ */
+void init_sweep_config(sweep_config_t* sweep) {
+    if (!sweep) return;
+
+    memset(sweep, 0, sizeof(sweep_config_t));
+    sweep->losses[0] = 0.0;
+    sweep->losses[1] = 0.05;
+    sweep->losses[2] = 0.1;
+    sweep->losses[3] = 0.2;
+    sweep->loss_count = 4;
+    sweep->delays[0].min_ms = 10;
+    sweep->delays[0].max_ms = 50;
+    sweep->delays[1].min_ms = 50;
+    sweep->delays[1].max_ms = 200;
+    sweep->delay_count = 2;
+    sweep->windows[0] = 1;
+    sweep->windows[1] = 4;
+    sweep->windows[2] = 8;
+    sweep->windows[3] = 16;
+    sweep->window_count = 4;
+    sweep->modes[0] = ARQ_STOP_AND_WAIT;
+    sweep->modes[1] = ARQ_GO_BACK_N;
+    sweep->modes[2] = ARQ_SELECTIVE_REPEAT;
+    sweep->mode_count = 3;
+    sweep->ack_every[0] = 1;
+    sweep->ack_count = 1;
+    sweep->ack_delay_ms = ARQ_ACK_DELAY_MS;
+    sweep->replications = SWEEP_DEFAULT_REPLICATIONS;
+    sweep->message_length = SWEEP_DEFAULT_LENGTH;
+    sweep->payload_size = ARQ_DEFAULT_PAYLOAD;
+    sweep->threads = 0;
+    sweep->seed = 1;
+}
+
+/**
+ * 某模式下实际使用的窗口取值个数（停等协议只有窗口1）
+ */
+static int mode_window_count(const sweep_config_t* sweep, arq_mode_t mode) {
+    return mode == ARQ_STOP_AND_WAIT ? 1 : sweep->window_count;
+}
+
+/**
+ * 计算网格的格数
+ * @param sweep 参数网格
+ * @return 格数
+ */
+int count_sweep_cells(const sweep_config_t* sweep) {
+    if (!sweep) return 0;
+
+    int windows = 0;
+    for (int m = 0; m < sweep->mode_count; m++) {
+        windows += mode_window_count(sweep, sweep->modes[m]);
+    }
+    return windows * sweep->ack_count * sweep->loss_count * sweep->delay_count;
+}
+
+/**
+ * 检查参数网格
+ * @param sweep 参数网格
+ * @return 是否有效
+ */
+static bool validate_sweep_config(const sweep_config_t* sweep) {
+    if (sweep->loss_count < 1 || sweep->loss_count > SWEEP_MAX_VALUES ||
+        sweep->delay_count < 1 || sweep->delay_count > SWEEP_MAX_VALUES ||
+        sweep->window_count < 1 || sweep->window_count > SWEEP_MAX_VALUES ||
+        sweep->ack_count < 1 || sweep->ack_count > SWEEP_MAX_VALUES ||
+        sweep->mode_count < 1 || sweep->mode_count > 3) {
+        fprintf(stderr, "[错误] 每个维度需要 1-%d 个取值\n", SWEEP_MAX_VALUES);
+        return false;
+    }
+    if (sweep->replications < 1 || sweep->message_length == 0) {
+        fprintf(stderr, "[错误] 重复次数与传输字节数必须为正数\n");
+        return false;
+    }
+    for (int i = 0; i < sweep->loss_count; i++) {
+        if (sweep->losses[i] < 0.0 || sweep->losses[i] >= 1.0) {
+            fprintf(stderr, "[错误] 丢包率必须在 [0, 1) 之间\n");
+            return false;
+        }
+    }
+    for (int i = 0; i < sweep->delay_count; i++) {
+        if (sweep->delays[i].min_ms < 0 || sweep->delays[i].max_ms < sweep->delays[i].min_ms) {
+            fprintf(stderr, "[错误] 时延范围无效 (%d-%d)\n", sweep->delays[i].min_ms, sweep->delays[i].max_ms);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 由格的参数构造网络与窗口协议配置（不调用 init_*，避免在工作线程中输出）
+ */
+static void build_cell_configs(const sweep_config_t* sweep, const sweep_cell_t* cell,
+                               network_config_t* config, arq_config_t* arq) {
+    memset(config, 0, sizeof(network_config_t));
+    config->loss_probability = cell->loss_probability;
+    config->min_delay_ms = cell->delay.min_ms;
+    config->max_delay_ms = cell->delay.max_ms;
+    config->corruption_bits = 1;
+
+    memset(arq, 0, sizeof(arq_config_t));
+    arq->mode = cell->mode;
+    arq->window_size = cell->window_size;
+    arq->seq_space = (cell->mode == ARQ_SELECTIVE_REPEAT) ? 2 * cell->window_size : cell->window_size + 1;
+    arq->payload_size = sweep->payload_size;
+    arq->timeout_ms = TIMEOUT_MS;
+    arq->max_retries = ARQ_MAX_RETRIES;
+    arq->adaptive_rto = true;
+    arq->min_rto_ms = RTO_MIN_MS;
+    arq->max_rto_ms = RTO_MAX_MS;
+    arq->ack_every = cell->ack_every;
+    arq->ack_delay_ms = sweep->ack_delay_ms;
+}
+
+/**
+ * 由基础种子与任务号导出互不相关的种子（splitmix32 混合）
+ */
+static uint32_t replication_seed(uint32_t seed, int task) {
+    uint32_t x = seed + 0x9E3779B9u * (uint32_t)(task + 1);
+    x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+    x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+    return x ^ (x >> 16);
+}
+
+/**
+ * 工作线程：领取任务直到任务表取完
+ * @param argument 共享的任务表
+ * @return NULL
+ */
+static void* sweep_worker(void* argument) {
+    sweep_work_t* work = (sweep_work_t*)argument;
+    const sweep_config_t* sweep = work->sweep;
+
+    while (1) {
+        pthread_mutex_lock(&work->lock);
+        int task = work->next++;
+        pthread_mutex_unlock(&work->lock);
+        if (task >= work->total) break;
+
+        const sweep_cell_t* cell = &work->cells[task / sweep->replications];
+        network_config_t config;
+        arq_config_t arq;
+        build_cell_configs(sweep, cell, &config, &arq);
+
+        statistics_t stats;
+        memset(&stats, 0, sizeof(stats));
+        sweep_sample_t* sample = &work->samples[task];
+        sample->success = simulate_arq_transfer(sweep->message_length, &config, &arq,
+                                                replication_seed(sweep->seed, task), &stats);
+        sample->goodput_bps = stats.goodput_bps;
+        sample->efficiency = stats.wire_bytes > 0 ? (double)stats.bytes_delivered / stats.wire_bytes : 0.0;
+        sample->retransmissions = stats.retransmissions;
+        sample->acks = stats.acks_sent;
+        sample->acks_per_frame = stats.frames_received > 0 ? (double)stats.acks_sent / stats.frames_received : 0.0;
+    }
+    return NULL;
+}
+
+/**
+ * 双侧95%置信水平的 t 分布临界值
+ * @param df 自由度
+ * @return 临界值（自由度超过30时用 1.96 + 2.5/df 近似）
+ */
+static double t_critical_95(int df) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df < 1) return 0.0;
+    if (df <= 30) return table[df - 1];
+    return 1.96 + 2.5 / df;
+}
+
+/**
+ * 计算均值与95%置信区间半宽 t·s/√n（样本数不足2时半宽为0）
+ * @param values 样本
+ * @param count 样本数
+ * @param ci95 输出的半宽
+ * @return 均值
+ */
+static double mean_with_ci95(const double* values, int count, double* ci95) {
+    *ci95 = 0.0;
+    if (count == 0) return 0.0;
+
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += values[i];
+    double mean = sum / count;
+    if (count < 2) return mean;
+
+    double squares = 0.0;
+    for (int i = 0; i < count; i++) squares += (values[i] - mean) * (values[i] - mean);
+    *ci95 = t_critical_95(count - 1) * sqrt(squares / (count - 1)) / sqrt((double)count);
+    return mean;
+}
+
+/**
+ * 汇总一格的全部重复
+ * @param cell 格
+ * @param samples 该格的样本（replications 个）
+ * @param scratch 临时数组（至少 replications 个）
+ */
+static void summarize_cell(sweep_cell_t* cell, const sweep_sample_t* samples, double* scratch) {
+    int successes = 0;
+    double retransmissions = 0.0, acks = 0.0, acks_per_frame = 0.0;
+    for (int i = 0; i < cell->replications; i++) {
+        if (!samples[i].success) continue;
+        scratch[successes++] = samples[i].goodput_bps;
+        retransmissions += samples[i].retransmissions;
+        acks += samples[i].acks;
+        acks_per_frame += samples[i].acks_per_frame;
+    }
+    cell->successes = successes;
+    cell->goodput_mean = mean_with_ci95(scratch, successes, &cell->goodput_ci95);
+    cell->retransmissions_mean = successes > 0 ? retransmissions / successes : 0.0;
+    cell->acks_mean = successes > 0 ? acks / successes : 0.0;
+    cell->acks_per_frame_mean = successes > 0 ? acks_per_frame / successes : 0.0;
+
+    successes = 0;
+    for (int i = 0; i < cell->replications; i++) {
+        if (samples[i].success) scratch[successes++] = samples[i].efficiency;
+    }
+    cell->efficiency_mean = mean_with_ci95(scratch, successes, &cell->efficiency_ci95);
+}
+
+/**
+ * 运行参数扫描：所有格的所有重复作为独立任务分给工作线程，
+ * 每个任务的信道随机数只由基础种子与任务号决定
+ * @param sweep 参数网格
+ * @param cells 输出的各格结果
+ * @return 是否完成（配置无效或内存不足时返回 false）
+ */
+bool run_parameter_sweep(const sweep_config_t* sweep, sweep_cell_t* cells) {
+    if (!sweep || !cells || !validate_sweep_config(sweep)) return false;
+
+    // 展开网格
+    int count = 0;
+    for (int m = 0; m < sweep->mode_count; m++) {
+        for (int w = 0; w < mode_window_count(sweep, sweep->modes[m]); w++) {
+            for (int a = 0; a < sweep->ack_count; a++) {
+                for (int l = 0; l < sweep->loss_count; l++) {
+                    for (int d = 0; d < sweep->delay_count; d++) {
+                        sweep_cell_t* cell = &cells[count++];
+                        memset(cell, 0, sizeof(sweep_cell_t));
+                        cell->mode = sweep->modes[m];
+                        cell->window_size = (cell->mode == ARQ_STOP_AND_WAIT) ? 1 : sweep->windows[w];
+                        cell->ack_every = sweep->ack_every[a];
+                        cell->loss_probability = sweep->losses[l];
+                        cell->delay = sweep->delays[d];
+                        cell->replications = sweep->replications;
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        arq_config_t arq;
+        network_config_t config;
+        build_cell_configs(sweep, &cells[i], &config, &arq);
+        if (!validate_arq_config(&arq)) return false;
+    }
+
+    sweep_work_t work;
+    work.sweep = sweep;
+    work.cells = cells;
+    work.total = count * sweep->replications;
+    work.next = 0;
+    work.samples = calloc((size_t)work.total, sizeof(sweep_sample_t));
+    double* scratch = malloc(sizeof(double) * (size_t)sweep->replications);
+    int threads = sweep->threads > 0 ? sweep->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+    if (threads > work.total) threads = work.total;
+    pthread_t* workers = malloc(sizeof(pthread_t) * (size_t)threads);
+    if (!work.samples || !scratch || !workers) {
+        free(work.samples);
+        free(scratch);
+        free(workers);
+        return false;
+    }
+    pthread_mutex_init(&work.lock, NULL);
+
+    // 线程创建失败时由已创建的线程（或当前线程）完成剩余任务
+    int started = 0;
+    while (started < threads && pthread_create(&workers[started], NULL, sweep_worker, &work) == 0) {
+        started++;
+    }
+    if (started == 0) sweep_worker(&work);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    pthread_mutex_destroy(&work.lock);
+
+    for (int i = 0; i < count; i++) {
+        summarize_cell(&cells[i], &work.samples[i * sweep->replications], scratch);
+    }
+
+    free(workers);
+    free(scratch);
+    free(work.samples);
+    return true;
+}
+
+/**
+ * 以CSV格式输出扫描结果（吞吐量单位 kbit/s）。
+ * 确认间隔不同而其余参数相同的行对比，即为延迟确认省去的确认帧与吞吐量的代价
+ * @param output 输出文件
+ * @param cells 各格结果
+ * @param count 格数
+ */
+void write_sweep_csv(FILE* output, const sweep_cell_t* cells, int count) {
+    if (!output || !cells) return;
+
+    fprintf(output, "mode,window,ack_every,loss,min_delay_ms,max_delay_ms,replications,successes,"
+                    "goodput_kbps_mean,goodput_kbps_ci95,efficiency_mean,efficiency_ci95,"
+                    "retransmissions_mean,acks_mean,acks_per_frame_mean\n");
+    static const char* mode_keys[] = {"saw", "gbn", "sr"};
+    for (int i = 0; i < count; i++) {
+        const sweep_cell_t* cell = &cells[i];
+        fprintf(output, "%s,%d,%d,%.4f,%d,%d,%d,%d,%.3f,%.3f,%.4f,%.4f,%.2f,%.2f,%.4f\n",
+                mode_keys[cell->mode], cell->window_size, cell->ack_every, cell->loss_probability,
+                cell->delay.min_ms, cell->delay.max_ms, cell->replications, cell->successes,
+                cell->goodput_mean / 1000.0, cell->goodput_ci95 / 1000.0,
+                cell->efficiency_mean, cell->efficiency_ci95, cell->retransmissions_mean,
+                cell->acks_mean, cell->acks_per_frame_mean);
+    }
+}
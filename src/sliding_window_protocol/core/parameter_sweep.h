@@ -0,0 +1,67 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <stdio.h>
+#include "sliding_window.h"
+
+/* 常量定义 */
+#define SWEEP_MAX_VALUES 16             // 每个维度最多的取值个数
+#define SWEEP_DEFAULT_REPLICATIONS 10   // 默认每格重复次数
+#define SWEEP_DEFAULT_LENGTH 16384      // 默认每次传输的字节数
+
+/* 时延范围 */
+typedef struct {
+    int min_ms;
+    int max_ms;
+} delay_range_t;
+
+/* 参数网格：丢包率 × 时延范围 × 窗口大小 × 协议模式 × 确认间隔，每格独立重复 replications 次。
+ * 停等协议的窗口固定为1，只占一列 */
+typedef struct {
+    double losses[SWEEP_MAX_VALUES];
+    int loss_count;
+    delay_range_t delays[SWEEP_MAX_VALUES];
+    int delay_count;
+    int windows[SWEEP_MAX_VALUES];
+    int window_count;
+    arq_mode_t modes[3];
+    int mode_count;
+    int ack_every[SWEEP_MAX_VALUES];    // 延迟确认：每 k 帧确认一次（1 为逐帧确认）
+    int ack_count;
+    int ack_delay_ms;           // 延迟确认的最长等待时间（毫秒）
+    int replications;           // 每格的重复次数（至少2次才能给出置信区间）
+    size_t message_length;      // 每次传输的字节数
+    int payload_size;           // 每帧携带的数据字节数
+    int threads;                // 工作线程数（0 表示使用全部在线CPU）
+    uint32_t seed;              // 基础随机种子：同一种子下结果与线程数无关
+} sweep_config_t;
+
+/* 一格的汇总结果（均值与95%置信区间半宽只统计成功的重复） */
+typedef struct {
+    arq_mode_t mode;
+    int window_size;
+    int ack_every;
+    double loss_probability;
+    delay_range_t delay;
+    int replications;
+    int successes;
+    double goodput_mean;        // 有效吞吐量（比特/秒）
+    double goodput_ci95;
+    double efficiency_mean;     // 信道效率：交付的数据字节 / 线路上承载的全部字节
+    double efficiency_ci95;
+    double retransmissions_mean;
+    double acks_mean;           // 接收方发出的确认帧数
+    double acks_per_frame_mean; // 平均每个到达的数据帧引出的确认帧数（逐帧确认时约为1）
+} sweep_cell_t;
+
+/* 配置 */
+void init_sweep_config(sweep_config_t* sweep);
+int count_sweep_cells(const sweep_config_t* sweep);
+
+/* 运行：结果按 模式、窗口、确认间隔、丢包率、时延 的顺序写入 cells（容量至少 count_sweep_cells 个） */
+bool run_parameter_sweep(const sweep_config_t* sweep, sweep_cell_t* cells);
+
+/* 输出 */
+void write_sweep_csv(FILE* output, const sweep_cell_t* cells, int count);
+
+#endif // PARAMETER_SWEEP_H
@@ -0,0 +1,195 @@
+#include "pcapng_writer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* pcapng 块类型与字段（按本机字节序写入，读取方由节头块的字节序标记判断） */
+#define PCAPNG_SECTION_HEADER 0x0A0D0D0Au
+#define PCAPNG_INTERFACE_DESCRIPTION 0x00000001u
+#define PCAPNG_ENHANCED_PACKET 0x00000006u
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4Du
+#define PCAPNG_SNAPLEN 65535
+#define PCAPNG_PACKET_OVERHEAD 32           // 增强报文块除数据外的字节数
+#define PCAPNG_PAD4(n) (((n) + 3) & ~(size_t)3)
+
+static void put_u16(uint8_t* out, uint16_t value) {
+    memcpy(out, &value, sizeof(value));
+}
+
+static void put_u32(uint8_t* out, uint32_t value) {
+    memcpy(out, &value, sizeof(value));
+}
+
+/* IPv4/UDP 报头字段为网络字节序 */
+static void put_be16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)(value >> 8);
+    out[1] = (uint8_t)value;
+}
+
+static void put_be32(uint8_t* out, uint32_t value) {
+    put_be16(out, (uint16_t)(value >> 16));
+    put_be16(out + 2, (uint16_t)value);
+}
+
+/**
+ * 为下一个块预留缓冲区空间，不足时先把缓冲区写入文件
+ * @param writer 写入器
+ * @param length 块长度（不超过缓冲区大小）
+ * @return 块在缓冲区中的起始位置，写文件出错时返回NULL
+ */
+static uint8_t* reserve_pcapng_block(pcapng_writer_t* writer, size_t length) {
+    if (writer->failed || length > PCAPNG_BUFFER_SIZE) return NULL;
+    if (writer->used + length > PCAPNG_BUFFER_SIZE && !flush_pcapng_writer(writer)) return NULL;
+    uint8_t* block = writer->buffer + writer->used;
+    writer->used += length;
+    writer->file_bytes += (long long)length;
+    return block;
+}
+
+/**
+ * 创建抓包文件，写入节头块与接口描述块（链路类型为裸IP，时间戳精度取默认的微秒）
+ * @param writer 写入器
+ * @param path 文件路径
+ * @return 是否成功
+ */
+bool open_pcapng_writer(pcapng_writer_t* writer, const char* path) {
+    if (!writer || !path) return false;
+    memset(writer, 0, sizeof(pcapng_writer_t));
+    writer->buffer = malloc(PCAPNG_BUFFER_SIZE);
+    writer->file = writer->buffer ? fopen(path, "wb") : NULL;
+    if (!writer->file) {
+        printf("[错误] 无法创建抓包文件 %s\n", path);
+        free(writer->buffer);
+        writer->buffer = NULL;
+        return false;
+    }
+
+    uint8_t* block = reserve_pcapng_block(writer, 28);
+    put_u32(block, PCAPNG_SECTION_HEADER);
+    put_u32(block + 4, 28);
+    put_u32(block + 8, PCAPNG_BYTE_ORDER_MAGIC);
+    put_u16(block + 12, 1);                 // 版本 1.0
+    put_u16(block + 14, 0);
+    put_u32(block + 16, 0xFFFFFFFFu);       // 节长度未知（-1）
+    put_u32(block + 20, 0xFFFFFFFFu);
+    put_u32(block + 24, 28);
+
+    block = reserve_pcapng_block(writer, 20);
+    put_u32(block, PCAPNG_INTERFACE_DESCRIPTION);
+    put_u32(block + 4, 20);
+    put_u16(block + 8, PCAPNG_LINKTYPE_RAW);
+    put_u16(block + 10, 0);
+    put_u32(block + 12, PCAPNG_SNAPLEN);
+    put_u32(block + 16, 20);
+    return true;
+}
+
+/**
+ * 计算IPv4报头校验和
+ * @param header 报头（校验和字段为0）
+ * @return 校验和
+ */
+static uint16_t calculate_ipv4_checksum(const uint8_t* header) {
+    uint32_t sum = 0;
+    for (int i = 0; i < PCAPNG_IP_HEADER; i += 2) {
+        sum += (uint32_t)header[i] << 8 | header[i + 1];
+    }
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+/**
+ * 写入一个报文：报文作为UDP载荷，前面加上合成的IPv4与UDP报头，整体写成一个增强报文块。
+ * UDP校验和填0（IPv4下表示不校验），协议自身的尾部校验和仍在报文中
+ * @param writer 写入器
+ * @param time_ms 时间戳（毫秒，仿真中为虚拟时刻）
+ * @param forward 是否 A→B 方向
+ * @param packet 报文
+ * @param length 报文长度
+ * @return 是否写入（写文件出错或报文过长时返回 false）
+ */
+bool write_pcapng_packet(pcapng_writer_t* writer, double time_ms, bool forward,
+                         const uint8_t* packet, size_t length) {
+    if (!writer || !writer->file || !packet) return false;
+    size_t captured = PCAPNG_IP_HEADER + PCAPNG_UDP_HEADER + length;
+    if (captured > PCAPNG_SNAPLEN) return false;
+    size_t block_length = PCAPNG_PACKET_OVERHEAD + PCAPNG_PAD4(captured);
+    uint8_t* block = reserve_pcapng_block(writer, block_length);
+    if (!block) return false;
+
+    uint64_t timestamp = time_ms > 0.0 ? (uint64_t)(time_ms * 1000.0 + 0.5) : 0;
+    put_u32(block, PCAPNG_ENHANCED_PACKET);
+    put_u32(block + 4, (uint32_t)block_length);
+    put_u32(block + 8, 0);                  // 接口编号
+    put_u32(block + 12, (uint32_t)(timestamp >> 32));
+    put_u32(block + 16, (uint32_t)timestamp);
+    put_u32(block + 20, (uint32_t)captured);
+    put_u32(block + 24, (uint32_t)captured);
+
+    uint8_t* ip = block + 28;
+    memset(ip, 0, PCAPNG_IP_HEADER);
+    ip[0] = 0x45;                           // 版本4，报头20字节
+    put_be16(ip + 2, (uint16_t)captured);
+    put_be16(ip + 4, writer->ip_id++);
+    put_be16(ip + 6, 0x4000);               // 不分片
+    ip[8] = 64;                             // TTL
+    ip[9] = 17;                             // UDP
+    put_be32(ip + 12, forward ? PCAPNG_ADDRESS_A : PCAPNG_ADDRESS_B);
+    put_be32(ip + 16, forward ? PCAPNG_ADDRESS_B : PCAPNG_ADDRESS_A);
+    put_be16(ip + 10, calculate_ipv4_checksum(ip));
+
+    uint8_t* udp = ip + PCAPNG_IP_HEADER;
+    put_be16(udp, PCAPNG_UDP_PORT);
+    put_be16(udp + 2, PCAPNG_UDP_PORT);
+    put_be16(udp + 4, (uint16_t)(PCAPNG_UDP_HEADER + length));
+    put_be16(udp + 6, 0);
+
+    memcpy(udp + PCAPNG_UDP_HEADER, packet, length);
+    memset(block + 28 + captured, 0, PCAPNG_PAD4(captured) - captured);
+    put_u32(block + block_length - 4, (uint32_t)block_length);
+    writer->packets++;
+    return true;
+}
+
+/**
+ * 把缓冲区写入文件
+ * @param writer 写入器
+ * @return 是否成功
+ */
+bool flush_pcapng_writer(pcapng_writer_t* writer) {
+    if (!writer || !writer->file || writer->failed) return false;
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        printf("[错误] 抓包文件写入失败\n");
+        writer->failed = true;
+        return false;
+    }
+    writer->used = 0;
+    return true;
+}
+
+/**
+ * 落盘并关闭抓包文件
+ * @param writer 写入器
+ * @return 全部报文是否都已成功写入
+ */
+bool close_pcapng_writer(pcapng_writer_t* writer) {
+    if (!writer || !writer->file) return false;
+    bool ok = flush_pcapng_writer(writer);
+    if (fclose(writer->file) != 0) ok = false;
+    free(writer->buffer);
+    writer->file = NULL;
+    writer->buffer = NULL;
+    return ok && !writer->failed;
+}
+
+/**
+ * 抓包回调：把窗口协议发出的报文写入抓包文件
+ * @param time_ms 虚拟时刻（毫秒）
+ * @param forward 是否 A→B 方向
+ * @param packet 报文
+ * @param length 报文长度
+ * @param context 写入器
+ */
+void capture_pcapng_packet(double time_ms, bool forward, const uint8_t* packet, size_t length, void* context) {
+    write_pcapng_packet((pcapng_writer_t*)context, time_ms, forward, packet, length);
+}
@@ -0,0 +1,46 @@
+#ifndef PCAPNG_WRITER_H
+#define PCAPNG_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* 常量定义 */
+#define PCAPNG_BUFFER_SIZE (64 * 1024)     // 写缓冲区字节数，写满即落盘（内存占用与报文数无关）
+#define PCAPNG_LINKTYPE_RAW 101             // 链路类型：裸IP报文，无链路层报头
+#define PCAPNG_UDP_PORT 47000               // 合成UDP报头的端口（Wireshark 解析脚本按此端口注册）
+#define PCAPNG_ADDRESS_A 0x0A000001u        // A端（正向发送方）地址 10.0.0.1
+#define PCAPNG_ADDRESS_B 0x0A000002u        // B端地址 10.0.0.2
+#define PCAPNG_IP_HEADER 20
+#define PCAPNG_UDP_HEADER 8
+
+/* pcapng 抓包文件写入器：每个报文封装为 IPv4/UDP 报文写成一个增强报文块（微秒时间戳），
+ * 块先追加到固定大小的写缓冲区，缓冲区写满时整块写入文件 */
+typedef struct {
+    FILE* file;
+    uint8_t* buffer;            // 写缓冲区
+    size_t used;                // 缓冲区中待写入的字节数
+    uint16_t ip_id;             // 合成IPv4报头的标识字段（逐包递增）
+    long packets;               // 已写入的报文数
+    long long file_bytes;       // 已写入（含缓冲区中）的文件字节数
+    bool failed;                // 写文件出错，之后的报文全部丢弃
+} pcapng_writer_t;
+
+/* 创建文件并写入节头块与接口描述块；失败时返回 false */
+bool open_pcapng_writer(pcapng_writer_t* writer, const char* path);
+
+/* 写入一个报文：time_ms 为时间戳（毫秒），forward 为 A→B 方向，否则 B→A */
+bool write_pcapng_packet(pcapng_writer_t* writer, double time_ms, bool forward,
+                         const uint8_t* packet, size_t length);
+
+/* 把缓冲区写入文件 */
+bool flush_pcapng_writer(pcapng_writer_t* writer);
+
+/* 落盘并关闭文件，返回之前的写入是否全部成功 */
+bool close_pcapng_writer(pcapng_writer_t* writer);
+
+/* 与窗口协议的抓包回调（arq_capture_fn）签名一致，context 为 pcapng_writer_t* */
+void capture_pcapng_packet(double time_ms, bool forward, const uint8_t* packet, size_t length, void* context);
+
+#endif // PCAPNG_WRITER_H
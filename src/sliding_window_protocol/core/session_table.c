@@ -0,0 +1,126 @@
+#include "session_table.h"
+
+#include <stdlib.h>
+
+/**
+ * 连接号的散列值（乘法散列，连续的连接号分散到不同槽位）
+ * @param conn_id 连接号
+ * @param capacity 槽位数（2的幂）
+ * @return 槽位号
+ */
+static size_t session_slot(uint32_t conn_id, size_t capacity) {
+    return (size_t)(conn_id * 2654435761u) & (capacity - 1);
+}
+
+/**
+ * 分配槽位数组
+ * @param table 会话表
+ * @param capacity 槽位数（2的幂）
+ * @return 是否成功
+ */
+static bool allocate_session_slots(session_table_t* table, size_t capacity) {
+    table->keys = malloc(capacity * sizeof(uint32_t));
+    table->sessions = calloc(capacity, sizeof(void*));
+    if (!table->keys || !table->sessions) {
+        free(table->keys);
+        free(table->sessions);
+        table->keys = NULL;
+        table->sessions = NULL;
+        return false;
+    }
+    table->capacity = capacity;
+    return true;
+}
+
+/**
+ * 初始化会话表
+ * @param table 会话表
+ * @param expected_sessions 预计的会话数（按此预留槽位，之后不必扩容）
+ * @return 是否成功
+ */
+bool init_session_table(session_table_t* table, size_t expected_sessions) {
+    if (!table) return false;
+
+    size_t capacity = SESSION_TABLE_MIN_CAPACITY;
+    while (capacity < 2 * expected_sessions) capacity *= 2;
+    table->count = 0;
+    return allocate_session_slots(table, capacity);
+}
+
+/**
+ * 释放会话表（不释放会话本身）
+ * @param table 会话表
+ */
+void free_session_table(session_table_t* table) {
+    if (!table) return;
+
+    free(table->keys);
+    free(table->sessions);
+    table->keys = NULL;
+    table->sessions = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+/**
+ * 槽位数翻倍，重新放入全部会话
+ * @param table 会话表
+ * @return 是否成功
+ */
+static bool grow_session_table(session_table_t* table) {
+    uint32_t* old_keys = table->keys;
+    void** old_sessions = table->sessions;
+    size_t old_capacity = table->capacity;
+    if (!allocate_session_slots(table, old_capacity * 2)) {
+        table->keys = old_keys;
+        table->sessions = old_sessions;
+        return false;
+    }
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!old_sessions[i]) continue;
+        size_t slot = session_slot(old_keys[i], table->capacity);
+        while (table->sessions[slot]) slot = (slot + 1) & (table->capacity - 1);
+        table->keys[slot] = old_keys[i];
+        table->sessions[slot] = old_sessions[i];
+    }
+    free(old_keys);
+    free(old_sessions);
+    return true;
+}
+
+/**
+ * 加入会话
+ * @param table 会话表
+ * @param conn_id 连接号
+ * @param session 会话
+ * @return 是否加入（连接号已存在或内存不足时返回 false）
+ */
+bool insert_session(session_table_t* table, uint32_t conn_id, void* session) {
+    if (!table || !session || find_session(table, conn_id)) return false;
+    if (2 * (table->count + 1) > table->capacity && !grow_session_table(table)) return false;
+
+    size_t slot = session_slot(conn_id, table->capacity);
+    while (table->sessions[slot]) slot = (slot + 1) & (table->capacity - 1);
+    table->keys[slot] = conn_id;
+    table->sessions[slot] = session;
+    table->count++;
+    return true;
+}
+
+/**
+ * 查找会话
+ * @param table 会话表
+ * @param conn_id 连接号
+ * @return 会话，不存在时返回NULL
+ */
+void* find_session(const session_table_t* table, uint32_t conn_id) {
+    if (!table || table->capacity == 0) return NULL;
+
+    size_t slot = session_slot(conn_id, table->capacity);
+    while (table->sessions[slot]) {
+        if (table->keys[slot] == conn_id) return table->sessions[slot];
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    return NULL;
+}
@@ -0,0 +1,30 @@
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 常量定义 */
+#define SESSION_TABLE_MIN_CAPACITY 16   // 散列表的最小槽位数
+
+/* 会话表：连接号 → 会话的开放寻址散列表（线性探测，装载率不超过1/2，满时翻倍）。
+ * 多路复用时按报文携带的连接号找到会话；会话只增不删，传输结束时整表释放 */
+typedef struct {
+    uint32_t* keys;             // 各槽位的连接号
+    void** sessions;            // 各槽位的会话（NULL 表示空槽位）
+    size_t capacity;            // 槽位数（2的幂）
+    size_t count;               // 会话数
+} session_table_t;
+
+/* 初始化与释放 */
+bool init_session_table(session_table_t* table, size_t expected_sessions);
+void free_session_table(session_table_t* table);
+
+/* 加入会话（session 不得为NULL），连接号已存在或内存不足时返回 false */
+bool insert_session(session_table_t* table, uint32_t conn_id, void* session);
+
+/* 查找会话，不存在时返回NULL */
+void* find_session(const session_table_t* table, uint32_t conn_id);
+
+#endif // SESSION_TABLE_H
@@ -1,11 +1,70 @@
+#define _DEFAULT_SOURCE
 #include "sliding_window.h"
+#include "crc32c.h"
+#include "event_sim.h"
+#include "frame_pool.h"
+#include "session_table.h"
+#include "trace_ring.h"
+#include "wire_format.h"
 
-/* 全局变量：用于模拟网络传输的缓冲区 */
-static data_frame_t network_data_buffer;
-static ack_frame_t network_ack_buffer;
+#include <pthread.h>
+#include <stddef.h>
+
+/* 数据帧校验和覆盖数据区之前的帧头与有效数据；确认帧没有数据区，覆盖校验和字段之前的全部字段 */
+#define DATA_HEADER_SPAN offsetof(data_frame_t, data)
+#define ACK_CHECKSUM_SPAN offsetof(ack_frame_t, checksum)
+
+#define CHANNEL_DEFAULT_SEED 0x9E3779B9u    // 种子为0时使用的固定种子（xorshift 的状态不能为0）
+
+/* 协议过程的文字说明：只在跟踪级别为 TRACE_LEVEL_TEXT 时格式化输出，默认级别下不做任何格式化 */
+#define PROTOCOL_LOG(...) do { \
+        if (get_trace_level() >= TRACE_LEVEL_TEXT) printf(__VA_ARGS__); \
+    } while (0)
+
+/* 全局变量：用于模拟网络传输的缓冲区（存放紧凑线路格式的报文） */
+static uint8_t network_data_buffer[WIRE_MAX_DATA_FRAME];
+static size_t network_data_length = 0;
+static uint8_t network_ack_buffer[WIRE_MAX_ACK_FRAME];
+static size_t network_ack_length = 0;
 static bool data_in_transit = false;
 static bool ack_in_transit = false;
 
+/* 仿真信道中的一帧，到达事件的参数即槽位号。数据帧只保存本次发送的报头与校验和，
+ * 载荷引用帧池中的帧（不复制）；确认帧与被损坏的数据帧以完整的紧凑线路格式保存在 wire 中 */
+typedef struct {
+    int frame;                  // 数据帧的帧池句柄（持有一个引用），FRAME_NONE 表示报文在 wire 中
+    uint8_t header[WIRE_MAX_DATA_HEADER]; // 数据帧本次发送的报头（捎带的确认每次发送可能不同）
+    size_t header_length;
+    uint32_t checksum;          // 数据帧的尾部校验和（报头 + 载荷）
+    uint8_t wire[WIRE_MAX_DATA_FRAME];  // 编码后的报文，只有前 length 字节有效
+    size_t length;              // 报文在线路上的长度
+    bool corrupted;             // 在线路上被翻转过比特
+    statistics_t* stats;        // 发送该帧的传输方向的统计（校验结果计入同一方向）
+} channel_slot_t;
+
+/* 信道的一个方向：先经过瓶颈链路（按带宽串行化，排队满则尾部丢弃），再经过随机时延的传播路径。
+ * 未被选中乱序的帧按发送顺序到达；槽位用空闲栈管理，乱序和复制的帧可以同时在途。
+ * 槽位数随共用信道的传输方向数增加（瓶颈队列的长度仍不超过 CHANNEL_CAPACITY） */
+typedef struct {
+    channel_slot_t* slots;
+    int* free_slots;            // 空闲槽位栈
+    int free_count;
+    int capacity;               // 槽位数（同时在途的最大帧数）
+    bool bad_state;             // Gilbert-Elliott 模型当前处于坏状态
+    double last_arrival;        // 按序到达的帧中最后一帧的到达时刻
+    double link_free_at;        // 瓶颈链路发完已排队帧的时刻
+    double departures[CHANNEL_CAPACITY]; // 排队帧各自发送完毕的时刻（先进先出环形队列）
+    int queue_head;
+    int queue_count;
+} channel_link_t;
+
+/* 仿真信道：每次传输单独分配，不同线程中的传输互不干扰。
+ * 单工时正向只有数据帧、反向只有确认帧；全双工时两个方向都同时承载数据帧与确认帧 */
+typedef struct {
+    channel_link_t data;        // 正向（A→B）
+    channel_link_t acks;        // 反向（B→A）
+} sim_channel_t;
+
 /* ========== 初始化函数 ========== */
 
 /**
@@ -20,7 +79,7 @@ void init_sender(sender_state_t* sender) {
     sender->retry_count = 0;             // 重传计数清零
     memset(&sender->current_frame, 0, sizeof(data_frame_t));
     
-    printf("[发送方] 初始化完成 - 状态: 等待调用, 序列号: %d\n", sender->seq_num);
+    PROTOCOL_LOG("[发送方] 初始化完成 - 状态: 等待调用, 序列号: %d\n", sender->seq_num);
 }
 
 /**
@@ -33,7 +92,7 @@ void init_receiver(receiver_state_t* receiver) {
     receiver->state = WAITING_FOR_DATA;  // 初始状态：等待数据帧
     receiver->expected_seq = 0;          // 期望的序列号为0
     
-    printf("[接收方] 初始化完成 - 状态: 等待数据, 期望序列号: %d\n", receiver->expected_seq);
+    PROTOCOL_LOG("[接收方] 初始化完成 - 状态: 等待数据, 期望序列号: %d\n", receiver->expected_seq);
 }
 
 /**
@@ -46,7 +105,7 @@ void init_statistics(statistics_t* stats) {
     memset(stats, 0, sizeof(statistics_t));
     stats->start_time = clock();
     
-    printf("[统计] 统计信息初始化完成\n");
+    PROTOCOL_LOG("[统计] 统计信息初始化完成\n");
 }
 
 /**
@@ -59,28 +118,78 @@ void init_network_config(network_config_t* config) {
     config->loss_probability = 0.1;      // 10%丢包率
     config->min_delay_ms = 50;           // 最小延迟50ms
     config->max_delay_ms = 200;          // 最大延迟200ms
-    
-    printf("[网络] 网络配置初始化 - 丢包率: %.1f%%, 延迟: %d-%d ms\n", 
+    config->corruption_probability = 0.0; // 默认不损坏
+    config->corruption_bits = 1;
+    config->burst_enter_probability = 0.0; // 默认独立丢包
+    config->burst_exit_probability = 0.0;
+    config->burst_loss_probability = 0.0;
+    config->reorder_probability = 0.0;
+    config->reorder_delay_ms = 0;
+    config->duplicate_probability = 0.0;
+    config->bandwidth_bps = 0;           // 默认不限带宽
+    config->queue_limit = 0;
+    
+    PROTOCOL_LOG("[网络] 网络配置初始化 - 丢包率: %.1f%%, 延迟: %d-%d ms\n", 
            config->loss_probability * 100, config->min_delay_ms, config->max_delay_ms);
 }
 
+/**
+ * 初始化窗口协议配置（默认配置）
+ * @param arq 窗口协议配置结构体指针
+ * @param mode ARQ模式
+ */
+void init_arq_config(arq_config_t* arq, arq_mode_t mode) {
+    if (!arq) return;
+    
+    arq->mode = mode;
+    arq->window_size = (mode == ARQ_STOP_AND_WAIT) ? 1 : ARQ_DEFAULT_WINDOW;
+    // 各模式所需的最小序列号空间
+    arq->seq_space = (mode == ARQ_SELECTIVE_REPEAT) ? 2 * arq->window_size : arq->window_size + 1;
+    arq->payload_size = ARQ_DEFAULT_PAYLOAD;
+    arq->timeout_ms = TIMEOUT_MS;
+    arq->max_retries = ARQ_MAX_RETRIES;
+    arq->adaptive_rto = true;
+    arq->min_rto_ms = RTO_MIN_MS;
+    arq->max_rto_ms = RTO_MAX_MS;
+    arq->real_time = false;
+    arq->verbose = true;
+    arq->sack = false;
+    arq->congestion_control = false;
+    arq->cwnd_trace = NULL;
+    arq->cwnd_trace_context = NULL;
+    arq->capture = NULL;
+    arq->capture_context = NULL;
+    arq->piggyback_delay_ms = ARQ_PIGGYBACK_DELAY_MS;
+    arq->ack_every = 1;
+    arq->ack_delay_ms = ARQ_ACK_DELAY_MS;
+    arq->nak = false;
+    arq->fast_retransmit = false;
+    
+    PROTOCOL_LOG("[ARQ] 配置初始化 - 模式: %s, 窗口: %d, 序列号空间: %d, 每帧: %d 字节\n",
+           arq_mode_name(arq->mode), arq->window_size, arq->seq_space, arq->payload_size);
+}
+
 /* ========== 帧处理函数 ========== */
 
 /**
- * 计算简单的校验和（用于错误检测）
+ * 计算校验和（CRC-32C，有硬件指令时使用硬件指令）
  * @param data 数据指针
  * @param length 数据长度
  * @return 校验和
  */
 unsigned int calculate_checksum(const void* data, size_t length) {
-    const unsigned char* bytes = (const unsigned char*)data;
-    unsigned int sum = 0;
-    
-    for (size_t i = 0; i < length; i++) {
-        sum += bytes[i];
-    }
-    
-    return sum;
+    return calculate_crc32c(data, length);
+}
+
+/**
+ * 计算数据帧的校验和：只覆盖帧头与 data_length 字节的有效数据，不扫描未使用的数据区
+ * @param frame 数据帧
+ * @return 校验和
+ */
+unsigned int calculate_frame_checksum(const data_frame_t* frame) {
+    uint32_t crc = update_crc32c(CRC32C_INIT, frame, DATA_HEADER_SPAN);
+    crc = update_crc32c(crc, frame->data, (size_t)frame->data_length);
+    return crc ^ CRC32C_INIT;
 }
 
 /**
@@ -95,27 +204,59 @@ bool verify_checksum(const void* data, size_t length, unsigned int expected_chec
 }
 
 /**
- * 创建数据帧
+ * 填充数据帧（不输出日志，供仿真引擎使用）
  * @param frame 数据帧结构体指针
  * @param seq_num 序列号
  * @param data 数据内容
  * @param length 数据长度
  */
-void create_data_frame(data_frame_t* frame, int seq_num, const char* data, int length) {
-    if (!frame || !data) return;
-    
+static void fill_data_frame(data_frame_t* frame, int seq_num, const char* data, int length) {
     frame->type = DATA_FRAME;
     frame->seq_num = seq_num;
     frame->data_length = length;
+    frame->ack_num = -1;            // 不捎带确认
+    frame->sack_bitmap = 0;
+    frame->conn_id = 0;
     
-    // 复制数据内容
+    // 复制数据内容（只复制实际长度）
     memcpy(frame->data, data, length);
     frame->data[length] = '\0';  // 确保字符串结束
     
-    // 计算校验和（不包括校验和字段本身）
-    frame->checksum = calculate_checksum(frame, sizeof(data_frame_t) - sizeof(unsigned int));
+    // 引擎中的帧在线路编码时计算尾部校验和，这里不扫描整个结构体
+    frame->checksum = 0;
+}
+
+/**
+ * 填充确认帧（不输出日志，供仿真引擎使用）
+ * @param frame 确认帧结构体指针
+ * @param ack_num 确认号
+ * @param sack_bitmap 选择确认位图（未启用SACK时为0）
+ */
+static void fill_ack_frame(ack_frame_t* frame, int ack_num, uint64_t sack_bitmap) {
+    frame->type = ACK_FRAME;
+    frame->ack_num = ack_num;
+    frame->sack_bitmap = sack_bitmap;
+    frame->conn_id = 0;
+    frame->checksum = 0;
+}
+
+/**
+ * 创建数据帧
+ * @param frame 数据帧结构体指针
+ * @param seq_num 序列号
+ * @param data 数据内容
+ * @param length 数据长度
+ */
+void create_data_frame(data_frame_t* frame, int seq_num, const char* data, int length) {
+    if (!frame || !data) return;
+    
+    fill_data_frame(frame, seq_num, data, length);
     
-    printf("[帧创建] 数据帧 - 序列号: %d, 长度: %d, 内容: \"%.20s%s\"\n", 
+    // 计算校验和（帧头与有效数据）
+    frame->checksum = calculate_frame_checksum(frame);
+    record_trace_event(TRACE_FRAME_CREATE, monotonic_clock_ms(), 0, seq_num, (size_t)length);
+    
+    PROTOCOL_LOG("[帧创建] 数据帧 - 序列号: %d, 长度: %d, 内容: \"%.20s%s\"\n", 
            seq_num, length, data, length > 20 ? "..." : "");
 }
 
@@ -127,13 +268,11 @@ void create_data_frame(data_frame_t* frame, int seq_num, const char* data, int l
 void create_ack_frame(ack_frame_t* frame, int ack_num) {
     if (!frame) return;
     
-    frame->type = ACK_FRAME;
-    frame->ack_num = ack_num;
-    
-    // 计算校验和
-    frame->checksum = calculate_checksum(frame, sizeof(ack_frame_t) - sizeof(unsigned int));
+    fill_ack_frame(frame, ack_num, 0);
+    frame->checksum = calculate_checksum(frame, ACK_CHECKSUM_SPAN);
+    record_trace_event(TRACE_FRAME_CREATE, monotonic_clock_ms(), 0, ack_num, 0);
     
-    printf("[帧创建] 确认帧 - 确认号: %d\n", ack_num);
+    PROTOCOL_LOG("[帧创建] 确认帧 - 确认号: %d\n", ack_num);
 }
 
 /* ========== 网络模拟函数 ========== */
@@ -150,13 +289,23 @@ bool simulate_frame_loss(network_config_t* config) {
     bool lost = random_value < config->loss_probability;
     
     if (lost) {
-        printf("[网络模拟] 帧丢失! (概率: %.1f%%, 随机值: %.3f)\n", 
+        PROTOCOL_LOG("[网络模拟] 帧丢失! (概率: %.1f%%, 随机值: %.3f)\n", 
                config->loss_probability * 100, random_value);
     }
     
     return lost;
 }
 
+/**
+ * 按网络配置随机抽取一次单向延迟
+ * @param config 网络配置
+ * @return 延迟（毫秒）
+ */
+static int draw_network_delay(const network_config_t* config) {
+    return config->min_delay_ms + 
+           (rand() % (config->max_delay_ms - config->min_delay_ms + 1));
+}
+
 /**
  * 模拟网络延迟
  * @param config 网络配置
@@ -164,10 +313,9 @@ bool simulate_frame_loss(network_config_t* config) {
 void simulate_network_delay(network_config_t* config) {
     if (!config) return;
     
-    int delay = config->min_delay_ms + 
-                (rand() % (config->max_delay_ms - config->min_delay_ms + 1));
+    int delay = draw_network_delay(config);
     
-    printf("[网络模拟] 延迟 %d ms\n", delay);
+    PROTOCOL_LOG("[网络模拟] 延迟 %d ms\n", delay);
     
     // 简单的延迟模拟（在实际应用中可能需要更复杂的实现）
     usleep(delay * 1000);  // 转换为微秒
@@ -187,8 +335,9 @@ bool send_data_frame(sender_state_t* sender, const data_frame_t* frame,
                      network_config_t* config, statistics_t* stats) {
     if (!sender || !frame || !config || !stats) return false;
     
-    printf("\n[发送方] 准备发送数据帧 (序列号: %d)\n", frame->seq_num);
+    PROTOCOL_LOG("\n[发送方] 准备发送数据帧 (序列号: %d)\n", frame->seq_num);
     stats->frames_sent++;
+    record_trace_event(TRACE_DATA_SEND, monotonic_clock_ms(), 0, frame->seq_num, (size_t)frame->data_length);
     
     // 模拟网络延迟
     simulate_network_delay(config);
@@ -196,15 +345,20 @@ bool send_data_frame(sender_state_t* sender, const data_frame_t* frame,
     // 模拟帧丢失
     if (simulate_frame_loss(config)) {
         stats->frames_lost++;
-        printf("[发送方] 数据帧丢失，未到达接收方\n");
+        record_trace_event(TRACE_FRAME_LOST, monotonic_clock_ms(), 0, frame->seq_num, (size_t)frame->data_length);
+        PROTOCOL_LOG("[发送方] 数据帧丢失，未到达接收方\n");
         return false;
     }
     
-    // 将帧放入网络缓冲区
-    memcpy(&network_data_buffer, frame, sizeof(data_frame_t));
+    // 按紧凑线路格式编码后放入网络缓冲区
+    network_data_length = encode_data_frame(frame, network_data_buffer, sizeof(network_data_buffer));
+    if (network_data_length == 0) {
+        PROTOCOL_LOG("[发送方] 数据帧编码失败 (序列号: %d, 长度: %d)\n", frame->seq_num, frame->data_length);
+        return false;
+    }
     data_in_transit = true;
     
-    print_frame_info(frame, "发送");
+    if (get_trace_level() >= TRACE_LEVEL_TEXT) print_frame_info(frame, "发送");
     return true;
 }
 
@@ -225,26 +379,19 @@ bool receive_data_frame(receiver_state_t* receiver, data_frame_t* frame,
         return false;  // 没有数据帧可接收
     }
     
-    // 从网络缓冲区取出帧
-    memcpy(frame, &network_data_buffer, sizeof(data_frame_t));
+    // 从网络缓冲区取出报文并解码（同时验证尾部校验和）
     data_in_transit = false;
-    
     stats->frames_received++;
-    print_frame_info(frame, "接收");
     
-    // 验证校验和
-    unsigned int expected_checksum = frame->checksum;
-    frame->checksum = 0;  // 临时清零以计算校验和
-    unsigned int calculated_checksum = calculate_checksum(frame, sizeof(data_frame_t) - sizeof(unsigned int));
-    frame->checksum = expected_checksum;  // 恢复
-    
-    if (calculated_checksum != expected_checksum) {
-        printf("[接收方] 校验和错误! 期望: %u, 计算: %u\n", 
-               expected_checksum, calculated_checksum);
+    if (decode_frame(network_data_buffer, network_data_length, frame, NULL) != DATA_FRAME) {
+        record_trace_event(TRACE_FRAME_CORRUPT, monotonic_clock_ms(), 0, -1, network_data_length);
+        PROTOCOL_LOG("[接收方] 校验和错误! 报文 %zu 字节已损坏\n", network_data_length);
         return false;
     }
+    record_trace_event(TRACE_DATA_RECEIVE, monotonic_clock_ms(), 0, frame->seq_num, (size_t)frame->data_length);
+    if (get_trace_level() >= TRACE_LEVEL_TEXT) print_frame_info(frame, "接收");
     
-    printf("[接收方] 数据帧校验通过\n");
+    PROTOCOL_LOG("[接收方] 数据帧校验通过\n");
     return true;
 }
 
@@ -260,8 +407,9 @@ bool send_ack_frame(receiver_state_t* receiver, const ack_frame_t* ack,
                     network_config_t* config, statistics_t* stats) {
     if (!receiver || !ack || !config || !stats) return false;
     
-    printf("\n[接收方] 准备发送确认帧 (确认号: %d)\n", ack->ack_num);
+    PROTOCOL_LOG("\n[接收方] 准备发送确认帧 (确认号: %d)\n", ack->ack_num);
     stats->acks_sent++;
+    record_trace_event(TRACE_ACK_SEND, monotonic_clock_ms(), 0, ack->ack_num, 0);
     
     // 模拟网络延迟
     simulate_network_delay(config);
@@ -269,15 +417,20 @@ bool send_ack_frame(receiver_state_t* receiver, const ack_frame_t* ack,
     // 模拟帧丢失
     if (simulate_frame_loss(config)) {
         stats->frames_lost++;
-        printf("[接收方] 确认帧丢失，未到达发送方\n");
+        record_trace_event(TRACE_FRAME_LOST, monotonic_clock_ms(), 0, ack->ack_num, 0);
+        PROTOCOL_LOG("[接收方] 确认帧丢失，未到达发送方\n");
         return false;
     }
     
-    // 将确认帧放入网络缓冲区
-    memcpy(&network_ack_buffer, ack, sizeof(ack_frame_t));
+    // 按紧凑线路格式编码后放入网络缓冲区
+    network_ack_length = encode_ack_frame(ack, network_ack_buffer, sizeof(network_ack_buffer));
+    if (network_ack_length == 0) {
+        PROTOCOL_LOG("[接收方] 确认帧编码失败 (确认号: %d)\n", ack->ack_num);
+        return false;
+    }
     ack_in_transit = true;
     
-    print_ack_info(ack, "发送");
+    if (get_trace_level() >= TRACE_LEVEL_TEXT) print_ack_info(ack, "发送");
     return true;
 }
 
@@ -297,30 +450,25 @@ bool receive_ack_frame(sender_state_t* sender, const ack_frame_t* ack,
         return false;  // 没有确认帧可接收
     }
     
-    // 从网络缓冲区取出确认帧
+    // 从网络缓冲区取出报文并解码（同时验证尾部校验和）
     ack_frame_t received_ack;
-    memcpy(&received_ack, &network_ack_buffer, sizeof(ack_frame_t));
     ack_in_transit = false;
-    
     stats->acks_received++;
-    print_ack_info(&received_ack, "接收");
     
-    // 验证校验和
-    unsigned int expected_checksum = received_ack.checksum;
-    received_ack.checksum = 0;
-    unsigned int calculated_checksum = calculate_checksum(&received_ack, sizeof(ack_frame_t) - sizeof(unsigned int));
-    
-    if (calculated_checksum != expected_checksum) {
-        printf("[发送方] 确认帧校验和错误!\n");
+    if (decode_frame(network_ack_buffer, network_ack_length, NULL, &received_ack) != ACK_FRAME) {
+        record_trace_event(TRACE_FRAME_CORRUPT, monotonic_clock_ms(), 0, -1, network_ack_length);
+        PROTOCOL_LOG("[发送方] 确认帧校验和错误!\n");
         return false;
     }
+    record_trace_event(TRACE_ACK_RECEIVE, monotonic_clock_ms(), 0, received_ack.ack_num, 0);
+    if (get_trace_level() >= TRACE_LEVEL_TEXT) print_ack_info(&received_ack, "接收");
     
     // 检查确认号是否正确
     if (received_ack.ack_num == sender->seq_num) {
-        printf("[发送方] 接收到正确的确认帧 (确认号: %d)\n", received_ack.ack_num);
+        PROTOCOL_LOG("[发送方] 接收到正确的确认帧 (确认号: %d)\n", received_ack.ack_num);
         return true;
     } else {
-        printf("[发送方] 接收到错误的确认号: %d (期望: %d)\n", 
+        PROTOCOL_LOG("[发送方] 接收到错误的确认号: %d (期望: %d)\n", 
                received_ack.ack_num, sender->seq_num);
         return false;
     }
@@ -336,8 +484,8 @@ bool receive_ack_frame(sender_state_t* sender, const ack_frame_t* ack,
 bool is_timeout(sender_state_t* sender) {
     if (!sender || sender->state != WAITING_FOR_ACK) return false;
     
-    clock_t current_time = clock();
-    double elapsed_ms = ((double)(current_time - sender->timer_start)) / CLOCKS_PER_SEC * 1000;
+    // 使用单调时钟：clock() 只统计进程CPU时间，进程休眠等待时不会增长
+    double elapsed_ms = monotonic_clock_ms() - sender->timer_start_ms;
     
     return elapsed_ms > TIMEOUT_MS;
 }
@@ -352,18 +500,21 @@ void handle_timeout(sender_state_t* sender, network_config_t* config,
                     statistics_t* stats) {
     if (!sender || !config || !stats) return;
     
-    printf("\n[超时处理] 发生超时! 准备重传...\n");
+    PROTOCOL_LOG("\n[超时处理] 发生超时! 准备重传...\n");
+    record_trace_event(TRACE_TIMEOUT, monotonic_clock_ms(), 0, sender->seq_num, 0);
     
     sender->retry_count++;
     stats->retransmissions++;
     
     if (sender->retry_count >= MAX_RETRIES) {
-        printf("[超时处理] 达到最大重传次数 (%d)，传输失败\n", MAX_RETRIES);
+        PROTOCOL_LOG("[超时处理] 达到最大重传次数 (%d)，传输失败\n", MAX_RETRIES);
         sender->state = WAITING_FOR_CALL;
         return;
     }
     
-    printf("[超时处理] 第 %d 次重传 (最大: %d)\n", sender->retry_count, MAX_RETRIES);
+    PROTOCOL_LOG("[超时处理] 第 %d 次重传 (最大: %d)\n", sender->retry_count, MAX_RETRIES);
+    record_trace_event(TRACE_RETRANSMIT, monotonic_clock_ms(), 0, sender->seq_num,
+                       (size_t)sender->current_frame.data_length);
     
     // 重新发送当前帧
     send_data_frame(sender, &sender->current_frame, config, stats);
@@ -377,14 +528,17 @@ void handle_timeout(sender_state_t* sender, network_config_t* config,
 void reset_timer(sender_state_t* sender) {
     if (!sender) return;
     
-    sender->timer_start = clock();
-    printf("[计时器] 重置计时器\n");
+    sender->timer_start_ms = monotonic_clock_ms();
+    record_trace_event(TRACE_TIMER_RESET, sender->timer_start_ms, 0, sender->seq_num, 0);
+    PROTOCOL_LOG("[计时器] 重置计时器\n");
 }
 
 /* ========== 主要传输函数 ========== */
 
 /**
- * 传输消息的主函数（停等协议实现）
+ * 传输消息的主函数
+ * 单帧容纳得下的消息整条作为一帧，用停等协议发送，序列号在 0/1 之间交替；
+ * 更长的消息按 ARQ_MTU_PAYLOAD 分片，经选择重传窗口流水线发送后在接收方重组
  * @param message 要传输的消息
  * @param config 网络配置
  * @param stats 统计信息
@@ -394,173 +548,3051 @@ bool transmit_message(const char* message, network_config_t* config,
                       statistics_t* stats) {
     if (!message || !config || !stats) return false;
     
+    size_t message_len = strlen(message);
     printf("\n========== 开始传输消息 ==========\n");
-    printf("消息内容: \"%s\"\n", message);
-    printf("消息长度: %lu 字节\n", strlen(message));
-    
-    // 初始化发送方和接收方
-    sender_state_t sender;
-    receiver_state_t receiver;
-    init_sender(&sender);
-    init_receiver(&receiver);
-    
-    // 为简化演示，这里传输整个消息作为一帧
-    // 在实际实现中，可能需要分片处理大消息
-    int message_len = strlen(message);
+    printf("消息内容: \"%.50s%s\"\n", message, message_len > 50 ? "..." : "");
+    printf("消息长度: %zu 字节\n", message_len);
+    
     if (message_len == 0) {
         printf("[错误] 消息不能为空\n");
         return false;
     }
-    if (message_len > MAX_DATA_SIZE - 1) {
-        printf("[错误] 消息过长，超过最大帧大小\n");
-        return false;
+    
+    arq_config_t arq;
+    if (message_len <= ARQ_MTU_PAYLOAD) {
+        init_arq_config(&arq, ARQ_STOP_AND_WAIT);
+        arq.seq_space = MAX_SEQ_NUM;
+        arq.payload_size = (int)message_len;
+        arq.max_retries = MAX_RETRIES;
+    } else {
+        init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+        arq.seq_space = 2 * arq.window_size;
+        arq.payload_size = ARQ_MTU_PAYLOAD;
+        PROTOCOL_LOG("[分片] 消息超过单帧容量 %d 字节，分片后经选择重传窗口发送\n", ARQ_MTU_PAYLOAD);
     }
     
-    // 创建数据帧
-    create_data_frame(&sender.current_frame, sender.seq_num, message, message_len);
-    
-    // 停等协议主循环
-    while (sender.state != WAITING_FOR_CALL || sender.retry_count == 0) {
-        switch (sender.state) {
-            case WAITING_FOR_CALL:
-                // 开始传输
-                printf("\n[协议状态] 发送方开始传输\n");
-                sender.state = WAITING_FOR_ACK;
-                
-                // 发送数据帧
-                send_data_frame(&sender, &sender.current_frame, config, stats);
-                reset_timer(&sender);
-                break;
-                
-            case WAITING_FOR_ACK:
-                // 等待确认帧
-                printf("\n[协议状态] 等待确认帧...\n");
-                
-                // 模拟一些延迟，让接收方有时间处理
-                usleep(100000); // 100ms
-                
-                // 检查是否有数据帧到达接收方
-                data_frame_t received_frame;
-                if (receive_data_frame(&receiver, &received_frame, config, stats)) {
-                    printf("[接收方] 成功接收数据帧\n");
-                    
-                    // 检查序列号
-                    if (received_frame.seq_num == receiver.expected_seq) {
-                        printf("[接收方] 序列号正确 (期望: %d, 接收: %d)\n", 
-                               receiver.expected_seq, received_frame.seq_num);
-                        
-                        // 发送确认帧
-                        ack_frame_t ack;
-                        create_ack_frame(&ack, received_frame.seq_num);
-                        send_ack_frame(&receiver, &ack, config, stats);
-                        
-                        // 更新接收方期望的序列号
-                        receiver.expected_seq = (receiver.expected_seq + 1) % MAX_SEQ_NUM;
-                    } else {
-                        printf("[接收方] 序列号错误，丢弃帧\n");
-                        // 可以选择发送上一个确认帧
-                    }
-                }
-                
-                // 检查发送方是否收到确认
-                ack_frame_t received_ack;
-                if (receive_ack_frame(&sender, &received_ack, stats)) {
-                    printf("[发送方] 收到正确确认，传输成功!\n");
-                    sender.state = WAITING_FOR_CALL;
-                    sender.seq_num = (sender.seq_num + 1) % MAX_SEQ_NUM;
-                    sender.retry_count = 0;
-                    
-                    // 传输完成
-                    stats->end_time = clock();
-                    printf("\n========== 传输完成 ==========\n");
-                    return true;
-                }
-                
-                // 检查超时
-                if (is_timeout(&sender)) {
-                    handle_timeout(&sender, config, stats);
-                    if (sender.retry_count >= MAX_RETRIES) {
-                        printf("\n========== 传输失败 ==========\n");
-                        return false;
-                    }
-                }
-                break;
-                
-            default:
-                printf("[错误] 未知的协议状态\n");
-                return false;
-        }
-        
-        print_protocol_state(&sender, &receiver);
+    return transmit_message_arq(message, config, &arq, stats);
+}
+
+/* ========== 重传超时估计（RFC 6298） ========== */
+
+/**
+ * 把RTO限制在上下限之间
+ * @param rto 估计器
+ */
+static void clamp_rto(rto_estimator_t* rto) {
+    if (rto->rto_ms < rto->min_rto_ms) rto->rto_ms = rto->min_rto_ms;
+    if (rto->rto_ms > rto->max_rto_ms) rto->rto_ms = rto->max_rto_ms;
+}
+
+/**
+ * 初始化重传超时估计器（尚无样本时使用初始RTO）
+ * @param rto 估计器
+ * @param initial_ms 初始RTO
+ * @param min_ms RTO下限
+ * @param max_ms RTO上限
+ * @param granularity_ms 时钟粒度G
+ */
+void init_rto_estimator(rto_estimator_t* rto, double initial_ms, double min_ms,
+                        double max_ms, double granularity_ms) {
+    if (!rto) return;
+    
+    memset(rto, 0, sizeof(rto_estimator_t));
+    rto->min_rto_ms = min_ms;
+    rto->max_rto_ms = max_ms;
+    rto->granularity_ms = granularity_ms;
+    rto->rto_ms = initial_ms;
+    clamp_rto(rto);
+    rto->initial_rto_ms = rto->rto_ms;
+}
+
+/**
+ * 用一个RTT样本更新估计（只能来自未重传过的帧，见Karn算法）
+ * 首个样本: SRTT = R, RTTVAR = R/2
+ * 之后: RTTVAR = (1-β)·RTTVAR + β·|SRTT-R|, SRTT = (1-α)·SRTT + α·R
+ * RTO = SRTT + max(G, K·RTTVAR)，新样本同时清除退避
+ * @param rto 估计器
+ * @param rtt_ms 往返时间样本
+ */
+void update_rto_estimator(rto_estimator_t* rto, double rtt_ms) {
+    if (!rto || rtt_ms < 0) return;
+    
+    if (rto->samples == 0) {
+        rto->srtt_ms = rtt_ms;
+        rto->rttvar_ms = rtt_ms / 2;
+    } else {
+        double error = rto->srtt_ms - rtt_ms;
+        if (error < 0) error = -error;
+        rto->rttvar_ms = (1 - RTO_BETA) * rto->rttvar_ms + RTO_BETA * error;
+        rto->srtt_ms = (1 - RTO_ALPHA) * rto->srtt_ms + RTO_ALPHA * rtt_ms;
     }
+    rto->samples++;
+    clear_rto_backoff(rto);
+}
+
+/**
+ * 清除退避，RTO恢复为 SRTT + max(G, K·RTTVAR)，尚无样本时恢复为初始RTO
+ * 确认推进了窗口即说明链路已恢复，即使被确认的帧重传过（不能采样）也应清除退避，
+ * 否则回退N帧在连续丢包后所有确认都落在重传帧上，退避后的RTO会一直保持
+ * @param rto 估计器
+ */
+void clear_rto_backoff(rto_estimator_t* rto) {
+    if (!rto) return;
     
-    return false;
+    rto->backoffs = 0;
+    if (rto->samples == 0) {
+        // 尚无样本时恢复初始RTO（RFC 6298 5.7），否则确认全落在重传帧上时RTO会一直翻倍到上限
+        rto->rto_ms = rto->initial_rto_ms;
+        return;
+    }
+    
+    double variance_term = RTO_K * rto->rttvar_ms;
+    rto->rto_ms = rto->srtt_ms + (variance_term > rto->granularity_ms ? variance_term : rto->granularity_ms);
+    clamp_rto(rto);
 }
 
-/* ========== 工具函数 ========== */
+/**
+ * 超时后指数退避：RTO加倍（不超过上限）
+ * @param rto 估计器
+ */
+void backoff_rto_estimator(rto_estimator_t* rto) {
+    if (!rto) return;
+    
+    rto->rto_ms *= 2;
+    rto->backoffs++;
+    clamp_rto(rto);
+}
+
+/* ========== 窗口协议（回退N帧 / 选择重传） ========== */
+
+/* 一次仿真中各传输方向共用的部分：帧到达放在事件堆中，
+ * 重传计时器挂在分层时间轮上，二者共用虚拟时钟。
+ * 多路复用时各会话共用信道、帧池与时间轮，到达的报文按连接号在会话表中找到所属会话 */
+typedef struct {
+    event_queue_t events;       // 帧到达事件队列
+    timing_wheel_t wheel;       // 计时器（全双工时两个方向的计时器挂在同一个时间轮上）
+    double now;                 // 当前虚拟时刻（毫秒）
+    double wall_start_ms;       // 仿真开始时的单调时钟时刻
+    sim_channel_t* channel;     // 仿真信道
+    frame_pool_t pool;          // 数据帧池：发送窗口、信道与接收缓冲区之间以句柄传递帧
+    uint32_t rng_state;         // 仿真信道的随机数状态（每次传输独立，可在多线程中并行仿真）
+    bool out_of_memory;         // 事件调度失败
+    uint64_t timers_fired;      // 到期的计时器数
+    session_table_t sessions;   // 连接号 → 会话（会话的正向传输方向）
+    struct arq_run** flows;     // 全部传输方向，按会话顺序排列（全双工会话的反方向紧随正向）
+    int flow_count;
+    struct arq_run** dirty;     // 本轮事件改变了状态的传输方向
+    int dirty_count;
+    int sessions_open;          // 尚未结束的会话数
+} arq_sim_t;
+
+/* 一个传输方向的上下文：发送方、信道与接收方都由事件驱动。
+ * 全双工时两个方向各有一个上下文，通过 peer 互指并共用同一个仿真核心；
+ * 一个会话即一个连接号下的正向（及全双工的反向）传输方向 */
+typedef struct arq_run {
+    const arq_config_t* arq;
+    const network_config_t* config;
+    statistics_t* stats;
+    window_sender_t* sender;
+    window_receiver_t* receiver;
+    arq_source_fn source;       // 发送方的数据源
+    void* source_context;
+    arq_sink_fn sink;           // 接收方的数据汇
+    void* sink_context;
+    size_t bytes_read;          // 已从数据源读出的字节数
+    bool sink_failed;           // 数据汇拒绝接收，传输中止
+    transport_t* transport;     // 真实传输端点（为NULL时使用仿真信道）
+    arq_sim_t* sim;             // 仿真核心（虚拟时钟、事件、计时器与信道）
+    struct arq_run* peer;       // 全双工：反方向的传输（它的数据帧捎带本方向的确认），单工为NULL
+    channel_link_t* data_link;  // 本方向数据帧经过的信道方向
+    channel_link_t* ack_link;   // 本方向确认帧经过的信道方向
+    ack_frame_t pending_ack;    // 等待捎带（全双工）或合并（延迟确认）的确认
+    bool ack_pending;
+    int held_frames;            // 等待中的确认已覆盖的数据帧数
+    wheel_timer_t ack_timer;    // 确认等待计时器：到期时仍未被捎带或凑满 k 帧，单独发送确认
+    uint32_t seed;              // 仿真信道的随机种子（0 表示由 rand() 决定）
+    bool quiet;                 // 不输出传输开始与结束的提示
+    bool stream_finished;       // 接收方已按序收到结束帧
+    bool retries_exhausted;     // 超时重传次数超限
+    uint32_t conn_id;           // 连接号（单会话为0，多路复用时从1开始编号）
+    struct arq_run* session;    // 所属会话的正向传输方向（正向指向自身）
+    int index;                  // 在 flows 中的位置：同一轮内按此顺序补发新帧
+    bool dirty;                 // 已在 dirty 列表中
+    bool finished;              // 会话已结束（成功或失败），不再发送
+    bool completed;             // 会话成功完成（数据全部按序交付）
+} arq_run_t;
+
+/* 协议事件日志：带虚拟时间戳，只在开启 verbose 且跟踪级别为 TRACE_LEVEL_TEXT 时输出 */
+#define ARQ_TRACE(run, ...) do { \
+        if ((run)->arq->verbose && get_trace_level() >= TRACE_LEVEL_TEXT) { \
+            printf("[%9.1f ms] ", (run)->sim->now); \
+            printf(__VA_ARGS__); \
+        } \
+    } while (0)
+
+/* 二进制事件记录：虚拟时间戳与连接号取自传输方向，不做格式化 */
+#define ARQ_EVENT(run, type, seq, size) \
+    record_trace_event((type), (run)->sim->now, (run)->conn_id, (seq), (size_t)(size))
 
 /**
- * 打印数据帧信息
- * @param frame 数据帧
- * @param direction 方向描述
+ * 实时模式：休眠到虚拟时刻对应的墙钟时刻
+ * @param run 仿真上下文
+ * @param time 虚拟时刻
  */
-void print_frame_info(const data_frame_t* frame, const char* direction) {
-    if (!frame || !direction) return;
+static void pace_to_wall_clock(const arq_run_t* run, double time) {
+    double wait_ms = run->sim->wall_start_ms + time - monotonic_clock_ms();
+    if (wait_ms <= 0) return;
+    
+    struct timespec ts;
+    ts.tv_sec = (time_t)(wait_ms / 1000);
+    ts.tv_nsec = (long)((wait_ms - ts.tv_sec * 1000.0) * 1e6);
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * 调度一个事件，失败时标记上下文
+ * @param run 仿真上下文
+ * @param time 事件时刻
+ * @param type 事件类型
+ * @param arg 事件参数
+ */
+static void arq_schedule(arq_run_t* run, double time, sim_event_type_t type, int arg) {
+    if (!schedule_event(&run->sim->events, time, type, arg)) {
+        run->sim->out_of_memory = true;
+    }
+}
+
+/**
+ * 设置仿真信道的随机种子
+ * @param sim 仿真核心
+ * @param seed 种子（0 会被替换为固定的非零值）
+ */
+static void seed_channel_random(arq_sim_t* sim, uint32_t seed) {
+    sim->rng_state = seed ? seed : CHANNEL_DEFAULT_SEED;
+}
+
+/**
+ * 仿真信道的随机数（xorshift32）
+ * @param run 仿真上下文
+ * @return [0, 1) 之间的随机数
+ */
+static double channel_random(arq_run_t* run) {
+    uint32_t x = run->sim->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    run->sim->rng_state = x;
+    return x / 4294967296.0;
+}
+
+/**
+ * 初始化信道的一个方向
+ * @param link 信道方向
+ * @param capacity 槽位数
+ * @return 是否分配成功
+ */
+static bool init_channel_link(channel_link_t* link, int capacity) {
+    link->slots = malloc(sizeof(channel_slot_t) * (size_t)capacity);
+    link->free_slots = malloc(sizeof(int) * (size_t)capacity);
+    if (!link->slots || !link->free_slots) return false;
     
-    printf("[数据帧%s] 类型: %s, 序列号: %d, 长度: %d, 校验和: %u\n",
-           direction,
-           frame->type == DATA_FRAME ? "数据" : "未知",
-           frame->seq_num,
-           frame->data_length,
-           frame->checksum);
-    printf("           数据内容: \"%.50s%s\"\n", 
-           frame->data, frame->data_length > 50 ? "..." : "");
+    for (int i = 0; i < capacity; i++) {
+        link->free_slots[i] = capacity - 1 - i;
+    }
+    link->free_count = capacity;
+    link->capacity = capacity;
+    return true;
 }
 
 /**
- * 打印确认帧信息
- * @param ack 确认帧
- * @param direction 方向描述
+ * 释放信道的一个方向
+ * @param link 信道方向
  */
-void print_ack_info(const ack_frame_t* ack, const char* direction) {
-    if (!ack || !direction) return;
+static void free_channel_link(channel_link_t* link) {
+    free(link->slots);
+    free(link->free_slots);
+    link->slots = NULL;
+    link->free_slots = NULL;
+}
+
+/**
+ * 按丢包模型抽取一次。启用 Gilbert-Elliott 模型时先按转移概率更新状态，
+ * 好状态按 loss_probability、坏状态按 burst_loss_probability 丢包，形成突发丢包
+ * @param run 仿真上下文
+ * @param link 信道方向
+ * @return 是否丢失帧
+ */
+static bool roll_frame_loss(arq_run_t* run, channel_link_t* link) {
+    const network_config_t* config = run->config;
+    if (config->burst_enter_probability <= 0.0) {
+        return channel_random(run) < config->loss_probability;
+    }
     
-    printf("[确认帧%s] 类型: %s, 确认号: %d, 校验和: %u\n",
-           direction,
-           ack->type == ACK_FRAME ? "确认" : "未知",
-           ack->ack_num,
-           ack->checksum);
+    double transition = channel_random(run);
+    if (link->bad_state) {
+        if (transition < config->burst_exit_probability) link->bad_state = false;
+    } else if (transition < config->burst_enter_probability) {
+        link->bad_state = true;
+    }
+    double loss = link->bad_state ? config->burst_loss_probability : config->loss_probability;
+    return channel_random(run) < loss;
 }
 
 /**
- * 打印统计信息
- * @param stats 统计信息
+ * 帧进入瓶颈链路：排在已排队的帧之后按带宽串行化发送
+ * @param run 仿真上下文
+ * @param link 信道方向
+ * @param length 报文长度
+ * @param depart 输出帧发送完毕（离开瓶颈链路）的时刻
+ * @return 是否进入队列（队列已满时尾部丢弃）
  */
-void print_statistics(const statistics_t* stats) {
-    if (!stats) return;
+static bool channel_enqueue(arq_run_t* run, channel_link_t* link, size_t length, double* depart) {
+    const network_config_t* config = run->config;
+    if (config->bandwidth_bps <= 0) {
+        *depart = run->sim->now;
+        return true;
+    }
     
-    double duration = ((double)(stats->end_time - stats->start_time)) / CLOCKS_PER_SEC;
+    while (link->queue_count > 0 && link->departures[link->queue_head] <= run->sim->now) {
+        link->queue_head = (link->queue_head + 1) % CHANNEL_CAPACITY;
+        link->queue_count--;
+    }
+    int limit = (config->queue_limit > 0 && config->queue_limit < CHANNEL_CAPACITY)
+                ? config->queue_limit : CHANNEL_CAPACITY;
+    if (link->queue_count >= limit) return false;
+    
+    double start = link->link_free_at > run->sim->now ? link->link_free_at : run->sim->now;
+    link->link_free_at = start + length * 8 * 1000.0 / config->bandwidth_bps;
+    link->departures[(link->queue_head + link->queue_count++) % CHANNEL_CAPACITY] = link->link_free_at;
+    *depart = link->link_free_at;
+    return true;
+}
+
+/**
+ * 计算帧的到达时刻：离开瓶颈链路后加上随机传播时延。按序的帧不早于前一帧到达；
+ * 被选中乱序的帧再额外延迟，且不受先后约束，之后发出的帧可能先到
+ * @param run 仿真上下文
+ * @param link 信道方向
+ * @param depart 离开瓶颈链路的时刻
+ * @return 到达时刻
+ */
+static double channel_arrival_time(arq_run_t* run, channel_link_t* link, double depart) {
+    const network_config_t* config = run->config;
+    int spread = config->max_delay_ms - config->min_delay_ms + 1;
+    double arrival = depart + config->min_delay_ms + (int)(channel_random(run) * spread);
+    
+    if (config->reorder_probability > 0.0 && channel_random(run) < config->reorder_probability) {
+        run->stats->reordered_frames++;
+        return arrival + 1 + (int)(channel_random(run) * config->reorder_delay_ms);
+    }
+    if (arrival < link->last_arrival) arrival = link->last_arrival;
+    link->last_arrival = arrival;
+    return arrival;
+}
+
+/* ========== 真实传输 ========== */
+
+/**
+ * 发送方：把数据帧按紧凑格式编码后交给传输端点
+ * @param run 上下文
+ * @param frame 数据帧
+ */
+static void transport_send_data(arq_run_t* run, const data_frame_t* frame) {
+    uint8_t packet[WIRE_MAX_DATA_FRAME];
+    size_t length = encode_data_frame(frame, packet, sizeof(packet));
+    if (length > 0 && transport_enqueue(run->transport, packet, length)) {
+        run->stats->wire_bytes += (long)length;
+    } else {
+        run->stats->frames_lost++;
+        ARQ_EVENT(run, TRACE_FRAME_LOST, frame->seq_num, frame->data_length);
+        ARQ_TRACE(run, "[损伤注入] 数据帧 (序列号 %d) 丢失\n", frame->seq_num);
+    }
+}
+
+/**
+ * 接收方：把确认帧按紧凑格式编码后交给传输端点
+ * @param run 上下文
+ * @param ack 确认帧
+ */
+static void transport_send_ack(arq_run_t* run, const ack_frame_t* ack) {
+    uint8_t packet[WIRE_MAX_ACK_FRAME];
+    size_t length = encode_ack_frame(ack, packet, sizeof(packet));
+    if (length > 0 && transport_enqueue(run->transport, packet, length)) {
+        run->stats->wire_bytes += (long)length;
+    } else {
+        run->stats->frames_lost++;
+        ARQ_EVENT(run, TRACE_FRAME_LOST, ack->ack_num, 0);
+        ARQ_TRACE(run, "[损伤注入] 确认帧 (确认号 %d) 丢失\n", ack->ack_num);
+    }
+}
+
+/**
+ * 按配置决定报文是否被损坏（未启用损坏时不消耗随机数，不改变其余场景的随机序列）
+ * @param run 仿真上下文
+ * @return 报文是否被损坏
+ */
+static bool roll_corruption(arq_run_t* run) {
+    const network_config_t* config = run->config;
+    if (config->corruption_probability <= 0.0 || config->corruption_bits < 1) return false;
+    return channel_random(run) < config->corruption_probability;
+}
+
+/**
+ * 损坏报文：随机翻转 corruption_bits 个不同的比特
+ * @param run 仿真上下文
+ * @param wire 报文
+ * @param length 报文长度
+ */
+static void corrupt_wire_bytes(arq_run_t* run, uint8_t* wire, size_t length) {
+    const network_config_t* config = run->config;
+    size_t total_bits = length * 8;
+    size_t flips = (size_t)config->corruption_bits < total_bits ? (size_t)config->corruption_bits : total_bits;
+    size_t flipped[64];
+    size_t count = 0;
+    while (count < flips && count < 64) {
+        size_t bit = (size_t)(channel_random(run) * total_bits);
+        bool repeated = false;
+        for (size_t i = 0; i < count; i++) repeated |= flipped[i] == bit;
+        if (repeated) continue;
+        flipped[count++] = bit;
+        wire[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    run->stats->corrupted_frames++;
+}
+
+/**
+ * 把报文放入槽位。数据帧只复制报头并引用帧池中的帧；
+ * 被损坏时先在槽位中编码出完整报文（私有副本）再翻转比特，帧池中的帧保持不变
+ * @param run 仿真上下文
+ * @param slot 槽位
+ * @param handle 数据帧句柄（FRAME_NONE 表示 bytes 为完整报文）
+ * @param bytes 数据帧的报头，或完整报文
+ * @param bytes_length bytes 的长度
+ * @param checksum 数据帧的尾部校验和
+ * @param length 报文在线路上的长度
+ */
+static void fill_channel_slot(arq_run_t* run, channel_slot_t* slot, int handle, const uint8_t* bytes,
+                              size_t bytes_length, uint32_t checksum, size_t length) {
+    frame_pool_t* pool = &run->sim->pool;
+    slot->frame = handle;
+    slot->length = length;
+    slot->stats = run->stats;
+    if (handle == FRAME_NONE) {
+        memcpy(slot->wire, bytes, bytes_length);
+    } else {
+        retain_frame(pool, handle);
+        memcpy(slot->header, bytes, bytes_length);
+        slot->header_length = bytes_length;
+        slot->checksum = checksum;
+    }
     
-    printf("\n========== 传输统计 ==========\n");
-    printf("传输时间:     %.3f 秒\n", duration);
-    printf("发送帧数:     %d\n", stats->frames_sent);
-    printf("接收帧数:     %d\n", stats->frames_received);
-    printf("发送确认数:   %d\n", stats->acks_sent);
-    printf("接收确认数:   %d\n", stats->acks_received);
-    printf("重传次数:     %d\n", stats->retransmissions);
-    printf("丢失帧数:     %d\n", stats->frames_lost);
+    slot->corrupted = roll_corruption(run);
+    if (!slot->corrupted) return;
+    if (handle != FRAME_NONE) {
+        // 报头在发送时刚编码，帧的确认字段尚未改变，重新编码得到同样的报文
+        encode_data_frame(frame_at(pool, handle), slot->wire, sizeof(slot->wire));
+        release_frame(pool, handle);
+        slot->frame = FRAME_NONE;
+    }
+    corrupt_wire_bytes(run, slot->wire, length);
+}
+
+/**
+ * 抓包：把进入信道的报文拼成完整的线路格式交给抓包回调（发送端视角，之后在信道中丢失的帧也会记录）
+ * @param run 仿真上下文
+ * @param link 信道方向
+ * @param handle 数据帧句柄（FRAME_NONE 表示 bytes 为完整报文）
+ * @param bytes 数据帧的报头，或完整报文
+ * @param bytes_length bytes 的长度
+ * @param checksum 数据帧的尾部校验和
+ */
+static void capture_channel_packet(arq_run_t* run, const channel_link_t* link, int handle,
+                                   const uint8_t* bytes, size_t bytes_length, uint32_t checksum) {
+    const uint8_t* packet = bytes;
+    size_t length = bytes_length;
+    uint8_t wire[WIRE_MAX_DATA_FRAME];
+    if (handle != FRAME_NONE) {
+        const data_frame_t* frame = frame_at(&run->sim->pool, handle);
+        memcpy(wire, bytes, bytes_length);
+        memcpy(wire + length, frame->data, (size_t)frame->data_length);
+        length += (size_t)frame->data_length;
+        for (int i = 0; i < WIRE_TRAILER; i++) {
+            wire[length++] = (uint8_t)(checksum >> (8 * i));
+        }
+        packet = wire;
+    }
+    run->arq->capture(run->sim->now, link == &run->sim->channel->data, packet, length, run->arq->capture_context);
+}
+
+/**
+ * 报文进入信道的一个方向：依次经过丢包、瓶颈队列、复制与比特损坏，为每个副本调度到达事件
+ * @param run 仿真上下文
+ * @param link 信道方向
+ * @param handle 数据帧句柄（FRAME_NONE 表示 bytes 为完整报文）
+ * @param bytes 数据帧的报头，或完整报文
+ * @param bytes_length bytes 的长度
+ * @param checksum 数据帧的尾部校验和
+ * @return 是否至少有一份进入信道（用于日志）
+ */
+static bool channel_transmit(arq_run_t* run, channel_link_t* link, int handle, const uint8_t* bytes,
+                             size_t bytes_length, uint32_t checksum) {
+    const network_config_t* config = run->config;
+    statistics_t* stats = run->stats;
+    sim_event_type_t type = (link == &run->sim->channel->data) ? EVENT_DATA_ARRIVAL : EVENT_ACK_ARRIVAL;
+    size_t length = bytes_length;
+    double depart;
+    
+    if (handle != FRAME_NONE) length += frame_at(&run->sim->pool, handle)->data_length + WIRE_TRAILER;
+    if (run->arq->capture) capture_channel_packet(run, link, handle, bytes, bytes_length, checksum);
+    if (roll_frame_loss(run, link)) {
+        stats->frames_lost++;
+        return false;
+    }
+    if (!channel_enqueue(run, link, length, &depart)) {
+        stats->frames_lost++;
+        stats->queue_drops++;
+        return false;
+    }
+    stats->wire_bytes += (long)length;
     
-    if (stats->frames_sent > 0) {
-        double success_rate = ((double)(stats->frames_sent - stats->frames_lost)) / stats->frames_sent * 100;
-        printf("传输成功率:   %.1f%%\n", success_rate);
+    int copies = 1;
+    if (config->duplicate_probability > 0.0 && channel_random(run) < config->duplicate_probability) {
+        copies = 2;
+    }
+    bool sent = false;
+    for (int copy = 0; copy < copies; copy++) {
+        if (link->free_count == 0) {    // 在途帧超过信道容量（复制出的副本直接放弃，不计入复制帧数）
+            if (copy == 0) stats->frames_lost++;
+            continue;
+        }
+        if (copy == 1) stats->network_duplicates++;
+        int index = link->free_slots[--link->free_count];
+        fill_channel_slot(run, &link->slots[index], handle, bytes, bytes_length, checksum, length);
+        arq_schedule(run, channel_arrival_time(run, link, depart), type, index);
+        sent = true;
+    }
+    return sent;
+}
+
+/**
+ * 全双工：数据帧出发前捎带反方向等待中的确认（撤销其捎带等待计时器），没有则清空确认字段
+ * 帧的确认字段在每次（重）发送时重新填写，总是携带最新的确认
+ * @param run 数据帧所属的传输方向
+ * @param frame 数据帧
+ */
+static void attach_piggyback_ack(arq_run_t* run, data_frame_t* frame) {
+    arq_run_t* reverse = run->peer;
+    if (!reverse || !reverse->ack_pending) {
+        frame->ack_num = -1;
+        frame->sack_bitmap = 0;
+        return;
     }
     
-    if (stats->retransmissions > 0 && stats->frames_received > 0) {
-        double retrans_rate = ((double)stats->retransmissions) / stats->frames_sent * 100;
-        printf("重传率:       %.1f%%\n", retrans_rate);
+    frame->ack_num = reverse->pending_ack.ack_num;
+    frame->sack_bitmap = reverse->pending_ack.sack_bitmap;
+    reverse->ack_pending = false;
+    reverse->held_frames = 0;
+    cancel_timer(&run->sim->wheel, &reverse->ack_timer);
+    reverse->stats->piggybacked_acks++;
+    ARQ_TRACE(run, "[捎带] 数据帧 (序列号 %d) 携带反方向确认 %d\n", frame->seq_num, frame->ack_num);
+}
+
+/**
+ * 数据帧进入信道：真实传输时编码后交给传输端点；仿真信道只编码报头、计算校验和，
+ * 载荷留在帧池中由信道引用，重传也不复制载荷
+ * @param run 仿真上下文
+ * @param handle 发送窗口中的帧句柄（全双工时填写帧的捎带确认字段）
+ */
+static void channel_send_data(arq_run_t* run, int handle) {
+    data_frame_t* frame = frame_at(&run->sim->pool, handle);
+    run->stats->frames_sent++;
+    ARQ_EVENT(run, TRACE_DATA_SEND, frame->seq_num, frame->data_length);
+    attach_piggyback_ack(run, frame);
+    if (run->transport) {
+        transport_send_data(run, frame);
+        return;
     }
     
-    printf("=============================\n");
+    uint8_t header[WIRE_MAX_DATA_HEADER];
+    size_t header_length = encode_data_header(frame, header);
+    if (header_length == 0) {
+        run->stats->frames_lost++;
+        ARQ_TRACE(run, "[网络模拟] 数据帧 (序列号 %d) 编码失败\n", frame->seq_num);
+        return;
+    }
+    uint32_t checksum = calculate_wire_checksum(header, header_length, frame->data, frame->data_length);
+    if (!channel_transmit(run, run->data_link, handle, header, header_length, checksum)) {
+        ARQ_EVENT(run, TRACE_FRAME_LOST, frame->seq_num, frame->data_length);
+        ARQ_TRACE(run, "[网络模拟] 数据帧 (序列号 %d) 丢失\n", frame->seq_num);
+    }
+}
+
+/**
+ * 单独的确认帧（或否定确认帧）进入信道
+ * @param run 仿真上下文
+ * @param ack 确认帧
+ */
+static void transmit_ack_frame(arq_run_t* run, const ack_frame_t* ack) {
+    ack_frame_t frame = *ack;
+    frame.conn_id = run->conn_id;
+    if (ack->type == NAK_FRAME) {
+        run->stats->naks_sent++;
+        ARQ_EVENT(run, TRACE_NAK_SEND, ack->ack_num, 0);
+    } else {
+        run->stats->acks_sent++;
+        ARQ_EVENT(run, TRACE_ACK_SEND, ack->ack_num, 0);
+    }
+    if (run->transport) {
+        transport_send_ack(run, &frame);
+        return;
+    }
+    
+    uint8_t wire[WIRE_MAX_ACK_FRAME];
+    size_t length = encode_ack_frame(&frame, wire, sizeof(wire));
+    if (length == 0) {
+        run->stats->frames_lost++;
+        ARQ_TRACE(run, "[网络模拟] 确认帧 (确认号 %d) 编码失败\n", ack->ack_num);
+        return;
+    }
+    if (!channel_transmit(run, run->ack_link, FRAME_NONE, wire, length, 0)) {
+        ARQ_EVENT(run, TRACE_FRAME_LOST, ack->ack_num, 0);
+        ARQ_TRACE(run, "[网络模拟] 确认帧 (确认号 %d) 丢失\n", ack->ack_num);
+    }
+}
+
+/**
+ * 等待中的确认立即单独发出（捎带或延迟等待到期、凑满 k 帧、需要立即确认时）
+ * @param run 仿真上下文
+ */
+static void flush_pending_ack(arq_run_t* run) {
+    if (!run->ack_pending) return;
+    run->ack_pending = false;
+    run->held_frames = 0;
+    cancel_timer(&run->sim->wheel, &run->ack_timer);
+    transmit_ack_frame(run, &run->pending_ack);
+}
+
+/**
+ * 发出接收方的确认。确认可以先等待一段时间：全双工时等待反向数据帧捎带，
+ * 启用延迟确认时等待后续数据帧，每 k 帧合并成一个确认；等待时长取二者的较大值，到期仍未发出则单独发送。
+ * 累积确认（回退N帧、SACK）中新确认包含旧确认的信息，直接替换；
+ * 选择重传的单帧确认互不包含，不做延迟确认，已有等待捎带的确认时先把它单独发出；
+ * 停等协议每次只有一帧在途，没有可合并的确认，也不做延迟确认
+ * @param run 仿真上下文
+ * @param ack 确认帧
+ * @param urgent 失序、重复或填补空缺的帧：延迟确认时立即发送，让发送方尽快得知空缺
+ */
+static void channel_send_ack(arq_run_t* run, const ack_frame_t* ack, bool urgent) {
+    const arq_config_t* arq = run->arq;
+    bool cumulative = arq->mode != ARQ_SELECTIVE_REPEAT || arq->sack;
+    bool delayed = cumulative && arq->ack_every > 1 && arq->window_size > 1;
+    int hold_ms = run->peer ? arq->piggyback_delay_ms : 0;
+    if (delayed && arq->ack_delay_ms > hold_ms) hold_ms = arq->ack_delay_ms;
+    if (hold_ms <= 0) {
+        transmit_ack_frame(run, ack);
+        return;
+    }
+    
+    if (run->ack_pending && !cumulative && run->pending_ack.ack_num != ack->ack_num) {
+        transmit_ack_frame(run, &run->pending_ack);
+    } else if (run->ack_pending) {
+        run->stats->coalesced_acks++;
+    }
+    bool armed = run->ack_pending;
+    run->pending_ack = *ack;
+    run->ack_pending = true;
+    run->held_frames++;
+    if (delayed && (urgent || run->held_frames >= arq->ack_every)) {
+        flush_pending_ack(run);
+    } else if (!armed) {
+        run->ack_timer.owner = run;
+        arm_timer(&run->sim->wheel, &run->ack_timer, run->sim->now + hold_ms);
+    }
+}
+
+/**
+ * 统计损坏帧的检出情况（信道知道哪些帧被翻转过比特，可以据此统计漏检）
+ * @param run 仿真上下文
+ * @param slot 到达的帧（检出情况计入发送该帧的方向）
+ * @param intact 帧是否通过了校验
+ */
+static void count_corruption(arq_run_t* run, const channel_slot_t* slot, bool intact) {
+    if (!slot->corrupted) return;
+    if (intact) {
+        slot->stats->undetected_errors++;
+        ARQ_TRACE(run, "[网络模拟] 损坏的帧通过了校验（漏检）\n");
+    } else {
+        slot->stats->corruption_detected++;
+    }
+}
+
+/**
+ * 取出到达的报文：释放槽位并返回报文（槽位在下一次发送前不会被覆盖）
+ * @param link 信道方向
+ * @param index 槽位号（到达事件的参数）
+ * @return 槽位
+ */
+static const channel_slot_t* channel_take(channel_link_t* link, int index) {
+    link->free_slots[link->free_count++] = index;
+    return &link->slots[index];
+}
+
+/**
+ * 取出一个到达的报文并校验。引用帧池的数据帧直接对报头与池中的载荷计算校验和，不复制载荷；
+ * 完整报文（被损坏过）解码到新取的帧中
+ * @param run 仿真上下文
+ * @param link 信道方向
+ * @param index 槽位号
+ * @param handle 输出的数据帧句柄（调用方持有一个引用，处理完后释放），其他情况为 FRAME_NONE
+ * @param ack 输出的确认帧；数据帧时为捎带的确认（确认号为-1表示没有）
+ * @param conn_id 输出的连接号（未通过校验时为报文中读出的值，不一定可信）
+ * @return 帧类型，未通过校验时返回-1
+ */
+static int channel_receive(arq_run_t* run, channel_link_t* link, int index, int* handle, ack_frame_t* ack,
+                           uint32_t* conn_id) {
+    frame_pool_t* pool = &run->sim->pool;
+    const channel_slot_t* slot = channel_take(link, index);
+    *handle = slot->frame;      // 槽位的引用转交给调用方
+    
+    int type = -1;
+    if (slot->frame != FRAME_NONE) {
+        const data_frame_t* frame = frame_at(pool, slot->frame);
+        wire_data_header_t header;
+        if (calculate_wire_checksum(slot->header, slot->header_length, frame->data, frame->data_length) == slot->checksum &&
+            decode_data_header(slot->header, slot->header_length, &header) > 0) {
+            fill_ack_frame(ack, header.ack_num, header.sack_bitmap);
+            ack->conn_id = header.conn_id;
+            type = DATA_FRAME;
+        }
+    } else if (slot->wire[0] == DATA_FRAME) {
+        *handle = acquire_frame(pool);
+        if (*handle == FRAME_NONE) {
+            run->sim->out_of_memory = true;
+        } else {
+            data_frame_t* frame = frame_at(pool, *handle);
+            type = decode_frame(slot->wire, slot->length, frame, ack);
+            if (type == DATA_FRAME) {
+                fill_ack_frame(ack, frame->ack_num, frame->sack_bitmap);
+                ack->conn_id = frame->conn_id;
+            }
+        }
+    } else {
+        type = decode_frame(slot->wire, slot->length, NULL, ack);
+    }
+    
+    *conn_id = ack->conn_id;
+    if (type < 0) {
+        release_frame(pool, *handle);
+        *handle = FRAME_NONE;
+        if (!peek_connection_id(slot->frame != FRAME_NONE ? slot->header : slot->wire,
+                                slot->frame != FRAME_NONE ? slot->header_length : slot->length, conn_id)) {
+            *conn_id = 0;
+        }
+    }
+    count_corruption(run, slot, type >= 0);
+    return type;
+}
+
+/**
+ * 验证窗口协议配置
+ * @param arq 窗口协议配置
+ * @return 配置是否有效
+ */
+bool validate_arq_config(const arq_config_t* arq) {
+    if (!arq) return false;
+    
+    if (arq->window_size < 1 || arq->window_size > MAX_WINDOW_SIZE) {
+        printf("[错误] 窗口大小必须在 1-%d 之间\n", MAX_WINDOW_SIZE);
+        return false;
+    }
+    if (arq->mode == ARQ_STOP_AND_WAIT && arq->window_size != 1) {
+        printf("[错误] 停等协议的窗口大小必须为1\n");
+        return false;
+    }
+    if (arq->sack && arq->mode == ARQ_STOP_AND_WAIT) {
+        printf("[错误] 停等协议不支持SACK\n");
+        return false;
+    }
+    // 选择重传（以及启用SACK、缓存失序帧）的接收窗口与发送窗口等大，新旧两个窗口的序列号不能重叠
+    bool buffering = (arq->mode == ARQ_SELECTIVE_REPEAT || arq->sack);
+    int min_space = buffering ? 2 * arq->window_size : arq->window_size + 1;
+    if (arq->seq_space < min_space) {
+        printf("[错误] 序列号空间 %d 过小，%s%s窗口为 %d 时至少需要 %d\n",
+               arq->seq_space, arq_mode_name(arq->mode), arq->sack ? "+SACK" : "",
+               arq->window_size, min_space);
+        return false;
+    }
+    if (arq->payload_size < 1 || arq->payload_size > MAX_DATA_SIZE - 1) {
+        printf("[错误] 每帧数据长度必须在 1-%d 字节之间\n", MAX_DATA_SIZE - 1);
+        return false;
+    }
+    if (arq->timeout_ms <= 0 || arq->max_retries < 1) {
+        printf("[错误] 超时时间和最大重传次数必须为正数\n");
+        return false;
+    }
+    if (arq->adaptive_rto && (arq->min_rto_ms <= 0 || arq->max_rto_ms < arq->min_rto_ms)) {
+        printf("[错误] RTO上下限无效 (下限 %d, 上限 %d)\n", arq->min_rto_ms, arq->max_rto_ms);
+        return false;
+    }
+    if (arq->ack_every < 1 || arq->ack_delay_ms < 0) {
+        printf("[错误] 延迟确认的帧数须为正数，等待时间不能为负\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 当前的重传超时：自适应时取估计器的RTO，否则为固定的 timeout_ms
+ * @param run 仿真上下文
+ * @return 毫秒数
+ */
+static double current_rto(const arq_run_t* run) {
+    return run->arq->adaptive_rto ? run->sender->rto.rto_ms : run->arq->timeout_ms;
+}
+
+/**
+ * 确认到达时采集RTT样本（Karn算法：重传过的帧无法区分确认对应哪次发送，不采样，只清除退避）
+ * @param run 仿真上下文
+ * @param frame_no 被确认的帧号
+ */
+static void sample_rtt(arq_run_t* run, int frame_no) {
+    int slot = frame_no % run->arq->window_size;
+    if (!run->arq->adaptive_rto) return;
+    
+    if (run->sender->frame_retransmitted[slot]) {
+        clear_rto_backoff(&run->sender->rto);
+    } else {
+        update_rto_estimator(&run->sender->rto, run->sim->now - run->sender->frame_sent_ms[slot]);
+    }
+}
+
+/**
+ * 窗口计时器超时后退避共用的RTO
+ * @param run 仿真上下文
+ */
+static void backoff_rto(arq_run_t* run) {
+    if (run->arq->adaptive_rto) backoff_rto_estimator(&run->sender->rto);
+}
+
+/**
+ * 启动（或重启）窗口发送方的重传计时器
+ * @param run 仿真上下文
+ */
+static void restart_window_timer(arq_run_t* run) {
+    run->sender->window_timer.owner = run;
+    arm_timer(&run->sim->wheel, &run->sender->window_timer, run->sim->now + current_rto(run));
+}
+
+/**
+ * 选择重传：启动单帧计时器
+ * 退避按帧进行（该帧每超时一次超时值加倍），一帧丢失不会拖慢窗口内其他帧的计时器
+ * @param run 仿真上下文
+ * @param frame_no 帧号
+ */
+static void start_frame_timer(arq_run_t* run, int frame_no) {
+    int slot = frame_no % run->arq->window_size;
+    wheel_timer_t* timer = &run->sender->frame_timers[slot];
+    double timeout = current_rto(run);
+    if (run->arq->adaptive_rto) {
+        for (int i = 0; i < run->sender->frame_retries[slot] && timeout < run->sender->rto.max_rto_ms; i++) {
+            timeout *= 2;
+        }
+        if (timeout > run->sender->rto.max_rto_ms) timeout = run->sender->rto.max_rto_ms;
+    }
+    timer->id = frame_no;
+    timer->owner = run;
+    arm_timer(&run->sim->wheel, timer, run->sim->now + timeout);
+}
+
+/* ---------- 拥塞控制（慢启动、拥塞避免与 NewReno 快速恢复，以帧为单位） ---------- */
+
+/**
+ * 设置拥塞窗口与慢启动阈值，累计时间加权面积并通知跟踪回调
+ * @param run 仿真上下文
+ * @param cwnd 新的拥塞窗口
+ * @param ssthresh 新的慢启动阈值
+ */
+static void set_congestion_window(arq_run_t* run, double cwnd, double ssthresh) {
+    window_sender_t* sender = run->sender;
+    double limit = run->arq->window_size;
+    if (cwnd < 1) cwnd = 1;
+    // 超出窗口大小的部分发不出去，不再增长（避免长时间无丢包后窗口虚高、丢包时减不下来）
+    if (cwnd > limit && !sender->in_recovery) cwnd = limit;
+    
+    sender->cwnd_area += sender->cwnd * (run->sim->now - sender->cwnd_changed_ms);
+    sender->cwnd_changed_ms = run->sim->now;
+    if (cwnd == sender->cwnd && ssthresh == sender->ssthresh) return;
+    
+    sender->cwnd = cwnd;
+    sender->ssthresh = ssthresh;
+    if (cwnd > run->stats->cwnd_max) run->stats->cwnd_max = cwnd;
+    if (run->arq->cwnd_trace) {
+        run->arq->cwnd_trace(run->sim->now, cwnd, ssthresh, run->arq->cwnd_trace_context);
+    }
+}
+
+/**
+ * 传输开始时的拥塞窗口：从 CWND_INITIAL 帧慢启动，阈值取窗口大小
+ * @param run 仿真上下文
+ */
+static void init_congestion_window(arq_run_t* run) {
+    window_sender_t* sender = run->sender;
+    if (!run->arq->congestion_control) return;
+    sender->cwnd = 0;
+    sender->cwnd_changed_ms = run->sim->now;
+    set_congestion_window(run, CWND_INITIAL, run->arq->window_size);
+}
+
+/**
+ * 实际可用的发送窗口：未启用拥塞控制时即窗口大小
+ * @param run 仿真上下文
+ * @return 在途帧数上限
+ */
+static int send_window(const arq_run_t* run) {
+    int window = run->arq->window_size;
+    if (run->arq->congestion_control && run->sender->cwnd < window) {
+        window = (int)run->sender->cwnd;
+    }
+    return window < 1 ? 1 : window;
+}
+
+/**
+ * 出现丢包时的乘性减：慢启动阈值取在途帧数的一半
+ * 丢失的帧早于上一次减窗时的 recover 时说明属于同一窗口，不重复减小阈值
+ * @param run 仿真上下文
+ * @param frame_no 丢失的帧号
+ * @return 本次是否减小了阈值
+ */
+static bool reduce_ssthresh(arq_run_t* run, int frame_no) {
+    window_sender_t* sender = run->sender;
+    if (frame_no < sender->recover) return false;
+    
+    double flight = sender->next_frame - sender->base;
+    double ssthresh = flight / 2;
+    if (ssthresh < CWND_MIN_SSTHRESH) ssthresh = CWND_MIN_SSTHRESH;
+    sender->ssthresh = ssthresh;
+    sender->recover = sender->next_frame;
+    run->stats->cwnd_reductions++;
+    return true;
+}
+
+/**
+ * 超时：拥塞窗口回到1帧重新慢启动，退出快速恢复
+ * @param run 仿真上下文
+ * @param frame_no 超时的帧号（回退N帧为窗口左沿）
+ */
+static void congestion_timeout(arq_run_t* run, int frame_no) {
+    window_sender_t* sender = run->sender;
+    if (!run->arq->congestion_control) return;
+    
+    reduce_ssthresh(run, frame_no);
+    sender->in_recovery = false;
+    sender->dup_acks = 0;
+    set_congestion_window(run, 1, sender->ssthresh);
+    ARQ_TRACE(run, "[拥塞控制] 超时，cwnd=1, ssthresh=%.1f\n", sender->ssthresh);
+}
+
+/**
+ * 重传发送窗口中的一帧
+ * @param run 仿真上下文
+ * @param frame_no 帧号
+ */
+static void retransmit_frame(arq_run_t* run, int frame_no) {
+    window_sender_t* sender = run->sender;
+    int slot = frame_no % run->arq->window_size;
+    const data_frame_t* frame = frame_at(&run->sim->pool, sender->window[slot]);
+    ARQ_EVENT(run, TRACE_RETRANSMIT, frame->seq_num, frame->data_length);
+    channel_send_data(run, sender->window[slot]);
+    run->stats->retransmissions++;
+    sender->frame_retransmitted[slot] = true;
+}
+
+/**
+ * 快速重传（重复确认或否定确认触发，不等超时）：回退N帧的接收方丢弃了空缺之后的所有帧，
+ * 从丢失的帧起重传整个在途窗口；选择重传与SACK只重传丢失的一帧
+ * @param run 仿真上下文
+ * @param first 丢失的帧号
+ */
+static void fast_retransmit(arq_run_t* run, int first) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    int last = (arq->mode == ARQ_SELECTIVE_REPEAT || arq->sack) ? first + 1 : sender->next_frame;
+    
+    for (int frame_no = first; frame_no < last; frame_no++) {
+        int slot = frame_no % arq->window_size;
+        if (sender->frame_acked[slot]) continue;
+        retransmit_frame(run, frame_no);
+        if (arq->mode == ARQ_SELECTIVE_REPEAT) start_frame_timer(run, frame_no);
+    }
+    if (arq->mode != ARQ_SELECTIVE_REPEAT) restart_window_timer(run);
+}
+
+/**
+ * 处理完一个确认后更新拥塞窗口
+ * 左沿前进：慢启动每帧加1，拥塞避免每帧加 1/cwnd；快速恢复中全部确认到 recover 才退出，
+ * 部分确认说明还有空缺，立即重传（NewReno）。
+ * 左沿未前进：重复确认，第三个进入快速恢复（ssthresh 减半、cwnd = ssthresh + 3），之后每个再膨胀1帧
+ * @param run 仿真上下文
+ * @param old_base 处理确认前的窗口左沿
+ */
+static void update_congestion_window(arq_run_t* run, int old_base) {
+    window_sender_t* sender = run->sender;
+    int acked = sender->base - old_base;
+    
+    if (acked > 0) {
+        sender->dup_acks = 0;
+        if (sender->in_recovery) {
+            if (sender->base >= sender->recover) {
+                sender->in_recovery = false;
+                set_congestion_window(run, sender->ssthresh, sender->ssthresh);
+                ARQ_TRACE(run, "[拥塞控制] 退出快速恢复，cwnd=%.1f\n", sender->cwnd);
+            } else {
+                // 部分确认：收缩膨胀的窗口；回退N帧已重传整个窗口，不必再补
+                set_congestion_window(run, sender->cwnd - acked + 1, sender->ssthresh);
+                if (run->arq->mode == ARQ_SELECTIVE_REPEAT || run->arq->sack) {
+                    fast_retransmit(run, sender->base);
+                    run->stats->fast_retransmits++;
+                }
+            }
+        } else if (sender->cwnd < sender->ssthresh) {
+            set_congestion_window(run, sender->cwnd + acked, sender->ssthresh);
+        } else {
+            set_congestion_window(run, sender->cwnd + (double)acked / sender->cwnd, sender->ssthresh);
+        }
+        return;
+    }
+    
+    if (sender->base == sender->next_frame) return;     // 没有在途帧，不算重复确认
+    if (sender->in_recovery) {
+        set_congestion_window(run, sender->cwnd + 1, sender->ssthresh);
+    } else if (++sender->dup_acks == DUP_ACK_THRESHOLD && reduce_ssthresh(run, sender->base)) {
+        sender->in_recovery = true;
+        set_congestion_window(run, sender->ssthresh + DUP_ACK_THRESHOLD, sender->ssthresh);
+        ARQ_TRACE(run, "[拥塞控制] %d 个重复确认，快速重传帧 %d，cwnd=%.1f, ssthresh=%.1f\n",
+                  DUP_ACK_THRESHOLD, sender->base, sender->cwnd, sender->ssthresh);
+        fast_retransmit(run, sender->base);
+        run->stats->fast_retransmits++;
+    }
+}
+
+/**
+ * 汇总拥塞窗口统计：时间加权平均
+ * @param run 仿真上下文
+ */
+static void finish_congestion_stats(arq_run_t* run) {
+    window_sender_t* sender = run->sender;
+    if (!run->arq->congestion_control) return;
+    
+    sender->cwnd_area += sender->cwnd * (run->sim->now - sender->cwnd_changed_ms);
+    sender->cwnd_changed_ms = run->sim->now;
+    run->stats->cwnd_mean = run->sim->now > 0 ? sender->cwnd_area / run->sim->now : sender->cwnd;
+}
+
+/* ---------- 快速重传与否定确认 ---------- */
+
+/**
+ * 未启用拥塞控制时的重复确认计数：第 DUP_ACK_THRESHOLD 个重复确认立即重传窗口左沿。
+ * 左沿帧已经重传过（超时、否定确认或上一次快速重传）说明重传已在途，不再重复
+ * @param run 仿真上下文
+ * @param old_base 处理确认前的窗口左沿
+ */
+static void count_duplicate_ack(arq_run_t* run, int old_base) {
+    window_sender_t* sender = run->sender;
+    if (sender->base != old_base) {
+        sender->dup_acks = 0;
+        return;
+    }
+    if (sender->base == sender->next_frame) return;     // 没有在途帧，不算重复确认
+    
+    int slot = sender->base % run->arq->window_size;
+    if (++sender->dup_acks == DUP_ACK_THRESHOLD && !sender->frame_retransmitted[slot]) {
+        ARQ_TRACE(run, "[发送方] %d 个重复确认，快速重传帧 %d\n", DUP_ACK_THRESHOLD, sender->base);
+        fast_retransmit(run, sender->base);
+        run->stats->fast_retransmits++;
+    }
+}
+
+/**
+ * 发送方处理否定确认：接收方报告该序列号的帧缺失或损坏，不等超时立即重传。
+ * 帧已重传过说明重传已在途，不再重复；启用拥塞控制时与3个重复确认一样进入快速恢复
+ * @param run 仿真上下文
+ * @param nak 否定确认帧（ack_num 为请求重传的序列号）
+ */
+static void receive_nak(arq_run_t* run, const ack_frame_t* nak) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    
+    for (int frame_no = sender->base; frame_no < sender->next_frame; frame_no++) {
+        int slot = frame_no % arq->window_size;
+        if (frame_no % arq->seq_space != nak->ack_num) continue;
+        if (sender->frame_acked[slot] || sender->frame_retransmitted[slot]) break;
+        
+        ARQ_TRACE(run, "[发送方] 否定确认 (序列号 %d)，立即重传帧 %d\n", nak->ack_num, frame_no);
+        if (arq->congestion_control && reduce_ssthresh(run, frame_no)) {
+            sender->in_recovery = true;
+            set_congestion_window(run, sender->ssthresh, sender->ssthresh);
+        }
+        fast_retransmit(run, frame_no);
+        run->stats->nak_retransmits++;
+        return;
+    }
+    ARQ_TRACE(run, "[发送方] 否定确认 (序列号 %d) 没有需要重传的帧，忽略\n", nak->ack_num);
+}
+
+/**
+ * 接收方请求重传期望的帧（启用否定确认时）。每个期望帧只请求一次，
+ * 重传的帧再次丢失时由超时恢复；失序帧可能来自丢失确认后的旧重传，个别否定确认会多引起一次重传
+ * @param run 仿真上下文
+ * @param reason 触发原因（日志用）
+ */
+static void send_nak(arq_run_t* run, const char* reason) {
+    window_receiver_t* receiver = run->receiver;
+    if (!run->arq->nak || receiver->nak_sent || run->stream_finished) return;
+    
+    receiver->nak_sent = true;
+    ack_frame_t nak;
+    fill_ack_frame(&nak, receiver->expected_frame % run->arq->seq_space, 0);
+    nak.type = NAK_FRAME;
+    ARQ_TRACE(run, "[接收方] %s，否定确认帧 %d (序列号 %d)\n", reason, receiver->expected_frame, nak.ack_num);
+    transmit_ack_frame(run, &nak);
+}
+
+/**
+ * 把一帧的数据按序交付给数据汇：数据汇直接读取帧池中的载荷
+ * （接收方不保存已交付的数据，内存占用与消息长度无关）
+ * @param run 仿真上下文
+ * @param frame 数据帧
+ * @return 数据汇是否接收
+ */
+static bool deliver_frame(arq_run_t* run, const data_frame_t* frame) {
+    window_receiver_t* receiver = run->receiver;
+    if (frame->data_length == 0) {
+        // 零长度的结束帧：数据流到此为止
+        run->stream_finished = true;
+        receiver->expected_frame++;
+        receiver->nak_sent = false;
+        return true;
+    }
+    if (!run->sink(frame->data, frame->data_length, run->sink_context)) {
+        run->sink_failed = true;
+        return false;
+    }
+    
+    receiver->length += frame->data_length;
+    receiver->expected_frame++;
+    receiver->nak_sent = false;
+    run->stats->bytes_delivered += frame->data_length;
+    return true;
+}
+
+/**
+ * 接收方处理到达的数据帧：只接受按序的帧，其余丢弃并重发最后一个按序确认
+ * @param run 仿真上下文
+ * @param frame 到达的数据帧
+ */
+static void gbn_receive_frame(arq_run_t* run, const data_frame_t* frame) {
+    window_receiver_t* receiver = run->receiver;
+    const arq_config_t* arq = run->arq;
+    run->stats->frames_received++;
+    
+    int expected_seq = receiver->expected_frame % arq->seq_space;
+    bool in_order = frame->seq_num == expected_seq && deliver_frame(run, frame);
+    if (in_order) {
+        ARQ_TRACE(run, "[GBN接收方] 按序接收帧 %d (序列号 %d)\n",
+                  receiver->expected_frame - 1, frame->seq_num);
+    } else {
+        ARQ_TRACE(run, "[GBN接收方] 失序帧 (序列号 %d, 期望 %d)，丢弃\n", frame->seq_num, expected_seq);
+        int offset = (frame->seq_num - expected_seq + arq->seq_space) % arq->seq_space;
+        if (offset > 0 && offset < arq->window_size) send_nak(run, "期望的帧缺失");
+        if (receiver->expected_frame == 0) return;  // 尚无可确认的帧
+    }
+    
+    // 累积确认：确认号为最后一个按序接收帧的序列号
+    ack_frame_t ack;
+    fill_ack_frame(&ack, (receiver->expected_frame - 1) % arq->seq_space, 0);
+    channel_send_ack(run, &ack, !in_order || run->stream_finished);
+}
+
+/**
+ * 发送方处理到达的累积确认：确认号落在窗口内时一次滑过所有被确认的帧
+ * @param run 仿真上下文
+ * @param ack 到达的确认帧
+ */
+static void gbn_receive_ack(arq_run_t* run, const ack_frame_t* ack) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    run->stats->acks_received++;
+    
+    // 序列号空间不小于N+1，窗口内每个序列号只出现一次，映射无歧义
+    for (int frame = sender->base; frame < sender->next_frame; frame++) {
+        if (frame % arq->seq_space == ack->ack_num) {
+            sample_rtt(run, frame);
+            sender->base = frame + 1;
+            sender->retry_count = 0;
+            ARQ_TRACE(run, "[GBN发送方] 累积确认至帧 %d，窗口滑动到 [%d, %d)\n",
+                      frame, sender->base, sender->base + arq->window_size);
+            
+            if (sender->base == sender->next_frame) {
+                cancel_timer(&run->sim->wheel, &sender->window_timer);
+            } else {
+                restart_window_timer(run);
+            }
+            return;
+        }
+    }
+    
+    ARQ_TRACE(run, "[GBN发送方] 重复确认 (确认号 %d)，忽略\n", ack->ack_num);
+}
+
+/**
+ * 发送SACK确认：累积确认最后一个按序交付的帧，位图标出接收窗口内已缓存的后续帧
+ * 每个确认都携带完整的接收状态，个别确认丢失不会导致发送方重传已收到的帧
+ * @param run 仿真上下文
+ * @param urgent 是否需要立即确认（接收窗口内仍有空缺时也立即确认）
+ */
+static void send_sack(arq_run_t* run, bool urgent) {
+    window_receiver_t* receiver = run->receiver;
+    const arq_config_t* arq = run->arq;
+    uint64_t bitmap = 0;
+    
+    // 左沿帧 expected 必定未到（否则已交付），位图从 expected+1 开始
+    for (int i = 0; i + 1 < arq->window_size && i < SACK_BITMAP_BITS; i++) {
+        if (receiver->slot_filled[(receiver->expected_frame + 1 + i) % arq->window_size]) {
+            bitmap |= 1ULL << i;
+        }
+    }
+    
+    ack_frame_t ack;
+    fill_ack_frame(&ack, (receiver->expected_frame - 1 + arq->seq_space) % arq->seq_space, bitmap);
+    channel_send_ack(run, &ack, urgent || bitmap != 0);
+}
+
+/**
+ * 选择重传接收方：窗口内的帧不论先后都缓存（持有帧池中的帧，不复制）并单独确认，补齐空缺后按序交付
+ * @param run 仿真上下文
+ * @param handle 到达的数据帧句柄
+ */
+static void sr_receive_frame(arq_run_t* run, int handle) {
+    window_receiver_t* receiver = run->receiver;
+    const arq_config_t* arq = run->arq;
+    frame_pool_t* pool = &run->sim->pool;
+    const data_frame_t* frame = frame_at(pool, handle);
+    run->stats->frames_received++;
+    
+    // 序列号空间不小于2N：接收窗口 [expected, expected+N) 与上一个窗口互不重叠
+    int offset = (frame->seq_num - receiver->expected_frame % arq->seq_space + arq->seq_space) % arq->seq_space;
+    if (offset < arq->window_size) {
+        int frame_no = receiver->expected_frame + offset;
+        int slot = frame_no % arq->window_size;
+        if (!receiver->slot_filled[slot]) {
+            retain_frame(pool, handle);
+            receiver->slots[slot] = handle;
+            receiver->slot_filled[slot] = true;
+            ARQ_TRACE(run, "[SR接收方] 缓存帧 %d (序列号 %d)\n", frame_no, frame->seq_num);
+        } else {
+            run->stats->duplicate_frames++;
+        }
+        if (offset > 0) send_nak(run, "窗口左沿的帧缺失");
+    } else if (offset < arq->seq_space - arq->window_size) {
+        ARQ_TRACE(run, "[SR接收方] 序列号 %d 不在接收窗口内，丢弃\n", frame->seq_num);
+        return;
+    } else {
+        // 上一窗口内已交付帧的重传（确认丢失），重新确认即可
+        run->stats->duplicate_frames++;
+    }
+    
+    if (!arq->sack) {
+        ack_frame_t ack;
+        fill_ack_frame(&ack, frame->seq_num, 0);
+        channel_send_ack(run, &ack, false);
+    }
+    
+    // 从窗口左沿开始按序交付连续的帧
+    int first = receiver->expected_frame;
+    int slot = receiver->expected_frame % arq->window_size;
+    while (receiver->slot_filled[slot]) {
+        bool delivered = deliver_frame(run, frame_at(pool, receiver->slots[slot]));
+        receiver->slot_filled[slot] = false;
+        release_frame(pool, receiver->slots[slot]);
+        receiver->slots[slot] = FRAME_NONE;
+        if (!delivered) break;
+        slot = receiver->expected_frame % arq->window_size;
+    }
+    
+    // 恰好补上左沿的一帧才是按序到达；一次交付多帧说明填补了空缺
+    if (arq->sack) send_sack(run, receiver->expected_frame != first + 1 || run->stream_finished);
+}
+
+/**
+ * 选择重传发送方：单独确认窗口内的一帧，左沿帧被确认后滑动窗口
+ * @param run 仿真上下文
+ * @param ack 到达的确认帧
+ */
+static void sr_receive_ack(arq_run_t* run, const ack_frame_t* ack) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    run->stats->acks_received++;
+    
+    for (int frame = sender->base; frame < sender->next_frame; frame++) {
+        int slot = frame % arq->window_size;
+        if (frame % arq->seq_space == ack->ack_num) {
+            if (!sender->frame_acked[slot]) {
+                sender->frame_acked[slot] = true;
+                cancel_timer(&run->sim->wheel, &sender->frame_timers[slot]);
+                sample_rtt(run, frame);
+                ARQ_TRACE(run, "[SR发送方] 帧 %d 已确认\n", frame);
+            }
+            break;
+        }
+    }
+    
+    while (sender->base < sender->next_frame && sender->frame_acked[sender->base % arq->window_size]) {
+        sender->frame_acked[sender->base % arq->window_size] = false;
+        sender->base++;
+    }
+}
+
+/**
+ * SACK发送方：先按累积确认滑动，再把位图中标出的帧标记为已收到（撤销其计时器）
+ * @param run 仿真上下文
+ * @param ack 到达的确认帧
+ */
+static void sack_receive_ack(arq_run_t* run, const ack_frame_t* ack) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    run->stats->acks_received++;
+    
+    // 累积确认号相对 base-1 的偏移：不超过在途帧数时为前进，否则是过期的确认（序列号空间不小于2N）
+    int offset = (ack->ack_num - (sender->base - 1 + arq->seq_space) % arq->seq_space + arq->seq_space) % arq->seq_space;
+    int cumulative = sender->base - 1 + offset;
+    if (offset > sender->next_frame - sender->base) cumulative -= arq->seq_space;
+    
+    int newest = -1;
+    for (int frame = sender->base; frame < sender->next_frame; frame++) {
+        int slot = frame % arq->window_size;
+        int bit = frame - cumulative - 2;
+        bool received = frame <= cumulative ||
+                        (bit >= 0 && bit < SACK_BITMAP_BITS && ((ack->sack_bitmap >> bit) & 1));
+        if (received && !sender->frame_acked[slot]) {
+            sender->frame_acked[slot] = true;
+            cancel_timer(&run->sim->wheel, &sender->frame_timers[slot]);
+            newest = frame;
+        }
+    }
+    if (newest < 0) {
+        ARQ_TRACE(run, "[SACK发送方] 确认 (累积 %d) 无新信息\n", ack->ack_num);
+        return;
+    }
+    sample_rtt(run, newest);    // 每个确认只采样一次，取最新被确认的帧
+    
+    int old_base = sender->base;
+    while (sender->base < sender->next_frame && sender->frame_acked[sender->base % arq->window_size]) {
+        sender->frame_acked[sender->base % arq->window_size] = false;
+        sender->base++;
+    }
+    ARQ_TRACE(run, "[SACK发送方] 累积确认至帧 %d, 位图 %#llx, 窗口 [%d, %d)\n", cumulative,
+              (unsigned long long)ack->sack_bitmap, sender->base, sender->base + arq->window_size);
+    if (sender->base == old_base) return;
+    
+    sender->retry_count = 0;
+    if (arq->mode != ARQ_SELECTIVE_REPEAT) {
+        if (sender->base == sender->next_frame) {
+            cancel_timer(&run->sim->wheel, &sender->window_timer);
+        } else {
+            restart_window_timer(run);
+        }
+    }
+}
+
+/**
+ * 选择重传：单帧计时器到期，只重传该帧（确认时计时器已撤销，到期的必定未确认）
+ * @param run 仿真上下文
+ * @param frame_no 帧号
+ * @return 是否仍在重传次数限制内
+ */
+static bool sr_frame_timeout(arq_run_t* run, int frame_no) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    int slot = frame_no % arq->window_size;
+    
+    run->stats->timeouts++;
+    congestion_timeout(run, frame_no);
+    if (++sender->frame_retries[slot] > arq->max_retries) {
+        ARQ_TRACE(run, "[SR发送方] 帧 %d 连续 %d 次超时，传输失败\n", frame_no, arq->max_retries);
+        return false;
+    }
+    ARQ_TRACE(run, "[SR发送方] 帧 %d 超时，单独重传 (第 %d 次)\n", frame_no, sender->frame_retries[slot]);
+    retransmit_frame(run, frame_no);
+    start_frame_timer(run, frame_no);
+    return true;
+}
+
+/**
+ * 回退N帧/停等：窗口计时器到期，重传窗口内所有已发送帧（启用SACK时跳过已收到的帧）
+ * @param run 仿真上下文
+ * @return 是否仍在重传次数限制内
+ */
+static bool gbn_timeout(arq_run_t* run) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    
+    run->stats->timeouts++;
+    congestion_timeout(run, sender->base);
+    if (++sender->retry_count > arq->max_retries) {
+        ARQ_TRACE(run, "[GBN发送方] 连续 %d 次超时无进展，传输失败\n", arq->max_retries);
+        return false;
+    }
+    backoff_rto(run);
+    ARQ_TRACE(run, "[GBN发送方] 超时! 回退重传帧 %d - %d (第 %d 次, RTO %.0f ms)\n",
+              sender->base, sender->next_frame - 1, sender->retry_count, current_rto(run));
+    for (int frame_no = sender->base; frame_no < sender->next_frame; frame_no++) {
+        int slot = frame_no % arq->window_size;
+        if (arq->sack && sender->frame_acked[slot]) {
+            run->stats->sack_skips++;   // SACK表明接收方已缓存，只重传空缺
+            continue;
+        }
+        retransmit_frame(run, frame_no);
+    }
+    restart_window_timer(run);
+    return true;
+}
+
+/**
+ * 窗口未满时从数据源读取下一段数据并发送，数据源取完后不再读取。
+ * 数据源直接写入帧池中的帧，这是载荷唯一的一次复制；之后发送窗口、信道与接收方都只传递句柄。
+ * 未确认的数据只保存在发送窗口中，内存占用与消息长度无关
+ * @param run 仿真上下文
+ */
+static void send_new_frames(arq_run_t* run) {
+    window_sender_t* sender = run->sender;
+    const arq_config_t* arq = run->arq;
+    frame_pool_t* pool = &run->sim->pool;
+    
+    while (!sender->source_done && sender->next_frame < sender->base + send_window(run)) {
+        int handle = acquire_frame(pool);
+        if (handle == FRAME_NONE) {
+            run->sim->out_of_memory = true;     // 帧池按窗口与信道容量分配，不应耗尽
+            return;
+        }
+        data_frame_t* frame = frame_at(pool, handle);
+        size_t length = run->source(frame->data, arq->payload_size, run->source_context);
+        if (length == 0) {
+            sender->source_done = true;
+            // 真实传输的接收方不知道流的长度，追加一个零长度的结束帧
+            if (!run->transport) {
+                release_frame(pool, handle);
+                break;
+            }
+        }
+        if (length > (size_t)arq->payload_size) length = arq->payload_size;
+        run->bytes_read += length;
+        
+        int frame_no = sender->next_frame;
+        int slot = frame_no % arq->window_size;
+        frame->type = DATA_FRAME;
+        frame->conn_id = run->conn_id;
+        frame->seq_num = frame_no % arq->seq_space;
+        frame->data_length = (int)length;
+        frame->data[length] = '\0';
+        frame->checksum = 0;        // 尾部校验和在线路编码时计算
+        sender->window[slot] = handle;
+        ARQ_TRACE(run, "[发送方] 发送帧 %d (序列号 %d, %zu 字节)\n", frame_no, frame->seq_num, length);
+        channel_send_data(run, handle);
+        sender->frame_sent_ms[slot] = run->sim->now;
+        sender->frame_retransmitted[slot] = false;
+        sender->frame_acked[slot] = false;
+        sender->next_frame++;
+        if (arq->mode == ARQ_SELECTIVE_REPEAT) {
+            sender->frame_retries[slot] = 0;
+            start_frame_timer(run, frame_no);
+        } else if (!sender->window_timer.armed) {
+            restart_window_timer(run);
+        }
+    }
+}
+
+/**
+ * 把到达的数据帧交给接收方：选择重传或启用SACK时缓存失序帧，否则只收按序帧
+ * @param run 上下文
+ * @param handle 数据帧句柄（接收方需要缓存时自行增加引用）
+ */
+static void dispatch_data_frame(arq_run_t* run, int handle) {
+    const data_frame_t* frame = frame_at(&run->sim->pool, handle);
+    ARQ_EVENT(run, TRACE_DATA_RECEIVE, frame->seq_num, frame->data_length);
+    if (run->arq->mode == ARQ_SELECTIVE_REPEAT || run->arq->sack) {
+        sr_receive_frame(run, handle);
+    } else {
+        gbn_receive_frame(run, frame_at(&run->sim->pool, handle));
+    }
+}
+
+/**
+ * 发送窗口滑过的帧已被确认，释放发送窗口对它们的引用
+ * @param run 上下文
+ * @param old_base 处理确认前的窗口左沿
+ */
+static void release_acked_frames(arq_run_t* run, int old_base) {
+    window_sender_t* sender = run->sender;
+    for (int frame_no = old_base; frame_no < sender->base; frame_no++) {
+        int slot = frame_no % run->arq->window_size;
+        release_frame(&run->sim->pool, sender->window[slot]);
+        sender->window[slot] = FRAME_NONE;
+    }
+}
+
+/**
+ * 把到达的确认帧（或否定确认帧）交给发送方
+ * @param run 上下文
+ * @param ack 确认帧
+ */
+static void dispatch_ack_frame(arq_run_t* run, const ack_frame_t* ack) {
+    int old_base = run->sender->base;
+    ARQ_EVENT(run, ack->type == NAK_FRAME ? TRACE_NAK_RECEIVE : TRACE_ACK_RECEIVE, ack->ack_num, 0);
+    if (ack->type == NAK_FRAME) {
+        receive_nak(run, ack);
+        return;
+    }
+    if (run->arq->sack) {
+        sack_receive_ack(run, ack);
+    } else if (run->arq->mode == ARQ_SELECTIVE_REPEAT) {
+        sr_receive_ack(run, ack);
+    } else {
+        gbn_receive_ack(run, ack);
+    }
+    release_acked_frames(run, old_base);
+    if (run->arq->congestion_control) {
+        update_congestion_window(run, old_base);
+    } else if (run->arq->fast_retransmit) {
+        count_duplicate_ack(run, old_base);
+    }
+}
+
+/**
+ * 把会话的两个传输方向加入本轮待处理列表：到达或超时改变了会话状态，之后要为它补发新帧并检查是否结束
+ * @param run 会话中的任一传输方向
+ */
+static void mark_session(arq_run_t* run) {
+    arq_run_t* session = run->session;
+    arq_run_t* flows[2] = { session, session->peer };
+    for (int i = 0; i < 2; i++) {
+        if (!flows[i] || flows[i]->dirty) continue;
+        flows[i]->dirty = true;
+        session->sim->dirty[session->sim->dirty_count++] = flows[i];
+    }
+}
+
+/**
+ * 处理一个帧到达事件。报文按连接号在会话表中找到所属会话（只有一个会话时不必查表，
+ * 校验失败的帧也能交给它回复否定确认）；已结束的会话与未知连接号的帧直接丢弃。
+ * 正向链路的帧到达B端：数据帧交给正向的接收方，确认交给反向的发送方；
+ * 反向链路的帧到达A端，角色互换。捎带的确认先于数据处理，先释放发送窗口
+ * @param sim 仿真核心
+ * @param event 事件
+ */
+static void handle_arrival_event(arq_sim_t* sim, const sim_event_t* event) {
+    arq_run_t* first = sim->flows[0];
+    bool forward = event->type == EVENT_DATA_ARRIVAL;
+    channel_link_t* link = forward ? &sim->channel->data : &sim->channel->acks;
+    int handle;
+    ack_frame_t ack;
+    uint32_t conn_id;
+    
+    int type = channel_receive(first, link, event->arg, &handle, &ack, &conn_id);
+    arq_run_t* run = sim->sessions.count == 1 ? first : (arq_run_t*)find_session(&sim->sessions, conn_id);
+    if (!run || run->finished) {
+        if (!run) ARQ_TRACE(first, "[网络模拟] 连接号 %u 没有对应的会话，丢弃\n", conn_id);
+        release_frame(&sim->pool, handle);
+        return;
+    }
+    
+    arq_run_t* data_flow = forward ? run : run->peer;   // 在该端接收数据的方向
+    arq_run_t* ack_flow = forward ? run->peer : run;    // 在该端接收确认的方向
+    if (type == DATA_FRAME && data_flow) {
+        if (ack.ack_num >= 0 && ack_flow) dispatch_ack_frame(ack_flow, &ack);
+        dispatch_data_frame(data_flow, handle);
+    } else if ((type == ACK_FRAME || type == NAK_FRAME) && ack_flow) {
+        dispatch_ack_frame(ack_flow, &ack);
+    } else if (type < 0 && data_flow) {
+        data_flow->stats->frames_received++;
+        ARQ_EVENT(run, TRACE_FRAME_CORRUPT, -1, 0);
+        ARQ_TRACE(run, "[接收方] 数据帧校验和错误，丢弃\n");
+        send_nak(data_flow, "数据帧校验和错误");
+    } else if (type < 0) {
+        ack_flow->stats->acks_received++;
+        ARQ_EVENT(run, TRACE_FRAME_CORRUPT, -1, 0);
+        ARQ_TRACE(run, "[发送方] 确认帧校验和错误，丢弃\n");
+    }
+    mark_session(run);
+    release_frame(&sim->pool, handle);
+}
+
+/**
+ * 时间轮到期回调：选择重传逐帧计时，其余模式回退整个窗口；捎带等待到期则单独发送确认
+ * @param timer 到期的计时器（owner 为所属的传输方向）
+ * @param context 仿真核心
+ */
+static void arq_timer_expired(wheel_timer_t* timer, void* context) {
+    arq_run_t* run = (arq_run_t*)timer->owner;
+    arq_sim_t* sim = (arq_sim_t*)context;
+    sim->now = timing_wheel_time_ms(&sim->wheel);
+    sim->timers_fired++;
+    if (run->session->finished) return;
+    if (run->arq->real_time) pace_to_wall_clock(run, sim->now);
+    mark_session(run);
+    if (timer == &run->ack_timer) {
+        flush_pending_ack(run);
+        return;
+    }
+    if (run->retries_exhausted) return;
+    
+    ARQ_EVENT(run, TRACE_TIMEOUT, timer == &run->sender->window_timer ? run->sender->base : timer->id, 0);
+    bool within_limit = (timer == &run->sender->window_timer)
+                        ? gbn_timeout(run)
+                        : sr_frame_timeout(run, timer->id);
+    if (!within_limit) run->retries_exhausted = true;
+}
+
+/**
+ * 逐 tick 推进时间轮，触发早于下一次帧到达的计时器
+ * 一旦有计时器到期就返回，由调用方先处理重传可能产生的更早的到达事件
+ * @param sim 仿真核心
+ * @param until 下一次帧到达的时刻（负数表示没有待到达的帧）
+ * @return 是否有计时器到期
+ */
+static bool fire_due_timers(arq_sim_t* sim, double until) {
+    while (sim->wheel.armed_count > 0) {
+        // 与帧到达同一时刻的计时器让位于到达事件：恰好按时到达的确认不算超时
+        if (until >= 0 && timing_wheel_time_ms(&sim->wheel) + sim->wheel.tick_ms >= until) return false;
+        if (step_timing_wheel(&sim->wheel, arq_timer_expired, sim) > 0) return true;
+    }
+    return false;
+}
+
+/**
+ * 为一个传输方向分配发送方与接收方，并接到信道上（反方向的数据走B→A，确认走A→B）
+ * @param run 传输方向
+ * @param sim 仿真核心（信道已分配）
+ * @param reverse 是否为全双工的反方向
+ * @return 是否分配成功
+ */
+static bool init_flow(arq_run_t* run, arq_sim_t* sim, bool reverse) {
+    const arq_config_t* arq = run->arq;
+    run->sim = sim;
+    run->data_link = reverse ? &sim->channel->acks : &sim->channel->data;
+    run->ack_link = reverse ? &sim->channel->data : &sim->channel->acks;
+    run->sender = calloc(1, sizeof(window_sender_t));
+    run->receiver = calloc(1, sizeof(window_receiver_t));
+    if (!run->sender || !run->receiver) return false;
+    
+    for (int i = 0; i < MAX_WINDOW_SIZE; i++) {
+        run->sender->window[i] = FRAME_NONE;
+        run->receiver->slots[i] = FRAME_NONE;
+    }
+    init_rto_estimator(&run->sender->rto, arq->timeout_ms, arq->min_rto_ms, arq->max_rto_ms, TIMER_TICK_MS);
+    init_congestion_window(run);
+    return true;
+}
+
+/**
+ * 传输方向的数据是否已全部发出并被确认
+ * @param run 传输方向
+ * @return 是否完成
+ */
+static bool flow_done(const arq_run_t* run) {
+    return run->sender->source_done && run->sender->base == run->sender->next_frame;
+}
+
+/**
+ * 传输方向是否已无法完成（重传超限或数据汇拒绝接收）
+ * @param run 传输方向
+ * @return 是否失败
+ */
+static bool flow_failed(const arq_run_t* run) {
+    return run->retries_exhausted || run->sink_failed;
+}
+
+/**
+ * 汇总一个传输方向的统计信息
+ * @param run 传输方向
+ */
+static void finish_flow_stats(arq_run_t* run) {
+    statistics_t* stats = run->stats;
+    stats->elapsed_ms = run->sim->now;
+    stats->wall_ms = monotonic_clock_ms() - run->sim->wall_start_ms;
+    stats->events_processed = (long)(run->sim->events.processed + run->sim->timers_fired);
+    stats->rto_ms = current_rto(run);
+    stats->srtt_ms = run->sender->rto.srtt_ms;
+    stats->rttvar_ms = run->sender->rto.rttvar_ms;
+    stats->rtt_samples = run->sender->rto.samples;
+    stats->pool_frames_peak = run->sim->pool.peak_in_use;
+    finish_congestion_stats(run);
+    stats->end_time = clock();
+    if (stats->elapsed_ms > 0) {
+        stats->goodput_bps = stats->bytes_delivered * 8.0 / (stats->elapsed_ms / 1000.0);
+    }
+}
+
+/**
+ * 停止传输方向的全部计时器（会话结束后不再重传，也不再单独发送确认）
+ * @param run 传输方向
+ */
+static void cancel_flow_timers(arq_run_t* run) {
+    timing_wheel_t* wheel = &run->sim->wheel;
+    cancel_timer(wheel, &run->sender->window_timer);
+    for (int i = 0; i < MAX_WINDOW_SIZE; i++) {
+        cancel_timer(wheel, &run->sender->frame_timers[i]);
+    }
+    cancel_timer(wheel, &run->ack_timer);
+}
+
+/**
+ * 结束一个会话：汇总统计（仿真时长取结束时刻），停止计时器
+ * @param session 会话的正向传输方向
+ * @param done 两个方向的数据是否都已发出并被确认
+ */
+static void finish_session(arq_run_t* session, bool done) {
+    arq_run_t* flows[2] = { session, session->peer };
+    session->finished = true;
+    session->completed = done;
+    session->sim->sessions_open--;
+    for (int i = 0; i < 2; i++) {
+        if (!flows[i]) continue;
+        finish_flow_stats(flows[i]);
+        if (flows[i]->sink_failed || flows[i]->receiver->length != flows[i]->bytes_read) session->completed = false;
+        cancel_flow_timers(flows[i]);
+    }
+}
+
+/**
+ * 处理本轮状态有变化的传输方向：按 flows 中的顺序补发新帧，再结束已完成或已失败的会话
+ * @param sim 仿真核心
+ */
+static void service_flows(arq_sim_t* sim) {
+    // 待处理列表很短（通常只有一个会话的一两个方向），插入排序即可保证发送顺序与会话数无关
+    for (int i = 1; i < sim->dirty_count; i++) {
+        arq_run_t* run = sim->dirty[i];
+        int j = i;
+        while (j > 0 && sim->dirty[j - 1]->index > run->index) {
+            sim->dirty[j] = sim->dirty[j - 1];
+            j--;
+        }
+        sim->dirty[j] = run;
+    }
+    
+    for (int i = 0; i < sim->dirty_count; i++) {
+        if (!sim->dirty[i]->session->finished) send_new_frames(sim->dirty[i]);
+    }
+    for (int i = 0; i < sim->dirty_count; i++) {
+        arq_run_t* session = sim->dirty[i];
+        session->dirty = false;
+        if (session != session->session || session->finished) continue;
+        
+        arq_run_t* reverse = session->peer;
+        if (flow_done(session) && (!reverse || flow_done(reverse))) {
+            finish_session(session, true);
+        } else if (flow_failed(session) || (reverse && flow_failed(reverse))) {
+            finish_session(session, false);
+        }
+    }
+    sim->dirty_count = 0;
+}
+
+/**
+ * 释放传输方向的发送方与接收方
+ * @param run 传输方向
+ */
+static void free_flow(arq_run_t* run) {
+    free(run->receiver);
+    free(run->sender);
+    run->receiver = NULL;
+    run->sender = NULL;
+}
+
+/**
+ * 释放仿真核心及全部传输方向
+ * @param sim 仿真核心
+ */
+static void free_arq_sim(arq_sim_t* sim) {
+    for (int i = 0; i < sim->flow_count; i++) {
+        free_flow(sim->flows[i]);
+    }
+    if (sim->channel) {
+        free_channel_link(&sim->channel->data);
+        free_channel_link(&sim->channel->acks);
+    }
+    free_event_queue(&sim->events);
+    free_frame_pool(&sim->pool);
+    free_session_table(&sim->sessions);
+    free(sim->channel);
+    free(sim->flows);
+    free(sim->dirty);
+}
+
+/**
+ * 为会话建立仿真核心：登记传输方向与会话表，按传输方向数分配信道槽位与帧池
+ * 每个传输方向最多同时持有发送窗口与接收缓冲区各一个窗口的帧，再加上信道中全部在途的数据帧
+ * 与正在处理的到达帧
+ * @param sim 仿真核心（已清零）
+ * @param sessions 会话数组（正向传输方向，全双工时已设置 peer）
+ * @param count 会话数
+ * @return 是否成功
+ */
+static bool init_arq_sim(arq_sim_t* sim, arq_run_t* sessions, int count) {
+    int window_size = sessions[0].arq->window_size;
+    int data_links = 1;
+    sim->flows = malloc(sizeof(arq_run_t*) * 2 * (size_t)count);
+    sim->dirty = malloc(sizeof(arq_run_t*) * 2 * (size_t)count);
+    if (!sim->flows || !sim->dirty) return false;
+    for (int i = 0; i < count; i++) {
+        arq_run_t* flows[2] = { &sessions[i], sessions[i].peer };
+        for (int k = 0; k < 2 && flows[k]; k++) {
+            flows[k]->session = &sessions[i];
+            flows[k]->index = sim->flow_count;
+            flows[k]->dirty = false;
+            sim->flows[sim->flow_count++] = flows[k];
+        }
+        if (flows[1]) data_links = 2;
+        sessions[i].finished = false;
+        sessions[i].completed = false;
+    }
+    
+    int link_capacity = 2 * window_size * sim->flow_count;
+    if (link_capacity < CHANNEL_CAPACITY) link_capacity = CHANNEL_CAPACITY;
+    sim->channel = calloc(1, sizeof(sim_channel_t));
+    if (!sim->channel || !init_event_queue(&sim->events, 0) ||
+        !init_frame_pool(&sim->pool, 2 * window_size * sim->flow_count + link_capacity * data_links + 1) ||
+        !init_channel_link(&sim->channel->data, link_capacity) ||
+        !init_channel_link(&sim->channel->acks, link_capacity) ||
+        !init_session_table(&sim->sessions, (size_t)count)) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!insert_session(&sim->sessions, sessions[i].conn_id, &sessions[i])) return false;
+    }
+    for (int i = 0; i < sim->flow_count; i++) {
+        if (!init_flow(sim->flows[i], sim, sim->flows[i] != sim->flows[i]->session)) return false;
+    }
+    sim->sessions_open = count;
+    return true;
+}
+
+/**
+ * 窗口协议传输引擎：从数据源按 payload_size 分帧，通过停等、回退N帧或选择重传协议发送，
+ * 接收方按序交付给数据汇。帧到达（事件堆）与超时（时间轮）按虚拟时刻顺序处理；
+ * real_time 关闭时不休眠，仿真速度只受处理开销限制。
+ * 设置了 peer 的会话为全双工：两个方向同时传输，确认可捎带在数据帧中。
+ * 多个会话时各会话共用信道（带宽、队列与丢包）、事件、时间轮与帧池，按连接号区分，
+ * 每个事件只处理它所属的会话，开销与会话总数无关
+ * @param sessions 会话数组（已设置配置、数据源、数据汇与互不相同的连接号）
+ * @param count 会话数
+ * @return 是否全部会话都传输成功（数据源取完且全部数据按序交付，全双工时两个方向都是如此）
+ */
+static bool run_arq_transfer(arq_run_t* sessions, int count) {
+    const arq_config_t* arq = sessions[0].arq;
+    arq_sim_t sim;
+    memset(&sim, 0, sizeof(sim));
+    if (!init_arq_sim(&sim, sessions, count)) {
+        free_arq_sim(&sim);
+        return false;
+    }
+    
+    // 未指定种子时从 rand() 取一个，调用方的 srand() 仍然决定整个仿真
+    seed_channel_random(&sim, sessions[0].seed ? sessions[0].seed : (uint32_t)rand());
+    init_timing_wheel(&sim.wheel, TIMER_TICK_MS, 0);
+    sim.wall_start_ms = monotonic_clock_ms();
+    bool success = true;
+    
+    for (int i = 0; i < sim.flow_count; i++) {
+        sim.flows[i]->dirty = true;
+        sim.dirty[sim.dirty_count++] = sim.flows[i];
+    }
+    service_flows(&sim);
+    sim_event_t event;
+    while (sim.sessions_open > 0) {
+        if (sim.out_of_memory) {
+            success = false;
+            break;
+        }
+        
+        double next_arrival = -1;
+        bool has_arrival = peek_event_time(&sim.events, &next_arrival);
+        if (!has_arrival && sim.wheel.armed_count == 0) {
+            success = false;    // 既无在途帧也无计时器，协议无法继续
+            break;
+        }
+        
+        if (!fire_due_timers(&sim, next_arrival)) {
+            pop_event(&sim.events, &event);
+            sim.now = event.time;
+            if (arq->real_time) pace_to_wall_clock(sim.flows[0], sim.now);
+            handle_arrival_event(&sim, &event);
+        }
+        service_flows(&sim);
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (!sessions[i].finished) finish_session(&sessions[i], false);
+        if (!sessions[i].completed) success = false;
+    }
+    if (!sessions[0].quiet) {
+        printf("\n========== 窗口协议传输%s (仿真时长 %.1f 毫秒) ==========\n",
+               success ? "完成" : "失败", sim.now);
+    }
+    
+    free_arq_sim(&sim);
+    return success;
+}
+
+/* 内存数据源：顺序读出一段连续内存 */
+typedef struct {
+    const char* data;
+    size_t length;
+    size_t offset;
+} memory_source_t;
+
+/* 内存数据汇：写入调用方缓冲区，或与期望内容逐段比对（二者可同时使用） */
+typedef struct {
+    char* output;               // 输出缓冲区（可为NULL）
+    size_t capacity;            // 可接收的最大字节数
+    const char* expected;       // 期望内容（可为NULL）
+    size_t length;              // 已接收的字节数
+} memory_sink_t;
+
+static size_t read_memory_source(char* buffer, size_t capacity, void* context) {
+    memory_source_t* source = (memory_source_t*)context;
+    size_t remaining = source->length - source->offset;
+    size_t length = remaining < capacity ? remaining : capacity;
+    
+    memcpy(buffer, source->data + source->offset, length);
+    source->offset += length;
+    return length;
+}
+
+static bool write_memory_sink(const char* data, size_t length, void* context) {
+    memory_sink_t* sink = (memory_sink_t*)context;
+    if (sink->length + length > sink->capacity) return false;
+    if (sink->expected && memcmp(sink->expected + sink->length, data, length) != 0) return false;
+    
+    if (sink->output) memcpy(sink->output + sink->length, data, length);
+    sink->length += length;
+    return true;
+}
+
+/**
+ * 传输一段内存数据
+ * @param data 数据
+ * @param length 数据长度
+ * @param sink 内存数据汇
+ * @param config 网络配置
+ * @param arq 窗口协议配置
+ * @param stats 统计信息
+ * @return 传输是否成功（数据汇收到全部数据）
+ */
+static bool transmit_memory_arq(const char* data, size_t length, memory_sink_t* sink,
+                                network_config_t* config, const arq_config_t* arq,
+                                statistics_t* stats) {
+    if (!validate_arq_config(arq)) return false;
+    if (length == 0) {
+        printf("[错误] 消息不能为空\n");
+        return false;
+    }
+    
+    printf("\n========== 开始窗口协议传输 (%s, 窗口 %d) ==========\n",
+           arq_mode_name(arq->mode), arq->window_size);
+    printf("消息长度: %zu 字节, 分为 %zu 帧\n", length,
+           (length + arq->payload_size - 1) / arq->payload_size);
+    
+    memory_source_t source = {data, length, 0};
+    arq_run_t run;
+    memset(&run, 0, sizeof(run));
+    run.arq = arq;
+    run.config = config;
+    run.stats = stats;
+    run.source = read_memory_source;
+    run.source_context = &source;
+    run.sink = write_memory_sink;
+    run.sink_context = sink;
+    
+    return run_arq_transfer(&run, 1) && sink->length == length;
+}
+
+/**
+ * 窗口协议传输消息：接收方逐段与原消息比对，不另行分配重组缓冲区
+ * @param message 要传输的消息
+ * @param config 网络配置
+ * @param arq 窗口协议配置
+ * @param stats 统计信息
+ * @return 传输是否成功（接收方按序重组出完整消息）
+ */
+bool transmit_message_arq(const char* message, network_config_t* config,
+                          const arq_config_t* arq, statistics_t* stats) {
+    if (!message || !config || !arq || !stats) return false;
+    
+    size_t message_len = strlen(message);
+    memory_sink_t sink = {NULL, message_len, message, 0};
+    return transmit_memory_arq(message, message_len, &sink, config, arq, stats);
+}
+
+/**
+ * 窗口协议传输任意二进制数据，接收方重组到调用方提供的缓冲区
+ * @param data 数据
+ * @param length 数据长度
+ * @param output 重组缓冲区
+ * @param output_capacity 缓冲区容量（不小于 length）
+ * @param config 网络配置
+ * @param arq 窗口协议配置
+ * @param stats 统计信息
+ * @return 传输是否成功（缓冲区中为完整数据）
+ */
+bool transmit_buffer_arq(const char* data, size_t length, char* output, size_t output_capacity,
+                         network_config_t* config, const arq_config_t* arq, statistics_t* stats) {
+    if (!data || !output || !config || !arq || !stats) return false;
+    if (output_capacity < length) {
+        printf("[错误] 重组缓冲区容量 %zu 字节，小于数据长度 %zu 字节\n", output_capacity, length);
+        return false;
+    }
+    
+    memory_sink_t sink = {output, output_capacity, NULL, 0};
+    return transmit_memory_arq(data, length, &sink, config, arq, stats);
+}
+
+/**
+ * 窗口协议传输字节流：长度不必事先已知，发送方按需从数据源读取，
+ * 接收方按序交付给数据汇；两端只保存窗口内的帧，内存占用为常数
+ * @param source 数据源
+ * @param source_context 数据源上下文
+ * @param sink 数据汇
+ * @param sink_context 数据汇上下文
+ * @param config 网络配置
+ * @param arq 窗口协议配置
+ * @param stats 统计信息
+ * @return 传输是否成功（数据源取完且全部数据按序交付）
+ */
+bool transmit_stream_arq(arq_source_fn source, void* source_context,
+                         arq_sink_fn sink, void* sink_context,
+                         network_config_t* config, const arq_config_t* arq, statistics_t* stats) {
+    if (!source || !sink || !config || !arq || !stats) return false;
+    if (!validate_arq_config(arq)) return false;
+    
+    printf("\n========== 开始流式传输 (%s, 窗口 %d, 每帧 %d 字节) ==========\n",
+           arq_mode_name(arq->mode), arq->window_size, arq->payload_size);
+    
+    arq_run_t run;
+    memset(&run, 0, sizeof(run));
+    run.arq = arq;
+    run.config = config;
+    run.stats = stats;
+    run.source = source;
+    run.source_context = source_context;
+    run.sink = sink;
+    run.sink_context = sink_context;
+    
+    return run_arq_transfer(&run, 1);
+}
+
+/* 合成数据流：按位置生成字节，接收方逐字节核对，不需要缓冲区 */
+typedef struct {
+    size_t total;
+    size_t position;
+} synthetic_stream_t;
+
+static unsigned char synthetic_byte(size_t position) {
+    return (unsigned char)(position * 167 + (position >> 8));
+}
+
+static size_t read_synthetic_source(char* buffer, size_t capacity, void* context) {
+    synthetic_stream_t* stream = (synthetic_stream_t*)context;
+    size_t length = stream->total - stream->position;
+    if (length > capacity) length = capacity;
+    for (size_t i = 0; i < length; i++) buffer[i] = (char)synthetic_byte(stream->position + i);
+    stream->position += length;
+    return length;
+}
+
+static bool write_synthetic_sink(const char* data, size_t length, void* context) {
+    synthetic_stream_t* stream = (synthetic_stream_t*)context;
+    if (stream->position + length > stream->total) return false;
+    for (size_t i = 0; i < length; i++) {
+        if ((unsigned char)data[i] != synthetic_byte(stream->position + i)) return false;
+    }
+    stream->position += length;
+    return true;
+}
+
+/**
+ * 无输出的仿真传输：传输 length 字节的合成数据，信道随机数只由 seed 决定。
+ * 不使用 rand() 与任何全局状态，可以在多个线程中同时调用（参数扫描用）
+ * @param length 数据长度
+ * @param config 网络配置
+ * @param arq 窗口协议配置（verbose 应关闭）
+ * @param seed 随机种子
+ * @param stats 统计信息（调用方清零）
+ * @return 传输是否成功
+ */
+bool simulate_arq_transfer(size_t length, const network_config_t* config, const arq_config_t* arq,
+                           uint32_t seed, statistics_t* stats) {
+    if (!config || !arq || !stats || length == 0) return false;
+    if (!validate_arq_config(arq)) return false;
+    
+    synthetic_stream_t source = {length, 0};
+    synthetic_stream_t sink = {length, 0};
+    arq_run_t run;
+    memset(&run, 0, sizeof(run));
+    run.arq = arq;
+    run.config = config;
+    run.stats = stats;
+    run.source = read_synthetic_source;
+    run.source_context = &source;
+    run.sink = write_synthetic_sink;
+    run.sink_context = &sink;
+    run.quiet = true;
+    run.seed = seed ? seed : CHANNEL_DEFAULT_SEED;
+    
+    return run_arq_transfer(&run, 1) && sink.position == length;
+}
+
+/**
+ * 按全双工的一个方向设置传输上下文
+ * @param run 传输上下文（已清零）
+ * @param direction 该方向的数据源、数据汇与统计
+ * @param config 网络配置
+ * @param arq 窗口协议配置
+ */
+static void setup_direction_run(arq_run_t* run, const arq_direction_t* direction,
+                                const network_config_t* config, const arq_config_t* arq) {
+    run->arq = arq;
+    run->config = config;
+    run->stats = direction->stats;
+    run->source = direction->source;
+    run->source_context = direction->source_context;
+    run->sink = direction->sink;
+    run->sink_context = direction->sink_context;
+}
+
+/**
+ * 全双工窗口协议传输：A→B 与 B→A 两个方向同时传输，共用信道的两个方向。
+ * 接收方的确认先等待同一端发出的反向数据帧捎带，piggyback_delay_ms 内没有数据帧才单独发送
+ * @param forward 正向（A→B）的数据源、数据汇与统计
+ * @param reverse 反向（B→A）的数据源、数据汇与统计
+ * @param config 网络配置（两个方向相同）
+ * @param arq 窗口协议配置（两个方向相同）
+ * @return 两个方向是否都传输成功
+ */
+bool transmit_duplex_arq(const arq_direction_t* forward, const arq_direction_t* reverse,
+                         network_config_t* config, const arq_config_t* arq) {
+    if (!forward || !reverse || !config || !arq) return false;
+    if (!forward->source || !forward->sink || !forward->stats ||
+        !reverse->source || !reverse->sink || !reverse->stats) return false;
+    if (!validate_arq_config(arq)) return false;
+    
+    printf("\n========== 开始全双工传输 (%s, 窗口 %d, 捎带等待 %d 毫秒) ==========\n",
+           arq_mode_name(arq->mode), arq->window_size, arq->piggyback_delay_ms);
+    
+    arq_run_t runs[2];
+    memset(runs, 0, sizeof(runs));
+    setup_direction_run(&runs[0], forward, config, arq);
+    setup_direction_run(&runs[1], reverse, config, arq);
+    runs[0].peer = &runs[1];
+    runs[1].peer = &runs[0];
+    
+    return run_arq_transfer(&runs[0], 1);
+}
+
+/**
+ * 无输出的全双工仿真传输：两个方向各传输一段合成数据，信道随机数只由 seed 决定
+ * @param forward_length 正向数据长度
+ * @param reverse_length 反向数据长度（可为0，此时确认全部单独发送）
+ * @param config 网络配置
+ * @param arq 窗口协议配置（verbose 应关闭）
+ * @param seed 随机种子
+ * @param forward_stats 正向的统计信息（调用方清零）
+ * @param reverse_stats 反向的统计信息（调用方清零）
+ * @return 两个方向是否都传输成功
+ */
+bool simulate_duplex_transfer(size_t forward_length, size_t reverse_length,
+                              const network_config_t* config, const arq_config_t* arq, uint32_t seed,
+                              statistics_t* forward_stats, statistics_t* reverse_stats) {
+    if (!config || !arq || !forward_stats || !reverse_stats) return false;
+    if (forward_length == 0 && reverse_length == 0) return false;
+    if (!validate_arq_config(arq)) return false;
+    
+    synthetic_stream_t sources[2] = {{forward_length, 0}, {reverse_length, 0}};
+    synthetic_stream_t sinks[2] = {{forward_length, 0}, {reverse_length, 0}};
+    arq_direction_t directions[2] = {
+        {read_synthetic_source, &sources[0], write_synthetic_sink, &sinks[0], forward_stats},
+        {read_synthetic_source, &sources[1], write_synthetic_sink, &sinks[1], reverse_stats}
+    };
+    arq_run_t runs[2];
+    memset(runs, 0, sizeof(runs));
+    for (int i = 0; i < 2; i++) {
+        setup_direction_run(&runs[i], &directions[i], config, arq);
+        runs[i].peer = &runs[1 - i];
+    }
+    runs[0].quiet = true;
+    runs[0].seed = seed ? seed : CHANNEL_DEFAULT_SEED;
+    
+    return run_arq_transfer(&runs[0], 1) && sinks[0].position == forward_length &&
+           sinks[1].position == reverse_length;
+}
+
+/* ========== 多路复用 ========== */
+
+/**
+ * Jain 公平性指数 (Σx)² / (n·Σx²)：各值相等时为1，只有一个非零值时为 1/n
+ * @param values 各会话的指标（如有效吞吐量）
+ * @param count 个数
+ * @return 公平性指数，全为0或没有值时返回0
+ */
+double calculate_jain_index(const double* values, int count) {
+    if (!values || count < 1) return 0.0;
+    
+    double sum = 0.0;
+    double squares = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += values[i];
+        squares += values[i] * values[i];
+    }
+    if (squares <= 0.0) return 0.0;
+    return sum * sum / (count * squares);
+}
+
+/**
+ * 汇总各会话的统计：总交付字节数按最后一个会话结束的时刻折算为总吞吐量，
+ * 各会话的有效吞吐量按各自结束的时刻计算，据此给出最小、最大、平均值与 Jain 指数
+ * @param sessions 各会话（统计已汇总）
+ * @param completed 各会话是否成功
+ * @param count 会话数
+ * @param summary 输出的汇总
+ */
+static void summarize_sessions(const arq_direction_t* sessions, const bool* completed, int count,
+                               mux_summary_t* summary) {
+    memset(summary, 0, sizeof(mux_summary_t));
+    summary->sessions = count;
+    double* goodputs = malloc(sizeof(double) * (size_t)count);
+    if (!goodputs) return;
+    
+    for (int i = 0; i < count; i++) {
+        const statistics_t* stats = sessions[i].stats;
+        goodputs[i] = stats->goodput_bps;
+        if (completed[i]) summary->completed++;
+        summary->bytes_delivered += stats->bytes_delivered;
+        summary->mean_goodput_bps += stats->goodput_bps / count;
+        if (i == 0 || stats->goodput_bps < summary->min_goodput_bps) summary->min_goodput_bps = stats->goodput_bps;
+        if (stats->goodput_bps > summary->max_goodput_bps) summary->max_goodput_bps = stats->goodput_bps;
+        if (stats->elapsed_ms > summary->elapsed_ms) summary->elapsed_ms = stats->elapsed_ms;
+        if (stats->wall_ms > summary->wall_ms) summary->wall_ms = stats->wall_ms;
+        if (stats->events_processed > summary->events_processed) summary->events_processed = stats->events_processed;
+    }
+    if (summary->elapsed_ms > 0) {
+        summary->aggregate_goodput_bps = summary->bytes_delivered * 8.0 / (summary->elapsed_ms / 1000.0);
+    }
+    summary->jain_index = calculate_jain_index(goodputs, count);
+    free(goodputs);
+}
+
+/**
+ * 多个会话共用仿真信道并发传输：各会话从1开始编号为连接号，同时开始发送，
+ * 共用带宽、瓶颈队列与丢包模型（单工，每个会话一个数据源与数据汇）
+ * @param sessions 各会话的数据源、数据汇与统计信息（调用方清零）
+ * @param count 会话数
+ * @param config 网络配置（各会话相同）
+ * @param arq 窗口协议配置（各会话相同）
+ * @param seed 信道随机种子（0 表示由 rand() 决定）
+ * @param quiet 不输出传输开始与结束的提示
+ * @param summary 输出的汇总（可为NULL）
+ * @return 是否全部会话都传输成功
+ */
+static bool run_multiplexed_arq(const arq_direction_t* sessions, int count, const network_config_t* config,
+                                const arq_config_t* arq, uint32_t seed, bool quiet, mux_summary_t* summary) {
+    arq_run_t* runs = calloc((size_t)count, sizeof(arq_run_t));
+    bool* completed = calloc((size_t)count, sizeof(bool));
+    if (!runs || !completed) {
+        free(runs);
+        free(completed);
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        setup_direction_run(&runs[i], &sessions[i], config, arq);
+        runs[i].conn_id = (uint32_t)i + 1;
+    }
+    runs[0].quiet = quiet;
+    runs[0].seed = seed;
+    
+    bool success = run_arq_transfer(runs, count);
+    for (int i = 0; i < count; i++) {
+        completed[i] = runs[i].completed;
+    }
+    if (summary) summarize_sessions(sessions, completed, count, summary);
+    free(runs);
+    free(completed);
+    return success;
+}
+
+/**
+ * 多路复用窗口协议传输：多个会话按连接号共用仿真信道并发传输
+ * @param sessions 各会话的数据源、数据汇与统计信息（调用方清零）
+ * @param count 会话数
+ * @param config 网络配置（各会话相同）
+ * @param arq 窗口协议配置（各会话相同）
+ * @param summary 输出的汇总（可为NULL）
+ * @return 是否全部会话都传输成功
+ */
+bool transmit_multiplexed_arq(const arq_direction_t* sessions, int count, network_config_t* config,
+                              const arq_config_t* arq, mux_summary_t* summary) {
+    if (!sessions || count < 1 || !config || !arq) return false;
+    for (int i = 0; i < count; i++) {
+        if (!sessions[i].source || !sessions[i].sink || !sessions[i].stats) return false;
+    }
+    if (!validate_arq_config(arq)) return false;
+    
+    printf("\n========== 开始多路复用传输 (%d 个会话, %s, 窗口 %d) ==========\n",
+           count, arq_mode_name(arq->mode), arq->window_size);
+    return run_multiplexed_arq(sessions, count, config, arq, 0, false, summary);
+}
+
+/**
+ * 无输出的多路复用仿真：每个会话传输一段等长的合成数据，信道随机数只由 seed 决定
+ * @param sessions 会话数
+ * @param length 每个会话的数据长度
+ * @param config 网络配置（各会话共用信道，应设置带宽以观察对瓶颈的争用）
+ * @param arq 窗口协议配置（verbose 应关闭）
+ * @param seed 随机种子
+ * @param session_stats 各会话的统计信息（容量至少 sessions 个，调用方清零）
+ * @param summary 输出的汇总（可为NULL）
+ * @return 是否全部会话都传输成功
+ */
+bool simulate_multiplexed_transfer(int sessions, size_t length, const network_config_t* config,
+                                   const arq_config_t* arq, uint32_t seed,
+                                   statistics_t* session_stats, mux_summary_t* summary) {
+    if (sessions < 1 || length == 0 || !config || !arq || !session_stats) return false;
+    if (!validate_arq_config(arq)) return false;
+    
+    synthetic_stream_t* streams = calloc(2 * (size_t)sessions, sizeof(synthetic_stream_t));
+    arq_direction_t* directions = calloc((size_t)sessions, sizeof(arq_direction_t));
+    if (!streams || !directions) {
+        free(streams);
+        free(directions);
+        return false;
+    }
+    for (int i = 0; i < sessions; i++) {
+        synthetic_stream_t* source = &streams[2 * i];
+        synthetic_stream_t* sink = &streams[2 * i + 1];
+        source->total = length;
+        sink->total = length;
+        directions[i] = (arq_direction_t){ read_synthetic_source, source, write_synthetic_sink, sink,
+                                           &session_stats[i] };
+    }
+    
+    bool success = run_multiplexed_arq(directions, sessions, config, arq,
+                                       seed ? seed : CHANNEL_DEFAULT_SEED, true, summary);
+    for (int i = 0; i < sessions; i++) {
+        if (streams[2 * i + 1].position != length) success = false;
+    }
+    free(streams);
+    free(directions);
+    return success;
+}
+
+/* ========== 真实传输 ========== */
+
+/**
+ * 当前线程消耗的CPU时间
+ * @return 毫秒数
+ */
+static double thread_cpu_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * 处理从传输端点收到的一个报文：按连接号找到所属会话（只有一个会话时不必查表）
+ * @param sim 本端的时钟、时间轮、帧池与会话表
+ * @param packet 报文
+ */
+static void handle_transport_packet(arq_sim_t* sim, const transport_packet_t* packet) {
+    frame_pool_t* pool = &sim->pool;
+    uint32_t conn_id = 0;
+    arq_run_t* run = sim->flows[0];
+    if (sim->sessions.count > 1) {
+        run = peek_connection_id((const uint8_t*)packet->data, packet->length, &conn_id)
+              ? (arq_run_t*)find_session(&sim->sessions, conn_id) : NULL;
+    }
+    if (!run || run->finished) {
+        if (!run) ARQ_TRACE(sim->flows[0], "[传输] 连接号 %u 没有对应的会话，丢弃\n", conn_id);
+        return;
+    }
+    ack_frame_t ack;
+    
+    // 报文缓冲区会被下一批报文覆盖，数据帧解码到帧池中（接收方缓存时不再复制）
+    int handle = run->receiver ? acquire_frame(pool) : FRAME_NONE;
+    data_frame_t* frame = handle != FRAME_NONE ? frame_at(pool, handle) : NULL;
+    int type = decode_frame((const uint8_t*)packet->data, packet->length, frame, &ack);
+    if (type == DATA_FRAME && run->receiver) {
+        dispatch_data_frame(run, handle);
+    } else if ((type == ACK_FRAME || type == NAK_FRAME) && run->sender) {
+        dispatch_ack_frame(run, &ack);
+    } else if (type < 0) {
+        ARQ_EVENT(run, TRACE_FRAME_CORRUPT, -1, packet->length);
+        ARQ_TRACE(run, "[传输] 报文损坏 (%zu 字节)，丢弃\n", packet->length);
+        if (run->receiver) send_nak(run, "数据帧校验和错误");
+    }
+    mark_session(run);
+    release_frame(pool, handle);
+}
+
+/**
+ * 初始化真实传输一端的各个会话：虚拟时钟即单调时钟，时间轮按墙钟推进（不使用事件堆与仿真信道）。
+ * 各会话共用传输端点、时间轮与帧池，按连接号登记在会话表中（只有一个会话时连接号为0，报文格式不变）。
+ * 帧池容纳每个会话的一个窗口与正在处理的一帧（报文离开本端即编码进传输端点的缓冲区）
+ * @param runs 会话上下文数组
+ * @param count 会话数
+ * @param sim 时钟、时间轮、帧池与会话表
+ * @param transport 传输端点
+ * @param arq 窗口协议配置
+ * @param sessions 各会话的数据源（发送端）或数据汇（接收端）与统计信息
+ * @return 配置是否有效且分配成功
+ */
+static bool init_transport_runs(arq_run_t* runs, int count, arq_sim_t* sim, transport_t* transport,
+                                const arq_config_t* arq, const arq_direction_t* sessions) {
+    memset(sim, 0, sizeof(arq_sim_t));
+    memset(runs, 0, sizeof(arq_run_t) * (size_t)count);
+    if (!transport || !arq || !validate_arq_config(arq)) return false;
+    
+    sim->flows = malloc(sizeof(arq_run_t*) * (size_t)count);
+    sim->dirty = malloc(sizeof(arq_run_t*) * (size_t)count);
+    if (!sim->flows || !sim->dirty || !init_session_table(&sim->sessions, (size_t)count) ||
+        !init_frame_pool(&sim->pool, arq->window_size * count + 1)) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        arq_run_t* run = &runs[i];
+        if (!sessions[i].stats) return false;
+        run->arq = arq;
+        run->stats = sessions[i].stats;
+        run->transport = transport;
+        run->sim = sim;
+        run->conn_id = count > 1 ? (uint32_t)i + 1 : 0;
+        run->session = run;
+        run->index = i;
+        sim->flows[sim->flow_count++] = run;
+        if (!insert_session(&sim->sessions, run->conn_id, run)) return false;
+    }
+    sim->sessions_open = count;
+    init_timing_wheel(&sim->wheel, TIMER_TICK_MS, 0);
+    sim->wall_start_ms = monotonic_clock_ms();
+    return true;
+}
+
+/**
+ * 释放真实传输一端的各个会话
+ * @param sim 时钟、时间轮、帧池与会话表
+ */
+static void free_transport_runs(arq_sim_t* sim) {
+    for (int i = 0; i < sim->flow_count; i++) {
+        free_flow(sim->flows[i]);
+    }
+    free_frame_pool(&sim->pool);
+    free_session_table(&sim->sessions);
+    free(sim->flows);
+    free(sim->dirty);
+}
+
+/**
+ * 汇总真实传输一端的统计信息
+ * @param run 上下文
+ * @param cpu_start_ms 开始时的线程CPU时间
+ * @param packets_handled 处理的报文数
+ */
+static void finish_transport_stats(arq_run_t* run, double cpu_start_ms, long packets_handled) {
+    statistics_t* stats = run->stats;
+    stats->wall_ms = monotonic_clock_ms() - run->sim->wall_start_ms;
+    stats->elapsed_ms = stats->wall_ms;
+    stats->cpu_ms = thread_cpu_ms() - cpu_start_ms;
+    stats->events_processed = packets_handled + (long)run->sim->timers_fired;
+    stats->pool_frames_peak = run->sim->pool.peak_in_use;
+    stats->end_time = clock();
+    if (run->sender) {
+        stats->rto_ms = current_rto(run);
+        stats->srtt_ms = run->sender->rto.srtt_ms;
+        stats->rttvar_ms = run->sender->rto.rttvar_ms;
+        stats->rtt_samples = run->sender->rto.samples;
+        finish_congestion_stats(run);
+    }
+    if (stats->elapsed_ms > 0) {
+        stats->goodput_bps = stats->bytes_delivered * 8.0 / (stats->elapsed_ms / 1000.0);
+    }
+}
+
+/**
+ * 发送端处理本轮状态有变化的会话：补发新帧，结束已全部确认或重传超限的会话
+ * @param sim 发送端的时钟、时间轮、帧池与会话表
+ * @param cpu_start_ms 开始时的线程CPU时间
+ * @param packets_handled 已处理的报文数
+ */
+static void service_transport_senders(arq_sim_t* sim, double cpu_start_ms, long packets_handled) {
+    for (int i = 0; i < sim->dirty_count; i++) {
+        arq_run_t* run = sim->dirty[i];
+        run->dirty = false;
+        if (run->finished) continue;
+        
+        send_new_frames(run);
+        bool done = flow_done(run);
+        if (done || flow_failed(run)) {
+            run->finished = true;
+            run->completed = done;
+            sim->sessions_open--;
+            finish_transport_stats(run, cpu_start_ms, packets_handled);
+            cancel_flow_timers(run);
+        }
+    }
+    sim->dirty_count = 0;
+}
+
+/**
+ * 真实传输的发送端（可多路复用）：各会话从各自的数据源读取并发送，直到全部帧（含结束帧）被确认。
+ * 每轮把收到的确认一次处理完，只为状态有变化的会话补发新帧，产生的新帧攒成一批再发出
+ * @param sessions 各会话的数据源与统计信息（只含发送端的计数）
+ * @param count 会话数
+ * @param transport 传输端点（各会话共用）
+ * @param arq 窗口协议配置
+ * @param completed 输出各会话是否成功（可为NULL）
+ * @return 是否全部会话都传输成功
+ */
+static bool run_transport_senders(const arq_direction_t* sessions, int count, transport_t* transport,
+                                  const arq_config_t* arq, bool* completed) {
+    arq_sim_t sim;
+    arq_run_t* runs = calloc((size_t)count, sizeof(arq_run_t));
+    bool ready = runs && init_transport_runs(runs, count, &sim, transport, arq, sessions);
+    for (int i = 0; ready && i < count; i++) {
+        arq_run_t* run = &runs[i];
+        run->source = sessions[i].source;
+        run->source_context = sessions[i].source_context;
+        run->sender = calloc(1, sizeof(window_sender_t));
+        if (!run->source || !run->sender) {
+            ready = false;
+            break;
+        }
+        for (int k = 0; k < MAX_WINDOW_SIZE; k++) run->sender->window[k] = FRAME_NONE;
+        init_rto_estimator(&run->sender->rto, arq->timeout_ms, arq->min_rto_ms, arq->max_rto_ms, TIMER_TICK_MS);
+        init_congestion_window(run);
+        run->dirty = true;
+        sim.dirty[sim.dirty_count++] = run;
+    }
+    if (!ready) {
+        if (runs) free_transport_runs(&sim);
+        free(runs);
+        return false;
+    }
+    
+    double cpu_start = thread_cpu_ms();
+    transport_packet_t packets[TRANSPORT_BATCH];
+    long packets_handled = 0;
+    
+    service_transport_senders(&sim, cpu_start, packets_handled);
+    transport_flush(transport);
+    while (sim.sessions_open > 0 && !sim.out_of_memory) {
+        // 有计时器装载时最多等待一个 tick，以便按时推进时间轮
+        double wait_ms = sim.wheel.armed_count > 0 ? sim.wheel.tick_ms : ARQ_IDLE_LIMIT_MS;
+        int received = transport_receive(transport, packets, TRANSPORT_BATCH, wait_ms);
+        sim.now = monotonic_clock_ms() - sim.wall_start_ms;
+        for (int i = 0; i < received; i++) {
+            handle_transport_packet(&sim, &packets[i]);
+        }
+        packets_handled += received;
+        
+        advance_timing_wheel(&sim.wheel, sim.now, arq_timer_expired, &sim);
+        service_transport_senders(&sim, cpu_start, packets_handled);
+        transport_flush(transport);
+    }
+    
+    bool success = true;
+    for (int i = 0; i < count; i++) {
+        if (!runs[i].finished) finish_transport_stats(&runs[i], cpu_start, packets_handled);
+        if (!runs[i].completed) success = false;
+        if (completed) completed[i] = runs[i].completed;
+    }
+    free_transport_runs(&sim);
+    free(runs);
+    return success;
+}
+
+/**
+ * 真实传输的接收端（可多路复用）：各会话按序交付给各自的数据汇，全部会话收到结束帧后继续应答一段时间，
+ * 以便最后的确认丢失时对发送方的重传作出应答
+ * @param sessions 各会话的数据汇与统计信息（只含接收端的计数）
+ * @param count 会话数（须与发送端一致）
+ * @param transport 传输端点（各会话共用）
+ * @param arq 窗口协议配置（须与发送端一致）
+ * @param completed 输出各会话是否完整接收了数据流（可为NULL）
+ * @return 是否全部会话都完整接收了数据流
+ */
+static bool run_transport_receivers(const arq_direction_t* sessions, int count, transport_t* transport,
+                                    const arq_config_t* arq, bool* completed) {
+    arq_sim_t sim;
+    arq_run_t* runs = calloc((size_t)count, sizeof(arq_run_t));
+    bool ready = runs && init_transport_runs(runs, count, &sim, transport, arq, sessions);
+    for (int i = 0; ready && i < count; i++) {
+        arq_run_t* run = &runs[i];
+        run->sink = sessions[i].sink;
+        run->sink_context = sessions[i].sink_context;
+        run->receiver = calloc(1, sizeof(window_receiver_t));
+        if (!run->sink || !run->receiver) {
+            ready = false;
+            break;
+        }
+        for (int k = 0; k < MAX_WINDOW_SIZE; k++) run->receiver->slots[k] = FRAME_NONE;
+    }
+    if (!ready) {
+        if (runs) free_transport_runs(&sim);
+        free(runs);
+        return false;
+    }
+    
+    double cpu_start = thread_cpu_ms();
+    double linger_ms = ARQ_LINGER_RTOS * arq->timeout_ms;
+    double last_packet_ms = 0;
+    transport_packet_t packets[TRANSPORT_BATCH];
+    long packets_handled = 0;
+    int failed = 0;
+    
+    while (true) {
+        // 有延迟确认在等待时最多等待一个 tick，以便按时发出
+        double wait_ms = sim.wheel.armed_count > 0 ? sim.wheel.tick_ms : 10;
+        int received = transport_receive(transport, packets, TRANSPORT_BATCH, wait_ms);
+        sim.now = monotonic_clock_ms() - sim.wall_start_ms;
+        for (int i = 0; i < received; i++) {
+            handle_transport_packet(&sim, &packets[i]);
+        }
+        advance_timing_wheel(&sim.wheel, sim.now, arq_timer_expired, &sim);
+        transport_flush(transport);
+        if (received > 0) last_packet_ms = sim.now;
+        packets_handled += received;
+        
+        // 接收方收到结束帧后仍要应答重传，只记录完成，不停止会话
+        for (int i = 0; i < sim.dirty_count; i++) {
+            arq_run_t* run = sim.dirty[i];
+            run->dirty = false;
+            if (run->completed || run->finished) continue;
+            if (run->sink_failed) {
+                run->finished = true;
+                failed++;
+                sim.sessions_open--;
+            } else if (run->stream_finished) {
+                run->completed = true;
+                sim.sessions_open--;
+            }
+        }
+        sim.dirty_count = 0;
+        
+        double idle_ms = sim.now - last_packet_ms;
+        if (sim.sessions_open == 0 && (failed > 0 || idle_ms >= linger_ms)) break;
+        if (sim.sessions_open > 0 && idle_ms >= ARQ_IDLE_LIMIT_MS) {
+            printf("[错误] 发送方 %d 毫秒无响应，接收中止\n", ARQ_IDLE_LIMIT_MS);
+            break;
+        }
+    }
+    
+    bool success = sim.sessions_open == 0 && failed == 0;
+    for (int i = 0; i < count; i++) {
+        finish_transport_stats(&runs[i], cpu_start, packets_handled);
+        if (completed) completed[i] = runs[i].completed;
+    }
+    free_transport_runs(&sim);
+    free(runs);
+    return success;
+}
+
+/**
+ * 真实传输的发送端：从数据源读取并发送，直到全部帧（含结束帧）被确认
+ * 每轮把收到的确认一次处理完，产生的新帧攒成一批再发出
+ * @param source 数据源
+ * @param source_context 数据源上下文
+ * @param transport 传输端点
+ * @param arq 窗口协议配置
+ * @param stats 统计信息（只含发送端的计数）
+ * @return 传输是否成功
+ */
+bool run_transport_sender(arq_source_fn source, void* source_context, transport_t* transport,
+                          const arq_config_t* arq, statistics_t* stats) {
+    arq_direction_t session = { source, source_context, NULL, NULL, stats };
+    return run_transport_senders(&session, 1, transport, arq, NULL);
+}
+
+/**
+ * 真实传输的接收端：按序交付给数据汇，收到结束帧后继续应答一段时间，
+ * 以便最后的确认丢失时对发送方的重传作出应答
+ * @param sink 数据汇
+ * @param sink_context 数据汇上下文
+ * @param transport 传输端点
+ * @param arq 窗口协议配置（须与发送端一致）
+ * @param stats 统计信息（只含接收端的计数）
+ * @return 是否完整接收了数据流
+ */
+bool run_transport_receiver(arq_sink_fn sink, void* sink_context, transport_t* transport,
+                            const arq_config_t* arq, statistics_t* stats) {
+    arq_direction_t session = { NULL, NULL, sink, sink_context, stats };
+    return run_transport_receivers(&session, 1, transport, arq, NULL);
+}
+
+/* 接收端线程参数 */
+typedef struct {
+    const arq_direction_t* sessions;    // 各会话的数据汇，统计只含接收端的计数
+    int count;
+    transport_t* transport;
+    const arq_config_t* arq;
+    bool* completed;
+    bool success;
+} receiver_thread_t;
+
+static void* receiver_thread_main(void* argument) {
+    receiver_thread_t* thread = (receiver_thread_t*)argument;
+    thread->success = run_transport_receivers(thread->sessions, thread->count, thread->transport,
+                                              thread->arq, thread->completed);
+    return NULL;
+}
+
+/**
+ * 把接收端的计数并入发送端的统计；吞吐量按发送端完成的时刻计算
+ * @param stats 发送端的统计信息
+ * @param receiver 接收端的统计信息
+ */
+static void merge_receiver_stats(statistics_t* stats, const statistics_t* receiver) {
+    stats->frames_received = receiver->frames_received;
+    stats->acks_sent = receiver->acks_sent;
+    stats->frames_lost += receiver->frames_lost;
+    stats->bytes_delivered = receiver->bytes_delivered;
+    stats->duplicate_frames = receiver->duplicate_frames;
+    stats->wire_bytes += receiver->wire_bytes;
+    stats->events_processed += receiver->events_processed;
+    stats->cpu_ms += receiver->cpu_ms;
+    if (stats->elapsed_ms > 0) {
+        stats->goodput_bps = stats->bytes_delivered * 8.0 / (stats->elapsed_ms / 1000.0);
+    }
+}
+
+/**
+ * 经一对传输端点传输各会话的字节流：接收端运行在新线程中，发送端运行在调用线程中，
+ * 结束后把各会话接收端的统计并入该会话的统计
+ * @param sessions 各会话的数据源、数据汇（在接收线程中调用）与统计信息
+ * @param count 会话数
+ * @param sender_transport 发送端的传输端点
+ * @param receiver_transport 接收端的传输端点
+ * @param arq 窗口协议配置
+ * @param completed 输出各会话是否成功（可为NULL）
+ * @return 是否全部会话都传输成功
+ */
+static bool transfer_over_transport(const arq_direction_t* sessions, int count,
+                                    transport_t* sender_transport, transport_t* receiver_transport,
+                                    const arq_config_t* arq, bool* completed) {
+    arq_direction_t* receivers = calloc((size_t)count, sizeof(arq_direction_t));
+    statistics_t* receiver_stats = calloc((size_t)count, sizeof(statistics_t));
+    bool* received = calloc((size_t)count, sizeof(bool));
+    if (!receivers || !receiver_stats || !received) {
+        free(receivers);
+        free(receiver_stats);
+        free(received);
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        receivers[i].sink = sessions[i].sink;
+        receivers[i].sink_context = sessions[i].sink_context;
+        receivers[i].stats = &receiver_stats[i];
+    }
+    
+    receiver_thread_t receiver = { receivers, count, receiver_transport, arq, received, false };
+    pthread_t thread;
+    bool success = false;
+    if (pthread_create(&thread, NULL, receiver_thread_main, &receiver) != 0) {
+        printf("[错误] 无法创建接收线程\n");
+    } else {
+        bool sent = run_transport_senders(sessions, count, sender_transport, arq, completed);
+        pthread_join(thread, NULL);
+        for (int i = 0; i < count; i++) {
+            merge_receiver_stats(sessions[i].stats, &receiver_stats[i]);
+            if (completed) completed[i] = completed[i] && received[i];
+        }
+        success = sent && receiver.success;
+    }
+    
+    free(receivers);
+    free(receiver_stats);
+    free(received);
+    return success;
+}
+
+/**
+ * 经一对传输端点传输字节流：接收端运行在新线程中，发送端运行在调用线程中，
+ * 结束后合并双方的统计
+ * @param source 数据源
+ * @param source_context 数据源上下文
+ * @param sink 数据汇（在接收线程中调用）
+ * @param sink_context 数据汇上下文
+ * @param sender_transport 发送端的传输端点
+ * @param receiver_transport 接收端的传输端点
+ * @param arq 窗口协议配置
+ * @param stats 统计信息
+ * @return 传输是否成功
+ */
+bool transmit_stream_transport(arq_source_fn source, void* source_context,
+                               arq_sink_fn sink, void* sink_context,
+                               transport_t* sender_transport, transport_t* receiver_transport,
+                               const arq_config_t* arq, statistics_t* stats) {
+    if (!source || !sink || !sender_transport || !receiver_transport || !arq || !stats) return false;
+    if (!validate_arq_config(arq)) return false;
+    
+    printf("\n========== 开始%s传输 (%s, 窗口 %d, 每帧 %d 字节) ==========\n",
+           sender_transport->ops->name, arq_mode_name(arq->mode), arq->window_size, arq->payload_size);
+    
+    arq_direction_t session = { source, source_context, sink, sink_context, stats };
+    bool success = transfer_over_transport(&session, 1, sender_transport, receiver_transport, arq, NULL);
+    printf("\n========== %s传输%s (耗时 %.1f 毫秒) ==========\n",
+           sender_transport->ops->name, success ? "完成" : "失败", stats->elapsed_ms);
+    return success;
+}
+
+/**
+ * 多路复用的真实传输：各会话共用一对传输端点（如同一个UDP套接字），报文按连接号分到各自的会话，
+ * 结束后汇总各会话的有效吞吐量与公平性
+ * @param sessions 各会话的数据源、数据汇与统计信息（调用方清零）
+ * @param count 会话数
+ * @param sender_transport 发送端的传输端点
+ * @param receiver_transport 接收端的传输端点
+ * @param arq 窗口协议配置
+ * @param summary 输出的汇总（可为NULL）
+ * @return 是否全部会话都传输成功
+ */
+bool transmit_multiplexed_transport(const arq_direction_t* sessions, int count,
+                                    transport_t* sender_transport, transport_t* receiver_transport,
+                                    const arq_config_t* arq, mux_summary_t* summary) {
+    if (!sessions || count < 1 || !sender_transport || !receiver_transport || !arq) return false;
+    for (int i = 0; i < count; i++) {
+        if (!sessions[i].source || !sessions[i].sink || !sessions[i].stats) return false;
+    }
+    if (!validate_arq_config(arq)) return false;
+    
+    printf("\n========== 开始%s多路复用传输 (%d 个会话, %s, 窗口 %d) ==========\n",
+           sender_transport->ops->name, count, arq_mode_name(arq->mode), arq->window_size);
+    
+    bool* completed = calloc((size_t)count, sizeof(bool));
+    if (!completed) return false;
+    bool success = transfer_over_transport(sessions, count, sender_transport, receiver_transport, arq, completed);
+    if (summary) summarize_sessions(sessions, completed, count, summary);
+    free(completed);
+    
+    printf("\n========== %s多路复用传输%s ==========\n", sender_transport->ops->name, success ? "完成" : "失败");
+    return success;
+}
+
+/**
+ * 回退N帧协议传输消息（使用默认分帧参数）
+ * @param message 要传输的消息
+ * @param config 网络配置
+ * @param window_size 发送窗口大小
+ * @param stats 统计信息
+ * @return 传输是否成功
+ */
+bool transmit_message_gbn(const char* message, network_config_t* config,
+                          int window_size, statistics_t* stats) {
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.window_size = window_size;
+    arq.seq_space = window_size + 1;
+    
+    return transmit_message_arq(message, config, &arq, stats);
+}
+
+/**
+ * 选择重传协议传输消息（使用默认分帧参数）
+ * @param message 要传输的消息
+ * @param config 网络配置
+ * @param window_size 发送/接收窗口大小
+ * @param stats 统计信息
+ * @return 传输是否成功
+ */
+bool transmit_message_sr(const char* message, network_config_t* config,
+                         int window_size, statistics_t* stats) {
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = window_size;
+    arq.seq_space = 2 * window_size;
+    
+    return transmit_message_arq(message, config, &arq, stats);
+}
+
+/**
+ * 获取ARQ模式名称
+ * @param mode ARQ模式
+ * @return 模式名称
+ */
+const char* arq_mode_name(arq_mode_t mode) {
+    switch (mode) {
+        case ARQ_STOP_AND_WAIT:
+            return "停等";
+        case ARQ_GO_BACK_N:
+            return "回退N帧";
+        case ARQ_SELECTIVE_REPEAT:
+            return "选择重传";
+        default:
+            return "未知";
+    }
+}
+
+/* ========== 工具函数 ========== */
+
+/**
+ * 打印数据帧信息
+ * @param frame 数据帧
+ * @param direction 方向描述
+ */
+void print_frame_info(const data_frame_t* frame, const char* direction) {
+    if (!frame || !direction) return;
+    
+    printf("[数据帧%s] 类型: %s, 序列号: %d, 长度: %d, 校验和: %u\n",
+           direction,
+           frame->type == DATA_FRAME ? "数据" : "未知",
+           frame->seq_num,
+           frame->data_length,
+           frame->checksum);
+    printf("           数据内容: \"%.50s%s\"\n", 
+           frame->data, frame->data_length > 50 ? "..." : "");
+}
+
+/**
+ * 打印确认帧信息
+ * @param ack 确认帧
+ * @param direction 方向描述
+ */
+void print_ack_info(const ack_frame_t* ack, const char* direction) {
+    if (!ack || !direction) return;
+    
+    printf("[确认帧%s] 类型: %s, 确认号: %d, 校验和: %u\n",
+           direction,
+           ack->type == ACK_FRAME ? "确认" : "未知",
+           ack->ack_num,
+           ack->checksum);
+}
+
+/**
+ * 打印统计信息
+ * @param stats 统计信息
+ */
+void print_statistics(const statistics_t* stats) {
+    if (!stats) return;
+    
+    double duration = ((double)(stats->end_time - stats->start_time)) / CLOCKS_PER_SEC;
+    
+    printf("\n========== 传输统计 ==========\n");
+    printf("传输时间:     %.3f 秒\n", duration);
+    if (stats->cpu_ms > 0) {
+        // 真实传输：时长即墙钟时间
+        printf("实际时长:     %.1f 毫秒\n", stats->wall_ms);
+        printf("处理事件数:   %ld\n", stats->events_processed);
+    } else {
+        if (stats->elapsed_ms > 0) {
+            printf("仿真时长:     %.1f 毫秒\n", stats->elapsed_ms);
+        }
+        if (stats->events_processed > 0) {
+            printf("仿真事件数:   %ld (实际耗时 %.1f 毫秒)\n", stats->events_processed, stats->wall_ms);
+        }
+    }
+    printf("发送帧数:     %d\n", stats->frames_sent);
+    printf("接收帧数:     %d\n", stats->frames_received);
+    printf("发送确认数:   %d\n", stats->acks_sent);
+    printf("接收确认数:   %d\n", stats->acks_received);
+    printf("重传次数:     %d\n", stats->retransmissions);
+    printf("丢失帧数:     %d\n", stats->frames_lost);
+    if (stats->timeouts > 0) {
+        printf("超时次数:     %d\n", stats->timeouts);
+    }
+    if (stats->duplicate_frames > 0) {
+        printf("冗余重传:     %d (接收方已收到的帧)\n", stats->duplicate_frames);
+    }
+    if (stats->sack_skips > 0) {
+        printf("SACK免重传:   %d\n", stats->sack_skips);
+    }
+    if (stats->piggybacked_acks > 0) {
+        printf("捎带确认:     %d (省去的独立确认帧)\n", stats->piggybacked_acks);
+    }
+    if (stats->naks_sent > 0 || stats->nak_retransmits > 0) {
+        printf("否定确认:     发出 %d, 触发立即重传 %d\n", stats->naks_sent, stats->nak_retransmits);
+    }
+    if (stats->coalesced_acks > 0) {
+        printf("合并确认:     %d (被后来的确认取代)\n", stats->coalesced_acks);
+    }
+    if (stats->rto_ms > 0) {
+        printf("当前RTO:      %.1f 毫秒\n", stats->rto_ms);
+    }
+    if (stats->rtt_samples > 0) {
+        printf("平滑RTT:      %.1f 毫秒 (偏差 %.1f, %d 个样本)\n",
+               stats->srtt_ms, stats->rttvar_ms, stats->rtt_samples);
+    }
+    if (stats->bytes_delivered > 0) {
+        printf("交付字节数:   %ld\n", stats->bytes_delivered);
+        printf("有效吞吐量:   %.2f kbit/s\n", stats->goodput_bps / 1000.0);
+    }
+    if (stats->wire_bytes > 0) {
+        int frames = stats->frames_sent + stats->acks_sent;
+        printf("线路字节数:   %ld (平均每帧 %.1f 字节)\n", stats->wire_bytes,
+               frames > 0 ? (double)stats->wire_bytes / frames : 0.0);
+    }
+    if (stats->queue_drops > 0) {
+        printf("队列丢弃:     %d (瓶颈链路排队已满)\n", stats->queue_drops);
+    }
+    if (stats->reordered_frames > 0 || stats->network_duplicates > 0) {
+        printf("乱序/复制:    %d / %d 帧\n", stats->reordered_frames, stats->network_duplicates);
+    }
+    if (stats->cwnd_max > 0) {
+        printf("拥塞窗口:     平均 %.1f 帧, 最大 %.1f 帧 (减窗 %d 次, 快速重传 %d 次)\n",
+               stats->cwnd_mean, stats->cwnd_max, stats->cwnd_reductions, stats->fast_retransmits);
+    } else if (stats->fast_retransmits > 0) {
+        printf("快速重传:     %d 次\n", stats->fast_retransmits);
+    }
+    if (stats->corrupted_frames > 0) {
+        printf("损坏帧数:     %d (校验发现 %d, 漏检 %d)\n", stats->corrupted_frames,
+               stats->corruption_detected, stats->undetected_errors);
+    }
+    if (stats->pool_frames_peak > 0) {
+        printf("帧池峰值:     %d 帧同时在用\n", stats->pool_frames_peak);
+    }
+    if (stats->cpu_ms > 0 && stats->frames_sent > 0) {
+        printf("实际帧速率:   %.0f 帧/秒\n", stats->frames_sent / (stats->wall_ms / 1000.0));
+        printf("CPU时间:      %.1f 毫秒 (每帧 %.2f 微秒)\n",
+               stats->cpu_ms, stats->cpu_ms * 1000.0 / stats->frames_sent);
+    }
+    
+    if (stats->frames_sent > 0) {
+        double success_rate = ((double)(stats->frames_sent - stats->frames_lost)) / stats->frames_sent * 100;
+        printf("传输成功率:   %.1f%%\n", success_rate);
+    }
+    
+    if (stats->retransmissions > 0 && stats->frames_received > 0) {
+        double retrans_rate = ((double)stats->retransmissions) / stats->frames_sent * 100;
+        printf("重传率:       %.1f%%\n", retrans_rate);
+    }
+    
+    printf("=============================\n");
+}
+
+/**
+ * 打印多路复用传输的汇总
+ * @param summary 汇总
+ */
+void print_mux_summary(const mux_summary_t* summary) {
+    if (!summary) return;
+    
+    printf("\n========== 多路复用统计 ==========\n");
+    printf("会话数:       %d (成功 %d)\n", summary->sessions, summary->completed);
+    printf("结束时刻:     %.1f 毫秒 (实际耗时 %.1f 毫秒)\n", summary->elapsed_ms, summary->wall_ms);
+    if (summary->events_processed > 0) {
+        printf("处理事件数:   %ld\n", summary->events_processed);
+    }
+    printf("交付字节数:   %ld\n", summary->bytes_delivered);
+    printf("总吞吐量:     %.2f kbit/s\n", summary->aggregate_goodput_bps / 1000.0);
+    printf("会话吞吐量:   平均 %.2f, 最小 %.2f, 最大 %.2f kbit/s\n", summary->mean_goodput_bps / 1000.0,
+           summary->min_goodput_bps / 1000.0, summary->max_goodput_bps / 1000.0);
+    printf("Jain公平指数: %.4f\n", summary->jain_index);
+    printf("=================================\n");
 }
 
 /**
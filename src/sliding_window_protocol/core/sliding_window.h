@@ -7,6 +7,9 @@
 #include <time.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "timing_wheel.h"
+#include "transport.h"
 
 /* 常量定义 */
 #define MAX_DATA_SIZE 1024      // 最大数据帧大小
@@ -14,13 +17,45 @@
 #define TIMEOUT_MS 1000         // 超时时间（毫秒）
 #define MAX_RETRIES 3           // 最大重传次数
 
+/* 窗口协议常量 */
+#define MAX_WINDOW_SIZE 64      // 窗口协议支持的最大窗口大小
+#define ARQ_DEFAULT_WINDOW 8    // 默认发送窗口大小
+#define ARQ_DEFAULT_PAYLOAD 16  // 默认每帧携带的数据字节数
+#define ARQ_MAX_RETRIES 16      // 窗口协议中无进展的最大连续超时次数
+#define CHANNEL_CAPACITY 256    // 信道中同时在途的最大帧数（超出即尾部丢弃）
+#define SACK_BITMAP_BITS 64     // 选择确认位图的位数（不小于最大接收窗口）
+#define ARQ_MTU_PAYLOAD (MAX_DATA_SIZE - 1)  // 分片传输时每帧的最大数据字节数
+#define ARQ_IDLE_LIMIT_MS 5000  // 真实传输中接收方等待对端的最长时间（毫秒）
+#define ARQ_LINGER_RTOS 4       // 接收方收到结束帧后继续应答的时长（初始RTO的倍数）
+#define ARQ_PIGGYBACK_DELAY_MS 10 // 全双工时确认等待反向数据帧捎带的默认时长（毫秒）
+#define ARQ_ACK_DELAY_MS 40     // 延迟确认的默认最长等待时间（毫秒）
+
+/* 重传超时估计常量（RFC 6298） */
+#define RTO_MIN_MS 10           // RTO下限（毫秒）；RFC建议1秒，仿真链路时延小，取更低的值
+#define RTO_MAX_MS 60000        // RTO上限（毫秒）
+#define RTO_ALPHA 0.125         // SRTT平滑系数
+#define RTO_BETA 0.25           // RTTVAR平滑系数
+#define RTO_K 4                 // RTO = SRTT + K × RTTVAR
+
+/* 拥塞控制常量（RFC 5681 / RFC 6582，以帧为单位） */
+#define CWND_INITIAL 1          // 初始拥塞窗口
+#define CWND_MIN_SSTHRESH 2     // 慢启动阈值下限
+#define DUP_ACK_THRESHOLD 3     // 触发快速重传的重复确认数
+
 /* 帧类型定义 */
 typedef enum {
     DATA_FRAME,     // 数据帧
     ACK_FRAME,      // 确认帧
-    NAK_FRAME       // 否定确认帧（可选）
+    NAK_FRAME       // 否定确认帧：接收方请求立即重传缺失或损坏的帧
 } frame_type_t;
 
+/* 自动重传请求(ARQ)模式 */
+typedef enum {
+    ARQ_STOP_AND_WAIT,      // 停等协议（窗口大小为1）
+    ARQ_GO_BACK_N,          // 回退N帧协议
+    ARQ_SELECTIVE_REPEAT    // 选择重传协议
+} arq_mode_t;
+
 /* 协议状态定义 */
 typedef enum {
     WAITING_FOR_CALL,       // 等待上层调用
@@ -33,30 +68,84 @@ typedef struct {
     frame_type_t type;          // 帧类型
     int seq_num;                // 序列号
     int data_length;            // 数据长度
+    int ack_num;                // 全双工：捎带的反方向确认号（-1 表示不携带）
+    uint64_t sack_bitmap;       // 捎带确认的SACK位图
+    uint32_t conn_id;           // 连接号：多路复用时区分会话（0 为默认连接）
     char data[MAX_DATA_SIZE];   // 数据内容
-    unsigned int checksum;      // 校验和（简单校验）
+    unsigned int checksum;      // 校验和（CRC-32C，只覆盖帧头与有效数据）
 } data_frame_t;
 
 /* 确认帧结构 */
 typedef struct {
     frame_type_t type;          // 帧类型
-    int ack_num;                // 确认号
+    int ack_num;                // 确认号（启用SACK时为累积确认：最后一个按序接收帧的序列号）
+    uint64_t sack_bitmap;       // 选择确认位图：第 i 位表示累积确认之后的第 i+2 帧已收到
+    uint32_t conn_id;           // 连接号
     unsigned int checksum;      // 校验和
 } ack_frame_t;
 
-/* 网络环境配置 */
+/* 网络环境配置（窗口协议仿真信道的每个方向独立使用这些参数） */
 typedef struct {
-    double loss_probability;    // 丢包概率 (0.0-1.0)
+    double loss_probability;    // 丢包概率 (0.0-1.0)；启用突发模型时为好状态下的丢包概率
     int min_delay_ms;          // 最小延迟（毫秒）
     int max_delay_ms;          // 最大延迟（毫秒）
+    double corruption_probability; // 帧在线路上被损坏的概率 (0.0-1.0)
+    int corruption_bits;       // 每个损坏帧随机翻转的比特数
+    double burst_enter_probability; // Gilbert-Elliott：每帧由好状态转入坏状态的概率（0 表示不启用）
+    double burst_exit_probability;  // 每帧由坏状态回到好状态的概率（平均突发长度为其倒数）
+    double burst_loss_probability;  // 坏状态下的丢包概率
+    double reorder_probability; // 帧被额外延迟、可能被后发帧超过的概率
+    int reorder_delay_ms;      // 乱序帧的最大额外延迟（毫秒）
+    double duplicate_probability; // 帧被网络复制（接收方收到两份）的概率
+    long bandwidth_bps;        // 瓶颈链路带宽（比特/秒，0 表示不限，不产生串行化时延）
+    int queue_limit;           // 瓶颈链路最多排队的帧数，超出即尾部丢弃（0 表示只受信道容量限制）
 } network_config_t;
 
+/* 拥塞窗口变化回调：time_ms 为虚拟时刻，cwnd 与 ssthresh 以帧为单位 */
+typedef void (*arq_cwnd_fn)(double time_ms, double cwnd, double ssthresh, void* context);
+
+/* 抓包回调：仿真中每个进入信道的报文（线路格式，含尾部校验和）在发送时刻调用一次，
+ * forward 表示 A→B 方向（正向数据与反向确认），否则 B→A */
+typedef void (*arq_capture_fn)(double time_ms, bool forward, const uint8_t* packet, size_t length, void* context);
+
+/* 窗口协议配置 */
+typedef struct {
+    arq_mode_t mode;            // ARQ模式
+    int window_size;            // 发送窗口大小N
+    int seq_space;              // 序列号空间大小（回退N帧至少N+1，选择重传至少2N）
+    int payload_size;           // 每帧携带的数据字节数
+    int timeout_ms;             // 重传超时（毫秒）；启用自适应时为初始RTO
+    int max_retries;            // 无进展的最大连续超时次数
+    bool adaptive_rto;          // 按RTT测量自适应调整RTO（RFC 6298）
+    int min_rto_ms;             // 自适应RTO下限（毫秒）
+    int max_rto_ms;             // 自适应RTO上限（毫秒）
+    bool real_time;             // 按墙钟节奏推进虚拟时钟（演示用），否则不休眠、尽快完成仿真
+    bool verbose;               // 是否逐事件打印协议日志（跟踪级别为 TRACE_LEVEL_TEXT 时才输出）
+    bool sack;                  // 确认帧携带SACK位图：接收方缓存失序帧，发送方只重传空缺
+    bool congestion_control;    // AIMD拥塞控制：实际发送窗口取 min(窗口大小, 拥塞窗口)
+    arq_cwnd_fn cwnd_trace;     // 拥塞窗口每次变化时调用（可为NULL）
+    void* cwnd_trace_context;
+    arq_capture_fn capture;     // 仿真信道的抓包回调（可为NULL；真实传输的报文可用系统抓包工具捕获）
+    void* capture_context;
+    int piggyback_delay_ms;     // 全双工：确认等待反向数据帧捎带的最长时间（毫秒，0 表示立即单独发送）
+    int ack_every;              // 延迟确认：每收到 k 个数据帧发一次确认（1 表示逐帧确认；只作用于累积确认）
+    int ack_delay_ms;           // 延迟确认：不足 k 帧时确认的最长等待时间（毫秒）
+    bool nak;                   // 接收方发现空缺（失序帧）或校验和错误时发送否定确认，发送方立即重传
+    bool fast_retransmit;       // 第3个重复确认时立即重传窗口左沿（启用拥塞控制时总是如此）
+} arq_config_t;
+
+/* 流式传输回调
+ * 数据源：向 buffer 写入至多 capacity 字节并返回写入的字节数，返回0表示数据已取完
+ * 数据汇：按序接收重组后的数据段，返回 false 时中止传输 */
+typedef size_t (*arq_source_fn)(char* buffer, size_t capacity, void* context);
+typedef bool (*arq_sink_fn)(const char* data, size_t length, void* context);
+
 /* 发送方状态 */
 typedef struct {
     protocol_state_t state;     // 当前状态
     int seq_num;               // 当前序列号
     data_frame_t current_frame; // 当前发送的帧
-    clock_t timer_start;       // 计时器开始时间
+    double timer_start_ms;     // 计时器开始时刻（单调时钟毫秒）
     int retry_count;           // 重传计数
 } sender_state_t;
 
@@ -66,6 +155,53 @@ typedef struct {
     int expected_seq;           // 期望的序列号
 } receiver_state_t;
 
+/* 重传超时估计器（RFC 6298） */
+typedef struct {
+    double srtt_ms;             // 平滑往返时间
+    double rttvar_ms;           // 往返时间偏差
+    double rto_ms;              // 当前重传超时（含退避）
+    double initial_rto_ms;      // 初始RTO（尚无样本时清除退避即恢复到该值）
+    double min_rto_ms;          // RTO下限
+    double max_rto_ms;          // RTO上限
+    double granularity_ms;      // 时钟粒度G
+    int samples;                // 已采集的RTT样本数
+    int backoffs;               // 当前连续退避次数
+} rto_estimator_t;
+
+/* 窗口发送方状态
+ * 帧号为不取模的绝对编号，线路上的序列号 = 帧号 % seq_space */
+typedef struct {
+    int window[MAX_WINDOW_SIZE]; // 在途帧的帧池句柄（环形缓冲区，按 帧号 % 窗口大小 索引）
+    int base;                   // 最早未确认的帧号
+    int next_frame;             // 下一个待发送的帧号
+    bool source_done;           // 数据源已取完，next_frame 即总帧数
+    wheel_timer_t window_timer; // 回退N帧/停等：整个窗口共用的重传计时器（窗口非空时装载）
+    int retry_count;            // 无进展的连续超时次数
+    wheel_timer_t frame_timers[MAX_WINDOW_SIZE]; // 选择重传：每帧独立的重传计时器
+    bool frame_acked[MAX_WINDOW_SIZE];     // 选择重传：该帧是否已被单独确认
+    int frame_retries[MAX_WINDOW_SIZE];    // 选择重传：该帧的超时次数
+    double frame_sent_ms[MAX_WINDOW_SIZE]; // 该帧首次发送的时刻（RTT采样）
+    bool frame_retransmitted[MAX_WINDOW_SIZE]; // 该帧是否被重传过（Karn算法：不采样）
+    rto_estimator_t rto;        // 重传超时估计
+    double cwnd;                // 拥塞窗口（帧，可为小数：拥塞避免阶段每个确认增加 1/cwnd）
+    double ssthresh;            // 慢启动阈值
+    int dup_acks;               // 连续的重复确认数（确认到达但窗口左沿未前进）
+    bool in_recovery;           // 处于快速恢复阶段
+    int recover;                // 进入快速恢复或超时时的 next_frame：其前的帧全部确认才退出恢复，
+                                // 这些帧再次丢失也不重复减窗
+    double cwnd_changed_ms;     // 拥塞窗口上次变化的时刻（计算时间加权平均）
+    double cwnd_area;           // 拥塞窗口对时间的积分（帧·毫秒）
+} window_sender_t;
+
+/* 窗口接收方状态 */
+typedef struct {
+    int expected_frame;         // 下一个按序期望的帧号
+    size_t length;              // 已按序交付给数据汇的字节数
+    int slots[MAX_WINDOW_SIZE]; // 选择重传的接收缓冲区（持有帧池句柄），按 帧号 % 窗口大小 索引
+    bool slot_filled[MAX_WINDOW_SIZE];    // 缓冲区槽位是否已有帧
+    bool nak_sent;              // 已为 expected_frame 发出否定确认（每个期望帧只请求一次）
+} window_receiver_t;
+
 /* 统计信息 */
 typedef struct {
     int frames_sent;            // 发送的帧数
@@ -76,8 +212,61 @@ typedef struct {
     int frames_lost;           // 丢失的帧数
     clock_t start_time;        // 开始时间
     clock_t end_time;          // 结束时间
+    double elapsed_ms;         // 传输耗时（仿真虚拟时钟，毫秒）
+    double wall_ms;            // 仿真实际运行耗时（墙钟，毫秒）
+    long events_processed;     // 仿真处理的事件数
+    long bytes_delivered;      // 按序交付给上层的字节数
+    int timeouts;              // 超时事件次数
+    double goodput_bps;        // 有效吞吐量（交付字节 × 8 / 耗时，比特/秒）
+    double rto_ms;             // 传输结束时的重传超时（毫秒）
+    double srtt_ms;            // 平滑往返时间（毫秒）
+    double rttvar_ms;          // 往返时间偏差（毫秒）
+    int rtt_samples;           // RTT样本数
+    double cpu_ms;             // 真实传输消耗的CPU时间（毫秒）
+    int duplicate_frames;      // 接收方收到的重复帧（冗余重传）
+    int sack_skips;            // 因SACK表明已收到而免于重传的帧数
+    long wire_bytes;           // 线路上实际承载的字节数（紧凑格式）
+    int corrupted_frames;      // 线路上被翻转比特的帧数
+    int corruption_detected;   // 其中被校验和发现并丢弃的帧数
+    int undetected_errors;     // 其中通过了校验的帧数（漏检）
+    int queue_drops;           // 瓶颈链路队列满而尾部丢弃的帧数（计入丢失帧数）
+    int reordered_frames;      // 被额外延迟而可能乱序到达的帧数
+    int network_duplicates;    // 被网络复制的帧数
+    int fast_retransmits;      // 重复确认触发的快速重传次数
+    int cwnd_reductions;       // 拥塞窗口被减小的次数（快速恢复与超时）
+    double cwnd_max;           // 拥塞窗口的最大值（帧）
+    double cwnd_mean;          // 拥塞窗口的时间加权平均值（帧）
+    int piggybacked_acks;      // 捎带在反向数据帧中的确认数（即省去的独立确认帧数）
+    int coalesced_acks;        // 等待期间被后来的确认取代、不再发送的确认数
+    int naks_sent;             // 接收方发出的否定确认数
+    int nak_retransmits;       // 否定确认触发的立即重传次数
+    int pool_frames_peak;      // 帧池中同时在用帧数的峰值（全双工时两个方向共用帧池）
 } statistics_t;
 
+/* 全双工传输的一个方向：数据源在一端，数据汇在另一端 */
+typedef struct {
+    arq_source_fn source;
+    void* source_context;
+    arq_sink_fn sink;
+    void* sink_context;
+    statistics_t* stats;        // 该方向的统计（数据帧、确认与捎带均按方向计数）
+} arq_direction_t;
+
+/* 多路复用传输的汇总：各会话共用信道时的总吞吐量与公平性 */
+typedef struct {
+    int sessions;               // 会话数
+    int completed;              // 成功完成的会话数
+    long bytes_delivered;       // 全部会话按序交付的字节数
+    double elapsed_ms;          // 最后一个会话结束的时刻（毫秒）
+    double wall_ms;             // 实际运行耗时（墙钟，毫秒）
+    long events_processed;      // 处理的事件数
+    double aggregate_goodput_bps;   // 总有效吞吐量（全部交付字节 × 8 / 最后结束的时刻）
+    double mean_goodput_bps;    // 各会话有效吞吐量的平均值（各按自己结束的时刻计算）
+    double min_goodput_bps;
+    double max_goodput_bps;
+    double jain_index;          // 各会话有效吞吐量的 Jain 公平性指数（1 为完全公平）
+} mux_summary_t;
+
 /* 函数声明 */
 
 /* 初始化函数 */
@@ -85,9 +274,11 @@ void init_sender(sender_state_t* sender);
 void init_receiver(receiver_state_t* receiver);
 void init_statistics(statistics_t* stats);
 void init_network_config(network_config_t* config);
+void init_arq_config(arq_config_t* arq, arq_mode_t mode);
 
 /* 帧处理函数 */
 unsigned int calculate_checksum(const void* data, size_t length);
+unsigned int calculate_frame_checksum(const data_frame_t* frame);
 bool verify_checksum(const void* data, size_t length, unsigned int expected_checksum);
 void create_data_frame(data_frame_t* frame, int seq_num, const char* data, int length);
 void create_ack_frame(ack_frame_t* frame, int ack_num);
@@ -116,10 +307,59 @@ void reset_timer(sender_state_t* sender);
 bool transmit_message(const char* message, network_config_t* config, 
                       statistics_t* stats);
 
+/* 重传超时估计（RFC 6298） */
+void init_rto_estimator(rto_estimator_t* rto, double initial_ms, double min_ms,
+                        double max_ms, double granularity_ms);
+void update_rto_estimator(rto_estimator_t* rto, double rtt_ms);
+void backoff_rto_estimator(rto_estimator_t* rto);
+void clear_rto_backoff(rto_estimator_t* rto);
+
+/* 窗口协议传输函数 */
+bool validate_arq_config(const arq_config_t* arq);
+bool transmit_message_arq(const char* message, network_config_t* config,
+                          const arq_config_t* arq, statistics_t* stats);
+bool transmit_stream_arq(arq_source_fn source, void* source_context,
+                         arq_sink_fn sink, void* sink_context,
+                         network_config_t* config, const arq_config_t* arq, statistics_t* stats);
+bool simulate_arq_transfer(size_t length, const network_config_t* config, const arq_config_t* arq,
+                           uint32_t seed, statistics_t* stats);
+bool transmit_buffer_arq(const char* data, size_t length, char* output, size_t output_capacity,
+                         network_config_t* config, const arq_config_t* arq, statistics_t* stats);
+bool transmit_duplex_arq(const arq_direction_t* forward, const arq_direction_t* reverse,
+                         network_config_t* config, const arq_config_t* arq);
+bool simulate_duplex_transfer(size_t forward_length, size_t reverse_length,
+                              const network_config_t* config, const arq_config_t* arq, uint32_t seed,
+                              statistics_t* forward_stats, statistics_t* reverse_stats);
+bool transmit_multiplexed_arq(const arq_direction_t* sessions, int count, network_config_t* config,
+                              const arq_config_t* arq, mux_summary_t* summary);
+bool simulate_multiplexed_transfer(int sessions, size_t length, const network_config_t* config,
+                                   const arq_config_t* arq, uint32_t seed,
+                                   statistics_t* session_stats, mux_summary_t* summary);
+double calculate_jain_index(const double* values, int count);
+bool transmit_message_gbn(const char* message, network_config_t* config,
+                          int window_size, statistics_t* stats);
+bool transmit_message_sr(const char* message, network_config_t* config,
+                         int window_size, statistics_t* stats);
+const char* arq_mode_name(arq_mode_t mode);
+
+/* 真实传输：收发双方经传输端点通信，可位于不同线程或进程 */
+bool run_transport_sender(arq_source_fn source, void* source_context, transport_t* transport,
+                          const arq_config_t* arq, statistics_t* stats);
+bool run_transport_receiver(arq_sink_fn sink, void* sink_context, transport_t* transport,
+                            const arq_config_t* arq, statistics_t* stats);
+bool transmit_stream_transport(arq_source_fn source, void* source_context,
+                               arq_sink_fn sink, void* sink_context,
+                               transport_t* sender_transport, transport_t* receiver_transport,
+                               const arq_config_t* arq, statistics_t* stats);
+bool transmit_multiplexed_transport(const arq_direction_t* sessions, int count,
+                                    transport_t* sender_transport, transport_t* receiver_transport,
+                                    const arq_config_t* arq, mux_summary_t* summary);
+
 /* 工具函数 */
 void print_frame_info(const data_frame_t* frame, const char* direction);
 void print_ack_info(const ack_frame_t* ack, const char* direction);
 void print_statistics(const statistics_t* stats);
+void print_mux_summary(const mux_summary_t* summary);
 void print_protocol_state(const sender_state_t* sender, const receiver_state_t* receiver);
 
 #endif // SLIDING_WINDOW_H
\ No newline at end of file
@@ -0,0 +1,233 @@
+#define _DEFAULT_SOURCE
+#include "timing_wheel.h"
+
+#include <string.h>
+#include <time.h>
+
+/* 整个时间轮可表示的最大 tick 跨度 */
+#define WHEEL_MAX_DELTA ((1ULL << (WHEEL_SLOT_BITS * WHEEL_LEVELS)) - 1)
+
+/* ========== 链表操作 ========== */
+
+/**
+ * 把计时器挂到槽链表头部
+ */
+static void link_timer(wheel_timer_t** bucket, wheel_timer_t* timer) {
+    timer->bucket = bucket;
+    timer->prev = NULL;
+    timer->next = *bucket;
+    if (*bucket) (*bucket)->prev = timer;
+    *bucket = timer;
+}
+
+/**
+ * 把计时器从所在槽摘除
+ */
+static void unlink_timer(wheel_timer_t* timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        *timer->bucket = timer->next;
+    }
+    if (timer->next) timer->next->prev = timer->prev;
+    timer->prev = NULL;
+    timer->next = NULL;
+    timer->bucket = NULL;
+}
+
+/**
+ * 按距到期的 tick 数选择层与槽：第 k 层容纳距到期 [64^k, 64^(k+1)) 的计时器
+ * @param wheel 时间轮
+ * @param timer 计时器（expires 已设置）
+ */
+static void place_timer(timing_wheel_t* wheel, wheel_timer_t* timer) {
+    uint64_t expires = timer->expires;
+    if (expires <= wheel->current_tick) expires = wheel->current_tick + 1;  // 已过期：下一个 tick 触发
+
+    uint64_t delta = expires - wheel->current_tick;
+    if (delta > WHEEL_MAX_DELTA) {
+        // 超出覆盖范围：先挂在最高层末端，级联时按真实到期时刻重新放置
+        delta = WHEEL_MAX_DELTA;
+        expires = wheel->current_tick + delta;
+    }
+
+    int level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1ULL << (WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = (int)((expires >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1));
+    link_timer(&wheel->slots[level][slot], timer);
+}
+
+/**
+ * 级联：低层转满一圈时，把高层当前槽的计时器重新放置到更低的层
+ * @param wheel 时间轮
+ */
+static void cascade_timers(timing_wheel_t* wheel) {
+    for (int level = 1; level < WHEEL_LEVELS; level++) {
+        uint64_t span_mask = (1ULL << (WHEEL_SLOT_BITS * level)) - 1;
+        if ((wheel->current_tick & span_mask) != 0) break;
+
+        int slot = (int)((wheel->current_tick >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1));
+        wheel_timer_t* timer = wheel->slots[level][slot];
+        wheel->slots[level][slot] = NULL;
+        while (timer) {
+            wheel_timer_t* next = timer->next;
+            if (timer->expires <= wheel->current_tick) {
+                // 恰好在本 tick 到期：放入第0层当前槽，随后在本 tick 触发
+                link_timer(&wheel->slots[0][wheel->current_tick & (WHEEL_SLOTS - 1)], timer);
+            } else {
+                place_timer(wheel, timer);
+            }
+            timer = next;
+        }
+    }
+}
+
+/* ========== 初始化与时钟 ========== */
+
+/**
+ * 初始化时间轮
+ * @param wheel 时间轮
+ * @param tick_ms tick 粒度（毫秒，非正数时使用默认值）
+ * @param now_ms 当前时刻
+ */
+void init_timing_wheel(timing_wheel_t* wheel, double tick_ms, double now_ms) {
+    if (!wheel) return;
+
+    memset(wheel, 0, sizeof(timing_wheel_t));
+    wheel->tick_ms = tick_ms > 0 ? tick_ms : TIMER_TICK_MS;
+    wheel->current_tick = now_ms > 0 ? (uint64_t)(now_ms / wheel->tick_ms) : 0;
+}
+
+/**
+ * 初始化计时器节点
+ * @param timer 计时器
+ * @param id 调用方自定义标识
+ */
+void init_wheel_timer(wheel_timer_t* timer, int id) {
+    if (!timer) return;
+
+    memset(timer, 0, sizeof(wheel_timer_t));
+    timer->id = id;
+}
+
+/**
+ * 时间轮已推进到的时刻
+ * @param wheel 时间轮
+ * @return 毫秒数
+ */
+double timing_wheel_time_ms(const timing_wheel_t* wheel) {
+    return wheel ? wheel->current_tick * wheel->tick_ms : 0;
+}
+
+/**
+ * 获取单调时钟的当前时间（不受系统时间调整和进程休眠影响）
+ * @return 毫秒数
+ */
+double monotonic_clock_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* ========== 计时器操作 ========== */
+
+/**
+ * 装载计时器：不早于 expire_ms 触发（向上取整到 tick）
+ * @param wheel 时间轮
+ * @param timer 计时器
+ * @param expire_ms 到期时刻
+ */
+void arm_timer(timing_wheel_t* wheel, wheel_timer_t* timer, double expire_ms) {
+    if (!wheel || !timer) return;
+
+    cancel_timer(wheel, timer);
+
+    uint64_t expires = 0;
+    if (expire_ms > 0) {
+        expires = (uint64_t)(expire_ms / wheel->tick_ms);
+        if (expires * wheel->tick_ms < expire_ms) expires++;
+    }
+    timer->expires = expires;
+    timer->armed = true;
+    wheel->armed_count++;
+    place_timer(wheel, timer);
+}
+
+/**
+ * 撤销计时器（未装载时无操作）
+ * @param wheel 时间轮
+ * @param timer 计时器
+ */
+void cancel_timer(timing_wheel_t* wheel, wheel_timer_t* timer) {
+    if (!wheel || !timer || !timer->armed) return;
+
+    unlink_timer(timer);
+    timer->armed = false;
+    wheel->armed_count--;
+}
+
+/**
+ * 处理下一个 tick：先级联高层槽，再触发第0层当前槽
+ * @param wheel 时间轮
+ * @param expire 到期回调
+ * @param context 回调上下文
+ * @return 触发的计时器个数
+ */
+static size_t process_next_tick(timing_wheel_t* wheel, timer_expire_fn expire, void* context) {
+    wheel->current_tick++;
+    cascade_timers(wheel);
+
+    // 第0层当前槽中的计时器恰好在本 tick 到期；回调装载的新计时器不会落回本槽
+    wheel_timer_t** bucket = &wheel->slots[0][wheel->current_tick & (WHEEL_SLOTS - 1)];
+    wheel_timer_t* timer;
+    size_t fired = 0;
+    while ((timer = *bucket) != NULL) {
+        unlink_timer(timer);
+        timer->armed = false;
+        wheel->armed_count--;
+        fired++;
+        if (expire) expire(timer, context);
+    }
+    return fired;
+}
+
+/**
+ * 推进时间轮到 now_ms
+ * @param wheel 时间轮
+ * @param now_ms 当前时刻
+ * @param expire 到期回调
+ * @param context 回调上下文
+ * @return 触发的计时器个数
+ */
+size_t advance_timing_wheel(timing_wheel_t* wheel, double now_ms,
+                            timer_expire_fn expire, void* context) {
+    if (!wheel || now_ms < 0) return 0;
+
+    uint64_t target = (uint64_t)(now_ms / wheel->tick_ms);
+    size_t fired = 0;
+
+    while (wheel->current_tick < target) {
+        if (wheel->armed_count == 0) {
+            wheel->current_tick = target;   // 没有计时器时直接跳到目标时刻
+            break;
+        }
+        fired += process_next_tick(wheel, expire, context);
+    }
+
+    return fired;
+}
+
+/**
+ * 推进时间轮一个 tick
+ * @param wheel 时间轮
+ * @param expire 到期回调
+ * @param context 回调上下文
+ * @return 触发的计时器个数
+ */
+size_t step_timing_wheel(timing_wheel_t* wheel, timer_expire_fn expire, void* context) {
+    if (!wheel) return 0;
+
+    return process_next_tick(wheel, expire, context);
+}
@@ -0,0 +1,55 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 常量定义 */
+#define WHEEL_LEVELS 4                          // 时间轮层数
+#define WHEEL_SLOT_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)      // 每层槽数（64）
+#define TIMER_TICK_MS 1.0                       // 默认 tick 粒度（毫秒）
+
+/* 计时器节点：嵌入在调用方的结构体中，时间轮不分配内存 */
+typedef struct wheel_timer {
+    struct wheel_timer* prev;   // 槽内双向链表
+    struct wheel_timer* next;
+    struct wheel_timer** bucket; // 所在槽的链表头（撤销时 O(1) 摘除）
+    uint64_t expires;           // 到期 tick
+    int id;                     // 调用方自定义标识（如帧号）
+    void* owner;                // 调用方自定义的所属对象（多个对象共用一个时间轮时区分回调目标）
+    bool armed;                 // 是否已挂在时间轮上
+} wheel_timer_t;
+
+/* 到期回调：回调中可以重新装载或撤销任意计时器 */
+typedef void (*timer_expire_fn)(wheel_timer_t* timer, void* context);
+
+/* 分层时间轮：第 k 层每槽跨度 64^k 个 tick，共覆盖 64^4 个 tick。
+ * 装载与撤销 O(1)；推进时每个 tick 只检查一个槽，高层槽在低层转满一圈时
+ * 整体下放（级联），不扫描计时器。时钟由调用方提供，可以是单调时钟或仿真虚拟时钟。 */
+typedef struct {
+    wheel_timer_t* slots[WHEEL_LEVELS][WHEEL_SLOTS];  // 各槽链表头
+    uint64_t current_tick;      // 已处理到的 tick
+    double tick_ms;             // 每个 tick 的毫秒数
+    size_t armed_count;         // 已装载的计时器数
+} timing_wheel_t;
+
+/* 初始化与时钟 */
+void init_timing_wheel(timing_wheel_t* wheel, double tick_ms, double now_ms);
+void init_wheel_timer(wheel_timer_t* timer, int id);
+double timing_wheel_time_ms(const timing_wheel_t* wheel);
+double monotonic_clock_ms(void);
+
+/* 计时器操作：重复装载会先撤销原有的到期时刻 */
+void arm_timer(timing_wheel_t* wheel, wheel_timer_t* timer, double expire_ms);
+void cancel_timer(timing_wheel_t* wheel, wheel_timer_t* timer);
+
+/* 推进到 now_ms，按 tick 顺序触发所有到期计时器，返回触发的个数 */
+size_t advance_timing_wheel(timing_wheel_t* wheel, double now_ms,
+                            timer_expire_fn expire, void* context);
+
+/* 只推进一个 tick（仿真中逐步推进虚拟时钟），返回触发的个数 */
+size_t step_timing_wheel(timing_wheel_t* wheel, timer_expire_fn expire, void* context);
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,195 @@
+#include "trace_ring.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_RING_MASK ((uint64_t)TRACE_RING_CAPACITY - 1)
+
+/* 一个线程的环形缓冲区。written 只由所属线程递增（release 存储）；
+ * 导出方在复制前后各读一次 written，丢弃复制期间可能被覆盖的记录，读写双方都不加锁 */
+typedef struct trace_ring {
+    trace_record_t records[TRACE_RING_CAPACITY];
+    uint64_t written;           // 累计写入的记录数
+    int in_use;                 // 是否有线程正在使用（线程退出时清零，供新线程复用）
+    unsigned int id;            // 编号（导出时区分线程）
+    struct trace_ring* next;    // 全局链表（只增不删）
+} trace_ring_t;
+
+static int trace_level = TRACE_LEVEL_EVENTS;
+static trace_ring_t* trace_rings = NULL;
+static unsigned int trace_ring_count = 0;
+static __thread trace_ring_t* thread_ring = NULL;
+static pthread_key_t trace_ring_key;
+static pthread_once_t trace_ring_once = PTHREAD_ONCE_INIT;
+
+/**
+ * 线程退出时交还缓冲区（记录保留到被新线程复用为止）
+ * @param ring 缓冲区
+ */
+static void release_trace_ring(void* ring) {
+    __atomic_store_n(&((trace_ring_t*)ring)->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void create_trace_ring_key(void) {
+    pthread_key_create(&trace_ring_key, release_trace_ring);
+}
+
+/**
+ * 为当前线程取得缓冲区：优先复用已退出线程交还的缓冲区，没有则新分配并加入全局链表
+ * @return 缓冲区，内存不足时返回NULL
+ */
+static trace_ring_t* attach_trace_ring(void) {
+    pthread_once(&trace_ring_once, create_trace_ring_key);
+
+    trace_ring_t* ring = NULL;
+    for (trace_ring_t* r = __atomic_load_n(&trace_rings, __ATOMIC_ACQUIRE); r; r = r->next) {
+        int idle = 0;
+        if (__atomic_compare_exchange_n(&r->in_use, &idle, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            ring = r;
+            __atomic_store_n(&ring->written, 0, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+    if (!ring) {
+        ring = calloc(1, sizeof(trace_ring_t));
+        if (!ring) return NULL;
+        ring->in_use = 1;
+        ring->id = __atomic_fetch_add(&trace_ring_count, 1, __ATOMIC_RELAXED);
+        ring->next = __atomic_load_n(&trace_rings, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&trace_rings, &ring->next, ring, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+    pthread_setspecific(trace_ring_key, ring);
+    thread_ring = ring;
+    return ring;
+}
+
+/**
+ * 设置跟踪级别
+ * @param level 跟踪级别
+ */
+void set_trace_level(trace_level_t level) {
+    if (level < TRACE_LEVEL_OFF || level > TRACE_LEVEL_TEXT) return;
+    __atomic_store_n(&trace_level, (int)level, __ATOMIC_RELAXED);
+}
+
+/**
+ * 查询跟踪级别
+ * @return 跟踪级别
+ */
+trace_level_t get_trace_level(void) {
+    return (trace_level_t)__atomic_load_n(&trace_level, __ATOMIC_RELAXED);
+}
+
+/**
+ * 记录一个事件：写入当前线程的缓冲区，不格式化、不加锁
+ * @param type 事件类型
+ * @param time_ms 时间戳（毫秒）
+ * @param conn_id 连接号
+ * @param seq 序列号、确认号或帧号
+ * @param size 数据长度
+ */
+void record_trace_event(trace_event_t type, double time_ms, uint32_t conn_id, int seq, size_t size) {
+    if (__atomic_load_n(&trace_level, __ATOMIC_RELAXED) < TRACE_LEVEL_EVENTS) return;
+    trace_ring_t* ring = thread_ring ? thread_ring : attach_trace_ring();
+    if (!ring) return;
+
+    uint64_t written = ring->written;
+    trace_record_t* record = &ring->records[written & TRACE_RING_MASK];
+    record->time_ms = time_ms;
+    record->type = (uint32_t)type;
+    record->conn_id = conn_id;
+    record->seq = seq;
+    record->size = (uint32_t)size;
+    __atomic_store_n(&ring->written, written + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * 复制一个缓冲区中最近的记录（最旧的在前）
+ * 其他线程的缓冲区可能正在写入：复制后再读一次 written，丢弃复制期间可能被覆盖的记录
+ * @param ring 缓冲区
+ * @param records 输出数组
+ * @param max_records 输出数组容量
+ * @return 复制的条数
+ */
+static size_t copy_trace_ring(const trace_ring_t* ring, trace_record_t* records, size_t max_records) {
+    uint64_t end = __atomic_load_n(&ring->written, __ATOMIC_ACQUIRE);
+    uint64_t begin = end > TRACE_RING_CAPACITY ? end - TRACE_RING_CAPACITY : 0;
+    if (end - begin > max_records) begin = end - max_records;
+
+    size_t count = 0;
+    for (uint64_t i = begin; i < end; i++) {
+        records[count++] = ring->records[i & TRACE_RING_MASK];
+    }
+    if (ring == thread_ring) return count;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t now = __atomic_load_n(&ring->written, __ATOMIC_RELAXED);
+    if (now < end) return 0;    // 缓冲区已被新线程复用并清空
+    // 序号 now 的记录可能正写到序号 now - 容量 的槽位上，此前的槽位都已被覆盖
+    uint64_t first_valid = now >= TRACE_RING_CAPACITY ? now - TRACE_RING_CAPACITY + 1 : 0;
+    if (first_valid > begin) {
+        size_t skip = first_valid - begin < count ? (size_t)(first_valid - begin) : count;
+        memmove(records, records + skip, (count - skip) * sizeof(trace_record_t));
+        count -= skip;
+    }
+    return count;
+}
+
+/**
+ * 读出当前线程最近的记录
+ * @param records 输出数组（最旧的在前）
+ * @param max_records 输出数组容量
+ * @return 读出的条数
+ */
+size_t read_trace_records(trace_record_t* records, size_t max_records) {
+    if (!records || max_records == 0 || !thread_ring) return 0;
+    return copy_trace_ring(thread_ring, records, max_records);
+}
+
+/**
+ * 清空当前线程的记录
+ */
+void clear_trace_records(void) {
+    if (thread_ring) __atomic_store_n(&thread_ring->written, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * 把全部线程的记录以文字形式导出（只在这里做格式化）
+ * @param output 输出文件
+ * @return 导出的条数
+ */
+size_t dump_trace_records(FILE* output) {
+    if (!output) return 0;
+    trace_record_t* records = malloc(sizeof(trace_record_t) * TRACE_RING_CAPACITY);
+    if (!records) return 0;
+
+    size_t total = 0;
+    for (trace_ring_t* ring = __atomic_load_n(&trace_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        size_t count = copy_trace_ring(ring, records, TRACE_RING_CAPACITY);
+        for (size_t i = 0; i < count; i++) {
+            const trace_record_t* record = &records[i];
+            fprintf(output, "[线程 %u] %12.3f ms  %-12s 连接 %-6u 序列号 %-8d %u 字节\n", ring->id,
+                    record->time_ms, trace_event_name(record->type), record->conn_id, record->seq, record->size);
+        }
+        total += count;
+    }
+    free(records);
+    return total;
+}
+
+/**
+ * 事件类型名称
+ * @param type 事件类型
+ * @return 名称
+ */
+const char* trace_event_name(uint32_t type) {
+    static const char* names[TRACE_EVENT_TYPES] = {
+        "未知", "创建帧", "发送数据", "接收数据", "发送确认", "接收确认", "发送否定确认",
+        "接收否定确认", "帧丢失", "校验失败", "重传", "超时", "重置计时器"
+    };
+    return type < TRACE_EVENT_TYPES ? names[type] : names[0];
+}
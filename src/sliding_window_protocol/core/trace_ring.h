@@ -0,0 +1,66 @@
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* 常量定义 */
+#define TRACE_RING_CAPACITY 4096        // 每个线程的环形缓冲区记录数（2的幂），写满后覆盖最旧的记录
+
+/* 跟踪级别（运行时可切换，所有线程共用） */
+typedef enum {
+    TRACE_LEVEL_OFF = 0,        // 不记录也不输出
+    TRACE_LEVEL_EVENTS = 1,     // 只写二进制事件记录，不做任何格式化（默认）
+    TRACE_LEVEL_TEXT = 2        // 另外逐步打印协议过程的文字说明（教学演示）
+} trace_level_t;
+
+/* 事件类型 */
+typedef enum {
+    TRACE_FRAME_CREATE = 1,     // 创建帧
+    TRACE_DATA_SEND,            // 数据帧进入信道（含重传）
+    TRACE_DATA_RECEIVE,         // 数据帧到达接收方并通过校验
+    TRACE_ACK_SEND,             // 发出确认帧
+    TRACE_ACK_RECEIVE,          // 确认帧到达发送方并通过校验
+    TRACE_NAK_SEND,             // 发出否定确认帧
+    TRACE_NAK_RECEIVE,          // 否定确认帧到达发送方
+    TRACE_FRAME_LOST,           // 帧在信道中丢失
+    TRACE_FRAME_CORRUPT,        // 帧未通过校验被丢弃
+    TRACE_RETRANSMIT,           // 重传一帧（超时、快速重传或否定确认）
+    TRACE_TIMEOUT,              // 重传计时器到期
+    TRACE_TIMER_RESET,          // 重置计时器
+    TRACE_EVENT_TYPES
+} trace_event_t;
+
+/* 定长事件记录（24字节） */
+typedef struct {
+    double time_ms;             // 时间戳（仿真为虚拟时刻，其余为单调时钟，毫秒）
+    uint32_t type;              // 事件类型（trace_event_t）
+    uint32_t conn_id;           // 连接号（单会话为0）
+    int32_t seq;                // 序列号、确认号或帧号（-1 表示无）
+    uint32_t size;              // 数据长度（字节）
+} trace_record_t;
+
+/* 每个线程第一次记录时取得一个环形缓冲区，此后只有该线程写入，写入不加锁；
+ * 线程退出后缓冲区留给新线程复用，已写入的记录在被复用前仍可导出 */
+
+/* 跟踪级别 */
+void set_trace_level(trace_level_t level);
+trace_level_t get_trace_level(void);
+
+/* 记录一个事件（级别低于 TRACE_LEVEL_EVENTS 时立即返回） */
+void record_trace_event(trace_event_t type, double time_ms, uint32_t conn_id, int seq, size_t size);
+
+/* 读出当前线程最近的记录（最旧的在前），返回条数 */
+size_t read_trace_records(trace_record_t* records, size_t max_records);
+
+/* 清空当前线程的记录 */
+void clear_trace_records(void);
+
+/* 按需把全部线程的记录以文字形式导出，返回导出的条数 */
+size_t dump_trace_records(FILE* output);
+
+/* 事件类型名称 */
+const char* trace_event_name(uint32_t type);
+
+#endif // TRACE_RING_H
@@ -0,0 +1,397 @@
+#define _GNU_SOURCE
+#include "transport.h"
+#include "timing_wheel.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* ========== UDP 后端 ========== */
+
+/**
+ * 一次 sendmmsg 发出一批报文
+ * @param transport 传输端点
+ * @param packets 报文数组
+ * @param count 报文数
+ * @return 实际发出的报文数
+ */
+static int udp_send_batch(transport_t* transport, const transport_packet_t* packets, int count) {
+    struct mmsghdr messages[TRANSPORT_BATCH];
+    struct iovec iov[TRANSPORT_BATCH];
+    if (count > TRANSPORT_BATCH) count = TRANSPORT_BATCH;
+
+    memset(messages, 0, sizeof(struct mmsghdr) * count);
+    for (int i = 0; i < count; i++) {
+        iov[i].iov_base = (void*)packets[i].data;
+        iov[i].iov_len = packets[i].length;
+        messages[i].msg_hdr.msg_iov = &iov[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = 0;
+    while (sent < count) {
+        int result = sendmmsg(transport->fd, messages + sent, count - sent, 0);
+        transport->send_calls++;
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            break;      // 套接字缓冲区满等错误：剩余报文按丢失处理
+        }
+        sent += result;
+    }
+    return sent;
+}
+
+/**
+ * 等待至多 timeout_ms 毫秒，然后用一次 recvmmsg 取出所有已到达的报文
+ * @param transport 传输端点
+ * @param packets 输出的报文数组
+ * @param max_count 最多接收的报文数
+ * @param timeout_ms 等待时间（毫秒）
+ * @return 收到的报文数
+ */
+static int udp_recv_batch(transport_t* transport, transport_packet_t* packets, int max_count,
+                          int timeout_ms) {
+    struct pollfd pfd = {transport->fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeout_ms) <= 0) return 0;
+
+    struct mmsghdr messages[TRANSPORT_BATCH];
+    struct iovec iov[TRANSPORT_BATCH];
+    if (max_count > TRANSPORT_BATCH) max_count = TRANSPORT_BATCH;
+
+    memset(messages, 0, sizeof(struct mmsghdr) * max_count);
+    for (int i = 0; i < max_count; i++) {
+        iov[i].iov_base = packets[i].data;
+        iov[i].iov_len = TRANSPORT_MAX_PACKET;
+        messages[i].msg_hdr.msg_iov = &iov[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received = recvmmsg(transport->fd, messages, max_count, MSG_DONTWAIT, NULL);
+    transport->recv_calls++;
+    if (received < 0) return 0;
+
+    for (int i = 0; i < received; i++) {
+        packets[i].length = messages[i].msg_len;
+    }
+    return received;
+}
+
+static void udp_close(transport_t* transport) {
+    if (transport->fd >= 0) close(transport->fd);
+    transport->fd = -1;
+}
+
+static const transport_ops_t udp_transport_ops = {
+    "UDP",
+    udp_send_batch,
+    udp_recv_batch,
+    udp_close
+};
+
+/**
+ * 初始化传输端点的通用部分
+ * @param transport 传输端点
+ * @param ops 后端
+ * @param fd 套接字
+ */
+static void init_transport(transport_t* transport, const transport_ops_t* ops, int fd) {
+    memset(transport, 0, sizeof(transport_t));
+    transport->ops = ops;
+    transport->fd = fd;
+    transport->rng_state = (uint32_t)fd * 2654435761u + 1;
+}
+
+/**
+ * 创建绑定在本地端口上的 UDP 套接字
+ * @param local_port 本地端口（0表示由系统分配）
+ * @return 套接字，失败返回-1
+ */
+static int create_udp_socket(int local_port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("[传输] 创建套接字失败");
+        return -1;
+    }
+
+    // 窗口内的帧可能同时到达，扩大接收缓冲区以免内核丢包
+    int buffer_size = 1 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)local_port);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        perror("[传输] 绑定端口失败");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * 把套接字连接到对端（之后收发无需指定地址，且只接收对端的报文）
+ * @param fd 套接字
+ * @param address 对端地址
+ * @return 是否成功
+ */
+static bool connect_udp_socket(int fd, const struct sockaddr_in* address) {
+    if (connect(fd, (const struct sockaddr*)address, sizeof(*address)) < 0) {
+        perror("[传输] 连接对端失败");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 打开 UDP 传输端点，用于收发双方位于不同进程的情形
+ * @param transport 传输端点
+ * @param local_port 本地端口
+ * @param peer_host 对端地址（点分十进制）
+ * @param peer_port 对端端口
+ * @return 是否成功
+ */
+bool open_udp_transport(transport_t* transport, int local_port, const char* peer_host, int peer_port) {
+    if (!transport || !peer_host) return false;
+
+    struct sockaddr_in peer;
+    memset(&peer, 0, sizeof(peer));
+    peer.sin_family = AF_INET;
+    peer.sin_port = htons((uint16_t)peer_port);
+    if (inet_pton(AF_INET, peer_host, &peer.sin_addr) != 1) {
+        printf("[传输] 无效的对端地址: %s\n", peer_host);
+        return false;
+    }
+
+    int fd = create_udp_socket(local_port);
+    if (fd < 0) return false;
+    if (!connect_udp_socket(fd, &peer)) {
+        close(fd);
+        return false;
+    }
+
+    init_transport(transport, &udp_transport_ops, fd);
+    return true;
+}
+
+/**
+ * 在回环地址上打开一对互相连接的 UDP 端点（端口由系统分配），用于同一进程的两个线程
+ * @param first 第一个端点
+ * @param second 第二个端点
+ * @return 是否成功
+ */
+bool open_udp_transport_pair(transport_t* first, transport_t* second) {
+    if (!first || !second) return false;
+
+    int fds[2] = {create_udp_socket(0), create_udp_socket(0)};
+    struct sockaddr_in addresses[2];
+    bool ok = fds[0] >= 0 && fds[1] >= 0;
+    for (int i = 0; ok && i < 2; i++) {
+        socklen_t length = sizeof(addresses[i]);
+        ok = getsockname(fds[i], (struct sockaddr*)&addresses[i], &length) == 0;
+    }
+    ok = ok && connect_udp_socket(fds[0], &addresses[1]) && connect_udp_socket(fds[1], &addresses[0]);
+    if (!ok) {
+        if (fds[0] >= 0) close(fds[0]);
+        if (fds[1] >= 0) close(fds[1]);
+        return false;
+    }
+
+    init_transport(first, &udp_transport_ops, fds[0]);
+    init_transport(second, &udp_transport_ops, fds[1]);
+    return true;
+}
+
+/**
+ * 关闭传输端点（未发出的批次被丢弃）
+ * @param transport 传输端点
+ */
+void close_transport(transport_t* transport) {
+    if (!transport || !transport->ops) return;
+
+    transport->ops->close(transport);
+    free(transport->held);
+    transport->held = NULL;
+    transport->held_count = 0;
+    transport->outbox_count = 0;
+}
+
+/* ========== 软件损伤注入 ========== */
+
+/**
+ * 端点私有的随机数（xorshift32），避免多线程共用 rand()
+ * @param transport 传输端点
+ * @return [0, 1) 之间的随机数
+ */
+static double transport_random(transport_t* transport) {
+    uint32_t x = transport->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    transport->rng_state = x;
+    return x / 4294967296.0;
+}
+
+/**
+ * 设置软件损伤：发送时按概率丢弃，接收时附加随机时延（保持先进先出）
+ * @param transport 传输端点
+ * @param loss_probability 丢包概率 (0.0-1.0)
+ * @param min_delay_ms 最小时延
+ * @param max_delay_ms 最大时延（0表示不注入时延）
+ * @param seed 随机数种子（非0）
+ * @return 参数是否有效
+ */
+bool set_transport_impairment(transport_t* transport, double loss_probability,
+                              int min_delay_ms, int max_delay_ms, uint32_t seed) {
+    if (!transport) return false;
+    if (loss_probability < 0 || loss_probability > 1 || min_delay_ms < 0 || max_delay_ms < min_delay_ms) {
+        printf("[错误] 损伤参数无效 (丢包率 %.2f, 时延 %d-%d ms)\n",
+               loss_probability, min_delay_ms, max_delay_ms);
+        return false;
+    }
+
+    if (max_delay_ms > 0 && !transport->held) {
+        transport->held = malloc(sizeof(held_packet_t) * TRANSPORT_HOLD_CAPACITY);
+        if (!transport->held) return false;
+    }
+    transport->loss_probability = loss_probability;
+    transport->min_delay_ms = min_delay_ms;
+    transport->max_delay_ms = max_delay_ms;
+    if (seed != 0) transport->rng_state = seed;
+    return true;
+}
+
+/**
+ * 把刚收到的报文放入时延队列
+ * @param transport 传输端点
+ * @param packet 报文
+ * @param now_ms 当前时刻
+ */
+static void hold_packet(transport_t* transport, const transport_packet_t* packet, double now_ms) {
+    if (transport->held_count >= TRANSPORT_HOLD_CAPACITY) {
+        transport->packets_dropped++;
+        return;
+    }
+
+    int span = transport->max_delay_ms - transport->min_delay_ms;
+    double release = now_ms + transport->min_delay_ms + transport_random(transport) * span;
+    if (release < transport->held_last_ms) release = transport->held_last_ms;   // 先进先出
+    transport->held_last_ms = release;
+
+    held_packet_t* slot = &transport->held[(transport->held_head + transport->held_count++) % TRANSPORT_HOLD_CAPACITY];
+    slot->packet.length = packet->length;
+    memcpy(slot->packet.data, packet->data, packet->length);
+    slot->release_ms = release;
+}
+
+/**
+ * 取出时延已满的报文
+ * @param transport 传输端点
+ * @param packets 输出的报文数组
+ * @param max_count 最多取出的报文数
+ * @param now_ms 当前时刻
+ * @return 取出的报文数
+ */
+static int release_held_packets(transport_t* transport, transport_packet_t* packets, int max_count,
+                                double now_ms) {
+    int count = 0;
+    while (count < max_count && transport->held_count > 0) {
+        held_packet_t* head = &transport->held[transport->held_head];
+        if (head->release_ms > now_ms) break;
+
+        packets[count].length = head->packet.length;
+        memcpy(packets[count].data, head->packet.data, head->packet.length);
+        count++;
+        transport->held_head = (transport->held_head + 1) % TRANSPORT_HOLD_CAPACITY;
+        transport->held_count--;
+    }
+    return count;
+}
+
+/* ========== 收发 ========== */
+
+/**
+ * 把报文加入发送批次，批次满时立即发送
+ * @param transport 传输端点
+ * @param data 报文内容
+ * @param length 报文长度
+ * @return 报文是否进入批次（false 表示被注入的丢包丢弃或长度无效）
+ */
+bool transport_enqueue(transport_t* transport, const void* data, size_t length) {
+    if (!transport || !data || length > TRANSPORT_MAX_PACKET) return false;
+
+    if (transport->loss_probability > 0 && transport_random(transport) < transport->loss_probability) {
+        transport->packets_dropped++;
+        return false;
+    }
+
+    if (transport->outbox_count == TRANSPORT_BATCH) transport_flush(transport);
+    transport_packet_t* packet = &transport->outbox[transport->outbox_count++];
+    packet->length = length;
+    memcpy(packet->data, data, length);
+    return true;
+}
+
+/**
+ * 用一次批量系统调用发出批次中的全部报文
+ * @param transport 传输端点
+ * @return 发出的报文数
+ */
+int transport_flush(transport_t* transport) {
+    if (!transport || transport->outbox_count == 0) return 0;
+
+    int sent = transport->ops->send_batch(transport, transport->outbox, transport->outbox_count);
+    transport->packets_sent += sent;
+    transport->packets_dropped += transport->outbox_count - sent;
+    transport->outbox_count = 0;
+    return sent;
+}
+
+/**
+ * 接收报文：至多等待 timeout_ms 毫秒；启用时延注入时只返回时延已满的报文，
+ * 因此可能在超时前返回0，调用方应循环调用
+ * @param transport 传输端点
+ * @param packets 输出的报文数组
+ * @param max_count 最多接收的报文数
+ * @param timeout_ms 等待时间（毫秒）
+ * @return 收到的报文数
+ */
+int transport_receive(transport_t* transport, transport_packet_t* packets, int max_count,
+                      double timeout_ms) {
+    if (!transport || !packets || max_count <= 0) return 0;
+    if (max_count > TRANSPORT_BATCH) max_count = TRANSPORT_BATCH;
+
+    if (!transport->held) {
+        int wait = timeout_ms > 0 ? (int)(timeout_ms + 0.999) : 0;
+        int received = transport->ops->recv_batch(transport, packets, max_count, wait);
+        transport->packets_received += received;
+        return received;
+    }
+
+    // 时延注入：队首报文到期前最多等到它的交付时刻
+    double now = monotonic_clock_ms();
+    int count = release_held_packets(transport, packets, max_count, now);
+    if (count > 0) return count;
+
+    double wait_ms = timeout_ms;
+    if (transport->held_count > 0) {
+        double until_release = transport->held[transport->held_head].release_ms - now;
+        if (until_release < wait_ms) wait_ms = until_release;
+    }
+    int wait = wait_ms > 0 ? (int)(wait_ms + 0.999) : 0;
+    int received = transport->ops->recv_batch(transport, packets, max_count, wait);
+    transport->packets_received += received;
+
+    now = monotonic_clock_ms();
+    for (int i = 0; i < received; i++) {
+        hold_packet(transport, &packets[i], now);
+    }
+    return release_held_packets(transport, packets, max_count, now);
+}
@@ -0,0 +1,78 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 常量定义 */
+#define TRANSPORT_MAX_PACKET 1500       // 单个数据报的最大字节数
+#define TRANSPORT_BATCH 32              // 每次批量收发的最大报文数
+#define TRANSPORT_HOLD_CAPACITY 1024    // 时延注入队列容量（超出即丢弃）
+
+/* 数据报 */
+typedef struct {
+    size_t length;
+    char data[TRANSPORT_MAX_PACKET];
+} transport_packet_t;
+
+typedef struct transport transport_t;
+
+/* 传输后端：只负责批量收发数据报，丢包与时延注入由通用层完成 */
+typedef struct {
+    const char* name;
+    int (*send_batch)(transport_t* transport, const transport_packet_t* packets, int count);
+    int (*recv_batch)(transport_t* transport, transport_packet_t* packets, int max_count,
+                      int timeout_ms);
+    void (*close)(transport_t* transport);
+} transport_ops_t;
+
+/* 时延注入队列中的报文 */
+typedef struct {
+    transport_packet_t packet;
+    double release_ms;          // 交付给上层的时刻（单调时钟毫秒）
+} held_packet_t;
+
+/* 传输端点：发送的报文先进入批次，调用 transport_flush 时一次系统调用发出 */
+struct transport {
+    const transport_ops_t* ops;
+    int fd;                     // 后端的套接字
+
+    /* 软件损伤注入 */
+    double loss_probability;    // 发送时丢弃的概率
+    int min_delay_ms;           // 接收时附加的最小时延
+    int max_delay_ms;           // 接收时附加的最大时延
+    uint32_t rng_state;         // 端点私有的随机数状态（线程之间互不干扰）
+    held_packet_t* held;        // 时延队列（先进先出，启用时延时分配）
+    int held_head;
+    int held_count;
+    double held_last_ms;        // 最后一个报文的交付时刻
+
+    /* 发送批次 */
+    transport_packet_t outbox[TRANSPORT_BATCH];
+    int outbox_count;
+
+    /* 统计 */
+    uint64_t packets_sent;      // 实际发出的报文数
+    uint64_t packets_received;  // 收到的报文数
+    uint64_t packets_dropped;   // 注入丢弃、队列溢出或发送失败的报文数
+    uint64_t send_calls;        // 发送系统调用次数
+    uint64_t recv_calls;        // 接收系统调用次数
+};
+
+/* UDP 后端：sendmmsg/recvmmsg 批量收发 */
+bool open_udp_transport(transport_t* transport, int local_port, const char* peer_host, int peer_port);
+bool open_udp_transport_pair(transport_t* first, transport_t* second);
+void close_transport(transport_t* transport);
+
+/* 软件损伤注入 */
+bool set_transport_impairment(transport_t* transport, double loss_probability,
+                              int min_delay_ms, int max_delay_ms, uint32_t seed);
+
+/* 收发：enqueue 在批次满时自动发送，返回 false 表示报文被丢弃 */
+bool transport_enqueue(transport_t* transport, const void* data, size_t length);
+int transport_flush(transport_t* transport);
+int transport_receive(transport_t* transport, transport_packet_t* packets, int max_count,
+                      double timeout_ms);
+
+#endif // TRANSPORT_H
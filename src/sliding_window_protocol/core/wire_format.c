@@ -0,0 +1,293 @@
+#include "wire_format.h"
+#include "crc32c.h"
+
+/* ========== 基本编码 ========== */
+
+static void put_le16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t get_le16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static void put_le32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t get_le32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/**
+ * 编码 varint
+ * @param value 数值
+ * @param out 输出缓冲区（至少 WIRE_MAX_VARINT 字节）
+ * @return 写入的字节数
+ */
+size_t encode_varint(uint64_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+/**
+ * 解码 varint
+ * @param in 输入
+ * @param length 可读的字节数
+ * @param value 输出的数值
+ * @return 读取的字节数，数据不完整或超过64位时返回0
+ */
+size_t decode_varint(const uint8_t* in, size_t length, uint64_t* value) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < length && i < WIRE_MAX_VARINT; i++) {
+        result |= (uint64_t)(in[i] & 0x7f) << (7 * i);
+        if (!(in[i] & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * 写入固定报头、连接号（非0时）与序列号
+ * @return 已写入的字节数
+ */
+static size_t encode_header(uint8_t* buffer, frame_type_t type, uint8_t flags, int length,
+                            uint32_t conn_id, int number) {
+    buffer[0] = (uint8_t)type;
+    buffer[1] = flags | (conn_id ? WIRE_FLAG_CONN : 0);
+    put_le16(buffer + 2, (uint16_t)length);
+    size_t offset = WIRE_FIXED_HEADER;
+    if (conn_id) offset += encode_varint(conn_id, buffer + offset);
+    return offset + encode_varint((uint32_t)number, buffer + offset);
+}
+
+/**
+ * 读出连接号与序列号
+ * @param buffer 报文
+ * @param length 可读的字节数
+ * @param conn_id 输出的连接号（未携带时为0）
+ * @param number 输出的序列号
+ * @return 序列号之后的偏移，字段无效时返回0
+ */
+static size_t decode_prefix(const uint8_t* buffer, size_t length, uint32_t* conn_id, int* number) {
+    if (length < WIRE_FIXED_HEADER + 1) return 0;
+
+    size_t offset = WIRE_FIXED_HEADER;
+    uint64_t value = 0;
+    if (buffer[1] & WIRE_FLAG_CONN) {
+        size_t used = decode_varint(buffer + offset, length - offset, &value);
+        if (used == 0 || value == 0 || value > UINT32_MAX) return 0;
+        offset += used;
+    }
+    *conn_id = (uint32_t)value;
+
+    size_t used = decode_varint(buffer + offset, length - offset, &value);
+    if (used == 0 || value > INT32_MAX) return 0;
+    *number = (int)value;
+    return offset + used;
+}
+
+/**
+ * 在报文末尾追加校验和
+ * @return 报文总长度
+ */
+static size_t append_trailer(uint8_t* buffer, size_t length) {
+    put_le32(buffer + length, calculate_checksum(buffer, length));
+    return length + WIRE_TRAILER;
+}
+
+/* ========== 帧编码 ========== */
+
+/**
+ * 编码数据帧的报头：固定报头、序列号，捎带确认时再写入确认号与SACK位图
+ * @param frame 数据帧（只读取帧头字段）
+ * @param header 输出缓冲区（至少 WIRE_MAX_DATA_HEADER 字节）
+ * @return 报头长度，字段无效时返回0
+ */
+size_t encode_data_header(const data_frame_t* frame, uint8_t* header) {
+    if (!frame || !header || frame->seq_num < 0) return 0;
+    if (frame->data_length < 0 || frame->data_length > MAX_DATA_SIZE - 1) return 0;
+
+    uint8_t flags = 0;
+    if (frame->ack_num >= 0) {
+        flags = WIRE_FLAG_ACK | (frame->sack_bitmap ? WIRE_FLAG_SACK : 0);
+    }
+    size_t length = encode_header(header, DATA_FRAME, flags, frame->data_length, frame->conn_id, frame->seq_num);
+    if (flags & WIRE_FLAG_ACK) {
+        length += encode_varint((uint32_t)frame->ack_num, header + length);
+    }
+    if (flags & WIRE_FLAG_SACK) {
+        length += encode_varint(frame->sack_bitmap, header + length);
+    }
+    return length;
+}
+
+/**
+ * 计算报头与载荷连在一起时的校验和（与完整报文的尾部校验和相同，载荷不必复制到报头之后）
+ * @param header 报头
+ * @param header_length 报头长度
+ * @param payload 载荷
+ * @param payload_length 载荷长度
+ * @return 校验和
+ */
+uint32_t calculate_wire_checksum(const uint8_t* header, size_t header_length,
+                                 const void* payload, size_t payload_length) {
+    uint32_t crc = update_crc32c(CRC32C_INIT, header, header_length);
+    return update_crc32c(crc, payload, payload_length) ^ CRC32C_INIT;
+}
+
+/**
+ * 按紧凑格式编码数据帧，只写入实际载荷
+ * @param frame 数据帧
+ * @param buffer 输出缓冲区
+ * @param capacity 缓冲区容量（WIRE_MAX_DATA_FRAME 足够容纳任意数据帧）
+ * @return 报文长度，失败返回0
+ */
+size_t encode_data_frame(const data_frame_t* frame, uint8_t* buffer, size_t capacity) {
+    if (!frame || !buffer || frame->data_length < 0) return 0;
+    if (capacity < WIRE_MAX_DATA_HEADER + (size_t)frame->data_length + WIRE_TRAILER) return 0;
+
+    size_t length = encode_data_header(frame, buffer);
+    if (length == 0) return 0;
+    memcpy(buffer + length, frame->data, frame->data_length);
+    return append_trailer(buffer, length + frame->data_length);
+}
+
+/**
+ * 按紧凑格式编码确认帧，SACK位图为空时省略；否定确认帧（type 为 NAK_FRAME）格式相同
+ * @param ack 确认帧
+ * @param buffer 输出缓冲区
+ * @param capacity 缓冲区容量（WIRE_MAX_ACK_FRAME 足够）
+ * @return 报文长度，失败返回0
+ */
+size_t encode_ack_frame(const ack_frame_t* ack, uint8_t* buffer, size_t capacity) {
+    if (!ack || !buffer || ack->ack_num < 0 || capacity < WIRE_MAX_ACK_FRAME) return 0;
+
+    uint8_t flags = ack->sack_bitmap ? WIRE_FLAG_SACK : 0;
+    frame_type_t type = (ack->type == NAK_FRAME) ? NAK_FRAME : ACK_FRAME;
+    size_t length = encode_header(buffer, type, flags, 0, ack->conn_id, ack->ack_num);
+    if (flags & WIRE_FLAG_SACK) {
+        length += encode_varint(ack->sack_bitmap, buffer + length);
+    }
+    return append_trailer(buffer, length);
+}
+
+/* ========== 帧解码 ========== */
+
+/**
+ * 读出报文的连接号（不校验校验和：损坏的报文随后由会话解码时丢弃）
+ * @param buffer 报文
+ * @param length 报文长度
+ * @param conn_id 输出的连接号（未携带时为0）
+ * @return 报头是否完整
+ */
+bool peek_connection_id(const uint8_t* buffer, size_t length, uint32_t* conn_id) {
+    int number;
+    return buffer && conn_id && decode_prefix(buffer, length, conn_id, &number) > 0;
+}
+
+/**
+ * 解码数据帧的报头（不校验校验和，也不读取载荷）
+ * @param buffer 报头开始的字节
+ * @param length 可读的字节数
+ * @param header 输出的报头字段
+ * @return 报头长度，不是数据帧或字段无效时返回0
+ */
+size_t decode_data_header(const uint8_t* buffer, size_t length, wire_data_header_t* header) {
+    if (!buffer || !header || length < WIRE_FIXED_HEADER + 1 || buffer[0] != DATA_FRAME) return 0;
+
+    uint8_t flags = buffer[1];
+    uint32_t conn_id;
+    int number;
+    size_t offset = decode_prefix(buffer, length, &conn_id, &number);
+    if (offset == 0) return 0;
+
+    uint64_t ack_num = 0;
+    uint64_t sack_bitmap = 0;
+    if (flags & WIRE_FLAG_ACK) {
+        size_t ack_used = decode_varint(buffer + offset, length - offset, &ack_num);
+        if (ack_used == 0 || ack_num > INT32_MAX) return 0;
+        offset += ack_used;
+    }
+    if (flags & WIRE_FLAG_SACK) {
+        size_t sack_used = decode_varint(buffer + offset, length - offset, &sack_bitmap);
+        if (sack_used == 0 || !(flags & WIRE_FLAG_ACK)) return 0;
+        offset += sack_used;
+    }
+
+    header->seq_num = number;
+    header->conn_id = conn_id;
+    header->data_length = get_le16(buffer + 2);
+    header->ack_num = (flags & WIRE_FLAG_ACK) ? (int)ack_num : -1;
+    header->sack_bitmap = sack_bitmap;
+    if (header->data_length > MAX_DATA_SIZE - 1) return 0;
+    return offset;
+}
+
+/**
+ * 解码报文：先校验尾部校验和，再按类型还原帧结构体（校验和字段取报文尾部的值）
+ * @param buffer 报文
+ * @param length 报文长度
+ * @param frame 输出的数据帧（类型为数据帧时填写）
+ * @param ack 输出的确认帧（类型为确认帧或否定确认帧时填写）
+ * @return 帧类型，报文损坏时返回-1
+ */
+int decode_frame(const uint8_t* buffer, size_t length, data_frame_t* frame, ack_frame_t* ack) {
+    if (!buffer || length < WIRE_FIXED_HEADER + 1 + WIRE_TRAILER) return -1;
+
+    size_t body = length - WIRE_TRAILER;
+    uint32_t checksum = get_le32(buffer + body);
+    if (calculate_checksum(buffer, body) != checksum) return -1;
+
+    int type = buffer[0];
+    uint8_t flags = buffer[1];
+    int data_length = get_le16(buffer + 2);
+    uint32_t conn_id;
+    int number;
+    size_t offset = decode_prefix(buffer, body, &conn_id, &number);
+    if (offset == 0) return -1;
+
+    if (type == DATA_FRAME) {
+        wire_data_header_t header;
+        offset = decode_data_header(buffer, body, &header);
+        if (!frame || offset == 0 || offset + data_length != body) return -1;
+        frame->type = DATA_FRAME;
+        frame->seq_num = header.seq_num;
+        frame->data_length = data_length;
+        frame->ack_num = header.ack_num;
+        frame->sack_bitmap = header.sack_bitmap;
+        frame->conn_id = header.conn_id;
+        memcpy(frame->data, buffer + offset, data_length);
+        frame->data[data_length] = '\0';
+        frame->checksum = checksum;
+        return DATA_FRAME;
+    }
+
+    if (type == ACK_FRAME || type == NAK_FRAME) {
+        uint64_t sack_bitmap = 0;
+        if (flags & WIRE_FLAG_SACK) {
+            size_t sack_used = decode_varint(buffer + offset, body - offset, &sack_bitmap);
+            if (sack_used == 0) return -1;
+            offset += sack_used;
+        }
+        if (!ack || data_length != 0 || offset != body) return -1;
+        ack->type = (frame_type_t)type;
+        ack->ack_num = number;
+        ack->sack_bitmap = sack_bitmap;
+        ack->conn_id = conn_id;
+        ack->checksum = checksum;
+        return type;
+    }
+
+    return -1;
+}
@@ -0,0 +1,54 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include "sliding_window.h"
+
+/* 紧凑线路格式（多字节字段均为小端序）
+ *   固定报头  类型 1字节 | 标志 1字节 | 数据长度 2字节
+ *   连接号    varint（仅当标志 WIRE_FLAG_CONN 置位；默认连接0省略，单会话的报文不变）
+ *   序列号    varint（确认帧为确认号，否定确认帧为请求重传的序列号）
+ *   捎带确认  数据帧的确认号 varint（仅当标志 WIRE_FLAG_ACK 置位）
+ *   SACK位图  varint（仅当标志 WIRE_FLAG_SACK 置位，确认帧与捎带确认的数据帧都可携带）
+ *   数据帧    数据，只占实际长度
+ *   尾部      校验和 4字节，覆盖之前的全部字节
+ * 报文长度与校验开销都随实际载荷变化，5字节数据的帧在线路上只占14字节 */
+#define WIRE_FIXED_HEADER 4                 // 固定报头字节数
+#define WIRE_TRAILER 4                      // 尾部校验和字节数
+#define WIRE_MAX_SEQ_VARINT 5               // 32位序列号的最大 varint 长度
+#define WIRE_MAX_VARINT 10                  // 64位值的最大 varint 长度
+#define WIRE_FLAG_SACK 0x01                 // 携带SACK位图
+#define WIRE_FLAG_ACK 0x02                  // 数据帧捎带反方向的确认
+#define WIRE_FLAG_CONN 0x04                 // 携带连接号
+#define WIRE_MAX_DATA_HEADER (WIRE_FIXED_HEADER + 3 * WIRE_MAX_SEQ_VARINT + WIRE_MAX_VARINT)
+#define WIRE_MAX_DATA_FRAME (WIRE_MAX_DATA_HEADER + MAX_DATA_SIZE - 1 + WIRE_TRAILER)
+#define WIRE_MAX_ACK_FRAME (WIRE_FIXED_HEADER + 2 * WIRE_MAX_SEQ_VARINT + WIRE_MAX_VARINT + WIRE_TRAILER)
+
+/* 数据帧报头（载荷之前的部分）的字段 */
+typedef struct {
+    int seq_num;
+    int data_length;
+    int ack_num;                // 捎带的确认号（-1 表示没有）
+    uint64_t sack_bitmap;
+    uint32_t conn_id;
+} wire_data_header_t;
+
+/* varint：每字节低7位为数据，最高位表示后面还有字节 */
+size_t encode_varint(uint64_t value, uint8_t* out);
+size_t decode_varint(const uint8_t* in, size_t length, uint64_t* value);
+
+/* 编码：返回报文长度，缓冲区不足或字段无效时返回0 */
+size_t encode_data_frame(const data_frame_t* frame, uint8_t* buffer, size_t capacity);
+size_t encode_ack_frame(const ack_frame_t* ack, uint8_t* buffer, size_t capacity);    // 按 ack->type 编码确认或否定确认
+
+/* 解码：校验尾部校验和并还原为帧结构体，返回帧类型，报文损坏时返回-1 */
+int decode_frame(const uint8_t* buffer, size_t length, data_frame_t* frame, ack_frame_t* ack);
+
+/* 报头与载荷分开处理（载荷不复制）：报文 = 报头 | 载荷 | 校验和 */
+size_t encode_data_header(const data_frame_t* frame, uint8_t* header);    // 返回报头长度
+size_t decode_data_header(const uint8_t* buffer, size_t length, wire_data_header_t* header);  // 返回报头长度，无效时返回0
+/* 不校验报文，只读出连接号（多路复用时先按连接号找到会话，再由会话解码） */
+bool peek_connection_id(const uint8_t* buffer, size_t length, uint32_t* conn_id);
+uint32_t calculate_wire_checksum(const uint8_t* header, size_t header_length,
+                                 const void* payload, size_t payload_length);
+
+#endif // WIRE_FORMAT_H
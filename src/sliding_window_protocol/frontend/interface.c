@@ -3,6 +3,10 @@
 #include <string.h>
 #include <time.h>
 #include "../core/sliding_window.h"
+#include "../core/crc32c.h"
+#include "../core/parameter_sweep.h"
+#include "../core/trace_ring.h"
+#include "../core/pcapng_writer.h"
 
 /* 界面显示常量 */
 #define LINE_LENGTH 60
@@ -118,7 +122,14 @@ void show_main_menu(void) {
     printf("2. 自定义网络环境设置\n");
     printf("3. 运行预设测试场景\n");
     printf("4. 查看协议说明\n");
-    printf("5. 退出程序\n");
+    printf("5. 窗口协议对比实验（停等 / 回退N帧 / 选择重传）\n");
+    printf("6. 离散事件仿真性能测试\n");
+    printf("7. 大数据流分片传输\n");
+    printf("8. UDP回环真实传输\n");
+    printf("9. 全双工捎带确认实验\n");
+    printf("10. 多路复用并发会话实验\n");
+    printf("11. 导出仿真报文（pcapng 抓包文件）\n");
+    printf("12. 退出程序\n");
     printf("\n");
 }
 
@@ -133,11 +144,34 @@ void show_network_config_menu(network_config_t* config) {
     printf("丢包概率：     %.1f%%\n", config->loss_probability * 100);
     printf("最小延迟：     %d 毫秒\n", config->min_delay_ms);
     printf("最大延迟：     %d 毫秒\n", config->max_delay_ms);
+    printf("帧损坏概率：   %.1f%% (每帧翻转 %d 比特)\n",
+           config->corruption_probability * 100, config->corruption_bits);
+    printf("校验算法：     CRC-32C (%s)\n", crc32c_implementation());
+    if (config->burst_enter_probability > 0) {
+        printf("突发丢包：     进入 %.1f%% / 离开 %.1f%% / 坏状态丢包 %.1f%%\n",
+               config->burst_enter_probability * 100, config->burst_exit_probability * 100,
+               config->burst_loss_probability * 100);
+    } else {
+        printf("突发丢包：     关闭\n");
+    }
+    printf("乱序概率：     %.1f%% (额外延迟最多 %d 毫秒)\n",
+           config->reorder_probability * 100, config->reorder_delay_ms);
+    printf("复制概率：     %.1f%%\n", config->duplicate_probability * 100);
+    if (config->bandwidth_bps > 0) {
+        printf("链路带宽：     %ld 比特/秒 (队列上限 %d 帧)\n", config->bandwidth_bps,
+               config->queue_limit > 0 ? config->queue_limit : CHANNEL_CAPACITY);
+    } else {
+        printf("链路带宽：     不限\n");
+    }
     printf("\n请选择要修改的参数：\n");
     printf("1. 修改丢包概率\n");
     printf("2. 修改网络延迟范围\n");
-    printf("3. 恢复默认设置\n");
-    printf("4. 返回主菜单\n");
+    printf("3. 修改比特损坏\n");
+    printf("4. 修改突发丢包 (Gilbert-Elliott)\n");
+    printf("5. 修改乱序与复制\n");
+    printf("6. 修改链路带宽与队列\n");
+    printf("7. 恢复默认设置\n");
+    printf("8. 返回主菜单\n");
     printf("\n");
 }
 
@@ -150,7 +184,7 @@ void modify_network_config(network_config_t* config) {
     
     while (1) {
         show_network_config_menu(config);
-        choice = safe_int_input("请输入选项 (1-4): ", 1, 4);
+        choice = safe_int_input("请输入选项 (1-8): ", 1, 8);
         
         switch (choice) {
             case 1: {
@@ -171,11 +205,64 @@ void modify_network_config(network_config_t* config) {
                 break;
             }
             case 3: {
+                double corruption = safe_double_input(
+                    "请输入帧损坏概率 (0.0-1.0): ", 0.0, 1.0);
+                int bits = safe_int_input("请输入每个损坏帧翻转的比特数 (1-32): ", 1, 32);
+                config->corruption_probability = corruption;
+                config->corruption_bits = bits;
+                printf("帧损坏概率已设置为 %.1f%%，每帧翻转 %d 比特\n", corruption * 100, bits);
+                break;
+            }
+            case 4: {
+                double enter = safe_double_input(
+                    "请输入进入坏状态的概率 (0.0-1.0, 0 关闭): ", 0.0, 1.0);
+                config->burst_enter_probability = enter;
+                if (enter > 0) {
+                    config->burst_exit_probability = safe_double_input(
+                        "请输入离开坏状态的概率 (0.01-1.0): ", 0.01, 1.0);
+                    config->burst_loss_probability = safe_double_input(
+                        "请输入坏状态下的丢包概率 (0.0-1.0): ", 0.0, 1.0);
+                    printf("平均突发长度约 %.1f 帧，坏状态占比约 %.1f%%\n",
+                           1.0 / config->burst_exit_probability,
+                           enter / (enter + config->burst_exit_probability) * 100);
+                } else {
+                    printf("已关闭突发丢包\n");
+                }
+                break;
+            }
+            case 5: {
+                config->reorder_probability = safe_double_input(
+                    "请输入乱序概率 (0.0-1.0): ", 0.0, 1.0);
+                if (config->reorder_probability > 0) {
+                    config->reorder_delay_ms = safe_int_input(
+                        "请输入乱序帧的最大额外延迟 (毫秒, 1-2000): ", 1, 2000);
+                }
+                config->duplicate_probability = safe_double_input(
+                    "请输入复制概率 (0.0-1.0): ", 0.0, 1.0);
+                printf("乱序概率 %.1f%%，复制概率 %.1f%%\n",
+                       config->reorder_probability * 100, config->duplicate_probability * 100);
+                break;
+            }
+            case 6: {
+                int kbps = safe_int_input("请输入链路带宽 (千比特/秒, 0 表示不限): ", 0, 1000000);
+                config->bandwidth_bps = (long)kbps * 1000;
+                if (kbps > 0) {
+                    config->queue_limit = safe_int_input(
+                        "请输入发送队列上限 (帧, 0 表示不限): ", 0, CHANNEL_CAPACITY);
+                    printf("链路带宽 %d 千比特/秒，队列上限 %d 帧\n", kbps,
+                           config->queue_limit > 0 ? config->queue_limit : CHANNEL_CAPACITY);
+                } else {
+                    config->queue_limit = 0;
+                    printf("链路带宽不限\n");
+                }
+                break;
+            }
+            case 7: {
                 init_network_config(config);
                 printf("已恢复默认网络设置\n");
                 break;
             }
-            case 4:
+            case 8:
                 return;
         }
         
@@ -252,6 +339,7 @@ void run_preset_scenarios(void) {
     int choice = safe_int_input("请选择场景 (1-4): ", 1, 4);
     
     network_config_t config;
+    init_network_config(&config);
     const char* test_message = "停等协议测试消息 - 计算机网络实验";
     
     switch (choice) {
@@ -308,6 +396,413 @@ void run_preset_scenarios(void) {
     getchar();
 }
 
+/**
+ * 在同一网络环境下对比停等、回退N帧与选择重传协议
+ * @param config 网络配置
+ */
+void run_window_comparison(network_config_t* config) {
+    print_title("窗口协议对比实验");
+    
+    printf("当前网络环境：\n");
+    printf("- 丢包概率: %.1f%%\n", config->loss_probability * 100);
+    printf("- 延迟范围: %d-%d 毫秒\n", config->min_delay_ms, config->max_delay_ms);
+    printf("\n");
+    
+    int window_size = safe_int_input("请输入窗口大小 (2-64): ", 2, MAX_WINDOW_SIZE);
+    int payload_size = safe_int_input("请输入每帧数据字节数 (1-256): ", 1, 256);
+    
+    const char* message = "滑动窗口协议对比实验：停等协议每发送一帧都要等待确认，"
+                          "信道利用率受往返时延限制；回退N帧协议允许窗口内多帧同时在途，"
+                          "在带宽时延积较大的链路上可以显著提高吞吐量。";
+    
+    // 第4、5组为启用SACK的回退N帧与选择重传，第6组再加上AIMD拥塞控制，
+    // 最后一组改用否定确认与快速重传（不等超时即重传丢失的帧）
+    arq_mode_t modes[7] = {ARQ_STOP_AND_WAIT, ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT,
+                           ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT, ARQ_SELECTIVE_REPEAT, ARQ_SELECTIVE_REPEAT};
+    bool sack[7] = {false, false, false, true, true, true, true};
+    bool congestion[7] = {false, false, false, false, false, true, false};
+    bool nak[7] = {false, false, false, false, false, false, true};
+    statistics_t results[7];
+    bool success[7];
+    char names[7][32];
+    
+    for (int i = 0; i < 7; i++) {
+        arq_config_t arq;
+        init_arq_config(&arq, modes[i]);
+        if (modes[i] != ARQ_STOP_AND_WAIT) {
+            arq.window_size = window_size;
+            // 接收方缓存失序帧时序列号空间至少2N
+            arq.seq_space = (modes[i] == ARQ_SELECTIVE_REPEAT || sack[i]) ? 2 * window_size : window_size + 1;
+        }
+        arq.payload_size = payload_size;
+        // 超时需覆盖一个最大往返时延
+        arq.timeout_ms = 2 * config->max_delay_ms + 100;
+        arq.sack = sack[i];
+        arq.congestion_control = congestion[i];
+        arq.nak = nak[i];
+        arq.fast_retransmit = nak[i];
+        snprintf(names[i], sizeof(names[i]), "%s%s%s%s", arq_mode_name(modes[i]),
+                 sack[i] ? "+SACK" : "", congestion[i] ? "+AIMD" : "", nak[i] ? "+NAK" : "");
+        
+        init_statistics(&results[i]);
+        success[i] = transmit_message_arq(message, config, &arq, &results[i]);
+    }
+    
+    printf("\n");
+    print_title("对比结果");
+    printf("%-18s %-8s %10s %8s %8s %8s %8s %8s %14s\n",
+           "协议", "结果", "耗时(ms)", "发送帧", "重传", "超时", "冗余", "丢失", "吞吐(kbit/s)");
+    for (int i = 0; i < 7; i++) {
+        printf("%-18s %-8s %10.1f %8d %8d %8d %8d %8d %14.2f\n",
+               names[i], success[i] ? "成功" : "失败", results[i].elapsed_ms,
+               results[i].frames_sent, results[i].retransmissions, results[i].timeouts,
+               results[i].duplicate_frames, results[i].frames_lost, results[i].goodput_bps / 1000.0);
+    }
+    for (int i = 1; i < 7; i++) {
+        if (success[0] && success[i] && results[i].elapsed_ms > 0) {
+            printf("\n%s(N=%d) 相对停等的加速比: %.2fx",
+                   names[i], window_size, results[0].elapsed_ms / results[i].elapsed_ms);
+        }
+    }
+    printf("\n");
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
+/**
+ * 离散事件仿真性能测试：关闭日志，在当前网络环境下仿真大量帧
+ * @param config 网络配置
+ */
+void run_simulation_benchmark(network_config_t* config) {
+    print_title("离散事件仿真性能测试");
+    
+    printf("当前网络环境：\n");
+    printf("- 丢包概率: %.1f%%\n", config->loss_probability * 100);
+    printf("- 延迟范围: %d-%d 毫秒\n", config->min_delay_ms, config->max_delay_ms);
+    printf("\n");
+    
+    int frame_count = safe_int_input("请输入仿真帧数 (1000-1000000): ", 1000, 1000000);
+    int window_size = safe_int_input("请输入窗口大小 (1-64): ", 1, MAX_WINDOW_SIZE);
+    
+    size_t message_len = (size_t)frame_count * ARQ_DEFAULT_PAYLOAD;
+    char* message = malloc(message_len + 1);
+    if (!message) {
+        printf("内存不足！\n");
+        return;
+    }
+    for (size_t i = 0; i < message_len; i++) {
+        message[i] = 'a' + i % 26;
+    }
+    message[message_len] = '\0';
+    
+    arq_config_t arq;
+    init_arq_config(&arq, window_size == 1 ? ARQ_STOP_AND_WAIT : ARQ_SELECTIVE_REPEAT);
+    if (window_size > 1) {
+        arq.window_size = window_size;
+        arq.seq_space = 2 * window_size;
+    }
+    arq.timeout_ms = 2 * config->max_delay_ms + 100;
+    arq.verbose = false;
+    
+    statistics_t stats;
+    init_statistics(&stats);
+    bool success = transmit_message_arq(message, config, &arq, &stats);
+    free(message);
+    
+    print_statistics(&stats);
+    if (success && stats.wall_ms > 0) {
+        printf("\n仿真速度: %.0f 帧/秒, %.0f 事件/秒 (仿真时间是实际耗时的 %.0f 倍)\n",
+               stats.frames_sent / (stats.wall_ms / 1000.0),
+               stats.events_processed / (stats.wall_ms / 1000.0),
+               stats.elapsed_ms / stats.wall_ms);
+    } else if (!success) {
+        print_title("仿真失败！");
+    }
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
+/* 大数据流演示：发送方按需生成字节，接收方逐段校验，两端都不保存整条数据 */
+typedef struct {
+    size_t total;               // 流的总长度
+    size_t produced;            // 已生成的字节数
+    size_t verified;            // 已校验的字节数
+    bool mismatch;              // 是否发现不一致的字节
+} pattern_stream_t;
+
+static size_t read_pattern_stream(char* buffer, size_t capacity, void* context) {
+    pattern_stream_t* stream = (pattern_stream_t*)context;
+    size_t length = stream->total - stream->produced;
+    if (length > capacity) length = capacity;
+    for (size_t i = 0; i < length; i++) {
+        buffer[i] = (char)((stream->produced + i) * 131 % 251);
+    }
+    stream->produced += length;
+    return length;
+}
+
+static bool verify_pattern_stream(const char* data, size_t length, void* context) {
+    pattern_stream_t* stream = (pattern_stream_t*)context;
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != (char)((stream->verified + i) * 131 % 251)) stream->mismatch = true;
+    }
+    stream->verified += length;
+    return !stream->mismatch;
+}
+
+/**
+ * 大数据流分片传输：按最大帧长分片，经选择重传窗口发送并在接收方流式重组
+ * @param config 网络配置
+ */
+void run_stream_transfer(network_config_t* config) {
+    print_title("大数据流分片传输");
+    
+    printf("当前网络环境：\n");
+    printf("- 丢包概率: %.1f%%\n", config->loss_probability * 100);
+    printf("- 延迟范围: %d-%d 毫秒\n", config->min_delay_ms, config->max_delay_ms);
+    printf("\n");
+    
+    int megabytes = safe_int_input("请输入数据量 (1-1024 MB): ", 1, 1024);
+    int window_size = safe_int_input("请输入窗口大小 (2-64): ", 2, MAX_WINDOW_SIZE);
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = window_size;
+    arq.seq_space = 2 * window_size;
+    arq.payload_size = ARQ_MTU_PAYLOAD;
+    arq.timeout_ms = 2 * config->max_delay_ms + 100;
+    arq.verbose = false;
+    
+    pattern_stream_t stream = {(size_t)megabytes << 20, 0, 0, false};
+    statistics_t stats;
+    init_statistics(&stats);
+    bool success = transmit_stream_arq(read_pattern_stream, &stream, verify_pattern_stream, &stream,
+                                       config, &arq, &stats);
+    
+    print_statistics(&stats);
+    if (success && stats.wall_ms > 0) {
+        printf("\n持续有效吞吐量: %.2f Mbps (仿真时钟)\n", stats.goodput_bps / 1e6);
+        printf("处理速度: %.1f MB/秒 (实际耗时 %.0f 毫秒)\n",
+               stream.verified / 1048576.0 / (stats.wall_ms / 1000.0), stats.wall_ms);
+    } else if (!success) {
+        print_title(stream.mismatch ? "数据校验失败！" : "传输失败！");
+    }
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
+/**
+ * UDP回环真实传输：收发双方在两个线程中经回环UDP套接字通信，测量真实的帧速率与CPU开销
+ */
+void run_udp_transfer(void) {
+    print_title("UDP回环真实传输");
+    
+    int megabytes = safe_int_input("请输入数据量 (1-256 MB): ", 1, 256);
+    int window_size = safe_int_input("请输入窗口大小 (2-64): ", 2, MAX_WINDOW_SIZE);
+    double loss_rate = safe_double_input("请输入注入的丢包率 (0-50%): ", 0.0, 50.0);
+    int max_delay = safe_int_input("请输入注入的最大时延 (0-100 毫秒): ", 0, 100);
+    
+    transport_t sender_side, receiver_side;
+    if (!open_udp_transport_pair(&sender_side, &receiver_side)) {
+        print_title("无法打开UDP套接字！");
+        return;
+    }
+    uint32_t seed = (uint32_t)time(NULL);
+    set_transport_impairment(&sender_side, loss_rate / 100.0, 0, max_delay, seed);
+    set_transport_impairment(&receiver_side, loss_rate / 100.0, 0, max_delay, seed ^ 0x5bd1e995u);
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = window_size;
+    arq.seq_space = 2 * window_size;
+    arq.payload_size = ARQ_MTU_PAYLOAD;
+    arq.timeout_ms = 2 * max_delay + 50;
+    arq.verbose = false;
+    
+    // 数据源在发送线程、数据汇在接收线程中调用，各用一份状态
+    pattern_stream_t source = {(size_t)megabytes << 20, 0, 0, false};
+    pattern_stream_t sink = source;
+    statistics_t stats;
+    init_statistics(&stats);
+    bool success = transmit_stream_transport(read_pattern_stream, &source, verify_pattern_stream, &sink,
+                                             &sender_side, &receiver_side, &arq, &stats);
+    
+    print_statistics(&stats);
+    printf("系统调用:     发送 %llu 次 / %llu 个报文, 接收 %llu 次 / %llu 个报文\n",
+           (unsigned long long)(sender_side.send_calls + receiver_side.send_calls),
+           (unsigned long long)(sender_side.packets_sent + receiver_side.packets_sent),
+           (unsigned long long)(sender_side.recv_calls + receiver_side.recv_calls),
+           (unsigned long long)(sender_side.packets_received + receiver_side.packets_received));
+    if (!success) {
+        print_title(sink.mismatch ? "数据校验失败！" : "传输失败！");
+    }
+    close_transport(&sender_side);
+    close_transport(&receiver_side);
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
+/**
+ * 全双工捎带确认实验：两端同时发送数据，对比确认单独发送与捎带在反向数据帧中的帧数
+ * @param config 网络配置
+ */
+void run_duplex_transfer(network_config_t* config) {
+    print_title("全双工捎带确认实验");
+    
+    printf("当前网络环境：\n");
+    printf("- 丢包概率: %.1f%%\n", config->loss_probability * 100);
+    printf("- 延迟范围: %d-%d 毫秒\n", config->min_delay_ms, config->max_delay_ms);
+    printf("\n");
+    
+    int kilobytes = safe_int_input("请输入每个方向的数据量 (1-1024 KB): ", 1, 1024);
+    int window_size = safe_int_input("请输入窗口大小 (2-32): ", 2, SACK_BITMAP_BITS / 2);
+    int delay_ms = safe_int_input("请输入捎带等待时长 (1-1000 毫秒): ", 1, 1000);
+    
+    const char* names[2] = {"单独确认", "捎带确认"};
+    statistics_t forward[2], reverse[2];
+    bool success[2];
+    int frames[2];
+    for (int i = 0; i < 2; i++) {
+        arq_config_t arq;
+        init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+        arq.window_size = window_size;
+        arq.seq_space = 2 * window_size;
+        arq.payload_size = ARQ_MTU_PAYLOAD;
+        arq.timeout_ms = 2 * config->max_delay_ms + 100;
+        arq.sack = true;        // 累积确认可以被后来的确认替换，捎带效果最好
+        arq.verbose = false;
+        arq.piggyback_delay_ms = (i == 0) ? 0 : delay_ms;
+        
+        // 每个方向一份数据源、一份数据汇
+        size_t total = (size_t)kilobytes << 10;
+        pattern_stream_t streams[4] = {{total, 0, 0, false}, {total, 0, 0, false},
+                                       {total, 0, 0, false}, {total, 0, 0, false}};
+        init_statistics(&forward[i]);
+        init_statistics(&reverse[i]);
+        arq_direction_t a_to_b = {read_pattern_stream, &streams[0], verify_pattern_stream, &streams[1], &forward[i]};
+        arq_direction_t b_to_a = {read_pattern_stream, &streams[2], verify_pattern_stream, &streams[3], &reverse[i]};
+        success[i] = transmit_duplex_arq(&a_to_b, &b_to_a, config, &arq);
+    }
+    
+    printf("\n");
+    print_title("对比结果");
+    printf("%-12s %-8s %10s %10s %10s %10s %10s\n",
+           "方式", "结果", "耗时(ms)", "数据帧", "独立确认", "捎带确认", "总帧数");
+    for (int i = 0; i < 2; i++) {
+        int data_frames = forward[i].frames_sent + reverse[i].frames_sent;
+        int ack_frames = forward[i].acks_sent + reverse[i].acks_sent;
+        frames[i] = data_frames + ack_frames;
+        printf("%-12s %-8s %10.1f %10d %10d %10d %10d\n", names[i], success[i] ? "成功" : "失败",
+               forward[i].elapsed_ms, data_frames, ack_frames,
+               forward[i].piggybacked_acks + reverse[i].piggybacked_acks, frames[i]);
+    }
+    if (frames[0] > 0) {
+        printf("\n捎带确认省去了 %.1f%% 的帧\n", (frames[0] - frames[1]) * 100.0 / frames[0]);
+    }
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
+/**
+ * 多路复用并发会话实验：大量会话按连接号共用一条瓶颈链路，观察总吞吐量与各会话之间的公平性
+ * @param config 网络配置
+ */
+void run_multiplexed_transfer(network_config_t* config) {
+    print_title("多路复用并发会话实验");
+    
+    printf("当前网络环境：\n");
+    printf("- 丢包概率: %.1f%%\n", config->loss_probability * 100);
+    printf("- 延迟范围: %d-%d 毫秒\n", config->min_delay_ms, config->max_delay_ms);
+    printf("\n");
+    
+    int sessions = safe_int_input("请输入会话数 (1-10000): ", 1, 10000);
+    int kilobytes = safe_int_input("请输入每个会话的数据量 (1-256 KB): ", 1, 256);
+    int megabits = safe_int_input("请输入瓶颈链路带宽 (0-10000 Mbit/s, 0 表示不限): ", 0, 10000);
+    
+    network_config_t shared = *config;
+    shared.bandwidth_bps = (long)megabits * 1000000;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 16;
+    arq.seq_space = 64;
+    arq.payload_size = ARQ_MTU_PAYLOAD;
+    arq.timeout_ms = 2 * config->max_delay_ms + 100;
+    arq.sack = true;
+    arq.congestion_control = true;     // 各会话按丢包减窗，共享瓶颈时才能趋于公平
+    arq.verbose = false;
+    
+    statistics_t* stats = calloc((size_t)sessions, sizeof(statistics_t));
+    if (!stats) {
+        printf("[错误] 内存分配失败\n");
+        return;
+    }
+    mux_summary_t summary;
+    bool success = simulate_multiplexed_transfer(sessions, (size_t)kilobytes << 10, &shared, &arq,
+                                                 (uint32_t)rand(), stats, &summary);
+    print_mux_summary(&summary);
+    printf("\n%s：%d 个会话中 %d 个完整交付\n", success ? "传输完成" : "传输失败",
+           summary.sessions, summary.completed);
+    printf("Jain公平指数越接近1，各会话分到的带宽越平均；1/n 表示一个会话独占链路\n");
+    free(stats);
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
+/**
+ * 导出仿真报文：把一次窗口协议仿真的全部数据帧、确认帧与否定确认帧写成 pcapng 文件，
+ * 时间戳为虚拟时刻，可用 Wireshark 加载 wireshark/sliding_window.lua 解析
+ * @param config 网络配置
+ */
+void run_pcapng_export(network_config_t* config) {
+    print_title("导出仿真报文（pcapng）");
+    
+    printf("1. 停等协议\n2. 回退N帧\n3. 选择重传（启用否定确认）\n");
+    int choice = safe_int_input("请选择协议 (1-3): ", 1, 3);
+    int window_size = choice == 1 ? 1 : safe_int_input("请输入窗口大小 (2-32): ", 2, SACK_BITMAP_BITS / 2);
+    int kilobytes = safe_int_input("请输入数据量 (1-1048576 KB): ", 1, 1048576);
+    char path[256];
+    safe_string_input("请输入抓包文件名（默认 sliding_window.pcapng）: ", path, sizeof(path));
+    if (path[0] == '\0') strcpy(path, "sliding_window.pcapng");
+    
+    arq_mode_t modes[3] = {ARQ_STOP_AND_WAIT, ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT};
+    arq_config_t arq;
+    init_arq_config(&arq, modes[choice - 1]);
+    arq.window_size = window_size;
+    arq.seq_space = choice == 3 ? 2 * window_size : window_size + 1;
+    arq.payload_size = ARQ_MTU_PAYLOAD;
+    arq.timeout_ms = 2 * config->max_delay_ms + 100;
+    arq.nak = (choice == 3);
+    arq.max_retries = 50;
+    arq.verbose = false;
+    
+    pcapng_writer_t writer;
+    if (!open_pcapng_writer(&writer, path)) return;
+    arq.capture = capture_pcapng_packet;
+    arq.capture_context = &writer;
+    statistics_t stats;
+    init_statistics(&stats);
+    bool success = simulate_arq_transfer((size_t)kilobytes << 10, config, &arq, (uint32_t)rand(), &stats);
+    long packets = writer.packets;
+    long long bytes = writer.file_bytes;
+    bool written = close_pcapng_writer(&writer);
+    
+    printf("\n传输%s：虚拟耗时 %.1f ms，数据帧 %d（重传 %d），确认帧 %d，否定确认帧 %d\n",
+           success ? "成功" : "失败", stats.elapsed_ms, stats.frames_sent, stats.retransmissions,
+           stats.acks_sent, stats.naks_sent);
+    printf("%s %ld 个报文（%.1f KB）到 %s\n", written ? "已写入" : "[错误] 写入中断，已写入",
+           packets, bytes / 1024.0, path);
+    printf("用 Wireshark 打开：wireshark -X lua_script:src/sliding_window_protocol/wireshark/sliding_window.lua %s\n", path);
+    
+    printf("\n按 Enter 键继续...");
+    getchar();
+}
+
 /**
  * 显示协议说明
  */
@@ -344,13 +839,181 @@ void show_protocol_explanation(void) {
     getchar();
 }
 
+/* ========== 命令行参数扫描 ========== */
+
+/**
+ * 显示参数扫描的用法
+ * @param program 程序名
+ */
+static void print_sweep_usage(const char* program) {
+    fprintf(stderr,
+            "用法: %s --sweep [选项]\n"
+            "  --loss 0,0.05,0.1      丢包率列表\n"
+            "  --delay 10-50,50-200   时延范围列表（毫秒）\n"
+            "  --window 1,4,8,16      窗口大小列表（停等协议固定为1）\n"
+            "  --mode saw,gbn,sr      协议模式列表\n"
+            "  --ack-every 1,2,4      延迟确认：每 k 帧确认一次的列表（1 为逐帧确认）\n"
+            "  --ack-delay 40         延迟确认的最长等待时间（毫秒）\n"
+            "  --reps 10              每格重复次数\n"
+            "  --length 16384         每次传输的字节数\n"
+            "  --payload 16           每帧数据字节数\n"
+            "  --threads 0            工作线程数（0 为全部CPU）\n"
+            "  --seed 1               基础随机种子\n"
+            "  --output 文件          CSV输出文件（默认标准输出）\n",
+            program);
+}
+
+/**
+ * 解析逗号分隔的列表，对每一项调用解析函数
+ * @param text 列表文本
+ * @param max_count 最多项数
+ * @param parse_item 单项解析函数（返回是否有效）
+ * @param target 解析结果的存放位置
+ * @return 项数，出错时返回-1
+ */
+static int parse_sweep_list(const char* text, int max_count,
+                            bool (*parse_item)(const char* item, int index, void* target), void* target) {
+    char buffer[256];
+    if (strlen(text) >= sizeof(buffer)) return -1;
+    strcpy(buffer, text);
+    
+    int count = 0;
+    for (char* item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        if (count >= max_count || !parse_item(item, count, target)) return -1;
+        count++;
+    }
+    return count > 0 ? count : -1;
+}
+
+static bool parse_loss_item(const char* item, int index, void* target) {
+    char* end;
+    ((double*)target)[index] = strtod(item, &end);
+    return *end == '\0';
+}
+
+static bool parse_delay_item(const char* item, int index, void* target) {
+    delay_range_t* delay = &((delay_range_t*)target)[index];
+    char* end;
+    delay->min_ms = (int)strtol(item, &end, 10);
+    if (*end == '\0') {
+        delay->max_ms = delay->min_ms;
+        return true;
+    }
+    if (*end != '-') return false;
+    delay->max_ms = (int)strtol(end + 1, &end, 10);
+    return *end == '\0';
+}
+
+static bool parse_window_item(const char* item, int index, void* target) {
+    char* end;
+    ((int*)target)[index] = (int)strtol(item, &end, 10);
+    return *end == '\0';
+}
+
+static bool parse_mode_item(const char* item, int index, void* target) {
+    arq_mode_t* modes = (arq_mode_t*)target;
+    if (strcmp(item, "saw") == 0) {
+        modes[index] = ARQ_STOP_AND_WAIT;
+    } else if (strcmp(item, "gbn") == 0) {
+        modes[index] = ARQ_GO_BACK_N;
+    } else if (strcmp(item, "sr") == 0) {
+        modes[index] = ARQ_SELECTIVE_REPEAT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 无交互的参数扫描：解析命令行，在全部CPU上运行网格并输出CSV，进度信息写到标准错误
+ * @param argc 参数个数
+ * @param argv 参数列表（argv[1] 为 --sweep）
+ * @return 进程退出码
+ */
+int run_sweep_command(int argc, char* argv[]) {
+    sweep_config_t sweep;
+    init_sweep_config(&sweep);
+    const char* output_path = NULL;
+    
+    for (int i = 2; i < argc; i++) {
+        const char* option = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool valid = value != NULL;
+        if (valid && strcmp(option, "--loss") == 0) {
+            valid = (sweep.loss_count = parse_sweep_list(value, SWEEP_MAX_VALUES, parse_loss_item, sweep.losses)) > 0;
+        } else if (valid && strcmp(option, "--delay") == 0) {
+            valid = (sweep.delay_count = parse_sweep_list(value, SWEEP_MAX_VALUES, parse_delay_item, sweep.delays)) > 0;
+        } else if (valid && strcmp(option, "--window") == 0) {
+            valid = (sweep.window_count = parse_sweep_list(value, SWEEP_MAX_VALUES, parse_window_item, sweep.windows)) > 0;
+        } else if (valid && strcmp(option, "--mode") == 0) {
+            valid = (sweep.mode_count = parse_sweep_list(value, 3, parse_mode_item, sweep.modes)) > 0;
+        } else if (valid && strcmp(option, "--ack-every") == 0) {
+            valid = (sweep.ack_count = parse_sweep_list(value, SWEEP_MAX_VALUES, parse_window_item, sweep.ack_every)) > 0;
+        } else if (valid && strcmp(option, "--ack-delay") == 0) {
+            sweep.ack_delay_ms = atoi(value);
+        } else if (valid && strcmp(option, "--reps") == 0) {
+            sweep.replications = atoi(value);
+        } else if (valid && strcmp(option, "--length") == 0) {
+            sweep.message_length = (size_t)strtoul(value, NULL, 10);
+        } else if (valid && strcmp(option, "--payload") == 0) {
+            sweep.payload_size = atoi(value);
+        } else if (valid && strcmp(option, "--threads") == 0) {
+            sweep.threads = atoi(value);
+        } else if (valid && strcmp(option, "--seed") == 0) {
+            sweep.seed = (uint32_t)strtoul(value, NULL, 10);
+        } else if (valid && strcmp(option, "--output") == 0) {
+            output_path = value;
+        } else {
+            valid = false;
+        }
+        
+        if (!valid) {
+            fprintf(stderr, "[错误] 无效的参数: %s %s\n", option, value ? value : "");
+            print_sweep_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    
+    int count = count_sweep_cells(&sweep);
+    sweep_cell_t* cells = calloc((size_t)count, sizeof(sweep_cell_t));
+    if (!cells) return 1;
+    
+    fprintf(stderr, "[扫描] %d 格 × %d 次重复，每次 %zu 字节\n", count, sweep.replications, sweep.message_length);
+    double start = monotonic_clock_ms();
+    if (!run_parameter_sweep(&sweep, cells)) {
+        free(cells);
+        return 1;
+    }
+    fprintf(stderr, "[扫描] 完成，耗时 %.1f 秒\n", (monotonic_clock_ms() - start) / 1000.0);
+    
+    FILE* output = output_path ? fopen(output_path, "w") : stdout;
+    if (!output) {
+        fprintf(stderr, "[错误] 无法写入 %s\n", output_path);
+        free(cells);
+        return 1;
+    }
+    write_sweep_csv(output, cells, count);
+    if (output != stdout) fclose(output);
+    free(cells);
+    return 0;
+}
+
 /**
  * 主程序入口
  */
-int main(void) {
+int main(int argc, char* argv[]) {
+    // 命令行参数扫描模式，不进入交互菜单
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        return run_sweep_command(argc, argv);
+    }
+    
     // 初始化随机数种子
     srand((unsigned int)time(NULL));
     
+    // 交互演示逐步打印协议过程的文字说明
+    set_trace_level(TRACE_LEVEL_TEXT);
+    
     // 初始化网络配置
     network_config_t config;
     init_network_config(&config);
@@ -362,7 +1025,7 @@ int main(void) {
     
     while (1) {
         show_main_menu();
-        choice = safe_int_input("请输入选项 (1-5): ", 1, 5);
+        choice = safe_int_input("请输入选项 (1-12): ", 1, 12);
         
         switch (choice) {
             case 1:
@@ -382,6 +1045,34 @@ int main(void) {
                 break;
                 
             case 5:
+                run_window_comparison(&config);
+                break;
+                
+            case 6:
+                run_simulation_benchmark(&config);
+                break;
+                
+            case 7:
+                run_stream_transfer(&config);
+                break;
+                
+            case 8:
+                run_udp_transfer();
+                break;
+                
+            case 9:
+                run_duplex_transfer(&config);
+                break;
+                
+            case 10:
+                run_multiplexed_transfer(&config);
+                break;
+                
+            case 11:
+                run_pcapng_export(&config);
+                break;
+                
+            case 12:
                 print_title("感谢使用");
                 printf("程序已退出。再见！\n");
                 return 0;
@@ -1,9 +1,20 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <time.h>
 #include "../core/sliding_window.h"
+#include "../core/event_sim.h"
+#include "../core/timing_wheel.h"
+#include "../core/wire_format.h"
+#include "../core/crc32c.h"
+#include "../core/parameter_sweep.h"
+#include "../core/frame_pool.h"
+#include "../core/session_table.h"
+#include "../core/trace_ring.h"
+#include "../core/pcapng_writer.h"
+#include <pthread.h>
 
 /* 测试用例计数器 */
 static int test_count = 0;
@@ -87,11 +98,13 @@ void test_frame_creation_and_checksum(void) {
     test_assert(strcmp(data_frame.data, test_data) == 0, "数据帧内容设置正确");
     test_assert(data_frame.checksum != 0, "数据帧校验和已计算");
     
-    // 测试校验和验证
+    // 测试校验和验证：只覆盖帧头与有效数据，未使用的数据区不影响校验和
     unsigned int original_checksum = data_frame.checksum;
-    data_frame.checksum = 0;
-    unsigned int calculated_checksum = calculate_checksum(&data_frame, sizeof(data_frame) - sizeof(unsigned int));
-    test_assert(calculated_checksum == original_checksum, "校验和计算正确");
+    test_assert(calculate_frame_checksum(&data_frame) == original_checksum, "校验和计算正确");
+    data_frame.data[data_frame.data_length + 8] = 'x';
+    test_assert(calculate_frame_checksum(&data_frame) == original_checksum, "校验和不覆盖未使用的数据区");
+    data_frame.data[0] = 'h';
+    test_assert(calculate_frame_checksum(&data_frame) != original_checksum, "有效数据变化时校验和改变");
     
     // 测试确认帧创建
     ack_frame_t ack_frame;
@@ -153,6 +166,7 @@ void test_basic_transmission_ideal_network(void) {
     
     // 设置理想网络环境（无丢包，低延迟）
     network_config_t config;
+    init_network_config(&config);
     config.loss_probability = 0.0;
     config.min_delay_ms = 1;
     config.max_delay_ms = 5;
@@ -182,6 +196,7 @@ void test_transmission_with_loss(void) {
     
     // 设置中等丢包率的网络环境
     network_config_t config;
+    init_network_config(&config);
     config.loss_probability = 0.3;  // 30%丢包率
     config.min_delay_ms = 10;
     config.max_delay_ms = 50;
@@ -220,19 +235,24 @@ void test_timeout_retransmission(void) {
     
     // 模拟发送状态
     sender.state = WAITING_FOR_ACK;
-    sender.timer_start = clock() - (TIMEOUT_MS + 100) * CLOCKS_PER_SEC / 1000;
+    sender.timer_start_ms = monotonic_clock_ms() - (TIMEOUT_MS + 100);
     
     test_assert(is_timeout(&sender) == true, "超时检测功能正常");
     
     // 测试未超时情况
-    sender.timer_start = clock();
+    sender.timer_start_ms = monotonic_clock_ms();
     test_assert(is_timeout(&sender) == false, "未超时检测正常");
     
     // 测试计时器重置
-    clock_t old_time = sender.timer_start;
+    double old_time = sender.timer_start_ms;
     usleep(1000);  // 等待1ms确保时间不同
     reset_timer(&sender);
-    test_assert(sender.timer_start > old_time, "计时器重置功能正常");
+    test_assert(sender.timer_start_ms > old_time, "计时器重置功能正常");
+    
+    // 进程休眠（不消耗CPU）期间计时器同样会到期
+    sender.timer_start_ms = monotonic_clock_ms() - TIMEOUT_MS + 20;
+    usleep(50 * 1000);
+    test_assert(is_timeout(&sender) == true, "休眠期间单调时钟照常计时");
 }
 
 /**
@@ -299,7 +319,8 @@ void test_error_handling_and_edge_cases(void) {
     long_message[MAX_DATA_SIZE + 50] = '\0';
     
     bool long_result = transmit_message(long_message, &config, &stats);
-    test_assert(long_result == false, "超长消息处理正确");
+    test_assert(long_result == true && stats.bytes_delivered == MAX_DATA_SIZE + 50,
+                "超长消息分片传输并重组");
 }
 
 /**
@@ -360,6 +381,1685 @@ void test_protocol_state_transitions(void) {
     test_assert(1, "协议状态显示功能正常");
 }
 
+/**
+ * 测试11: 回退N帧协议
+ */
+void test_go_back_n_transmission(void) {
+    print_test_header("回退N帧协议");
+    
+    srand(31);
+    const char* message = "Go-Back-N 滑动窗口协议测试：发送方连续发送窗口内的多个帧，"
+                          "接收方只按序接收并累积确认，超时后发送方回退到最早未确认帧重传整个窗口。";
+    size_t message_len = strlen(message);
+    
+    // 低延迟理想网络，超时设得较短以加快测试
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 5;
+    config.max_delay_ms = 10;
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.timeout_ms = 100;
+    int expected_frames = (int)((message_len + arq.payload_size - 1) / arq.payload_size);
+    
+    statistics_t gbn_stats;
+    init_statistics(&gbn_stats);
+    bool result = transmit_message_arq(message, &config, &arq, &gbn_stats);
+    test_assert(result == true, "理想网络下回退N帧传输成功");
+    test_assert(gbn_stats.frames_sent == expected_frames, "每帧恰好发送一次");
+    test_assert(gbn_stats.retransmissions == 0, "理想网络下无重传");
+    
+    // 同一网络下的停等协议：每帧都要等待一个往返
+    arq_config_t saw;
+    init_arq_config(&saw, ARQ_STOP_AND_WAIT);
+    saw.timeout_ms = 100;
+    statistics_t saw_stats;
+    init_statistics(&saw_stats);
+    result = transmit_message_arq(message, &config, &saw, &saw_stats);
+    test_assert(result == true, "停等模式传输成功");
+    printf("耗时对比: 停等 %.1f 毫秒, 回退N帧(N=%d) %.1f 毫秒\n",
+           saw_stats.elapsed_ms, arq.window_size, gbn_stats.elapsed_ms);
+    test_assert(gbn_stats.elapsed_ms * 2 < saw_stats.elapsed_ms, "窗口流水线显著快于停等");
+    
+    // 有丢包时依靠超时回退重传完成传输
+    config.loss_probability = 0.2;
+    statistics_t loss_stats;
+    init_statistics(&loss_stats);
+    result = transmit_message_gbn(message, &config, 4, &loss_stats);
+    test_assert(result == true, "20%丢包下回退N帧传输成功");
+    test_assert(loss_stats.retransmissions > 0, "丢包触发了回退重传");
+    
+    // 序列号空间不足N+1时拒绝
+    arq.seq_space = arq.window_size;
+    test_assert(transmit_message_arq(message, &config, &arq, &loss_stats) == false,
+                "序列号空间小于N+1被拒绝");
+}
+
+/**
+ * 测试12: 选择重传协议
+ */
+void test_selective_repeat_transmission(void) {
+    print_test_header("选择重传协议");
+    
+    // 较长的消息，让突发丢失下两种窗口协议的差异显现出来
+    char message[1024];
+    message[0] = '\0';
+    for (int i = 0; i < 12; i++) {
+        strcat(message, "Selective Repeat 选择重传 ");
+    }
+    size_t message_len = strlen(message);
+    
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 5;
+    config.max_delay_ms = 10;
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.timeout_ms = 60;
+    test_assert(arq.seq_space == 2 * arq.window_size, "选择重传默认序列号空间为2N");
+    
+    statistics_t stats;
+    init_statistics(&stats);
+    srand(32);
+    bool result = transmit_message_arq(message, &config, &arq, &stats);
+    test_assert(result == true, "理想网络下选择重传传输成功");
+    test_assert(stats.retransmissions == 0, "理想网络下无重传");
+    test_assert(stats.bytes_delivered == (long)message_len, "交付字节数等于消息长度");
+    test_assert(stats.goodput_bps > 0, "有效吞吐量已统计");
+    
+    // 相同丢包网络、相同随机序列下比较回退N帧与选择重传的重传量
+    config.loss_probability = 0.2;
+    arq_config_t gbn;
+    init_arq_config(&gbn, ARQ_GO_BACK_N);
+    gbn.timeout_ms = 60;
+    
+    statistics_t gbn_stats, sr_stats;
+    init_statistics(&gbn_stats);
+    init_statistics(&sr_stats);
+    srand(320);
+    bool gbn_result = transmit_message_arq(message, &config, &gbn, &gbn_stats);
+    srand(320);
+    bool sr_result = transmit_message_arq(message, &config, &arq, &sr_stats);
+    printf("20%%丢包: 回退N帧重传 %d 帧, 选择重传重传 %d 帧\n",
+           gbn_stats.retransmissions, sr_stats.retransmissions);
+    test_assert(gbn_result && sr_result, "丢包网络下两种窗口协议都传输成功");
+    test_assert(sr_stats.retransmissions < gbn_stats.retransmissions, "选择重传的重传帧数少于回退N帧");
+    test_assert(sr_stats.bytes_delivered == (long)message_len, "丢包下按序交付完整消息");
+    
+    // 序列号空间不足2N时拒绝
+    arq.seq_space = 2 * arq.window_size - 1;
+    test_assert(transmit_message_arq(message, &config, &arq, &stats) == false,
+                "序列号空间小于2N被拒绝");
+}
+
+/**
+ * 测试13: 离散事件仿真引擎
+ */
+void test_discrete_event_simulation(void) {
+    print_test_header("离散事件仿真引擎");
+    
+    // 事件堆按时刻出队，同一时刻按调度先后出队
+    event_queue_t queue;
+    test_assert(init_event_queue(&queue, 4), "事件队列初始化成功");
+    double times[8] = {30, 10, 20, 10, 50, 0, 20, 40};
+    for (int i = 0; i < 8; i++) {
+        schedule_event(&queue, times[i], EVENT_DATA_ARRIVAL, i);
+    }
+    int expected_order[8] = {5, 1, 3, 2, 6, 0, 7, 4};
+    bool ordered = true;
+    sim_event_t event;
+    for (int i = 0; i < 8; i++) {
+        if (!pop_event(&queue, &event) || event.arg != expected_order[i]) ordered = false;
+    }
+    test_assert(ordered, "事件按 (时刻, 调度顺序) 出队");
+    test_assert(queue.now == 50 && queue.processed == 8, "虚拟时钟推进到最后一个事件");
+    test_assert(!pop_event(&queue, &event), "空队列无事件可取");
+    free_event_queue(&queue);
+    
+    // 大量帧的仿真不休眠：仿真时长远大于实际耗时
+    const int frame_count = 20000;
+    char* message = malloc(frame_count * ARQ_DEFAULT_PAYLOAD + 1);
+    for (int i = 0; i < frame_count * ARQ_DEFAULT_PAYLOAD; i++) {
+        message[i] = 'a' + i % 26;
+    }
+    message[frame_count * ARQ_DEFAULT_PAYLOAD] = '\0';
+    
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.05;
+    config.min_delay_ms = 20;
+    config.max_delay_ms = 40;
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 32;
+    arq.seq_space = 64;
+    arq.timeout_ms = 100;
+    arq.verbose = false;
+    
+    statistics_t stats;
+    init_statistics(&stats);
+    srand(33);
+    bool result = transmit_message_arq(message, &config, &arq, &stats);
+    printf("%d 帧: 仿真时长 %.0f ms, 实际耗时 %.1f ms, 处理 %ld 个事件\n",
+           frame_count, stats.elapsed_ms, stats.wall_ms, stats.events_processed);
+    test_assert(result == true, "大规模仿真传输成功");
+    test_assert(stats.events_processed >= stats.frames_sent, "每次发送都产生了事件");
+    test_assert(stats.wall_ms * 10 < stats.elapsed_ms, "虚拟时钟不受休眠限制");
+    
+    // 相同随机种子下仿真结果可复现
+    statistics_t replay;
+    init_statistics(&replay);
+    srand(33);
+    transmit_message_arq(message, &config, &arq, &replay);
+    test_assert(replay.elapsed_ms == stats.elapsed_ms && replay.frames_sent == stats.frames_sent,
+                "相同随机种子下仿真结果一致");
+    free(message);
+}
+
+/* 时间轮测试的到期记录 */
+typedef struct {
+    timing_wheel_t* wheel;
+    int fired_count;
+    bool on_time;               // 每个计时器都恰好在到期 tick 触发
+    bool cancelled_fired;       // 被撤销的计时器是否误触发
+    int rearmed;                // 回调中重新装载的次数
+} wheel_probe_t;
+
+/**
+ * 时间轮测试回调：检查触发时刻，id 为负的计时器在回调中重新装载一次
+ */
+static void probe_timer_expired(wheel_timer_t* timer, void* context) {
+    wheel_probe_t* probe = (wheel_probe_t*)context;
+    probe->fired_count++;
+    if (timer->expires != probe->wheel->current_tick) probe->on_time = false;
+    if (timer->id % 2 == 1) probe->cancelled_fired = true;
+    if (timer->id < 0 && probe->rearmed == 0) {
+        probe->rearmed++;
+        arm_timer(probe->wheel, timer, timing_wheel_time_ms(probe->wheel) + 5);
+    }
+}
+
+/**
+ * 测试14: 分层时间轮
+ */
+void test_timing_wheel(void) {
+    print_test_header("分层时间轮");
+    
+    // 数千个并发计时器，到期时刻跨越多层，撤销其中一半
+    const int timer_count = 5000;
+    wheel_timer_t* timers = malloc(timer_count * sizeof(wheel_timer_t));
+    timing_wheel_t wheel;
+    init_timing_wheel(&wheel, TIMER_TICK_MS, 0);
+    
+    srand(34);
+    double latest = 0;
+    for (int i = 0; i < timer_count; i++) {
+        init_wheel_timer(&timers[i], i);
+        double expire_ms = 1 + rand() % 300000;
+        if (expire_ms > latest) latest = expire_ms;
+        arm_timer(&wheel, &timers[i], expire_ms);
+    }
+    test_assert(wheel.armed_count == (size_t)timer_count, "全部计时器已装载");
+    for (int i = 1; i < timer_count; i += 2) {
+        cancel_timer(&wheel, &timers[i]);
+    }
+    test_assert(wheel.armed_count == (size_t)timer_count / 2, "撤销后计数正确");
+    
+    wheel_probe_t probe = {&wheel, 0, true, false, 0};
+    size_t fired = advance_timing_wheel(&wheel, latest, probe_timer_expired, &probe);
+    test_assert(fired == (size_t)timer_count / 2 && probe.fired_count == timer_count / 2,
+                "未撤销的计时器全部到期");
+    test_assert(probe.on_time, "每个计时器恰好在到期 tick 触发（含级联的高层计时器）");
+    test_assert(!probe.cancelled_fired, "撤销的计时器没有触发");
+    test_assert(wheel.armed_count == 0, "到期后时间轮为空");
+    free(timers);
+    
+    // 回调中重新装载；提前推进不会触发未到期的计时器
+    wheel_timer_t timer;
+    init_wheel_timer(&timer, -2);
+    probe.fired_count = 0;
+    arm_timer(&wheel, &timer, timing_wheel_time_ms(&wheel) + 10);
+    advance_timing_wheel(&wheel, timing_wheel_time_ms(&wheel) + 9, probe_timer_expired, &probe);
+    test_assert(probe.fired_count == 0, "未到期的计时器不触发");
+    advance_timing_wheel(&wheel, timing_wheel_time_ms(&wheel) + 10, probe_timer_expired, &probe);
+    test_assert(probe.fired_count == 2 && probe.rearmed == 1, "回调中重新装载的计时器再次到期");
+    
+    // 超出时间轮覆盖范围的计时器按真实时刻到期
+    double far_ms = timing_wheel_time_ms(&wheel) + 20000000.0;
+    init_wheel_timer(&timer, 0);
+    arm_timer(&wheel, &timer, far_ms);
+    probe.fired_count = 0;
+    advance_timing_wheel(&wheel, far_ms - 1, probe_timer_expired, &probe);
+    test_assert(probe.fired_count == 0 && timer.armed, "超远计时器在到期前保持装载");
+    advance_timing_wheel(&wheel, far_ms, probe_timer_expired, &probe);
+    test_assert(probe.fired_count == 1 && probe.on_time, "超远计时器按时到期");
+}
+
+/**
+ * 测试15: 自适应重传超时
+ */
+void test_adaptive_rto(void) {
+    print_test_header("自适应重传超时");
+    
+    // RFC 6298 估计公式
+    rto_estimator_t rto;
+    init_rto_estimator(&rto, 1000, 10, 4000, 1);
+    test_assert(rto.rto_ms == 1000 && rto.samples == 0, "无样本时使用初始RTO");
+    update_rto_estimator(&rto, 100);
+    test_assert(rto.srtt_ms == 100 && rto.rttvar_ms == 50 && rto.rto_ms == 300,
+                "首个样本: SRTT=R, RTTVAR=R/2, RTO=SRTT+4·RTTVAR");
+    update_rto_estimator(&rto, 100);
+    test_assert(rto.srtt_ms == 100 && rto.rttvar_ms == 37.5 && rto.rto_ms == 250,
+                "后续样本按 α=1/8, β=1/4 平滑");
+    
+    // 指数退避与上下限
+    backoff_rto_estimator(&rto);
+    test_assert(rto.rto_ms == 500 && rto.backoffs == 1, "超时后RTO加倍");
+    for (int i = 0; i < 5; i++) backoff_rto_estimator(&rto);
+    test_assert(rto.rto_ms == 4000, "退避不超过上限");
+    update_rto_estimator(&rto, 100);
+    test_assert(rto.backoffs == 0 && rto.rto_ms < 500, "新样本清除退避");
+    for (int i = 0; i < 50; i++) update_rto_estimator(&rto, 1);
+    test_assert(rto.rto_ms == 10, "RTO不低于下限");
+    
+    // 默认网络环境（50-200ms时延）下与固定1秒超时对比
+    char message[512];
+    message[0] = '\0';
+    for (int i = 0; i < 16; i++) {
+        strcat(message, "adaptive RTO 自适应超时 ");
+    }
+    network_config_t config;
+    init_network_config(&config);
+    
+    arq_config_t fixed;
+    init_arq_config(&fixed, ARQ_GO_BACK_N);
+    fixed.adaptive_rto = false;
+    fixed.verbose = false;
+    arq_config_t adaptive = fixed;
+    adaptive.adaptive_rto = true;
+    
+    // 单次运行受随机丢包影响大，比较多个随机种子下的总耗时
+    statistics_t fixed_stats, adaptive_stats;
+    double fixed_total = 0, adaptive_total = 0;
+    bool all_succeeded = true;
+    for (int seed = 0; seed < 10; seed++) {
+        init_statistics(&fixed_stats);
+        init_statistics(&adaptive_stats);
+        srand(350 + seed);
+        all_succeeded &= transmit_message_arq(message, &config, &fixed, &fixed_stats);
+        srand(350 + seed);
+        all_succeeded &= transmit_message_arq(message, &config, &adaptive, &adaptive_stats);
+        fixed_total += fixed_stats.elapsed_ms;
+        adaptive_total += adaptive_stats.elapsed_ms;
+    }
+    printf("10次平均: 固定RTO %.0f ms, 自适应RTO %.0f ms (末次 SRTT %.1f ms, RTO %.1f ms)\n",
+           fixed_total / 10, adaptive_total / 10, adaptive_stats.srtt_ms, adaptive_stats.rto_ms);
+    test_assert(all_succeeded, "两种超时策略都传输成功");
+    test_assert(fixed_stats.rto_ms == TIMEOUT_MS, "固定模式报告配置的超时");
+    test_assert(adaptive_stats.rtt_samples > 0 && adaptive_stats.rto_ms < TIMEOUT_MS,
+                "自适应RTO收敛到往返时延附近");
+    test_assert(adaptive_stats.srtt_ms >= 2 * config.min_delay_ms &&
+                adaptive_stats.srtt_ms <= 2 * config.max_delay_ms, "SRTT落在往返时延范围内");
+    test_assert(adaptive_total < fixed_total, "丢包恢复快于固定1秒超时");
+    
+    // Karn算法：只有未重传过的帧产生样本
+    test_assert(adaptive_stats.rtt_samples <= adaptive_stats.acks_received, "RTT样本不多于确认数");
+    
+    // 上下限无效时拒绝
+    adaptive.min_rto_ms = 0;
+    test_assert(validate_arq_config(&adaptive) == false, "RTO下限必须为正数");
+}
+
+/* 流式传输测试用的数据源/数据汇：按线性同余序列生成和校验字节，不保存数据 */
+typedef struct {
+    size_t total;               // 流的总长度
+    size_t produced;            // 数据源已生成的字节数
+    size_t consumed;            // 数据汇已校验的字节数
+    unsigned int source_state;
+    unsigned int sink_state;
+    size_t max_outstanding;     // 已生成但未交付的最大字节数
+    size_t abort_after;         // 交付超过该字节数时拒绝接收（0表示不限）
+    bool corrupted;
+} lcg_stream_t;
+
+static unsigned char next_stream_byte(unsigned int* state) {
+    *state = *state * 1103515245u + 12345u;
+    return (unsigned char)(*state >> 16);
+}
+
+static size_t lcg_stream_source(char* buffer, size_t capacity, void* context) {
+    lcg_stream_t* stream = (lcg_stream_t*)context;
+    size_t length = stream->total - stream->produced;
+    if (length > capacity) length = capacity;
+    for (size_t i = 0; i < length; i++) {
+        buffer[i] = (char)next_stream_byte(&stream->source_state);
+    }
+    stream->produced += length;
+    if (stream->produced - stream->consumed > stream->max_outstanding) {
+        stream->max_outstanding = stream->produced - stream->consumed;
+    }
+    return length;
+}
+
+static bool lcg_stream_sink(const char* data, size_t length, void* context) {
+    lcg_stream_t* stream = (lcg_stream_t*)context;
+    if (stream->abort_after > 0 && stream->consumed + length > stream->abort_after) return false;
+    for (size_t i = 0; i < length; i++) {
+        if ((unsigned char)data[i] != next_stream_byte(&stream->sink_state)) stream->corrupted = true;
+    }
+    stream->consumed += length;
+    return true;
+}
+
+/**
+ * 测试16: 大消息分片与流式重组
+ */
+void test_stream_fragmentation(void) {
+    print_test_header("大消息分片与流式重组");
+    
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.05;
+    config.min_delay_ms = 1;
+    config.max_delay_ms = 5;
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 32;
+    arq.seq_space = 64;
+    arq.payload_size = ARQ_MTU_PAYLOAD;
+    arq.verbose = false;
+    
+    // 4MB 字节流：长度事先未知，两端只保存窗口内的帧
+    lcg_stream_t stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.total = 4u << 20;
+    stream.source_state = stream.sink_state = 36;
+    statistics_t stats;
+    init_statistics(&stats);
+    srand(36);
+    bool stream_ok = transmit_stream_arq(lcg_stream_source, &stream, lcg_stream_sink, &stream,
+                                         &config, &arq, &stats);
+    printf("4MB 流: 仿真时长 %.0f ms, 有效吞吐量 %.2f Mbps, 实际耗时 %.0f ms, 最大在途 %zu 字节\n",
+           stats.elapsed_ms, stats.goodput_bps / 1e6, stats.wall_ms, stream.max_outstanding);
+    test_assert(stream_ok && stream.consumed == stream.total && !stream.corrupted,
+                "4MB字节流按序完整交付");
+    test_assert(stats.bytes_delivered == (long)stream.total && stats.retransmissions > 0,
+                "丢包环境下经重传交付全部字节");
+    test_assert(stream.max_outstanding <= (size_t)arq.window_size * arq.payload_size,
+                "未交付数据不超过一个窗口（常数内存）");
+    
+    // 二进制数据（含0字节）重组到调用方缓冲区
+    size_t length = 10000;
+    char* data = malloc(length);
+    char* output = malloc(length);
+    for (size_t i = 0; i < length; i++) data[i] = (char)(i * 7);
+    arq_config_t gbn;
+    init_arq_config(&gbn, ARQ_GO_BACK_N);
+    gbn.payload_size = 512;
+    gbn.verbose = false;
+    init_statistics(&stats);
+    bool buffer_ok = transmit_buffer_arq(data, length, output, length, &config, &gbn, &stats);
+    test_assert(buffer_ok && memcmp(data, output, length) == 0, "二进制数据重组到调用方缓冲区");
+    test_assert(transmit_buffer_arq(data, length, output, length - 1, &config, &gbn, &stats) == false,
+                "缓冲区不足时拒绝传输");
+    free(data);
+    free(output);
+    
+    // 数据汇拒绝接收时中止
+    memset(&stream, 0, sizeof(stream));
+    stream.total = 100000;
+    stream.abort_after = 20000;
+    init_statistics(&stats);
+    bool aborted = transmit_stream_arq(lcg_stream_source, &stream, lcg_stream_sink, &stream,
+                                       &config, &arq, &stats);
+    test_assert(aborted == false && stream.consumed <= 20000, "数据汇拒绝接收时传输中止");
+}
+
+/**
+ * 测试17: UDP回环真实传输
+ */
+void test_udp_transport(void) {
+    print_test_header("UDP回环真实传输");
+    
+    transport_t sender_side, receiver_side;
+    bool opened = open_udp_transport_pair(&sender_side, &receiver_side);
+    test_assert(opened, "打开一对回环UDP端点");
+    if (!opened) return;
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 32;
+    arq.seq_space = 64;
+    arq.payload_size = ARQ_MTU_PAYLOAD;
+    arq.timeout_ms = 50;
+    arq.verbose = false;
+    
+    // 收发两端在不同线程中运行，各用独立的数据源/数据汇状态
+    lcg_stream_t source, sink;
+    memset(&source, 0, sizeof(source));
+    memset(&sink, 0, sizeof(sink));
+    source.total = sink.total = 1u << 20;
+    source.source_state = sink.sink_state = 37;
+    statistics_t stats;
+    init_statistics(&stats);
+    bool clean_ok = transmit_stream_transport(lcg_stream_source, &source, lcg_stream_sink, &sink,
+                                              &sender_side, &receiver_side, &arq, &stats);
+    print_statistics(&stats);
+    printf("发送系统调用 %llu 次 / %llu 个报文\n",
+           (unsigned long long)sender_side.send_calls, (unsigned long long)sender_side.packets_sent);
+    test_assert(clean_ok && sink.consumed == source.total && !sink.corrupted, "1MB数据经UDP完整交付");
+    test_assert(stats.bytes_delivered == (long)source.total && stats.cpu_ms > 0, "统计交付字节与CPU时间");
+    test_assert(sender_side.send_calls < sender_side.packets_sent, "sendmmsg 批量发送多个报文");
+    
+    // 注入丢包与时延
+    test_assert(set_transport_impairment(&sender_side, 0.05, 1, 3, 371) &&
+                set_transport_impairment(&receiver_side, 0.05, 1, 3, 372), "设置软件损伤");
+    memset(&source, 0, sizeof(source));
+    memset(&sink, 0, sizeof(sink));
+    source.total = sink.total = 256u << 10;
+    init_statistics(&stats);
+    bool lossy_ok = transmit_stream_transport(lcg_stream_source, &source, lcg_stream_sink, &sink,
+                                              &sender_side, &receiver_side, &arq, &stats);
+    printf("损伤注入: 丢失 %d, 重传 %d, 耗时 %.0f ms\n",
+           stats.frames_lost, stats.retransmissions, stats.wall_ms);
+    test_assert(lossy_ok && sink.consumed == source.total && !sink.corrupted, "丢包与时延下完整交付");
+    test_assert(stats.frames_lost > 0 && stats.retransmissions > 0, "注入的丢包经重传恢复");
+    test_assert(set_transport_impairment(&sender_side, 1.5, 0, 0, 0) == false, "无效的损伤参数被拒绝");
+    
+    close_transport(&sender_side);
+    close_transport(&receiver_side);
+}
+
+/**
+ * 测试18: SACK选择确认
+ */
+void test_sack_acknowledgment(void) {
+    print_test_header("SACK选择确认");
+    
+    size_t length = 32 * 1024;
+    char* message = malloc(length + 1);
+    for (size_t i = 0; i < length; i++) message[i] = 'a' + i % 26;
+    message[length] = '\0';
+    
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.2;
+    
+    // 同一随机种子下比较：回退N帧 / 回退N帧+SACK / 选择重传 / 选择重传+SACK
+    arq_mode_t modes[4] = {ARQ_GO_BACK_N, ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT, ARQ_SELECTIVE_REPEAT};
+    statistics_t results[4];
+    bool all_ok = true;
+    for (int i = 0; i < 4; i++) {
+        arq_config_t arq;
+        init_arq_config(&arq, modes[i]);
+        arq.window_size = 16;
+        arq.seq_space = 32;
+        arq.payload_size = 128;
+        arq.max_retries = 30;
+        arq.verbose = false;
+        arq.sack = (i % 2 == 1);
+        init_statistics(&results[i]);
+        srand(380);
+        all_ok &= transmit_message_arq(message, &config, &arq, &results[i]);
+        printf("%s%s: 发送 %d, 重传 %d, 冗余 %d, 免重传 %d, 耗时 %.0f ms\n",
+               arq_mode_name(modes[i]), arq.sack ? "+SACK" : "", results[i].frames_sent,
+               results[i].retransmissions, results[i].duplicate_frames, results[i].sack_skips,
+               results[i].elapsed_ms);
+    }
+    test_assert(all_ok, "四种配置在20%丢包下都传输成功");
+    test_assert(results[1].retransmissions * 2 < results[0].retransmissions && results[1].sack_skips > 0,
+                "回退N帧+SACK只重传空缺，重传减少一半以上");
+    test_assert(results[3].duplicate_frames * 2 < results[2].duplicate_frames,
+                "选择重传+SACK：确认丢失不再引起冗余重传");
+    test_assert(results[3].retransmissions < results[2].retransmissions, "选择重传+SACK重传更少");
+    free(message);
+    
+    // 配置校验
+    arq_config_t invalid;
+    init_arq_config(&invalid, ARQ_STOP_AND_WAIT);
+    invalid.sack = true;
+    test_assert(validate_arq_config(&invalid) == false, "停等协议不支持SACK");
+    init_arq_config(&invalid, ARQ_GO_BACK_N);
+    invalid.sack = true;
+    test_assert(validate_arq_config(&invalid) == false, "SACK要求序列号空间不小于2N");
+    
+    // SACK位图随确认帧经UDP线路格式传输
+    transport_t sender_side, receiver_side;
+    if (open_udp_transport_pair(&sender_side, &receiver_side)) {
+        set_transport_impairment(&sender_side, 0.1, 0, 0, 381);
+        set_transport_impairment(&receiver_side, 0.1, 0, 0, 382);
+        arq_config_t arq;
+        init_arq_config(&arq, ARQ_GO_BACK_N);
+        arq.window_size = 16;
+        arq.seq_space = 32;
+        arq.payload_size = ARQ_MTU_PAYLOAD;
+        arq.timeout_ms = 50;
+        arq.verbose = false;
+        arq.sack = true;
+        lcg_stream_t source, sink;
+        memset(&source, 0, sizeof(source));
+        memset(&sink, 0, sizeof(sink));
+        source.total = sink.total = 128u << 10;
+        statistics_t stats;
+        init_statistics(&stats);
+        bool ok = transmit_stream_transport(lcg_stream_source, &source, lcg_stream_sink, &sink,
+                                            &sender_side, &receiver_side, &arq, &stats);
+        test_assert(ok && sink.consumed == source.total && !sink.corrupted, "UDP上的回退N帧+SACK完整交付");
+        close_transport(&sender_side);
+        close_transport(&receiver_side);
+    }
+}
+
+/**
+ * 测试19: 紧凑线路格式
+ */
+void test_wire_format(void) {
+    print_test_header("紧凑线路格式");
+    
+    // varint 往返
+    uint64_t values[5] = {0, 127, 128, 300, UINT64_MAX};
+    size_t lengths[5] = {1, 1, 2, 2, WIRE_MAX_VARINT};
+    bool varint_ok = true;
+    for (int i = 0; i < 5; i++) {
+        uint8_t buffer[WIRE_MAX_VARINT];
+        uint64_t decoded = 0;
+        size_t used = encode_varint(values[i], buffer);
+        varint_ok &= used == lengths[i] && decode_varint(buffer, used, &decoded) == used &&
+                     decoded == values[i];
+    }
+    test_assert(varint_ok, "varint编码长度与往返正确");
+    uint8_t unterminated[2] = {0x80, 0x80};
+    uint64_t ignored;
+    test_assert(decode_varint(unterminated, 2, &ignored) == 0, "不完整的varint被拒绝");
+    
+    // 数据帧：5字节数据只占 4 + 1 + 5 + 4 字节
+    data_frame_t frame, decoded_frame;
+    create_data_frame(&frame, 5, "Hello", 5);
+    uint8_t packet[WIRE_MAX_DATA_FRAME];
+    size_t length = encode_data_frame(&frame, packet, sizeof(packet));
+    test_assert(length == 14, "5字节数据的帧编码为14字节");
+    test_assert(decode_frame(packet, length, &decoded_frame, NULL) == DATA_FRAME &&
+                decoded_frame.seq_num == 5 && decoded_frame.data_length == 5 &&
+                strcmp(decoded_frame.data, "Hello") == 0, "数据帧往返一致");
+    
+    // 确认帧：无SACK时省略位图
+    ack_frame_t ack, decoded_ack;
+    create_ack_frame(&ack, 300);
+    uint8_t ack_packet[WIRE_MAX_ACK_FRAME];
+    size_t plain_length = encode_ack_frame(&ack, ack_packet, sizeof(ack_packet));
+    ack.sack_bitmap = 0x8000000000000005ULL;
+    size_t sack_length = encode_ack_frame(&ack, ack_packet, sizeof(ack_packet));
+    test_assert(plain_length == 10 && sack_length > plain_length, "确认帧只在有SACK时携带位图");
+    test_assert(decode_frame(ack_packet, sack_length, NULL, &decoded_ack) == ACK_FRAME &&
+                decoded_ack.ack_num == 300 && decoded_ack.sack_bitmap == ack.sack_bitmap,
+                "确认帧与SACK位图往返一致");
+    
+    // 损坏与截断
+    packet[6] ^= 0x10;
+    test_assert(decode_frame(packet, length, &decoded_frame, NULL) == -1, "单比特翻转被校验和发现");
+    packet[6] ^= 0x10;
+    test_assert(decode_frame(packet, length - 1, &decoded_frame, NULL) == -1 &&
+                decode_frame(packet, 3, &decoded_frame, NULL) == -1, "截断的报文被拒绝");
+    test_assert(encode_data_frame(&frame, packet, 8) == 0, "缓冲区不足时编码失败");
+    
+    // 线路字节数随载荷大小变化，而不是固定的结构体大小
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    size_t message_length = 8 * 1024;
+    char* message = malloc(message_length + 1);
+    for (size_t i = 0; i < message_length; i++) message[i] = 'A' + i % 26;
+    message[message_length] = '\0';
+    
+    int payloads[2] = {16, 512};
+    statistics_t results[2];
+    bool all_ok = true;
+    for (int i = 0; i < 2; i++) {
+        arq_config_t arq;
+        init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+        arq.window_size = 8;
+        arq.payload_size = payloads[i];
+        arq.verbose = false;
+        init_statistics(&results[i]);
+        all_ok &= transmit_message_arq(message, &config, &arq, &results[i]);
+        printf("载荷 %d 字节: %d 帧, 线路 %ld 字节\n", payloads[i],
+               results[i].frames_sent, results[i].wire_bytes);
+    }
+    test_assert(all_ok, "不同载荷大小都传输成功");
+    long overhead = results[1].wire_bytes - (long)message_length;
+    test_assert(overhead > 0 && overhead < 64 * (results[1].frames_sent + results[1].acks_sent),
+                "线路开销只有报头与尾部，不含未用的数据区");
+    test_assert(results[0].wire_bytes < (long)(message_length * 3),
+                "小载荷的线路字节数与实际数据量相当");
+    free(message);
+}
+
+/**
+ * 测试20: CRC-32C 帧校验与比特损坏
+ */
+void test_crc32c_integrity(void) {
+    print_test_header("CRC-32C帧校验与比特损坏");
+    
+    printf("CRC-32C 实现: %s\n", crc32c_implementation());
+    test_assert(calculate_crc32c("123456789", 9) == 0xE3069283u, "标准测试向量 \"123456789\" 正确");
+    uint8_t block[1037];
+    for (size_t i = 0; i < sizeof(block); i++) block[i] = (uint8_t)(i * 131 + 7);
+    uint32_t crc = update_crc32c(CRC32C_INIT, block, 13);
+    crc = update_crc32c(crc, block + 13, sizeof(block) - 13);
+    test_assert((crc ^ CRC32C_INIT) == calculate_crc32c(block, sizeof(block)), "分段计算与一次计算一致");
+    
+    // 交换两个字节：加法和不变，CRC 改变
+    uint8_t swapped[sizeof(block)];
+    memcpy(swapped, block, sizeof(block));
+    swapped[100] = block[101];
+    swapped[101] = block[100];
+    unsigned int sum_before = 0, sum_after = 0;
+    for (size_t i = 0; i < sizeof(block); i++) {
+        sum_before += block[i];
+        sum_after += swapped[i];
+    }
+    test_assert(sum_before == sum_after && calculate_crc32c(swapped, sizeof(swapped)) != calculate_crc32c(block, sizeof(block)),
+                "字节交换：加法和漏检，CRC-32C 发现");
+    
+    // 双比特错误：比较原来的加法和与 CRC-32C 的漏检数
+    srand(400);
+    int sum_missed = 0, crc_missed = 0;
+    for (int trial = 0; trial < 2000; trial++) {
+        uint8_t frame[64];
+        for (size_t i = 0; i < sizeof(frame); i++) frame[i] = (uint8_t)rand();
+        unsigned int sum = 0;
+        for (size_t i = 0; i < sizeof(frame); i++) sum += frame[i];
+        uint32_t expected = calculate_crc32c(frame, sizeof(frame));
+        
+        int first = rand() % 512, second = rand() % 511;
+        if (second >= first) second++;
+        frame[first / 8] ^= (uint8_t)(1u << (first % 8));
+        frame[second / 8] ^= (uint8_t)(1u << (second % 8));
+        
+        unsigned int corrupted_sum = 0;
+        for (size_t i = 0; i < sizeof(frame); i++) corrupted_sum += frame[i];
+        sum_missed += corrupted_sum == sum;
+        crc_missed += calculate_crc32c(frame, sizeof(frame)) == expected;
+    }
+    printf("2000 个双比特错误: 加法和漏检 %d, CRC-32C 漏检 %d\n", sum_missed, crc_missed);
+    test_assert(sum_missed > 0 && crc_missed == 0, "双比特错误：CRC-32C 全部发现");
+    
+    // 仿真信道的比特损坏模式
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.corruption_probability = 0.2;
+    config.corruption_bits = 3;
+    size_t length = 16 * 1024;
+    char* message = malloc(length + 1);
+    for (size_t i = 0; i < length; i++) message[i] = 'a' + i % 26;
+    message[length] = '\0';
+    
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 8;
+    arq.payload_size = 256;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    statistics_t stats;
+    init_statistics(&stats);
+    srand(401);
+    bool ok = transmit_message_arq(message, &config, &arq, &stats);
+    printf("损坏 %d 帧, 发现 %d, 漏检 %d, 重传 %d\n", stats.corrupted_frames,
+           stats.corruption_detected, stats.undetected_errors, stats.retransmissions);
+    test_assert(ok, "20%帧损坏下传输成功");
+    test_assert(stats.corrupted_frames > 0 && stats.corruption_detected == stats.corrupted_frames &&
+                stats.undetected_errors == 0, "所有损坏帧都被校验和发现并丢弃");
+    test_assert(stats.retransmissions > 0, "损坏帧通过重传恢复");
+    free(message);
+}
+
+/**
+ * 测试21: 多线程参数扫描
+ */
+void test_parameter_sweep(void) {
+    print_test_header("多线程参数扫描");
+    
+    sweep_config_t sweep;
+    init_sweep_config(&sweep);
+    sweep.losses[0] = 0.0;
+    sweep.losses[1] = 0.2;
+    sweep.loss_count = 2;
+    sweep.delays[0].min_ms = 20;
+    sweep.delays[0].max_ms = 60;
+    sweep.delay_count = 1;
+    sweep.windows[0] = 2;
+    sweep.windows[1] = 8;
+    sweep.window_count = 2;
+    sweep.replications = 6;
+    sweep.message_length = 4096;
+    sweep.seed = 410;
+    
+    int count = count_sweep_cells(&sweep);
+    test_assert(count == (1 + 2 + 2) * 2, "停等协议只占一列窗口，格数正确");
+    
+    sweep_cell_t* parallel = calloc(count, sizeof(sweep_cell_t));
+    sweep_cell_t* serial = calloc(count, sizeof(sweep_cell_t));
+    sweep.threads = 4;
+    bool ok = run_parameter_sweep(&sweep, parallel);
+    sweep.threads = 1;
+    ok &= run_parameter_sweep(&sweep, serial);
+    test_assert(ok, "参数扫描完成");
+    
+    bool same = true, all_succeeded = true, has_interval = true;
+    for (int i = 0; i < count; i++) {
+        same &= parallel[i].goodput_mean == serial[i].goodput_mean &&
+                parallel[i].efficiency_ci95 == serial[i].efficiency_ci95;
+        all_succeeded &= parallel[i].successes == sweep.replications;
+        if (parallel[i].loss_probability > 0) has_interval &= parallel[i].goodput_ci95 > 0;
+    }
+    test_assert(same, "结果只由种子决定，与线程数无关");
+    test_assert(all_succeeded, "所有重复都传输成功");
+    test_assert(has_interval, "有丢包时给出非零的置信区间");
+    
+    // 格的顺序：停等(2格)、回退N帧 窗口2(2格)、窗口8(2格)、选择重传 ...
+    const sweep_cell_t* gbn_small = &parallel[2];
+    const sweep_cell_t* gbn_large = &parallel[4];
+    test_assert(gbn_small->mode == ARQ_GO_BACK_N && gbn_large->window_size == 8 &&
+                gbn_large->goodput_mean > gbn_small->goodput_mean, "无丢包时大窗口吞吐量更高");
+    test_assert(parallel[1].goodput_mean < parallel[0].goodput_mean &&
+                parallel[1].efficiency_mean < parallel[0].efficiency_mean, "丢包降低吞吐量与信道效率");
+    
+    FILE* csv = tmpfile();
+    int lines = 0;
+    if (csv) {
+        write_sweep_csv(csv, parallel, count);
+        rewind(csv);
+        char line[256];
+        while (fgets(line, sizeof(line), csv)) lines++;
+        fclose(csv);
+    }
+    test_assert(lines == count + 1, "CSV每格一行，另有表头");
+    
+    sweep.replications = 0;
+    test_assert(run_parameter_sweep(&sweep, serial) == false, "无效的重复次数被拒绝");
+    free(parallel);
+    free(serial);
+}
+
+/**
+ * 测试22: 信道损伤模型（突发丢包、乱序、复制、瓶颈带宽）
+ */
+void test_channel_impairments(void) {
+    print_test_header("信道损伤模型");
+    
+    network_config_t config;
+    arq_config_t arq;
+    statistics_t stats;
+    
+    // Gilbert-Elliott：坏状态占比 0.05 / (0.05 + 0.3) ≈ 14%，坏状态丢包80%，总体约11%
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    config.burst_enter_probability = 0.05;
+    config.burst_exit_probability = 0.3;
+    config.burst_loss_probability = 0.8;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.payload_size = 256;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    memset(&stats, 0, sizeof(stats));
+    bool ok = simulate_arq_transfer(64 * 1024, &config, &arq, 420, &stats);
+    double loss_rate = (double)stats.frames_lost / (stats.frames_sent + stats.acks_sent);
+    printf("突发丢包: 丢失 %d / %d 帧 (%.1f%%)\n", stats.frames_lost,
+           stats.frames_sent + stats.acks_sent, loss_rate * 100);
+    test_assert(ok && loss_rate > 0.05 && loss_rate < 0.17, "突发模型的平均丢包率接近稳态值");
+    
+    // 乱序与复制：序列号空间要大于乱序帧在途期间发出的帧数
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    config.reorder_probability = 0.2;
+    config.reorder_delay_ms = 40;
+    config.duplicate_probability = 0.1;
+    arq_mode_t modes[2] = {ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT};
+    bool all_ok = true;
+    for (int i = 0; i < 2; i++) {
+        init_arq_config(&arq, modes[i]);
+        arq.seq_space = 64;
+        arq.payload_size = 256;
+        arq.verbose = false;
+        memset(&stats, 0, sizeof(stats));
+        all_ok &= simulate_arq_transfer(64 * 1024, &config, &arq, 421, &stats);
+        printf("%s: 乱序 %d, 网络复制 %d, 接收方冗余 %d\n", arq_mode_name(modes[i]),
+               stats.reordered_frames, stats.network_duplicates, stats.duplicate_frames);
+        all_ok &= stats.reordered_frames > 0 && stats.network_duplicates > 0;
+    }
+    test_assert(all_ok, "乱序与复制下两种协议都按序交付");
+    test_assert(stats.duplicate_frames > 0, "接收方识别出网络复制的帧");
+    
+    // 瓶颈链路：1 Mbit/s、单程20毫秒，窗口需要覆盖带宽时延积才能跑满链路
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 20;
+    config.max_delay_ms = 20;
+    config.bandwidth_bps = 1000000;
+    double goodput[2];
+    int windows[2] = {1, 16};
+    for (int i = 0; i < 2; i++) {
+        init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+        arq.window_size = windows[i];
+        arq.seq_space = 2 * windows[i];
+        arq.payload_size = 1000;
+        arq.verbose = false;
+        memset(&stats, 0, sizeof(stats));
+        all_ok &= simulate_arq_transfer(256 * 1024, &config, &arq, 422, &stats);
+        goodput[i] = stats.goodput_bps;
+        printf("窗口 %d: 有效吞吐量 %.0f kbit/s\n", windows[i], goodput[i] / 1000);
+    }
+    test_assert(all_ok && goodput[1] <= config.bandwidth_bps && goodput[1] > 0.8 * config.bandwidth_bps,
+                "窗口覆盖带宽时延积时吞吐量接近链路带宽");
+    test_assert(goodput[0] * 4 < goodput[1], "窗口1受往返时延限制");
+    
+    // 尾部丢弃：窗口远大于队列时发生队列丢包
+    config.queue_limit = 4;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.window_size = 32;
+    arq.seq_space = 33;
+    arq.payload_size = 1000;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    memset(&stats, 0, sizeof(stats));
+    ok = simulate_arq_transfer(64 * 1024, &config, &arq, 423, &stats);
+    printf("队列上限 4: 队列丢弃 %d, 重传 %d\n", stats.queue_drops, stats.retransmissions);
+    test_assert(ok && stats.queue_drops > 0 && stats.queue_drops <= stats.frames_lost,
+                "瓶颈队列满时尾部丢弃，重传后仍完整交付");
+    
+    // 信道槽位耗尽：每帧都被复制，多个会话的在途帧超过信道容量；没有槽位的副本不计入复制帧数
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 50;
+    config.max_delay_ms = 50;
+    config.duplicate_probability = 1.0;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 32;
+    arq.seq_space = 128;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    enum { FULL_SESSIONS = 8 };
+    statistics_t session_stats[FULL_SESSIONS];
+    memset(session_stats, 0, sizeof(session_stats));
+    mux_summary_t summary;
+    simulate_multiplexed_transfer(FULL_SESSIONS, 8 * 1024, &config, &arq, 424, session_stats, &summary);
+    long sent = 0, lost = 0, duplicates = 0;
+    for (int i = 0; i < FULL_SESSIONS; i++) {
+        sent += session_stats[i].frames_sent + session_stats[i].acks_sent + session_stats[i].naks_sent;
+        lost += session_stats[i].frames_lost;
+        duplicates += session_stats[i].network_duplicates;
+    }
+    printf("信道满: 发送 %ld, 丢弃 %ld, 网络复制 %ld\n", sent, lost, duplicates);
+    test_assert(lost > 0 && duplicates > 0 && duplicates <= sent - lost, "信道满时丢弃的副本不计入复制帧数");
+}
+
+/* 拥塞窗口跟踪记录 */
+typedef struct {
+    int changes;
+    double first_cwnd;
+    double last_time;
+    bool time_ordered;
+} cwnd_trace_t;
+
+static void record_cwnd(double time_ms, double cwnd, double ssthresh, void* context) {
+    cwnd_trace_t* trace = (cwnd_trace_t*)context;
+    (void)ssthresh;
+    if (trace->changes++ == 0) trace->first_cwnd = cwnd;
+    if (time_ms < trace->last_time) trace->time_ordered = false;
+    trace->last_time = time_ms;
+}
+
+/**
+ * 测试23: AIMD拥塞控制
+ */
+void test_congestion_control(void) {
+    print_test_header("AIMD拥塞控制");
+    
+    network_config_t config;
+    arq_config_t arq;
+    statistics_t stats;
+    cwnd_trace_t trace;
+    
+    // 无丢包：慢启动把拥塞窗口开到窗口大小，不发生减窗
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 20;
+    config.max_delay_ms = 20;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 32;
+    arq.seq_space = 64;
+    arq.verbose = false;
+    arq.congestion_control = true;
+    arq.cwnd_trace = record_cwnd;
+    arq.cwnd_trace_context = &trace;
+    memset(&trace, 0, sizeof(trace));
+    trace.time_ordered = true;
+    memset(&stats, 0, sizeof(stats));
+    bool ok = simulate_arq_transfer(32 * 1024, &config, &arq, 430, &stats);
+    printf("无丢包: 拥塞窗口变化 %d 次, 最大 %.1f, 平均 %.1f\n", trace.changes, stats.cwnd_max, stats.cwnd_mean);
+    test_assert(ok && trace.first_cwnd == CWND_INITIAL && stats.cwnd_max == arq.window_size,
+                "慢启动从初始窗口增长到窗口大小");
+    test_assert(stats.cwnd_reductions == 0 && stats.fast_retransmits == 0 && trace.time_ordered,
+                "无丢包时不减窗，跟踪回调按时间顺序调用");
+    
+    // 瓶颈队列：固定的大窗口持续溢出队列，拥塞控制把在途帧数压到队列能容纳的范围
+    config.bandwidth_bps = 1000000;
+    config.queue_limit = 8;
+    double goodput[2];
+    int drops[2];
+    for (int i = 0; i < 2; i++) {
+        init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+        arq.window_size = 64;
+        arq.seq_space = 128;
+        arq.payload_size = 1000;
+        arq.max_retries = 30;
+        arq.verbose = false;
+        arq.congestion_control = (i == 1);
+        memset(&stats, 0, sizeof(stats));
+        ok &= simulate_arq_transfer(256 * 1024, &config, &arq, 431, &stats);
+        goodput[i] = stats.goodput_bps;
+        drops[i] = stats.queue_drops;
+        printf("%s: 有效吞吐量 %.0f kbit/s, 队列丢弃 %d, 减窗 %d 次\n", i ? "AIMD" : "固定窗口",
+               goodput[i] / 1000, drops[i], stats.cwnd_reductions);
+    }
+    test_assert(ok && goodput[1] > 2 * goodput[0] && drops[1] * 4 < drops[0],
+                "瓶颈链路上拥塞控制减少队列丢弃、提高吞吐量");
+    
+    // 随机丢包：重复确认触发快速重传，不必等待超时
+    init_network_config(&config);
+    config.loss_probability = 0.03;
+    config.min_delay_ms = 20;
+    config.max_delay_ms = 20;
+    arq_mode_t modes[2] = {ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT};
+    bool all_ok = true;
+    for (int i = 0; i < 2; i++) {
+        init_arq_config(&arq, modes[i]);
+        arq.window_size = 32;
+        arq.seq_space = 64;
+        arq.max_retries = 30;
+        arq.verbose = false;
+        arq.congestion_control = true;
+        memset(&stats, 0, sizeof(stats));
+        all_ok &= simulate_arq_transfer(64 * 1024, &config, &arq, 432, &stats);
+        printf("%s: 快速重传 %d 次, 超时 %d 次, 平均拥塞窗口 %.1f\n", arq_mode_name(modes[i]),
+               stats.fast_retransmits, stats.timeouts, stats.cwnd_mean);
+        all_ok &= stats.fast_retransmits > 0 && stats.cwnd_mean >= 1 && stats.cwnd_mean < arq.window_size;
+    }
+    test_assert(all_ok, "重复确认触发快速重传与快速恢复");
+}
+
+/**
+ * 测试24: 全双工传输与捎带确认
+ */
+void test_duplex_piggyback(void) {
+    print_test_header("全双工捎带确认");
+    
+    // 线路格式：捎带的确认号与SACK位图随数据帧编码
+    data_frame_t frame, decoded;
+    ack_frame_t unused;
+    uint8_t packet[WIRE_MAX_DATA_FRAME];
+    create_data_frame(&frame, 7, "duplex", 6);
+    size_t plain_length = encode_data_frame(&frame, packet, sizeof(packet));
+    frame.ack_num = 300;
+    frame.sack_bitmap = 0x5;
+    size_t piggyback_length = encode_data_frame(&frame, packet, sizeof(packet));
+    test_assert(piggyback_length == plain_length + 3 &&
+                decode_frame(packet, piggyback_length, &decoded, &unused) == DATA_FRAME &&
+                decoded.ack_num == 300 && decoded.sack_bitmap == 0x5 && decoded.seq_num == 7 &&
+                memcmp(decoded.data, "duplex", 6) == 0,
+                "捎带确认只多占确认号与位图的 varint 字节");
+    frame.ack_num = -1;
+    frame.sack_bitmap = 0;
+    encode_data_frame(&frame, packet, sizeof(packet));
+    test_assert(decode_frame(packet, plain_length, &decoded, &unused) == DATA_FRAME && decoded.ack_num == -1,
+                "不捎带时解码为 -1");
+    
+    // 双向等量数据：捎带确认省去大部分独立确认帧
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 8;
+    arq.seq_space = 16;
+    arq.sack = true;
+    arq.verbose = false;
+    statistics_t forward[2], reverse[2];
+    int frames[2];
+    bool ok = true;
+    for (int i = 0; i < 2; i++) {
+        arq.piggyback_delay_ms = (i == 0) ? 0 : ARQ_PIGGYBACK_DELAY_MS;
+        memset(&forward[i], 0, sizeof(statistics_t));
+        memset(&reverse[i], 0, sizeof(statistics_t));
+        ok &= simulate_duplex_transfer(32 * 1024, 32 * 1024, &config, &arq, 440, &forward[i], &reverse[i]);
+        frames[i] = forward[i].frames_sent + forward[i].acks_sent + reverse[i].frames_sent + reverse[i].acks_sent;
+        printf("捎带等待 %d 毫秒: 总帧数 %d, 独立确认 %d, 捎带确认 %d\n", arq.piggyback_delay_ms, frames[i],
+               forward[i].acks_sent + reverse[i].acks_sent,
+               forward[i].piggybacked_acks + reverse[i].piggybacked_acks);
+    }
+    test_assert(ok && forward[0].bytes_delivered == 32 * 1024 && reverse[0].bytes_delivered == 32 * 1024,
+                "两个方向同时完整交付");
+    test_assert(forward[0].piggybacked_acks == 0 && frames[1] * 10 < frames[0] * 6,
+                "捎带确认使总帧数减少40%以上");
+    test_assert(forward[1].piggybacked_acks + forward[1].acks_sent >= forward[1].frames_sent / 2,
+                "省去的帧数计入统计");
+    
+    // 有丢包时三种接收方都能正确处理捎带的确认
+    config.loss_probability = 0.1;
+    arq_mode_t modes[3] = {ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT, ARQ_SELECTIVE_REPEAT};
+    bool all_ok = true;
+    for (int i = 0; i < 3; i++) {
+        init_arq_config(&arq, modes[i]);
+        arq.window_size = 8;
+        arq.seq_space = 16;
+        arq.sack = (i == 2);
+        arq.max_retries = 30;
+        arq.verbose = false;
+        memset(&forward[0], 0, sizeof(statistics_t));
+        memset(&reverse[0], 0, sizeof(statistics_t));
+        all_ok &= simulate_duplex_transfer(8 * 1024, 8 * 1024, &config, &arq, 441 + i, &forward[0], &reverse[0]);
+        all_ok &= forward[0].piggybacked_acks > 0 && reverse[0].piggybacked_acks > 0;
+    }
+    test_assert(all_ok, "丢包下回退N帧、选择重传与SACK的全双工传输都成功");
+    
+    // 反向没有数据：捎带等待到期后回退为独立确认帧
+    config.loss_probability = 0.0;
+    memset(&forward[0], 0, sizeof(statistics_t));
+    memset(&reverse[0], 0, sizeof(statistics_t));
+    ok = simulate_duplex_transfer(4 * 1024, 0, &config, &arq, 444, &forward[0], &reverse[0]);
+    test_assert(ok && forward[0].piggybacked_acks == 0 && forward[0].acks_sent > 0 && reverse[0].frames_sent == 0,
+                "没有反向数据时确认在等待到期后单独发送");
+}
+
+/**
+ * 测试25: 延迟确认与确认合并
+ */
+void test_delayed_ack(void) {
+    print_test_header("延迟确认");
+    
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.0;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.window_size = 8;
+    arq.seq_space = 9;
+    arq.verbose = false;
+    test_assert(arq.ack_every == 1 && arq.ack_delay_ms == ARQ_ACK_DELAY_MS, "默认逐帧确认");
+    
+    // 无丢包：每 k 帧一个确认，吞吐量基本不变
+    statistics_t stats[3];
+    int every[3] = {1, 2, 4};
+    bool ok = true;
+    for (int i = 0; i < 3; i++) {
+        arq.ack_every = every[i];
+        memset(&stats[i], 0, sizeof(statistics_t));
+        ok &= simulate_arq_transfer(16 * 1024, &config, &arq, 450, &stats[i]);
+        printf("每 %d 帧确认: 确认帧 %d / 数据帧 %d, 合并 %d, 吞吐量 %.2f kbit/s\n", every[i],
+               stats[i].acks_sent, stats[i].frames_received, stats[i].coalesced_acks, stats[i].goodput_bps / 1000.0);
+    }
+    test_assert(ok, "延迟确认下传输成功");
+    test_assert(stats[0].acks_sent == stats[0].frames_received && stats[0].coalesced_acks == 0,
+                "逐帧确认时每个数据帧一个确认");
+    test_assert(stats[1].acks_sent <= stats[0].acks_sent / 2 + 1 && stats[2].acks_sent <= stats[0].acks_sent / 4 + 1,
+                "每 k 帧确认使确认帧减少到约 1/k");
+    test_assert(stats[2].acks_sent + stats[2].coalesced_acks == stats[2].frames_received,
+                "每个数据帧的确认要么发出，要么被合并");
+    test_assert(stats[2].goodput_bps > stats[0].goodput_bps * 0.9, "无丢包时吞吐量下降不超过10%");
+    
+    // k 大于窗口：发送方发完一窗后停下，等待计时器到期的确认推动传输
+    arq.ack_every = 16;
+    arq.ack_delay_ms = 20;
+    memset(&stats[0], 0, sizeof(statistics_t));
+    ok = simulate_arq_transfer(4 * 1024, &config, &arq, 451, &stats[0]);
+    test_assert(ok && stats[0].acks_sent > 0 && stats[0].acks_sent < stats[0].frames_received / 4,
+                "凑不满 k 帧时确认在等待到期后发出");
+    
+    // 有丢包：失序帧立即确认，回退N帧与SACK仍能完成
+    config.loss_probability = 0.1;
+    arq_mode_t modes[2] = {ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT};
+    bool lossy_ok = true, immediate = true;
+    for (int i = 0; i < 2; i++) {
+        init_arq_config(&arq, modes[i]);
+        arq.window_size = 8;
+        arq.seq_space = 16;
+        arq.sack = (modes[i] == ARQ_SELECTIVE_REPEAT);
+        arq.max_retries = 30;
+        arq.verbose = false;
+        arq.ack_every = 4;
+        memset(&stats[0], 0, sizeof(statistics_t));
+        lossy_ok &= simulate_arq_transfer(16 * 1024, &config, &arq, 452 + i, &stats[0]);
+        // 空缺期间每个帧都立即确认，确认帧明显多于 1/4
+        immediate &= stats[0].acks_sent * 4 > stats[0].frames_received + stats[0].frames_received / 10;
+    }
+    test_assert(lossy_ok, "10%丢包下回退N帧与SACK的延迟确认传输成功");
+    test_assert(immediate, "失序与填补空缺的帧立即确认");
+    
+    // 选择重传的单帧确认不能合并，延迟确认不起作用
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.verbose = false;
+    arq.ack_every = 4;
+    config.loss_probability = 0.0;
+    memset(&stats[0], 0, sizeof(statistics_t));
+    ok = simulate_arq_transfer(4 * 1024, &config, &arq, 454, &stats[0]);
+    test_assert(ok && stats[0].acks_sent == stats[0].frames_received, "选择重传仍逐帧确认");
+    arq.ack_every = 0;
+    test_assert(!validate_arq_config(&arq), "确认间隔为0被拒绝");
+    
+    // 参数扫描：确认间隔作为一个维度，输出确认帧数
+    sweep_config_t sweep;
+    init_sweep_config(&sweep);
+    sweep.losses[0] = 0.0;
+    sweep.loss_count = 1;
+    sweep.delays[0].min_ms = 10;
+    sweep.delays[0].max_ms = 30;
+    sweep.delay_count = 1;
+    sweep.windows[0] = 8;
+    sweep.window_count = 1;
+    sweep.modes[0] = ARQ_GO_BACK_N;
+    sweep.mode_count = 1;
+    sweep.ack_every[0] = 1;
+    sweep.ack_every[1] = 4;
+    sweep.ack_count = 2;
+    sweep.replications = 4;
+    sweep.message_length = 4096;
+    sweep_cell_t cells[2];
+    test_assert(count_sweep_cells(&sweep) == 2 && run_parameter_sweep(&sweep, cells) &&
+                cells[0].ack_every == 1 && cells[1].ack_every == 4 &&
+                cells[0].acks_per_frame_mean > 0.99 && cells[1].acks_per_frame_mean < 0.3 &&
+                cells[1].acks_mean < cells[0].acks_mean / 3,
+                "扫描结果给出每个确认间隔的确认帧数");
+}
+
+/**
+ * 测试26: 否定确认与重复确认快速重传
+ */
+void test_nak_fast_retransmit(void) {
+    print_test_header("否定确认与快速重传");
+    
+    // 线路格式：否定确认与确认帧格式相同，只有类型不同
+    ack_frame_t nak, decoded;
+    data_frame_t unused;
+    uint8_t packet[WIRE_MAX_ACK_FRAME];
+    create_ack_frame(&nak, 5);
+    nak.type = NAK_FRAME;
+    size_t length = encode_ack_frame(&nak, packet, sizeof(packet));
+    test_assert(decode_frame(packet, length, &unused, &decoded) == NAK_FRAME &&
+                decoded.type == NAK_FRAME && decoded.ack_num == 5, "否定确认帧编解码");
+    
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.05;
+    config.min_delay_ms = 40;
+    config.max_delay_ms = 60;
+    
+    // 回退N帧与SACK：丢失的帧不等超时即被重传，超时次数与耗时都减少
+    arq_mode_t modes[2] = {ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT};
+    const char* names[2] = {"回退N帧", "选择重传+SACK"};
+    bool ok = true, fewer_timeouts = true, faster = true, triggered = true;
+    for (int m = 0; m < 2; m++) {
+        statistics_t stats[2];
+        for (int i = 0; i < 2; i++) {
+            arq_config_t arq;
+            init_arq_config(&arq, modes[m]);
+            arq.window_size = 8;
+            arq.seq_space = 16;
+            arq.sack = (m == 1);
+            arq.max_retries = 30;
+            arq.verbose = false;
+            arq.nak = (i == 1);
+            arq.fast_retransmit = (i == 1);
+            memset(&stats[i], 0, sizeof(statistics_t));
+            ok &= simulate_arq_transfer(32 * 1024, &config, &arq, 460 + m, &stats[i]);
+            printf("%s%s: 耗时 %.0f ms, 超时 %d, 否定确认 %d, NAK重传 %d, 快速重传 %d\n", names[m],
+                   i ? "+NAK" : "", stats[i].elapsed_ms, stats[i].timeouts, stats[i].naks_sent,
+                   stats[i].nak_retransmits, stats[i].fast_retransmits);
+        }
+        fewer_timeouts &= stats[1].timeouts * 10 < stats[0].timeouts * 6;
+        faster &= stats[1].elapsed_ms < stats[0].elapsed_ms;
+        triggered &= stats[0].naks_sent == 0 && stats[1].naks_sent > 0 && stats[1].nak_retransmits > 0;
+    }
+    test_assert(ok, "启用否定确认后传输仍然正确");
+    test_assert(triggered, "接收方发现空缺时发出否定确认，发送方立即重传");
+    test_assert(fewer_timeouts, "超时次数减少40%以上");
+    test_assert(faster, "丢失的帧约一个RTT内恢复，总耗时缩短");
+    
+    // 校验和错误也触发否定确认
+    config.loss_probability = 0.0;
+    config.corruption_probability = 0.05;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.sack = true;
+    arq.nak = true;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    statistics_t stats;
+    memset(&stats, 0, sizeof(statistics_t));
+    ok = simulate_arq_transfer(16 * 1024, &config, &arq, 462, &stats);
+    test_assert(ok && stats.corruption_detected > 0 && stats.naks_sent > 0, "校验和错误时发出否定确认");
+    
+    // 未启用拥塞控制时，第3个重复确认触发快速重传（每个丢失帧至多一次）
+    config.corruption_probability = 0.0;
+    config.loss_probability = 0.05;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.max_retries = 30;
+    arq.verbose = false;
+    arq.fast_retransmit = true;
+    memset(&stats, 0, sizeof(statistics_t));
+    ok = simulate_arq_transfer(16 * 1024, &config, &arq, 463, &stats);
+    test_assert(ok && stats.fast_retransmits > 0 && stats.naks_sent == 0 &&
+                stats.fast_retransmits <= stats.frames_lost, "重复确认触发快速重传");
+}
+
+/**
+ * 测试帧池与零复制的帧传递
+ */
+void test_frame_pool(void) {
+    print_test_header("帧池与零复制帧传递");
+    
+    // 引用计数：最后一个引用释放时帧回到空闲栈，耗尽时返回空句柄
+    frame_pool_t pool;
+    test_assert(init_frame_pool(&pool, 3), "帧池初始化");
+    int a = acquire_frame(&pool);
+    int b = acquire_frame(&pool);
+    int c = acquire_frame(&pool);
+    test_assert(a != b && b != c && a != c && acquire_frame(&pool) == FRAME_NONE, "帧池耗尽时返回空句柄");
+    retain_frame(&pool, b);
+    release_frame(&pool, b);
+    test_assert(frames_in_use(&pool) == 3, "仍有引用的帧不回收");
+    release_frame(&pool, b);
+    release_frame(&pool, FRAME_NONE);
+    test_assert(frames_in_use(&pool) == 2 && acquire_frame(&pool) == b, "引用归零后帧可再次取用");
+    test_assert(pool.peak_in_use == 3, "记录在用帧数峰值");
+    free_frame_pool(&pool);
+    
+    // 报头与载荷分开编码：校验和与完整报文的尾部校验和相同
+    data_frame_t frame, decoded;
+    ack_frame_t unused;
+    uint8_t packet[WIRE_MAX_DATA_FRAME];
+    uint8_t header[WIRE_MAX_DATA_HEADER];
+    create_data_frame(&frame, 300, "zero copy payload", 17);
+    frame.ack_num = 7;
+    frame.sack_bitmap = 0x5;
+    size_t length = encode_data_frame(&frame, packet, sizeof(packet));
+    size_t header_length = encode_data_header(&frame, header);
+    uint32_t checksum = calculate_wire_checksum(header, header_length, frame.data, frame.data_length);
+    uint32_t trailer = packet[length - 4] | (uint32_t)packet[length - 3] << 8 |
+                       (uint32_t)packet[length - 2] << 16 | (uint32_t)packet[length - 1] << 24;
+    test_assert(length == header_length + 17 + WIRE_TRAILER && memcmp(packet, header, header_length) == 0 &&
+                checksum == trailer, "分开计算的报头与校验和与完整报文一致");
+    wire_data_header_t fields;
+    test_assert(decode_data_header(header, header_length, &fields) == header_length &&
+                fields.seq_num == 300 && fields.data_length == 17 && fields.ack_num == 7 &&
+                fields.sack_bitmap == 0x5, "报头解码");
+    test_assert(decode_frame(packet, length, &decoded, &unused) == DATA_FRAME &&
+                memcmp(decoded.data, "zero copy payload", 17) == 0, "完整报文解码");
+    
+    // 信道引用帧池中的帧：复制、乱序与损坏（损坏时复制出私有副本）都不影响发送窗口中的原帧
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.03;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    config.duplicate_probability = 0.05;
+    config.reorder_probability = 0.05;
+    config.reorder_delay_ms = 20;
+    config.corruption_probability = 0.05;
+    arq_mode_t modes[2] = {ARQ_GO_BACK_N, ARQ_SELECTIVE_REPEAT};
+    bool ok = true, bounded = true;
+    for (int m = 0; m < 2; m++) {
+        arq_config_t arq;
+        init_arq_config(&arq, modes[m]);
+        arq.window_size = 16;
+        arq.seq_space = 64;     // 乱序到达的旧帧可能晚于一个窗口，序列号空间取 4N 避免歧义
+        arq.max_retries = 30;
+        arq.verbose = false;
+        statistics_t stats;
+        memset(&stats, 0, sizeof(statistics_t));
+        ok &= simulate_arq_transfer(64 * 1024, &config, &arq, 470 + m, &stats);
+        printf("%s: 损坏 %d 帧, 复制 %d 帧, 帧池峰值 %d\n", arq_mode_name(modes[m]),
+               stats.corrupted_frames, stats.network_duplicates, stats.pool_frames_peak);
+        bounded &= stats.pool_frames_peak > 0 && stats.pool_frames_peak <= 2 * arq.window_size + CHANNEL_CAPACITY + 1;
+    }
+    test_assert(ok, "有损信道上的传输数据完整");
+    test_assert(bounded, "在用帧数不超过窗口与信道容量之和");
+    
+    // 全双工：两个方向共用帧池，捎带确认的报头每次发送单独编码
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 8;
+    arq.seq_space = 32;
+    arq.sack = true;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    statistics_t forward, reverse;
+    memset(&forward, 0, sizeof(statistics_t));
+    memset(&reverse, 0, sizeof(statistics_t));
+    ok = simulate_duplex_transfer(32 * 1024, 24 * 1024, &config, &arq, 472, &forward, &reverse);
+    test_assert(ok && forward.piggybacked_acks + reverse.piggybacked_acks > 0, "全双工共用帧池传输正确");
+}
+
+/**
+ * 测试28: 多路复用会话
+ */
+void test_multiplexed_sessions(void) {
+    print_test_header("多路复用会话与公平性");
+    
+    // 会话表：连接号 → 会话，插入超过初始容量时扩容，重复的连接号被拒绝
+    session_table_t table;
+    int values[100];
+    test_assert(init_session_table(&table, 4), "会话表初始化");
+    bool inserted = true;
+    for (int i = 0; i < 100; i++) inserted &= insert_session(&table, (uint32_t)i * 7919u, &values[i]);
+    bool found = true;
+    for (int i = 0; i < 100; i++) found &= find_session(&table, (uint32_t)i * 7919u) == &values[i];
+    test_assert(inserted && found && table.count == 100, "插入与查找100个会话（含连接号0与扩容）");
+    test_assert(!insert_session(&table, 7919u, &values[0]) && find_session(&table, 5) == NULL,
+                "重复连接号被拒绝，未知连接号查不到");
+    free_session_table(&table);
+    
+    // 连接号编码在报头中：连接号为0时报文与单会话格式逐字节相同
+    data_frame_t frame, decoded;
+    ack_frame_t ack, decoded_ack;
+    uint8_t plain[WIRE_MAX_DATA_FRAME], tagged[WIRE_MAX_DATA_FRAME];
+    create_data_frame(&frame, 42, "mux", 3);
+    size_t plain_length = encode_data_frame(&frame, plain, sizeof(plain));
+    frame.conn_id = 300;
+    size_t tagged_length = encode_data_frame(&frame, tagged, sizeof(tagged));
+    uint32_t conn_id = 0;
+    test_assert(plain_length > 0 && (plain[1] & WIRE_FLAG_CONN) == 0 && tagged_length == plain_length + 2,
+                "连接号0不占报头字节，非0时按变长整数编码");
+    test_assert(decode_frame(tagged, tagged_length, &decoded, &decoded_ack) == DATA_FRAME &&
+                decoded.conn_id == 300 && decoded.seq_num == 42 &&
+                peek_connection_id(tagged, tagged_length, &conn_id) && conn_id == 300, "数据帧连接号往返");
+    memset(&ack, 0, sizeof(ack));
+    ack.type = ACK_FRAME;
+    ack.ack_num = 9;
+    ack.conn_id = 123456;
+    size_t ack_length = encode_ack_frame(&ack, tagged, sizeof(tagged));
+    test_assert(decode_frame(tagged, ack_length, NULL, &decoded_ack) == ACK_FRAME &&
+                decoded_ack.conn_id == 123456 && decoded_ack.ack_num == 9, "确认帧连接号往返");
+    
+    // Jain 指数
+    double equal[4] = {5, 5, 5, 5};
+    double single[4] = {8, 0, 0, 0};
+    test_assert(calculate_jain_index(equal, 4) > 0.9999 && calculate_jain_index(single, 4) < 0.2501 &&
+                calculate_jain_index(single, 4) > 0.2499, "Jain指数：均分为1，独占为1/n");
+    
+    // 200个会话共用一条带宽受限的瓶颈链路
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.01;
+    config.min_delay_ms = 20;
+    config.max_delay_ms = 40;
+    config.bandwidth_bps = 20000000;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.window_size = 8;
+    arq.seq_space = 9;
+    arq.payload_size = 512;
+    arq.congestion_control = true;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    int sessions = 200;
+    statistics_t* stats = calloc((size_t)sessions, sizeof(statistics_t));
+    mux_summary_t summary;
+    bool ok = simulate_multiplexed_transfer(sessions, 16384, &config, &arq, 480, stats, &summary);
+    print_mux_summary(&summary);
+    bool delivered = true;
+    for (int i = 0; i < sessions; i++) delivered &= stats[i].bytes_delivered == 16384;
+    test_assert(ok && summary.completed == sessions && delivered, "200个会话全部完整交付");
+    test_assert(summary.bytes_delivered == 16384L * sessions && summary.aggregate_goodput_bps > 0 &&
+                summary.min_goodput_bps <= summary.mean_goodput_bps &&
+                summary.mean_goodput_bps <= summary.max_goodput_bps, "汇总交付字节与吞吐量");
+    test_assert(summary.jain_index > 1.0 / sessions && summary.jain_index <= 1.0, "公平性指数在 (1/n, 1] 内");
+    test_assert(stats[0].pool_frames_peak > 2 * arq.window_size, "各会话共用帧池");
+    
+    // 同一种子结果可复现
+    statistics_t* again = calloc((size_t)sessions, sizeof(statistics_t));
+    mux_summary_t repeat;
+    simulate_multiplexed_transfer(sessions, 16384, &config, &arq, 480, again, &repeat);
+    test_assert(repeat.elapsed_ms == summary.elapsed_ms && again[7].frames_sent == stats[7].frames_sent,
+                "同一种子的多路复用仿真可复现");
+    free(again);
+    free(stats);
+    
+    // 多个会话共用一对UDP端点，报文按连接号分到各自的会话
+    transport_t sender_side, receiver_side;
+    if (open_udp_transport_pair(&sender_side, &receiver_side)) {
+        init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+        arq.window_size = 8;
+        arq.seq_space = 16;
+        arq.timeout_ms = 50;
+        arq.verbose = false;
+        enum { UDP_SESSIONS = 16 };
+        lcg_stream_t sources[UDP_SESSIONS], sinks[UDP_SESSIONS];
+        statistics_t udp_stats[UDP_SESSIONS];
+        arq_direction_t directions[UDP_SESSIONS];
+        for (int i = 0; i < UDP_SESSIONS; i++) {
+            memset(&sources[i], 0, sizeof(lcg_stream_t));
+            memset(&sinks[i], 0, sizeof(lcg_stream_t));
+            sources[i].total = sinks[i].total = 16384 + 1000 * (size_t)i;
+            sources[i].source_state = sinks[i].sink_state = 500 + (uint32_t)i;
+            init_statistics(&udp_stats[i]);
+            directions[i] = (arq_direction_t){ lcg_stream_source, &sources[i], lcg_stream_sink, &sinks[i],
+                                               &udp_stats[i] };
+        }
+        ok = transmit_multiplexed_transport(directions, UDP_SESSIONS, &sender_side, &receiver_side, &arq, &summary);
+        print_mux_summary(&summary);
+        delivered = true;
+        for (int i = 0; i < UDP_SESSIONS; i++) {
+            delivered &= sinks[i].consumed == sources[i].total && !sinks[i].corrupted &&
+                         udp_stats[i].bytes_delivered == (long)sources[i].total;
+        }
+        test_assert(ok && delivered && summary.completed == UDP_SESSIONS, "16个会话经同一UDP端点各自完整交付");
+        close_transport(&sender_side);
+        close_transport(&receiver_side);
+    }
+}
+
+/**
+ * 其他线程写入跟踪记录，读出自己的记录条数
+ * @param arg 记录条数（int*），线程结束时改为读出的条数
+ * @return NULL
+ */
+static void* trace_writer_thread(void* arg) {
+    int* count = (int*)arg;
+    for (int i = 0; i < *count; i++) {
+        record_trace_event(TRACE_DATA_SEND, i, 99, i, 1);
+    }
+    trace_record_t records[16];
+    *count = (int)read_trace_records(records, 16);
+    return NULL;
+}
+
+/**
+ * 测试29: 二进制事件跟踪
+ */
+void test_trace_ring(void) {
+    print_test_header("二进制事件跟踪环形缓冲区");
+    
+    // 默认级别只记录二进制事件；关闭后不记录
+    test_assert(get_trace_level() == TRACE_LEVEL_EVENTS, "默认跟踪级别为二进制事件");
+    trace_record_t* records = malloc(sizeof(trace_record_t) * TRACE_RING_CAPACITY);
+    clear_trace_records();
+    set_trace_level(TRACE_LEVEL_OFF);
+    record_trace_event(TRACE_TIMEOUT, 1.0, 0, 1, 0);
+    test_assert(read_trace_records(records, TRACE_RING_CAPACITY) == 0, "关闭跟踪时不记录事件");
+    set_trace_level((trace_level_t)7);
+    test_assert(get_trace_level() == TRACE_LEVEL_OFF, "无效的跟踪级别被忽略");
+    set_trace_level(TRACE_LEVEL_EVENTS);
+    
+    // 仿真传输的事件带虚拟时间戳，按时间先后写入
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.1;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_GO_BACK_N);
+    arq.window_size = 4;
+    arq.verbose = true;     // 文字说明只在 TRACE_LEVEL_TEXT 级别输出，这里不应打印
+    statistics_t stats;
+    memset(&stats, 0, sizeof(statistics_t));
+    clear_trace_records();
+    bool ok = simulate_arq_transfer(8 * 1024, &config, &arq, 490, &stats);
+    size_t count = read_trace_records(records, TRACE_RING_CAPACITY);
+    int counts[TRACE_EVENT_TYPES] = {0};
+    bool ordered = true;
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].type < TRACE_EVENT_TYPES) counts[records[i].type]++;
+        if (i > 0 && records[i].time_ms < records[i - 1].time_ms) ordered = false;
+    }
+    printf("记录 %zu 条: 发送数据 %d, 接收确认 %d, 帧丢失 %d, 重传 %d\n", count, counts[TRACE_DATA_SEND],
+           counts[TRACE_ACK_RECEIVE], counts[TRACE_FRAME_LOST], counts[TRACE_RETRANSMIT]);
+    test_assert(ok && counts[TRACE_DATA_SEND] == stats.frames_sent && counts[TRACE_ACK_SEND] == stats.acks_sent,
+                "发送数据与发送确认的事件数与统计一致");
+    test_assert(counts[TRACE_RETRANSMIT] == stats.retransmissions && counts[TRACE_TIMEOUT] == stats.timeouts,
+                "重传与超时的事件数与统计一致");
+    test_assert(ordered && count > 0 && records[count - 1].time_ms <= stats.elapsed_ms,
+                "事件按虚拟时间先后记录");
+    
+    // 写满后覆盖最旧的记录，读出最近的容量条
+    clear_trace_records();
+    for (int i = 0; i < TRACE_RING_CAPACITY + 100; i++) {
+        record_trace_event(TRACE_DATA_SEND, i, 0, i, 0);
+    }
+    count = read_trace_records(records, TRACE_RING_CAPACITY);
+    test_assert(count == TRACE_RING_CAPACITY && records[0].seq == 100 &&
+                records[count - 1].seq == TRACE_RING_CAPACITY + 99, "环形缓冲区保留最近的记录");
+    test_assert(read_trace_records(records, 10) == 10 && records[9].seq == TRACE_RING_CAPACITY + 99,
+                "输出数组较小时读出最新的记录");
+    
+    // 每个线程写自己的缓冲区；导出时包含全部线程的记录
+    int thread_count = 5;
+    pthread_t thread;
+    bool joined = pthread_create(&thread, NULL, trace_writer_thread, &thread_count) == 0 &&
+                  pthread_join(thread, NULL) == 0;
+    test_assert(joined && thread_count == 5, "其他线程只读出自己写入的记录");
+    test_assert(read_trace_records(records, TRACE_RING_CAPACITY) == TRACE_RING_CAPACITY,
+                "其他线程的写入不影响本线程的缓冲区");
+    FILE* output = tmpfile();
+    size_t dumped = output ? dump_trace_records(output) : 0;
+    test_assert(dumped >= TRACE_RING_CAPACITY + 5, "按需导出全部线程的记录");
+    if (output) fclose(output);
+    test_assert(strcmp(trace_event_name(TRACE_RETRANSMIT), "重传") == 0 &&
+                strcmp(trace_event_name(999), "未知") == 0, "事件类型名称");
+    
+    clear_trace_records();
+    test_assert(read_trace_records(records, TRACE_RING_CAPACITY) == 0, "清空本线程的记录");
+    free(records);
+}
+
+/**
+ * 测试30: pcapng 报文导出
+ */
+void test_pcapng_export(void) {
+    print_test_header("pcapng 报文导出");
+    
+    // 每个进入信道的数据帧、确认帧与否定确认帧写成一个报文
+    const char* path = "test_sliding_window.pcapng";
+    network_config_t config;
+    init_network_config(&config);
+    config.loss_probability = 0.1;
+    config.min_delay_ms = 10;
+    config.max_delay_ms = 30;
+    config.corruption_probability = 0.02;
+    arq_config_t arq;
+    init_arq_config(&arq, ARQ_SELECTIVE_REPEAT);
+    arq.window_size = 8;
+    arq.seq_space = 16;
+    arq.nak = true;
+    arq.max_retries = 30;
+    arq.verbose = false;
+    pcapng_writer_t writer;
+    test_assert(open_pcapng_writer(&writer, path), "创建抓包文件");
+    arq.capture = capture_pcapng_packet;
+    arq.capture_context = &writer;
+    statistics_t stats;
+    memset(&stats, 0, sizeof(statistics_t));
+    bool ok = simulate_arq_transfer(256 * 1024, &config, &arq, 495, &stats);
+    long packets = writer.packets;
+    long long file_bytes = writer.file_bytes;
+    test_assert(close_pcapng_writer(&writer), "写入并关闭抓包文件");
+    test_assert(ok && packets == stats.frames_sent + stats.acks_sent + stats.naks_sent && stats.naks_sent > 0,
+                "数据帧、确认帧与否定确认帧各写入一个报文");
+    
+    // 读回文件：节头块与接口描述块之后是逐个增强报文块，报文为 IPv4/UDP 封装的线路格式
+    FILE* file = fopen(path, "rb");
+    long long size = 0;
+    long blocks = 0, decoded = 0, data_frames = 0;
+    bool valid = file != NULL, ordered = true;
+    double last_ms = -1.0, last_data_ms = 0.0;
+    uint8_t block[PCAPNG_IP_HEADER + PCAPNG_UDP_HEADER + WIRE_MAX_DATA_FRAME + 64];
+    while (valid) {
+        uint32_t head[2];
+        if (fread(head, sizeof(uint32_t), 2, file) != 2) break;
+        valid = head[1] >= 12 && head[1] % 4 == 0 && head[1] <= sizeof(block);
+        if (!valid || fread(block + 8, 1, head[1] - 8, file) != head[1] - 8) break;
+        size += head[1];
+        uint32_t tail;
+        memcpy(&tail, block + head[1] - 4, 4);
+        valid = tail == head[1];
+        if (blocks++ == 0) {
+            uint32_t magic;
+            memcpy(&magic, block + 8, 4);
+            valid &= head[0] == 0x0A0D0D0Au && magic == 0x1A2B3C4Du;
+            continue;
+        }
+        if (head[0] != 6) continue;
+        uint32_t fields[5];
+        memcpy(fields, block + 8, sizeof(fields));
+        double time_ms = ((uint64_t)fields[1] << 32 | fields[2]) / 1000.0;
+        ordered &= time_ms >= last_ms;
+        last_ms = time_ms;
+        const uint8_t* ip = block + 28;
+        const uint8_t* udp = ip + PCAPNG_IP_HEADER;
+        valid &= ip[0] == 0x45 && ip[9] == 17 && (size_t)(ip[2] << 8 | ip[3]) == fields[3] &&
+                 (udp[2] << 8 | udp[3]) == PCAPNG_UDP_PORT;
+        uint32_t sum = 0;
+        for (int i = 0; i < PCAPNG_IP_HEADER; i += 2) sum += (uint32_t)ip[i] << 8 | ip[i + 1];
+        while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+        valid &= sum == 0xFFFF;
+        data_frame_t frame;
+        ack_frame_t ack;
+        int type = decode_frame(udp + PCAPNG_UDP_HEADER, fields[3] - PCAPNG_IP_HEADER - PCAPNG_UDP_HEADER, &frame, &ack);
+        if (type >= 0) decoded++;
+        if (type == DATA_FRAME) {
+            data_frames++;
+            last_data_ms = time_ms;
+            valid &= ip[15] == 1;       // 数据帧从 A 端（10.0.0.1）发出
+        } else if (type >= 0) {
+            valid &= ip[15] == 2;
+        }
+    }
+    if (file) fclose(file);
+    remove(path);
+    printf("报文 %ld 个, 文件 %lld 字节, 写缓冲区 %d 字节\n", blocks - 2, size, PCAPNG_BUFFER_SIZE);
+    test_assert(valid && blocks - 2 == packets && size == file_bytes, "块结构完整，报文数与文件大小一致");
+    test_assert(decoded == packets && data_frames == stats.frames_sent, "报文可按线路格式解码（发送时尚未损坏）");
+    test_assert(ordered && last_data_ms > 0.0 && last_data_ms <= stats.elapsed_ms, "时间戳为递增的虚拟时刻");
+    
+    // 写缓冲区固定大小：写入的字节数远超缓冲区时内存占用不变
+    test_assert(file_bytes > 4 * PCAPNG_BUFFER_SIZE, "报文流式写入文件");
+    test_assert(!open_pcapng_writer(&writer, "/nonexistent/dir/x.pcapng"), "无法创建文件时返回失败");
+}
+
 /**
  * 运行所有测试
  */
@@ -381,6 +2081,26 @@ void run_all_tests(void) {
     test_error_handling_and_edge_cases();
     test_statistics_functionality();
     test_protocol_state_transitions();
+    test_go_back_n_transmission();
+    test_selective_repeat_transmission();
+    test_discrete_event_simulation();
+    test_timing_wheel();
+    test_adaptive_rto();
+    test_stream_fragmentation();
+    test_udp_transport();
+    test_sack_acknowledgment();
+    test_wire_format();
+    test_crc32c_integrity();
+    test_parameter_sweep();
+    test_channel_impairments();
+    test_congestion_control();
+    test_duplex_piggyback();
+    test_delayed_ack();
+    test_nak_fast_retransmit();
+    test_frame_pool();
+    test_multiplexed_sessions();
+    test_trace_ring();
+    test_pcapng_export();
     
     // 输出测试结果汇总
     printf("\n\n========================================\n");
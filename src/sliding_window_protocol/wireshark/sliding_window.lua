@@ -0,0 +1,144 @@
+-- 滑动窗口协议线路格式的 Wireshark 解析脚本
+-- 用法：wireshark -X lua_script:sliding_window.lua sliding_window.pcapng
+-- 也可复制到 Wireshark 的个人插件目录。仿真导出的报文封装在 UDP 端口 47000 上（见 core/pcapng_writer.h），
+-- 真实 UDP 传输的端口可在“解码为...”中手动指定为 SWP。
+--
+-- 线路格式（见 core/wire_format.h，多字节字段为小端序）：
+--   类型 1字节 | 标志 1字节 | 数据长度 2字节 | [连接号 varint] | 序列号 varint
+--   | [捎带确认号 varint] | [SACK位图 varint] | 数据 | CRC32C 校验和 4字节
+
+local swp = Proto("swp", "Sliding Window Protocol")
+
+local FLAG_SACK = 0x01
+local FLAG_ACK = 0x02
+local FLAG_CONN = 0x04
+local UDP_PORT = 47000
+
+local frame_types = { [0] = "DATA", [1] = "ACK", [2] = "NAK" }
+
+local f_type = ProtoField.uint8("swp.type", "帧类型", base.DEC, frame_types)
+local f_flags = ProtoField.uint8("swp.flags", "标志", base.HEX)
+local f_flag_sack = ProtoField.bool("swp.flags.sack", "携带SACK位图", 8, nil, FLAG_SACK)
+local f_flag_ack = ProtoField.bool("swp.flags.ack", "捎带确认", 8, nil, FLAG_ACK)
+local f_flag_conn = ProtoField.bool("swp.flags.conn", "携带连接号", 8, nil, FLAG_CONN)
+local f_length = ProtoField.uint16("swp.length", "数据长度", base.DEC)
+local f_conn = ProtoField.uint32("swp.conn", "连接号", base.DEC)
+local f_seq = ProtoField.uint32("swp.seq", "序列号", base.DEC)
+local f_ack = ProtoField.uint32("swp.ack", "确认号", base.DEC)
+local f_sack = ProtoField.uint64("swp.sack", "SACK位图", base.HEX)
+local f_data = ProtoField.bytes("swp.data", "数据")
+local f_checksum = ProtoField.uint32("swp.checksum", "校验和", base.HEX)
+local f_checksum_ok = ProtoField.bool("swp.checksum.ok", "校验和正确")
+
+swp.fields = { f_type, f_flags, f_flag_sack, f_flag_ack, f_flag_conn, f_length, f_conn,
+               f_seq, f_ack, f_sack, f_data, f_checksum, f_checksum_ok }
+
+local e_malformed = ProtoExpert.new("swp.malformed", "报文格式错误", expert.group.MALFORMED, expert.severity.ERROR)
+local e_checksum = ProtoExpert.new("swp.checksum.bad", "校验和错误", expert.group.CHECKSUM, expert.severity.WARN)
+swp.experts = { e_malformed, e_checksum }
+
+-- CRC32C（反射多项式 0x82F63B78，初值与结果异或值均为 0xFFFFFFFF），与 core/crc32c.c 相同
+local crc_table = {}
+for i = 0, 255 do
+    local crc = i
+    for _ = 1, 8 do
+        if bit.band(crc, 1) ~= 0 then
+            crc = bit.bxor(bit.rshift(crc, 1), 0x82F63B78)
+        else
+            crc = bit.rshift(crc, 1)
+        end
+    end
+    crc_table[i] = crc
+end
+
+local function crc32c(bytes, length)
+    local crc = bit.bnot(0)
+    for i = 0, length - 1 do
+        crc = bit.bxor(crc_table[bit.band(bit.bxor(crc, bytes:get_index(i)), 0xFF)], bit.rshift(crc, 8))
+    end
+    return bit.bnot(crc)
+end
+
+-- 读一个 varint：返回值（UInt64）与字节数，越界或超过10字节时返回 nil
+local function read_varint(tvb, offset, limit)
+    local value = UInt64(0)
+    for i = 0, 9 do
+        if offset + i >= limit then return nil end
+        local byte = tvb(offset + i, 1):uint()
+        value = value:bor(UInt64(bit.band(byte, 0x7F)):lshift(7 * i))
+        if bit.band(byte, 0x80) == 0 then return value, i + 1 end
+    end
+    return nil
+end
+
+function swp.dissector(tvb, pinfo, tree)
+    local length = tvb:len()
+    if length < 8 then return 0 end
+    local frame_type = tvb(0, 1):uint()
+    if frame_types[frame_type] == nil then return 0 end
+
+    pinfo.cols.protocol = "SWP"
+    local subtree = tree:add(swp, tvb(), "Sliding Window Protocol, " .. frame_types[frame_type])
+    local flags = tvb(1, 1):uint()
+    local data_length = tvb(2, 2):le_uint()
+    subtree:add(f_type, tvb(0, 1))
+    local flag_tree = subtree:add(f_flags, tvb(1, 1))
+    flag_tree:add(f_flag_sack, tvb(1, 1))
+    flag_tree:add(f_flag_ack, tvb(1, 1))
+    flag_tree:add(f_flag_conn, tvb(1, 1))
+    subtree:add_le(f_length, tvb(2, 2))
+
+    local limit = length - 4
+    local offset = 4
+    local function field(proto_field, label)
+        local value, size = read_varint(tvb, offset, limit)
+        if value == nil then
+            subtree:add_proto_expert_info(e_malformed, label .. "越界")
+            return nil
+        end
+        subtree:add(proto_field, tvb(offset, size), proto_field == f_sack and value or value:tonumber())
+        offset = offset + size
+        return value
+    end
+
+    local info = frame_types[frame_type]
+    if bit.band(flags, FLAG_CONN) ~= 0 then
+        local conn = field(f_conn, "连接号")
+        if conn == nil then return length end
+        info = info .. " conn=" .. tostring(conn)
+    end
+    local seq = field(frame_type == 0 and f_seq or f_ack, "序列号")
+    if seq == nil then return length end
+    info = info .. (frame_type == 0 and " seq=" or " ack=") .. tostring(seq)
+    if frame_type == 0 and bit.band(flags, FLAG_ACK) ~= 0 then
+        local ack = field(f_ack, "确认号")
+        if ack == nil then return length end
+        info = info .. " ack=" .. tostring(ack)
+    end
+    if bit.band(flags, FLAG_SACK) ~= 0 then
+        local sack = field(f_sack, "SACK位图")
+        if sack == nil then return length end
+        info = info .. " sack=0x" .. (sack:tohex():gsub("^0+(.)", "%1"))
+    end
+    if frame_type == 0 then
+        if offset + data_length ~= limit then
+            subtree:add_proto_expert_info(e_malformed, "数据长度与报文长度不符")
+            return length
+        end
+        if data_length > 0 then subtree:add(f_data, tvb(offset, data_length)) end
+        info = info .. " len=" .. data_length
+    end
+
+    local checksum = tvb(limit, 4):le_uint()
+    local checksum_item = subtree:add_le(f_checksum, tvb(limit, 4))
+    local ok = bit.tobit(crc32c(tvb:bytes(0, limit), limit)) == bit.tobit(checksum)
+    checksum_item:add(f_checksum_ok, ok):set_generated()
+    if not ok then
+        checksum_item:add_proto_expert_info(e_checksum)
+        info = info .. " [校验和错误]"
+    end
+    pinfo.cols.info = info
+    return length
+end
+
+DissectorTable.get("udp.port"):add(UDP_PORT, swp)